@@ -3,6 +3,7 @@
 
 #include "Android/AndroidJNIUtilities.h"
 
+#include "CleverTapJsonWriter.h"
 #include "CleverTapLog.h"
 #include "CleverTapLogLevel.h"
 #include "CleverTapUtilities.h"
@@ -317,8 +318,8 @@ bool SetDebugLevel(JNIEnv* Env, ECleverTapLogLevel Level)
 
 void OnUserLogin(JNIEnv* Env, jobject CleverTapInstance, jobject Profile)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::OnUserLogin(Profile)"));
-	UE_LOG(LogCleverTap, Log, TEXT("Profile: %s"), *JavaObjectToString(Env, Profile));
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::OnUserLogin(Profile)"));
+	CLEVERTAP_LOG_PAYLOAD(TEXT("Profile: %s"), *JavaObjectToString(Env, Profile));
 	jclass CleverTapAPIClass = GetCleverTapAPIClass(Env);
 	if (!CleverTapAPIClass)
 	{
@@ -341,9 +342,8 @@ void OnUserLogin(JNIEnv* Env, jobject CleverTapInstance, jobject Profile)
 
 void OnUserLogin(JNIEnv* Env, jobject CleverTapInstance, jobject Profile, const FString& CleverTapID)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::OnUserLogin(Profile, CleverTapID)"));
-	UE_LOG(
-		LogCleverTap, Log, TEXT("CleverTapID: \"%s\", Profile: %s"), *CleverTapID, *JavaObjectToString(Env, Profile));
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::OnUserLogin(Profile, CleverTapID)"));
+	CLEVERTAP_LOG_PAYLOAD(TEXT("CleverTapID: \"%s\", Profile: %s"), *CleverTapID, *JavaObjectToString(Env, Profile));
 
 	jclass CleverTapAPIClass = GetCleverTapAPIClass(Env);
 	if (!CleverTapAPIClass)
@@ -380,8 +380,8 @@ void OnUserLogin(JNIEnv* Env, jobject CleverTapInstance, jobject Profile, const
 
 void PushProfile(JNIEnv* Env, jobject CleverTapInstance, jobject Profile)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::PushProfile()"));
-	UE_LOG(LogCleverTap, Log, TEXT("Profile: %s"), *JavaObjectToString(Env, Profile));
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::PushProfile()"));
+	CLEVERTAP_LOG_PAYLOAD(TEXT("Profile: %s"), *JavaObjectToString(Env, Profile));
 
 	jclass CleverTapAPIClass = GetCleverTapAPIClass(Env);
 	if (!CleverTapAPIClass)
@@ -406,7 +406,7 @@ void PushProfile(JNIEnv* Env, jobject CleverTapInstance, jobject Profile)
 
 void PushEvent(JNIEnv* Env, jobject CleverTapInstance, const FString& EventName)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::PushEvent(%s)"), *EventName);
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::PushEvent(%s)"), *EventName);
 	jclass CleverTapAPIClass = GetCleverTapAPIClass(Env);
 	if (!CleverTapAPIClass)
 	{
@@ -433,8 +433,8 @@ void PushEvent(JNIEnv* Env, jobject CleverTapInstance, const FString& EventName)
 
 void PushEvent(JNIEnv* Env, jobject CleverTapInstance, const FString& EventName, jobject Actions)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::PushEvent(%s, Actions)"), *EventName);
-	UE_LOG(LogCleverTap, Log, TEXT("EventName: '%s', Actions: %s"), *EventName, *JavaObjectToString(Env, Actions));
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::PushEvent(%s, Actions)"), *EventName);
+	CLEVERTAP_LOG_PAYLOAD(TEXT("EventName: '%s', Actions: %s"), *EventName, *JavaObjectToString(Env, Actions));
 
 	jclass CleverTapAPIClass = GetCleverTapAPIClass(Env);
 	if (!CleverTapAPIClass)
@@ -465,8 +465,8 @@ void PushEvent(JNIEnv* Env, jobject CleverTapInstance, const FString& EventName,
 
 void PushChargedEvent(JNIEnv* Env, jobject CleverTapInstance, jobject ChargeDetails, jobject Items)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::PushChargedEvent()"));
-	UE_LOG(LogCleverTap, Log, TEXT("ChargeDetails: '%s', Items: %s"), *JavaObjectToString(Env, ChargeDetails),
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::PushChargedEvent()"));
+	CLEVERTAP_LOG_PAYLOAD(TEXT("ChargeDetails: '%s', Items: %s"), *JavaObjectToString(Env, ChargeDetails),
 		*JavaObjectToString(Env, Items));
 
 	jclass CleverTapAPIClass = GetCleverTapAPIClass(Env);
@@ -512,7 +512,7 @@ static void DecrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString
 
 void DecrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString& Key, int Amount)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::DecrementValue(%s,%d)"), *Key, Amount);
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::DecrementValue(%s,%d)"), *Key, Amount);
 	jclass IntegerClass = LoadJavaClass(Env, "java/lang/Integer");
 	if (!IntegerClass)
 	{
@@ -535,7 +535,7 @@ void DecrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString& Key,
 
 void DecrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString& Key, double Amount)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::DecrementValue(%s,%f)"), *Key, Amount);
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::DecrementValue(%s,%f)"), *Key, Amount);
 
 	jclass DoubleClass = LoadJavaClass(Env, "java/lang/Double");
 	if (!DoubleClass)
@@ -579,7 +579,7 @@ static void IncrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString
 
 void IncrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString& Key, int Amount)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::IncrementValue(%s,%d)"), *Key, Amount);
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::IncrementValue(%s,%d)"), *Key, Amount);
 	jclass IntegerClass = LoadJavaClass(Env, "java/lang/Integer");
 	if (!IntegerClass)
 	{
@@ -602,7 +602,7 @@ void IncrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString& Key,
 
 void IncrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString& Key, double Amount)
 {
-	UE_LOG(LogCleverTap, Log, TEXT("CleverTapSDK::Android::JNI::IncrementValue(%s,%f)"), *Key, Amount);
+	UE_LOG(LogCleverTap, Verbose, TEXT("CleverTapSDK::Android::JNI::IncrementValue(%s,%f)"), *Key, Amount);
 	jclass DoubleClass = LoadJavaClass(Env, "java/lang/Double");
 	if (!DoubleClass)
 	{
@@ -768,11 +768,12 @@ static jobject ConvertCleverTapDateToJavaDate(JNIEnv* Env, const FCleverTapDate&
 	return JavaDate;
 }
 
-jobject ConvertCleverTapPropertiesToJavaMap(JNIEnv* Env, const FCleverTapProperties& Properties)
+jobject ConvertCleverTapPropertiesToJavaMap(JNIEnv* Env, const FCleverTapProperties& Properties, jobject BaseMap)
 {
 	// HashMap Support
 	jclass HashMapClass = LoadJavaClass(Env, "java/util/HashMap");
-	jmethodID HashMapConstructor = GetMethodID(Env, HashMapClass, "<init>", "()V");
+	jmethodID HashMapConstructor = BaseMap ? GetMethodID(Env, HashMapClass, "<init>", "(Ljava/util/Map;)V")
+										   : GetMethodID(Env, HashMapClass, "<init>", "()V");
 	jmethodID HashMapPut =
 		GetMethodID(Env, HashMapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
 	if (!HashMapConstructor || !HashMapPut)
@@ -829,8 +830,9 @@ jobject ConvertCleverTapPropertiesToJavaMap(JNIEnv* Env, const FCleverTapPropert
 		return nullptr;
 	}
 
-	// Construct a new java hashmap
-	jobject JavaMap = Env->NewObject(HashMapClass, HashMapConstructor);
+	// Construct a new java hashmap, starting from a copy of the base map if there is one
+	jobject JavaMap = BaseMap ? Env->NewObject(HashMapClass, HashMapConstructor, BaseMap)
+							  : Env->NewObject(HashMapClass, HashMapConstructor);
 	if (HandleExceptionOrError(Env, !JavaMap, TEXT("HashMap Constructor")))
 	{
 		Env->DeleteLocalRef(HashMapClass);
@@ -920,9 +922,11 @@ jobject ConvertCleverTapPropertiesToJavaMap(JNIEnv* Env, const FCleverTapPropert
 			jobject JavaArrayList = Env->NewObject(ArrayListClass, ArrayListConstructor);
 			if (!HandleExceptionOrError(Env, !JavaArrayList, "Constructing ArrayList"))
 			{
+				ANSICHAR Buffer[FCleverTapJsonWriter::NumberBufferSize];
 				for (float Item : Value.Get<TArray<float>>())
 				{
-					jstring JavaItem = Env->NewStringUTF(TCHAR_TO_UTF8(*FString::Printf(TEXT("%.7g"), Item)));
+					FCleverTapJsonWriter::FormatFloat(Item, Buffer);
+					jstring JavaItem = Env->NewStringUTF(Buffer);
 					Env->CallBooleanMethod(JavaArrayList, ArrayListAdd, JavaItem);
 					if (HandleException(Env, "Adding to ArrayList"))
 					{
@@ -939,9 +943,11 @@ jobject ConvertCleverTapPropertiesToJavaMap(JNIEnv* Env, const FCleverTapPropert
 			jobject JavaArrayList = Env->NewObject(ArrayListClass, ArrayListConstructor);
 			if (!HandleExceptionOrError(Env, !JavaArrayList, "Constructing ArrayList"))
 			{
-				for (float Item : Value.Get<TArray<double>>())
+				ANSICHAR Buffer[FCleverTapJsonWriter::NumberBufferSize];
+				for (double Item : Value.Get<TArray<double>>())
 				{
-					jstring JavaItem = Env->NewStringUTF(TCHAR_TO_UTF8(*FString::Printf(TEXT("%.15g"), Item)));
+					FCleverTapJsonWriter::FormatDouble(Item, Buffer);
+					jstring JavaItem = Env->NewStringUTF(Buffer);
 					Env->CallBooleanMethod(JavaArrayList, ArrayListAdd, JavaItem);
 					if (HandleException(Env, "Adding to ArrayList"))
 					{
@@ -1063,7 +1069,152 @@ jobject ConvertArrayOfCleverTapPropertiesToJavaArrayOfMap(JNIEnv* Env, const TAr
 	return JavaArray;
 }
 
-static jobject CreateUECleverTapListener(JNIEnv* Env, const char* ClassPath, void* NativeInstance)
+static jobject ConvertStringsToJavaArray(JNIEnv* Env, const TArray<FString>& Strings)
+{
+	jclass StringClass = LoadJavaClass(Env, "java/lang/String");
+	jobjectArray JavaArray = Env->NewObjectArray(Strings.Num(), StringClass, nullptr);
+	Env->DeleteLocalRef(StringClass);
+	if (HandleExceptionOrError(Env, !JavaArray, TEXT("Constructing String[]")))
+	{
+		return nullptr;
+	}
+
+	for (int32 Index = 0; Index < Strings.Num(); ++Index)
+	{
+		jstring JavaString = Env->NewStringUTF(TCHAR_TO_UTF8(*Strings[Index]));
+		Env->SetObjectArrayElement(JavaArray, Index, JavaString);
+		Env->DeleteLocalRef(JavaString);
+	}
+	return JavaArray;
+}
+
+static jobject ConvertChargedItemsColumnToJavaArray(JNIEnv* Env, const FCleverTapPropertyValue& Values)
+{
+	static_assert(sizeof(jint) == sizeof(int32) && sizeof(jlong) == sizeof(int64), "Unexpected JNI integer sizes");
+	static_assert(sizeof(jfloat) == sizeof(float) && sizeof(jdouble) == sizeof(double), "Unexpected JNI float sizes");
+
+	switch (Values.GetIndex())
+	{
+		case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+		{
+			const TArray<int32>& Array = Values.Get<TArray<int32>>();
+			jintArray JavaArray = Env->NewIntArray(Array.Num());
+			if (JavaArray)
+			{
+				Env->SetIntArrayRegion(JavaArray, 0, Array.Num(), reinterpret_cast<const jint*>(Array.GetData()));
+			}
+			return JavaArray;
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+		{
+			const TArray<int64>& Array = Values.Get<TArray<int64>>();
+			jlongArray JavaArray = Env->NewLongArray(Array.Num());
+			if (JavaArray)
+			{
+				Env->SetLongArrayRegion(JavaArray, 0, Array.Num(), reinterpret_cast<const jlong*>(Array.GetData()));
+			}
+			return JavaArray;
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+		{
+			const TArray<float>& Array = Values.Get<TArray<float>>();
+			jfloatArray JavaArray = Env->NewFloatArray(Array.Num());
+			if (JavaArray)
+			{
+				Env->SetFloatArrayRegion(JavaArray, 0, Array.Num(), Array.GetData());
+			}
+			return JavaArray;
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+		{
+			const TArray<double>& Array = Values.Get<TArray<double>>();
+			jdoubleArray JavaArray = Env->NewDoubleArray(Array.Num());
+			if (JavaArray)
+			{
+				Env->SetDoubleArrayRegion(JavaArray, 0, Array.Num(), Array.GetData());
+			}
+			return JavaArray;
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+		{
+			const TArray<bool>& Array = Values.Get<TArray<bool>>();
+			TArray<jboolean, TInlineAllocator<256>> Booleans;
+			Booleans.SetNumUninitialized(Array.Num());
+			for (int32 Index = 0; Index < Array.Num(); ++Index)
+			{
+				Booleans[Index] = Array[Index] ? JNI_TRUE : JNI_FALSE;
+			}
+			jbooleanArray JavaArray = Env->NewBooleanArray(Array.Num());
+			if (JavaArray)
+			{
+				Env->SetBooleanArrayRegion(JavaArray, 0, Array.Num(), Booleans.GetData());
+			}
+			return JavaArray;
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+			return ConvertStringsToJavaArray(Env, Values.Get<TArray<FString>>());
+		default:
+			UE_LOG(LogCleverTap, Error, TEXT("Unsupported charged item column type (type index %d)"),
+				int32(Values.GetIndex()));
+			return nullptr;
+	}
+}
+
+jobject ConvertChargedItemsToJavaArrayOfMap(JNIEnv* Env, const FCleverTapChargedItems& Items)
+{
+	jclass BridgeClass = LoadJavaClass(Env, "com/clevertap/android/unreal/UECleverTapBridge");
+	jmethodID BuildMethod = GetStaticMethodID(
+		Env, BridgeClass, "buildChargedItems", "(I[Ljava/lang/String;[Ljava/lang/Object;)Ljava/util/ArrayList;");
+	if (!BuildMethod)
+	{
+		Env->DeleteLocalRef(BridgeClass);
+		return nullptr;
+	}
+
+	const FCleverTapPayload& Columns = Items.GetColumns();
+	TArray<FString> Keys;
+	Keys.Reserve(Columns.Num());
+	for (const TPair<FString, FCleverTapPropertyValue>& Column : Columns)
+	{
+		Keys.Add(Column.Key);
+	}
+	jobject JavaKeys = ConvertStringsToJavaArray(Env, Keys);
+
+	// each column is copied into a primitive Java array in a single call
+	jclass ObjectClass = LoadJavaClass(Env, "java/lang/Object");
+	jobjectArray JavaColumns = Env->NewObjectArray(Columns.Num(), ObjectClass, nullptr);
+	Env->DeleteLocalRef(ObjectClass);
+	if (HandleExceptionOrError(Env, !JavaKeys || !JavaColumns, TEXT("Constructing charged item columns")))
+	{
+		Env->DeleteLocalRef(BridgeClass);
+		Env->DeleteLocalRef(JavaKeys);
+		Env->DeleteLocalRef(JavaColumns);
+		return nullptr;
+	}
+	for (int32 Index = 0; Index < Columns.Num(); ++Index)
+	{
+		jobject JavaColumn = ConvertChargedItemsColumnToJavaArray(Env, Columns[Index].Value);
+		if (HandleExceptionOrError(Env, !JavaColumn, TEXT("Converting charged item column")))
+		{
+			continue; // the items won't have this key; keep going
+		}
+		Env->SetObjectArrayElement(JavaColumns, Index, JavaColumn);
+		Env->DeleteLocalRef(JavaColumn);
+	}
+
+	jobject JavaItems = Env->CallStaticObjectMethod(BridgeClass, BuildMethod, jint(Items.Num()), JavaKeys, JavaColumns);
+	if (HandleExceptionOrError(Env, !JavaItems, "buildChargedItems()"))
+	{
+		JavaItems = nullptr;
+	}
+	Env->DeleteLocalRef(BridgeClass);
+	Env->DeleteLocalRef(JavaKeys);
+	Env->DeleteLocalRef(JavaColumns);
+
+	return JavaItems;
+}
+
+static jobject CreateUECleverTapListener(JNIEnv* Env, const char* ClassPath, jlong NativeHandle)
 {
 	jclass ListenerClass = LoadJavaClass(Env, ClassPath);
 	jmethodID ListenerConstructor = GetMethodID(Env, ListenerClass, "<init>", "(J)V");
@@ -1071,7 +1222,7 @@ static jobject CreateUECleverTapListener(JNIEnv* Env, const char* ClassPath, voi
 	{
 		return nullptr;
 	}
-	jobject Listener = Env->NewObject(ListenerClass, ListenerConstructor, jlong(NativeInstance));
+	jobject Listener = Env->NewObject(ListenerClass, ListenerConstructor, NativeHandle);
 	if (HandleExceptionOrError(Env, !Listener, "Creating Listener"))
 	{
 		UE_LOG(LogCleverTap, Error, TEXT("Failed creating listener of class \"%hs\""), ClassPath);
@@ -1081,7 +1232,7 @@ static jobject CreateUECleverTapListener(JNIEnv* Env, const char* ClassPath, voi
 	return Listener;
 }
 
-bool RegisterPushPermissionResponseListener(JNIEnv* Env, jobject CleverTapInstance, void* NativeInstance)
+bool RegisterPushPermissionResponseListener(JNIEnv* Env, jobject CleverTapInstance, jlong NativeHandle)
 {
 	jclass CleverTapAPIClass = GetCleverTapAPIClass(Env);
 	jmethodID RegisterListenerMethod =
@@ -1094,7 +1245,7 @@ bool RegisterPushPermissionResponseListener(JNIEnv* Env, jobject CleverTapInstan
 	}
 
 	jobject Listener = JNI::CreateUECleverTapListener(
-		Env, "com/clevertap/android/unreal/UECleverTapListeners$PushPermissionListener", NativeInstance);
+		Env, "com/clevertap/android/unreal/UECleverTapListeners$PushPermissionListener", NativeHandle);
 	if (!Listener)
 	{
 		return false;
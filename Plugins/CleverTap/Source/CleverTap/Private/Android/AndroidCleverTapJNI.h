@@ -1,6 +1,7 @@
 // Copyright CleverTap All Rights Reserved.
 #pragma once
 
+#include "CleverTapChargedItems.h"
 #include "CleverTapInstanceConfig.h"
 #include "CleverTapLogLevel.h"
 #include "CleverTapProperties.h"
@@ -36,10 +37,16 @@ void IncrementValue(JNIEnv* Env, jobject CleverTapInstance, const FString& Key,
 
 FString GetCleverTapID(JNIEnv* Env, jobject CleverTapInstance);
 
-jobject ConvertCleverTapPropertiesToJavaMap(JNIEnv* Env, const FCleverTapProperties& Properties);
+/**
+ * Converts properties to a new java.util.HashMap. If BaseMap is set the result starts as a copy of it, so the
+ *  converted properties take precedence over its entries.
+ */
+jobject ConvertCleverTapPropertiesToJavaMap(
+	JNIEnv* Env, const FCleverTapProperties& Properties, jobject BaseMap = nullptr);
 jobject ConvertArrayOfCleverTapPropertiesToJavaArrayOfMap(JNIEnv* Env, const TArray<FCleverTapProperties>& Array);
+jobject ConvertChargedItemsToJavaArrayOfMap(JNIEnv* Env, const FCleverTapChargedItems& Items);
 
-bool RegisterPushPermissionResponseListener(JNIEnv* Env, jobject CleverTapInstance, void* NativeInstance);
+bool RegisterPushPermissionResponseListener(JNIEnv* Env, jobject CleverTapInstance, jlong NativeHandle);
 
 bool IsPushPermissionGranted(JNIEnv* Env, jobject CleverTapInstance);
 void PromptForPushPermission(JNIEnv* Env, jobject CleverTapInstance, bool bFallbackToSettings);
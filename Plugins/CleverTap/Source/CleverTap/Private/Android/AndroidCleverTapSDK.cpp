@@ -4,28 +4,92 @@
 #include "Android/AndroidCleverTapJNI.h"
 #include "Android/AndroidJNIUtilities.h"
 
-#include "CleverTapInstance.h"
+#include "CleverTapEventContext.h"
+#include "CleverTapGlobalProperties.h"
+#include "CleverTapHandleTable.h"
+#include "CleverTapIdCache.h"
 #include "CleverTapLog.h"
 #include "CleverTapLogLevel.h"
+#include "CleverTapMetricsInstance.h"
+#include "CleverTapProfileShadow.h"
+#include "CleverTapStartupProfiler.h"
 #include "CleverTapUtilities.h"
 
 #include "Android/AndroidApplication.h"
+#include "Async/Async.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
 
 namespace CleverTapSDK { namespace Android {
 
-class FAndroidCleverTapInstance : public ICleverTapInstance
+class FAndroidCleverTapInstance : public FCleverTapMetricsInstance
 {
 private:
-	static TSet<FAndroidCleverTapInstance*> Instances;
+	// Java listeners refer to native instances through handles from this table rather than raw pointers
+	using FHandleTable = TCleverTapHandleTable<FAndroidCleverTapInstance, 16>;
+	static FHandleTable Instances;
+
+	enum class EPushPermissionState : uint8
+	{
+		Unknown,
+		Denied,
+		Granted,
+	};
 
 public:
-	static bool IsValid(const FAndroidCleverTapInstance* Instance) { return Instances.Contains(Instance); }
+	/**
+	 * Records a push permission response reported by the Java listener. Can be called from any thread. Responses are
+	 *  coalesced so that a burst of responses results in a single game thread broadcast of the latest state.
+	 */
+	static void HandlePushPermissionResponse(FCleverTapHandle Handle, bool bGranted)
+	{
+		FHandleTable::FPinned Instance = Instances.Pin(Handle); // keeps the instance alive while it is being updated
+		if (!Instance)
+		{
+			UE_LOG(LogCleverTap, Error, TEXT("Invalid native instance handle %llx!"), Handle);
+			return;
+		}
+
+		Instance->PushPermissionState.store(
+			bGranted ? EPushPermissionState::Granted : EPushPermissionState::Denied, std::memory_order_release);
+		if (Instance->bPushPermissionBroadcastPending.exchange(true, std::memory_order_acq_rel))
+		{
+			return; // a broadcast is already queued and will pick up the latest state
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [Handle]() {
+			// instances are destroyed on the game thread so resolving without a pin is safe here
+			if (FAndroidCleverTapInstance* const GameThreadInstance = Instances.Resolve(Handle))
+			{
+				GameThreadInstance->BroadcastPushPermissionResponse();
+			}
+		});
+	}
 
 	jobject JavaCleverTapInstance;
 
-	FAndroidCleverTapInstance(JNIEnv* Env, jobject JavaCleverTapInstanceIn)
+	FAndroidCleverTapInstance(JNIEnv* Env, jobject JavaCleverTapInstanceIn, const FCleverTapInstanceConfig& Config)
+		: FCleverTapMetricsInstance(Config)
+		, IdCache(MakeShared<FCleverTapIdCache, ESPMode::ThreadSafe>(
+			  [this]() { return JNI::GetCleverTapID(JNI::GetJNIEnv(), JavaCleverTapInstance); },
+			  [this](const FString& CleverTapId) { OnCleverTapIdChanged.Broadcast(CleverTapId); }))
 	{
-		Instances.Add(this);
+		if (Config.bSendProfileChangesOnly)
+		{
+			ProfileShadow = MakeUnique<FCleverTapProfileShadow>();
+		}
+
+		Handle = Instances.Register(this);
+		UE_CLOG(Handle == InvalidCleverTapHandle, LogCleverTap, Error,
+			TEXT("Too many CleverTap instances. Listener notifications will not be delivered."));
+
+		// the user may change the permission in the system settings while the app is in the background
+		ForegroundHandle = FCoreDelegates::ApplicationHasEnteredForegroundDelegate.AddLambda([this]() {
+			PushPermissionState.store(EPushPermissionState::Unknown, std::memory_order_release);
+		});
+
 		if (!Env || !JavaCleverTapInstanceIn)
 		{
 			JavaCleverTapInstance = nullptr;
@@ -33,32 +97,48 @@ public:
 		}
 
 		JavaCleverTapInstance = Env->NewGlobalRef(JavaCleverTapInstanceIn);
-		JNI::RegisterPushPermissionResponseListener(Env, JavaCleverTapInstance, this);
+
+		CLEVERTAP_STARTUP_SCOPE("RegisterListeners");
+		JNI::RegisterPushPermissionResponseListener(Env, JavaCleverTapInstance, Handle);
 	}
 
 	~FAndroidCleverTapInstance()
 	{
+		FlushMetrics();
+
 		auto* Env = JNI::GetJNIEnv();
 		if (Env && JavaCleverTapInstance)
 		{
 			Env->DeleteGlobalRef(JavaCleverTapInstance);
 		}
 
-		Instances.Remove(this);
-	}
+		FCoreDelegates::ApplicationHasEnteredForegroundDelegate.Remove(ForegroundHandle);
+		Instances.Unregister(Handle);
 
-	FString GetCleverTapId() override
-	{
-		auto* Env = JNI::GetJNIEnv();
-		return JNI::GetCleverTapID(Env, JavaCleverTapInstance);
+		if (Env)
+		{
+			ReplaceGlobalRef(Env, JavaEventContext, nullptr);
+			ReplaceGlobalRef(Env, JavaCallContext, nullptr);
+		}
 	}
 
+	// The bridge converts payloads to native objects synchronously, so moving them in gains nothing over the copying
+	//  overloads; pull in the forwarding rvalue overloads rather than hiding them
+	using ICleverTapInstance::OnUserLogin;
+	using ICleverTapInstance::PushChargedEvent;
+	using ICleverTapInstance::PushEvent;
+	using ICleverTapInstance::PushProfile;
+
+	FString GetCleverTapId() override { return IdCache->Get(); }
+
 	void OnUserLogin(const FCleverTapProperties& Profile) override
 	{
 		auto* Env = JNI::GetJNIEnv();
 		jobject JavaProfile = JNI::ConvertCleverTapPropertiesToJavaMap(Env, Profile);
 		JNI::OnUserLogin(Env, JavaCleverTapInstance, JavaProfile);
 		Env->DeleteLocalRef(JavaProfile);
+		IdCache->Invalidate();
+		ResetProfileShadow(Profile);
 	};
 
 	void OnUserLogin(const FCleverTapProperties& Profile, const FString& CleverTapId) override
@@ -67,63 +147,139 @@ public:
 		jobject JavaProfile = JNI::ConvertCleverTapPropertiesToJavaMap(Env, Profile);
 		JNI::OnUserLogin(Env, JavaCleverTapInstance, JavaProfile, CleverTapId);
 		Env->DeleteLocalRef(JavaProfile);
+		IdCache->Invalidate();
+		ResetProfileShadow(Profile);
 	}
 
 	void PushProfile(const FCleverTapProperties& Profile) override
 	{
-		auto* Env = JNI::GetJNIEnv();
-		jobject JavaProfile = JNI::ConvertCleverTapPropertiesToJavaMap(Env, Profile);
-		JNI::PushProfile(Env, JavaCleverTapInstance, JavaProfile);
-		Env->DeleteLocalRef(JavaProfile);
+		if (ProfileShadow)
+		{
+			const FCleverTapProperties ChangedFields = ProfileShadow->FilterChangedFields(Profile);
+			if (ChangedFields.Num() > 0)
+			{
+				SendProfile(ChangedFields);
+			}
+			return;
+		}
+		SendProfile(Profile);
 	}
 
 	void PushEvent(const FString& EventName) override
 	{
 		auto* Env = JNI::GetJNIEnv();
+		if (jobject JavaContext = NewEventContextRef(Env))
+		{
+			JNI::PushEvent(Env, JavaCleverTapInstance, EventName, JavaContext);
+			Env->DeleteLocalRef(JavaContext);
+			return;
+		}
 		JNI::PushEvent(Env, JavaCleverTapInstance, EventName);
 	}
 
 	void PushEvent(const FString& EventName, const FCleverTapProperties& Actions) override
 	{
 		auto* Env = JNI::GetJNIEnv();
-		jobject JavaActions = JNI::ConvertCleverTapPropertiesToJavaMap(Env, Actions);
-		JNI::PushEvent(Env, JavaCleverTapInstance, EventName, JavaActions);
-		Env->DeleteLocalRef(JavaActions);
+		jobject JavaContext = NewEventContextRef(Env);
+		PushEventWithContext(Env, EventName, Actions, JavaContext);
+	}
+
+	void PushEvent(const FString& EventName, const FCleverTapEventContextRef& Context,
+		const FCleverTapProperties& Actions) override
+	{
+		auto* Env = JNI::GetJNIEnv();
+		jobject JavaContext = NewCallContextRef(Env, Context);
+		PushEventWithContext(Env, EventName, Actions, JavaContext);
 	}
 
 	void PushChargedEvent(const FCleverTapProperties& ChargeDetails, const TArray<FCleverTapProperties>& Items) override
 	{
 		auto* Env = JNI::GetJNIEnv();
-		jobject JavaDetails = JNI::ConvertCleverTapPropertiesToJavaMap(Env, ChargeDetails);
+		jobject JavaContext = NewEventContextRef(Env);
+		jobject JavaDetails = JNI::ConvertCleverTapPropertiesToJavaMap(Env, ChargeDetails, JavaContext);
+		if (JavaContext)
+		{
+			Env->DeleteLocalRef(JavaContext);
+		}
 		jobject JavaItems = JNI::ConvertArrayOfCleverTapPropertiesToJavaArrayOfMap(Env, Items);
 		JNI::PushChargedEvent(Env, JavaCleverTapInstance, JavaDetails, JavaItems);
 		Env->DeleteLocalRef(JavaDetails);
 		Env->DeleteLocalRef(JavaItems);
 	}
 
+	void SetEventContext(FCleverTapEventContextPtr Context) override
+	{
+		GlobalProperties.SetEventContext(MoveTemp(Context));
+	}
+
+	FCleverTapEventContextPtr GetEventContext() const override { return GlobalProperties.GetEventContext(); }
+
+	void SetGlobalProperty(const FString& Key, FCleverTapPropertyValue Value) override
+	{
+		GlobalProperties.SetProperty(Key, MoveTemp(Value));
+	}
+
+	void RemoveGlobalProperty(const FString& Key) override { GlobalProperties.RemoveProperty(Key); }
+
+	FDelegateHandle AddGlobalPropertyProvider(FCleverTapGlobalPropertyProvider Provider) override
+	{
+		return GlobalProperties.AddProvider(MoveTemp(Provider));
+	}
+
+	void RemoveGlobalPropertyProvider(FDelegateHandle Handle) override { GlobalProperties.RemoveProvider(Handle); }
+
+	void PushChargedEvent(const FCleverTapProperties& ChargeDetails, const FCleverTapChargedItems& Items) override
+	{
+		auto* Env = JNI::GetJNIEnv();
+		jobject JavaContext = NewEventContextRef(Env);
+		jobject JavaDetails = JNI::ConvertCleverTapPropertiesToJavaMap(Env, ChargeDetails, JavaContext);
+		if (JavaContext)
+		{
+			Env->DeleteLocalRef(JavaContext);
+		}
+		jobject JavaItems = JNI::ConvertChargedItemsToJavaArrayOfMap(Env, Items);
+		JNI::PushChargedEvent(Env, JavaCleverTapInstance, JavaDetails, JavaItems);
+		Env->DeleteLocalRef(JavaDetails);
+		Env->DeleteLocalRef(JavaItems);
+	}
+
 	void DecrementValue(const FString& Key, int Amount) override
 	{
 		JNI::DecrementValue(JNI::GetJNIEnv(), JavaCleverTapInstance, Key, Amount);
+		InvalidateProfileField(Key);
 	}
 
 	void DecrementValue(const FString& Key, double Amount) override
 	{
 		JNI::DecrementValue(JNI::GetJNIEnv(), JavaCleverTapInstance, Key, Amount);
+		InvalidateProfileField(Key);
 	}
 
 	void IncrementValue(const FString& Key, int Amount) override
 	{
 		JNI::IncrementValue(JNI::GetJNIEnv(), JavaCleverTapInstance, Key, Amount);
+		InvalidateProfileField(Key);
 	}
 
 	void IncrementValue(const FString& Key, double Amount) override
 	{
 		JNI::IncrementValue(JNI::GetJNIEnv(), JavaCleverTapInstance, Key, Amount);
+		InvalidateProfileField(Key);
 	}
 
 	void IsPushPermissionGrantedAsync(TFunction<void(bool)> Callback) override
 	{
-		Callback(JNI::IsPushPermissionGranted(JNI::GetJNIEnv(), JavaCleverTapInstance));
+		EPushPermissionState State = PushPermissionState.load(std::memory_order_acquire);
+		if (State == EPushPermissionState::Unknown)
+		{
+			const bool bGranted = JNI::IsPushPermissionGranted(JNI::GetJNIEnv(), JavaCleverTapInstance);
+			State = bGranted ? EPushPermissionState::Granted : EPushPermissionState::Denied;
+
+			// don't overwrite a state reported by the listener in the meantime
+			EPushPermissionState Expected = EPushPermissionState::Unknown;
+			PushPermissionState.compare_exchange_strong(Expected, State, std::memory_order_acq_rel);
+		}
+		Callback(State == EPushPermissionState::Granted);
 	}
 
 	void PromptForPushPermission(bool bFallbackToSettings) override
@@ -151,12 +307,155 @@ public:
 			Env->DeleteLocalRef(PrimerConfig);
 		}
 	}
+
+private:
+	static jobject NewGlobalJavaMap(JNIEnv* Env, const FCleverTapProperties& Properties, jobject BaseMap)
+	{
+		jobject LocalMap = JNI::ConvertCleverTapPropertiesToJavaMap(Env, Properties, BaseMap);
+		if (!LocalMap)
+		{
+			return nullptr;
+		}
+		jobject GlobalMap = Env->NewGlobalRef(LocalMap);
+		Env->DeleteLocalRef(LocalMap);
+		return GlobalMap;
+	}
+
+	static void ReplaceGlobalRef(JNIEnv* Env, jobject& GlobalRef, jobject NewGlobalRef)
+	{
+		if (GlobalRef)
+		{
+			Env->DeleteGlobalRef(GlobalRef);
+		}
+		GlobalRef = NewGlobalRef;
+	}
+
+	/**
+	 * Converts the resolved global properties to a Java map if they changed since the last conversion. Must be called
+	 *  with EventContextLock held.
+	 */
+	void UpdateJavaEventContext(JNIEnv* Env, FCleverTapEventContextPtr&& Resolved)
+	{
+		if (ConvertedEventContext.Get() != Resolved.Get())
+		{
+			const bool bHasProperties = Resolved.IsValid() && Resolved->Num() > 0;
+			ReplaceGlobalRef(Env, JavaEventContext,
+				bHasProperties ? NewGlobalJavaMap(Env, Resolved->GetProperties(), nullptr) : nullptr);
+			ConvertedEventContext = MoveTemp(Resolved);
+		}
+	}
+
+	/**
+	 * Returns a new local reference to the Java map of the global properties, or nullptr if there are none.
+	 */
+	jobject NewEventContextRef(JNIEnv* Env)
+	{
+		FCleverTapEventContextPtr Resolved = GlobalProperties.Resolve();
+
+		FScopeLock Lock(&EventContextLock);
+		UpdateJavaEventContext(Env, MoveTemp(Resolved));
+		return JavaEventContext ? Env->NewLocalRef(JavaEventContext) : nullptr;
+	}
+
+	/**
+	 * Returns a new local reference to the Java map of a call context merged over the global properties. The map of
+	 *  the most recent call context is cached, so pushing events with the same context converts it only once.
+	 */
+	jobject NewCallContextRef(JNIEnv* Env, const FCleverTapEventContextRef& Context)
+	{
+		FCleverTapEventContextPtr Resolved = GlobalProperties.Resolve();
+
+		FScopeLock Lock(&EventContextLock);
+		UpdateJavaEventContext(Env, MoveTemp(Resolved));
+		if (CallContext.Get() != &Context.Get() || CallContextBase.Get() != ConvertedEventContext.Get())
+		{
+			CallContext = Context;
+			CallContextBase = ConvertedEventContext;
+			ReplaceGlobalRef(Env, JavaCallContext, NewGlobalJavaMap(Env, Context->GetProperties(), JavaEventContext));
+		}
+		return JavaCallContext ? Env->NewLocalRef(JavaCallContext) : nullptr;
+	}
+
+	/**
+	 * Pushes an event whose properties are merged over a context map. Takes ownership of the local JavaContext
+	 *  reference, which may be null.
+	 */
+	void PushEventWithContext(
+		JNIEnv* Env, const FString& EventName, const FCleverTapProperties& Actions, jobject JavaContext)
+	{
+		jobject JavaActions = JNI::ConvertCleverTapPropertiesToJavaMap(Env, Actions, JavaContext);
+		JNI::PushEvent(Env, JavaCleverTapInstance, EventName, JavaActions);
+		Env->DeleteLocalRef(JavaActions);
+		if (JavaContext)
+		{
+			Env->DeleteLocalRef(JavaContext);
+		}
+	}
+
+	void SendProfile(const FCleverTapProperties& Profile)
+	{
+		auto* Env = JNI::GetJNIEnv();
+		jobject JavaProfile = JNI::ConvertCleverTapPropertiesToJavaMap(Env, Profile);
+		JNI::PushProfile(Env, JavaCleverTapInstance, JavaProfile);
+		Env->DeleteLocalRef(JavaProfile);
+	}
+
+	void ResetProfileShadow(const FCleverTapProperties& LoginProfile)
+	{
+		if (ProfileShadow)
+		{
+			ProfileShadow->Reset(LoginProfile);
+		}
+	}
+
+	void InvalidateProfileField(const FString& Key)
+	{
+		if (ProfileShadow)
+		{
+			ProfileShadow->Invalidate(Key);
+		}
+	}
+
+	void BroadcastPushPermissionResponse()
+	{
+		check(IsInGameThread());
+		bPushPermissionBroadcastPending.store(false, std::memory_order_release);
+
+		const bool bGranted = PushPermissionState.load(std::memory_order_acquire) == EPushPermissionState::Granted;
+		UE_LOG(LogCleverTap, Log, TEXT("OnPushPermissionResponse(bGranted=%s)"),
+			bGranted ? TEXT("TRUE") : TEXT("FALSE"));
+		OnPushPermissionResponse.Broadcast(bGranted);
+	}
+
+	FCleverTapHandle Handle = InvalidCleverTapHandle;
+	TSharedRef<FCleverTapIdCache, ESPMode::ThreadSafe> IdCache;
+
+	// last pushed profile fields, only set when PushProfile() sends changed fields only
+	TUniquePtr<FCleverTapProfileShadow> ProfileShadow;
+
+	// event context, global properties and providers, resolved into a single context per change
+	FCleverTapGlobalProperties GlobalProperties;
+
+	// Java maps (global references) of the resolved global properties and of the most recent call context merged
+	//  over them, converted once per change
+	FCriticalSection EventContextLock;
+	FCleverTapEventContextPtr ConvertedEventContext;
+	jobject JavaEventContext = nullptr;
+	FCleverTapEventContextPtr CallContext;
+	FCleverTapEventContextPtr CallContextBase;
+	jobject JavaCallContext = nullptr;
+
+	// last known push permission state; answered from here by IsPushPermissionGrantedAsync()
+	std::atomic<EPushPermissionState> PushPermissionState{ EPushPermissionState::Unknown };
+	std::atomic<bool> bPushPermissionBroadcastPending{ false };
+	FDelegateHandle ForegroundHandle;
 };
 
-TSet<FAndroidCleverTapInstance*> FAndroidCleverTapInstance::Instances;
+FAndroidCleverTapInstance::FHandleTable FAndroidCleverTapInstance::Instances;
 
 void FPlatformSDK::SetLogLevel(ECleverTapLogLevel Level)
 {
+	CLEVERTAP_STARTUP_SCOPE("SetDebugLevel");
 	JNIEnv* Env = JNI::GetJNIEnv();
 	JNI::SetDebugLevel(Env, Level);
 
@@ -168,13 +467,20 @@ TUniquePtr<ICleverTapInstance> FPlatformSDK::InitializeSharedInstance(const FCle
 	FPlatformSDK::SetLogLevel(Config.LogLevel);
 
 	JNIEnv* Env = JNI::GetJNIEnv();
-	JNI::SetDefaultConfig(Env, Config);
-	jobject Instance = JNI::GetDefaultInstance(Env);
+	{
+		CLEVERTAP_STARTUP_SCOPE("SetDefaultConfig");
+		JNI::SetDefaultConfig(Env, Config);
+	}
+	jobject Instance = nullptr;
+	{
+		CLEVERTAP_STARTUP_SCOPE("GetDefaultInstance");
+		Instance = JNI::GetDefaultInstance(Env);
+	}
 	if (!Env || !Instance)
 	{
 		return nullptr;
 	}
-	return MakeUnique<FAndroidCleverTapInstance>(Env, Instance);
+	return MakeUnique<FAndroidCleverTapInstance>(Env, Instance, Config);
 }
 
 TUniquePtr<ICleverTapInstance> FPlatformSDK::InitializeSharedInstance(
@@ -183,13 +489,20 @@ TUniquePtr<ICleverTapInstance> FPlatformSDK::InitializeSharedInstance(
 	FPlatformSDK::SetLogLevel(Config.LogLevel);
 
 	JNIEnv* Env = JNI::GetJNIEnv();
-	JNI::SetDefaultConfig(Env, Config);
-	jobject Instance = JNI::GetDefaultInstance(Env, CleverTapId);
+	{
+		CLEVERTAP_STARTUP_SCOPE("SetDefaultConfig");
+		JNI::SetDefaultConfig(Env, Config);
+	}
+	jobject Instance = nullptr;
+	{
+		CLEVERTAP_STARTUP_SCOPE("GetDefaultInstance");
+		Instance = JNI::GetDefaultInstance(Env, CleverTapId);
+	}
 	if (!Env || !Instance)
 	{
 		return nullptr;
 	}
-	return MakeUnique<FAndroidCleverTapInstance>(Env, Instance);
+	return MakeUnique<FAndroidCleverTapInstance>(Env, Instance, Config);
 }
 
 }} // namespace CleverTapSDK::Android
@@ -199,21 +512,10 @@ TUniquePtr<ICleverTapInstance> FPlatformSDK::InitializeSharedInstance(
 //
 extern "C" JNIEXPORT void JNICALL
 Java_com_clevertap_android_unreal_UECleverTapListeners_00024PushPermissionListener_nativeOnPushPermissionResponse__JZ(
-	JNIEnv* Env, jclass Class, jlong NativeInstancePtr, jboolean bGranted)
+	JNIEnv* Env, jclass Class, jlong NativeHandle, jboolean bGranted)
 {
-	// the java callbacks can come from any thread; to keep things simple we queue all work to the main game thread
-	AsyncTask(ENamedThreads::GameThread, [NativeInstancePtr, bGranted]() {
-		UE_LOG(LogCleverTap, Log, TEXT("OnPushPermissionResponse(NativeInstance=%lx, bGranted=%s)"), NativeInstancePtr,
-			bGranted ? TEXT("TRUE") : TEXT("FALSE"));
-		using namespace CleverTapSDK::Android;
-		auto* Instance = reinterpret_cast<FAndroidCleverTapInstance*>(NativeInstancePtr);
-		if (FAndroidCleverTapInstance::IsValid(Instance))
-		{
-			Instance->OnPushPermissionResponse.Broadcast(bGranted);
-		}
-		else
-		{
-			UE_LOG(LogCleverTap, Error, TEXT("Invalid native instance!"));
-		}
-	});
+	// the java callbacks can come from any thread; the instance coalesces them into a single game thread broadcast
+	using namespace CleverTapSDK::Android;
+	FAndroidCleverTapInstance::HandlePushPermissionResponse(
+		static_cast<CleverTapSDK::FCleverTapHandle>(NativeHandle), bGranted == JNI_TRUE);
 }
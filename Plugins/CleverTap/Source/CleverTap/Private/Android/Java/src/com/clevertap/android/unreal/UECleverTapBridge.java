@@ -1,6 +1,8 @@
 package com.clevertap.android.unreal;
 
 import com.clevertap.android.sdk.inapp.CTLocalInApp;
+import java.util.ArrayList;
+import java.util.HashMap;
 import java.util.Map;
 import org.json.JSONObject;
 
@@ -41,4 +43,50 @@ public class UECleverTapBridge {
                 .build();
     }
 
+    // Builds the items of a charged event from columns of values, one primitive or String array per key, so the
+    // native side can pass each column in a single call instead of building every item through JNI
+    public static ArrayList<HashMap<String, Object>> buildChargedItems(int numItems, String[] keys, Object[] columns) {
+        ArrayList<HashMap<String, Object>> items = new ArrayList<>(numItems);
+        for (int item = 0; item < numItems; ++item) {
+            items.add(new HashMap<String, Object>(keys.length * 2));
+        }
+
+        for (int column = 0; column < keys.length; ++column) {
+            String key = keys[column];
+            Object values = columns[column];
+            if (values instanceof int[]) {
+                int[] ints = (int[]) values;
+                for (int item = 0; item < numItems; ++item) {
+                    items.get(item).put(key, ints[item]);
+                }
+            } else if (values instanceof long[]) {
+                long[] longs = (long[]) values;
+                for (int item = 0; item < numItems; ++item) {
+                    items.get(item).put(key, longs[item]);
+                }
+            } else if (values instanceof float[]) {
+                float[] floats = (float[]) values;
+                for (int item = 0; item < numItems; ++item) {
+                    items.get(item).put(key, floats[item]);
+                }
+            } else if (values instanceof double[]) {
+                double[] doubles = (double[]) values;
+                for (int item = 0; item < numItems; ++item) {
+                    items.get(item).put(key, doubles[item]);
+                }
+            } else if (values instanceof boolean[]) {
+                boolean[] booleans = (boolean[]) values;
+                for (int item = 0; item < numItems; ++item) {
+                    items.get(item).put(key, booleans[item]);
+                }
+            } else if (values instanceof Object[]) {
+                Object[] objects = (Object[]) values;
+                for (int item = 0; item < numItems; ++item) {
+                    items.get(item).put(key, objects[item]);
+                }
+            }
+        }
+        return items;
+    }
+
 }
@@ -4,21 +4,23 @@ import com.clevertap.android.sdk.PushPermissionResponseListener;
 import com.clevertap.android.sdk.CleverTapAPI;
 
 // Listener implementations that redirect the notifications to native methods implemented in C++ 
-// that dispatch the notifcations on the main unreal game thread
+// that dispatch the notifcations on the main unreal game thread.
+// Native instances are identified by generational handles, which the native side validates
+// before use, so a listener outliving its native instance is harmless.
 
 public class UECleverTapListeners {
     public static class PushPermissionListener implements PushPermissionResponseListener {
-        private final long nativeInstancePtr;
+        private final long nativeHandle;
 
-        public PushPermissionListener(long nativeInstancePtr) {
-            this.nativeInstancePtr = nativeInstancePtr;
+        public PushPermissionListener(long nativeHandle) {
+            this.nativeHandle = nativeHandle;
         }
 
         @Override
         public void onPushPermissionResponse(boolean granted) {
-            nativeOnPushPermissionResponse(nativeInstancePtr, granted);
+            nativeOnPushPermissionResponse(nativeHandle, granted);
         }
 
-        private static native void nativeOnPushPermissionResponse(long nativeInstancePtr, boolean granted);
+        private static native void nativeOnPushPermissionResponse(long nativeHandle, boolean granted);
     }
 }
@@ -0,0 +1,103 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapAllocationTracker.h"
+
+#include "HAL/PlatformTLS.h"
+
+#if !UE_BUILD_SHIPPING
+
+FCleverTapAllocationTracker& FCleverTapAllocationTracker::Get()
+{
+	static FCleverTapAllocationTracker* const Tracker = new FCleverTapAllocationTracker();
+	return *Tracker;
+}
+
+void FCleverTapAllocationTracker::Install()
+{
+	check(GMalloc != this);
+	Inner = GMalloc;
+	TrackedThreadId = FPlatformTLS::GetCurrentThreadId();
+	NumAllocations.store(0);
+	LiveBytes = 0;
+	GMalloc = this;
+}
+
+void FCleverTapAllocationTracker::Uninstall()
+{
+	check(GMalloc == this);
+	GMalloc = Inner;
+	TrackedThreadId = 0; // the inner allocator stays set for the threads still calling into the tracker
+}
+
+void* FCleverTapAllocationTracker::Malloc(SIZE_T Count, uint32 Alignment)
+{
+	void* const Result = Inner->Malloc(Count, Alignment);
+	if (IsTrackedThread())
+	{
+		NumAllocations.fetch_add(1, std::memory_order_relaxed);
+		TrackBytes(Result, 1);
+	}
+	return Result;
+}
+
+void* FCleverTapAllocationTracker::Realloc(void* Original, SIZE_T Count, uint32 Alignment)
+{
+	if (!IsTrackedThread())
+	{
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+	NumAllocations.fetch_add(1, std::memory_order_relaxed);
+	TrackBytes(Original, -1);
+	void* const Result = Inner->Realloc(Original, Count, Alignment);
+	TrackBytes(Result, 1);
+	return Result;
+}
+
+void FCleverTapAllocationTracker::Free(void* Original)
+{
+	if (IsTrackedThread())
+	{
+		TrackBytes(Original, -1);
+	}
+	Inner->Free(Original);
+}
+
+bool FCleverTapAllocationTracker::GetAllocationSize(void* Original, SIZE_T& SizeOut)
+{
+	return Inner->GetAllocationSize(Original, SizeOut);
+}
+
+SIZE_T FCleverTapAllocationTracker::QuantizeSize(SIZE_T Count, uint32 Alignment)
+{
+	return Inner->QuantizeSize(Count, Alignment);
+}
+
+void FCleverTapAllocationTracker::Trim(bool bTrimThreadCaches)
+{
+	Inner->Trim(bTrimThreadCaches);
+}
+
+bool FCleverTapAllocationTracker::IsInternallyThreadSafe() const
+{
+	return Inner->IsInternallyThreadSafe();
+}
+
+const TCHAR* FCleverTapAllocationTracker::GetDescriptiveName()
+{
+	return TEXT("CleverTapAllocationTracker");
+}
+
+bool FCleverTapAllocationTracker::IsTrackedThread() const
+{
+	return TrackedThreadId != 0 && FPlatformTLS::GetCurrentThreadId() == TrackedThreadId;
+}
+
+void FCleverTapAllocationTracker::TrackBytes(void* Pointer, int64 Sign)
+{
+	SIZE_T Size = 0;
+	if (Pointer && Inner->GetAllocationSize(Pointer, Size))
+	{
+		LiveBytes += Sign * int64(Size);
+	}
+}
+
+#endif // !UE_BUILD_SHIPPING
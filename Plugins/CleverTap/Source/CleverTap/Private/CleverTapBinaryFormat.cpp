@@ -0,0 +1,520 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapBinaryFormat.h"
+
+#include "CleverTapMemory.h"
+
+#include "Containers/StringConv.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "The binary format stores floating point values in native order");
+
+namespace {
+
+// "CTB" followed by the format version
+const uint8 Header[] = { 'C', 'T', 'B', 1 };
+
+// Strings store their length in bytes shifted left by one, with the low bit set if the bytes are UTF-8 with non-ASCII
+//  characters rather than plain ASCII
+constexpr uint64 Utf8StringFlag = 1;
+
+uint64 ZigZagEncode(int64 Value)
+{
+	return (uint64(Value) << 1) ^ uint64(Value >> 63);
+}
+
+int64 ZigZagDecode(uint64 Value)
+{
+	return int64(Value >> 1) ^ -int64(Value & 1);
+}
+
+class FBinaryWriter
+{
+public:
+	explicit FBinaryWriter(TArray<uint8>& InOutput) : Output(InOutput) {}
+
+	void WriteVarint(uint64 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Output.Add(uint8(Value | 0x80));
+			Value >>= 7;
+		}
+		Output.Add(uint8(Value));
+	}
+
+	void WriteRaw(const void* Data, int32 Length) { Output.Append(static_cast<const uint8*>(Data), Length); }
+
+	void WriteElement(int32 Value) { WriteVarint(ZigZagEncode(Value)); }
+	void WriteElement(int64 Value) { WriteVarint(ZigZagEncode(Value)); }
+	void WriteElement(float Value) { WriteRaw(&Value, sizeof(Value)); }
+	void WriteElement(double Value) { WriteRaw(&Value, sizeof(Value)); }
+	void WriteElement(bool Value) { Output.Add(uint8(Value ? 1 : 0)); }
+
+	void WriteElement(const FString& Value)
+	{
+		const int32 Length = Value.Len();
+		const TCHAR* const Chars = *Value;
+
+		bool bAscii = true;
+		for (int32 Index = 0; Index < Length && bAscii; ++Index)
+		{
+			bAscii = Chars[Index] < 0x80;
+		}
+
+		if (bAscii)
+		{
+			WriteVarint(uint64(Length) << 1);
+			const int32 Start = Output.AddUninitialized(Length);
+			for (int32 Index = 0; Index < Length; ++Index)
+			{
+				Output[Start + Index] = uint8(Chars[Index]);
+			}
+		}
+		else
+		{
+			const FTCHARToUTF8 Utf8(Chars, Length);
+			WriteVarint((uint64(Utf8.Length()) << 1) | Utf8StringFlag);
+			WriteRaw(Utf8.Get(), Utf8.Length());
+		}
+	}
+
+	void WriteElement(const FCleverTapDate& Value)
+	{
+		WriteVarint(ZigZagEncode(Value.Year));
+		WriteVarint(ZigZagEncode(Value.Month));
+		WriteVarint(ZigZagEncode(Value.Day));
+	}
+
+	template <typename T> void WriteElement(const TArray<T>& Value)
+	{
+		WriteVarint(Value.Num());
+		for (const T& Element : Value)
+		{
+			WriteElement(Element);
+		}
+	}
+
+	void WriteValue(const FCleverTapPropertyValue& Value)
+	{
+		Output.Add(uint8(Value.GetIndex()));
+		switch (Value.GetIndex())
+		{
+			case FCleverTapPropertyValue::IndexOfType<int32>():
+				WriteElement(Value.Get<int32>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<int64>():
+				WriteElement(Value.Get<int64>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<float>():
+				WriteElement(Value.Get<float>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<double>():
+				WriteElement(Value.Get<double>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<bool>():
+				WriteElement(Value.Get<bool>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<FString>():
+				WriteElement(Value.Get<FString>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<FCleverTapDate>():
+				WriteElement(Value.Get<FCleverTapDate>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+				WriteElement(Value.Get<TArray<int32>>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+				WriteElement(Value.Get<TArray<int64>>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+				WriteElement(Value.Get<TArray<float>>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+				WriteElement(Value.Get<TArray<double>>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+				WriteElement(Value.Get<TArray<bool>>());
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+				WriteElement(Value.Get<TArray<FString>>());
+				break;
+			default:
+				checkNoEntry();
+				break;
+		}
+	}
+
+	template <typename PropertiesType> void WriteProperties(const PropertiesType& Properties)
+	{
+		WriteRaw(Header, sizeof(Header));
+		WriteVarint(Properties.Num());
+		WritePairs(Properties);
+	}
+
+	template <typename PropertiesType> void WritePairs(const PropertiesType& Properties)
+	{
+		for (const auto& Pair : Properties)
+		{
+			WriteElement(Pair.Key);
+			WriteValue(Pair.Value);
+		}
+	}
+
+private:
+	TArray<uint8>& Output;
+};
+
+class FBinaryReader
+{
+public:
+	FBinaryReader(const uint8* InData, int32 InLength) : Data(InData), Cursor(InData), End(InData + InLength) {}
+
+	/**
+	 * Reads the header and the number of properties that follow it.
+	 */
+	bool ReadHeader(int32& OutCount)
+	{
+		if (End - Cursor < int32(sizeof(Header)) || FMemory::Memcmp(Cursor, Header, sizeof(Header)) != 0)
+		{
+			return Fail(TEXT("Unknown header or version"));
+		}
+		Cursor += sizeof(Header);
+
+		// each property takes at least three bytes: the key length, the type and the value
+		return ReadCount(OutCount, 3);
+	}
+
+	template <typename AddPropertyType> bool ReadProperties(AddPropertyType&& AddProperty)
+	{
+		int32 Count = 0;
+		if (!ReadHeader(Count))
+		{
+			return false;
+		}
+
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			FString Key;
+			FCleverTapPropertyValue Value;
+			if (!ReadElement(Key) || !ReadValue(Value))
+			{
+				return false;
+			}
+			AddProperty(MoveTemp(Key), MoveTemp(Value));
+		}
+
+		if (Cursor != End)
+		{
+			return Fail(TEXT("Unexpected data after the properties"));
+		}
+		return true;
+	}
+
+	const uint8* GetCursor() const { return Cursor; }
+
+	FString Error;
+
+private:
+	bool Fail(const TCHAR* Message)
+	{
+		if (Error.IsEmpty())
+		{
+			Error = FString::Printf(TEXT("%s at offset %d"), Message, int32(Cursor - Data));
+		}
+		return false;
+	}
+
+	bool ReadVarint(uint64& OutValue)
+	{
+		uint64 Value = 0;
+		for (int32 Shift = 0; Shift < 64 && Cursor < End; Shift += 7)
+		{
+			const uint8 Byte = *Cursor++;
+			Value |= uint64(Byte & 0x7f) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				OutValue = Value;
+				return true;
+			}
+		}
+		return Fail(TEXT("Invalid variable length integer"));
+	}
+
+	/**
+	 * Reads an element count, rejecting counts that can't possibly fit the remaining data so that corrupt data can't
+	 *  trigger huge allocations.
+	 */
+	bool ReadCount(int32& OutCount, int32 MinElementSize)
+	{
+		uint64 Count = 0;
+		if (!ReadVarint(Count))
+		{
+			return false;
+		}
+		if (Count > uint64(End - Cursor) / MinElementSize)
+		{
+			return Fail(TEXT("Count exceeds the remaining data"));
+		}
+		OutCount = int32(Count);
+		return true;
+	}
+
+	bool ReadRaw(void* OutData, int32 Length)
+	{
+		if (End - Cursor < Length)
+		{
+			return Fail(TEXT("Unexpected end of data"));
+		}
+		FMemory::Memcpy(OutData, Cursor, Length);
+		Cursor += Length;
+		return true;
+	}
+
+	bool ReadSigned(int64& OutValue, int64 MinValue, int64 MaxValue)
+	{
+		uint64 Encoded = 0;
+		if (!ReadVarint(Encoded))
+		{
+			return false;
+		}
+		OutValue = ZigZagDecode(Encoded);
+		if (OutValue < MinValue || OutValue > MaxValue)
+		{
+			return Fail(TEXT("Integer out of range"));
+		}
+		return true;
+	}
+
+	bool ReadElement(int32& OutValue)
+	{
+		int64 Value = 0;
+		const bool bSuccess = ReadSigned(Value, MIN_int32, MAX_int32);
+		OutValue = int32(Value);
+		return bSuccess;
+	}
+
+	bool ReadElement(int64& OutValue) { return ReadSigned(OutValue, MIN_int64, MAX_int64); }
+	bool ReadElement(float& OutValue) { return ReadRaw(&OutValue, sizeof(OutValue)); }
+	bool ReadElement(double& OutValue) { return ReadRaw(&OutValue, sizeof(OutValue)); }
+
+	bool ReadElement(bool& OutValue)
+	{
+		uint8 Byte = 0;
+		if (!ReadRaw(&Byte, 1))
+		{
+			return false;
+		}
+		if (Byte > 1)
+		{
+			return Fail(TEXT("Invalid boolean"));
+		}
+		OutValue = Byte != 0;
+		return true;
+	}
+
+	bool ReadElement(FString& OutValue)
+	{
+		uint64 Encoded = 0;
+		if (!ReadVarint(Encoded))
+		{
+			return false;
+		}
+
+		const uint64 Length = Encoded >> 1;
+		if (Length > uint64(End - Cursor))
+		{
+			return Fail(TEXT("String exceeds the remaining data"));
+		}
+
+		OutValue.Reset();
+		if ((Encoded & Utf8StringFlag) != 0)
+		{
+			const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Cursor), int32(Length));
+			OutValue = FString(Converted.Length(), Converted.Get());
+		}
+		else if (Length > 0)
+		{
+			TArray<TCHAR>& Chars = OutValue.GetCharArray();
+			Chars.SetNumUninitialized(int32(Length) + 1);
+			for (int32 Index = 0; Index < int32(Length); ++Index)
+			{
+				Chars[Index] = TCHAR(Cursor[Index]);
+			}
+			Chars[int32(Length)] = TEXT('\0');
+		}
+		Cursor += Length;
+		return true;
+	}
+
+	bool ReadElement(FCleverTapDate& OutValue)
+	{
+		int64 Year = 0;
+		int64 Month = 0;
+		int64 Day = 0;
+		if (!ReadSigned(Year, MIN_int32, MAX_int32) || !ReadSigned(Month, MIN_int32, MAX_int32)
+			|| !ReadSigned(Day, MIN_int32, MAX_int32))
+		{
+			return false;
+		}
+		OutValue.Year = int32(Year);
+		OutValue.Month = int32(Month);
+		OutValue.Day = int32(Day);
+		return true;
+	}
+
+	template <typename T> bool ReadElement(TArray<T>& OutValue)
+	{
+		// the smallest encoding of an element: raw floating point values take their full size, everything else a byte
+		int32 Count = 0;
+		if (!ReadCount(Count, TIsFloatingPoint<T>::Value ? sizeof(T) : 1))
+		{
+			return false;
+		}
+
+		OutValue.SetNum(Count);
+		for (T& Element : OutValue)
+		{
+			if (!ReadElement(Element))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <typename T> bool ReadValueOfType(FCleverTapPropertyValue& OutValue)
+	{
+		T Value;
+		if (!ReadElement(Value))
+		{
+			return false;
+		}
+		OutValue = FCleverTapPropertyValue(MoveTemp(Value));
+		return true;
+	}
+
+	bool ReadValue(FCleverTapPropertyValue& OutValue)
+	{
+		uint8 TypeIndex = 0;
+		if (!ReadRaw(&TypeIndex, 1))
+		{
+			return false;
+		}
+
+		switch (TypeIndex)
+		{
+			case FCleverTapPropertyValue::IndexOfType<int32>():
+				return ReadValueOfType<int32>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<int64>():
+				return ReadValueOfType<int64>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<float>():
+				return ReadValueOfType<float>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<double>():
+				return ReadValueOfType<double>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<bool>():
+				return ReadValueOfType<bool>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<FString>():
+				return ReadValueOfType<FString>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<FCleverTapDate>():
+				return ReadValueOfType<FCleverTapDate>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+				return ReadValueOfType<TArray<int32>>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+				return ReadValueOfType<TArray<int64>>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+				return ReadValueOfType<TArray<float>>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+				return ReadValueOfType<TArray<double>>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+				return ReadValueOfType<TArray<bool>>(OutValue);
+			case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+				return ReadValueOfType<TArray<FString>>(OutValue);
+			default:
+				--Cursor;
+				return Fail(TEXT("Unknown value type"));
+		}
+	}
+
+	const uint8* const Data;
+	const uint8* Cursor;
+	const uint8* const End;
+};
+
+template <typename AddPropertyType>
+bool ReadImpl(TArrayView<const uint8> Data, FString* OutError, AddPropertyType&& AddProperty)
+{
+	FBinaryReader Reader(Data.GetData(), Data.Num());
+	const bool bSuccess = Reader.ReadProperties(Forward<AddPropertyType>(AddProperty));
+	if (!bSuccess && OutError != nullptr)
+	{
+		*OutError = MoveTemp(Reader.Error);
+	}
+	return bSuccess;
+}
+
+} // namespace
+
+void FCleverTapBinaryFormat::Write(const FCleverTapProperties& Properties, TArray<uint8>& Output)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FBinaryWriter(Output).WriteProperties(Properties);
+}
+
+void FCleverTapBinaryFormat::Write(const FCleverTapPayload& Properties, TArray<uint8>& Output)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FBinaryWriter(Output).WriteProperties(Properties);
+}
+
+bool FCleverTapBinaryFormat::Read(TArrayView<const uint8> Data, FCleverTapProperties& OutProperties, FString* OutError)
+{
+	CLEVERTAP_LLM_SCOPE();
+	return ReadImpl(Data, OutError, [&OutProperties](FString&& Key, FCleverTapPropertyValue&& Value) {
+		OutProperties.Add(MoveTemp(Key), MoveTemp(Value));
+	});
+}
+
+bool FCleverTapBinaryFormat::Read(TArrayView<const uint8> Data, FCleverTapPayload& OutProperties, FString* OutError)
+{
+	CLEVERTAP_LLM_SCOPE();
+	return ReadImpl(Data, OutError, [&OutProperties](FString&& Key, FCleverTapPropertyValue&& Value) {
+		OutProperties.Emplace(MoveTemp(Key), MoveTemp(Value));
+	});
+}
+
+void FCleverTapBinaryFormat::WriteLayered(TArrayView<const uint8> Encoded,
+	TArrayView<const FCleverTapProperties* const> Overrides, TArray<uint8>& Output)
+{
+	CLEVERTAP_LLM_SCOPE();
+
+	// the encoded properties are copied as they are, only their count changes
+	int32 NumEncoded = 0;
+	TArrayView<const uint8> EncodedPairs;
+	if (Encoded.Num() > 0)
+	{
+		FBinaryReader Reader(Encoded.GetData(), Encoded.Num());
+		if (ensureMsgf(Reader.ReadHeader(NumEncoded), TEXT("%s"), *Reader.Error))
+		{
+			const int32 HeaderSize = int32(Reader.GetCursor() - Encoded.GetData());
+			EncodedPairs = Encoded.Slice(HeaderSize, Encoded.Num() - HeaderSize);
+		}
+		else
+		{
+			NumEncoded = 0;
+		}
+	}
+
+	int32 Count = NumEncoded;
+	for (const FCleverTapProperties* Properties : Overrides)
+	{
+		Count += Properties->Num();
+	}
+
+	FBinaryWriter Writer(Output);
+	Writer.WriteRaw(Header, sizeof(Header));
+	Writer.WriteVarint(Count);
+	Writer.WriteRaw(EncodedPairs.GetData(), EncodedPairs.Num());
+	for (const FCleverTapProperties* Properties : Overrides)
+	{
+		Writer.WritePairs(*Properties);
+	}
+}
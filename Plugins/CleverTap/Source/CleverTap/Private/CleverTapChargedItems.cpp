@@ -0,0 +1,87 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapChargedItems.h"
+
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+
+namespace {
+
+template <typename T>
+void AddColumnToRows(const FString& Key, const TArray<T>& Values, TArray<FCleverTapProperties>& Rows)
+{
+	for (int32 Index = 0; Index < Rows.Num(); ++Index)
+	{
+		Rows[Index].Add(Key, Values[Index]);
+	}
+}
+
+} // namespace
+
+FCleverTapChargedItems& FCleverTapChargedItems::AddColumnValues(
+	FString Key, int32 NumValues, FCleverTapPropertyValue&& Values)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const int32 ExistingIndex = Columns.IndexOfByPredicate(
+		[&Key](const TPair<FString, FCleverTapPropertyValue>& Column) { return Column.Key == Key; });
+
+	// the number of items is set by the first column, or by the one replacing it
+	const bool bSetsNumItems = Columns.Num() == 0 || (Columns.Num() == 1 && ExistingIndex == 0);
+	if (!bSetsNumItems && NumValues != NumItems)
+	{
+		UE_LOG(LogCleverTap, Error, TEXT("Charged item column '%s' has %d values, expected %d. Column ignored."), *Key,
+			NumValues, NumItems);
+		return *this;
+	}
+	NumItems = NumValues;
+
+	if (ExistingIndex != INDEX_NONE)
+	{
+		Columns[ExistingIndex].Value = MoveTemp(Values);
+	}
+	else
+	{
+		Columns.Emplace(MoveTemp(Key), MoveTemp(Values));
+	}
+	return *this;
+}
+
+TArray<FCleverTapProperties> FCleverTapChargedItems::ToRows() const
+{
+	CLEVERTAP_LLM_SCOPE();
+	TArray<FCleverTapProperties> Rows;
+	Rows.SetNum(NumItems);
+	for (FCleverTapProperties& Row : Rows)
+	{
+		Row.Reserve(Columns.Num());
+	}
+
+	for (const TPair<FString, FCleverTapPropertyValue>& Column : Columns)
+	{
+		const FCleverTapPropertyValue& Values = Column.Value;
+		switch (Values.GetIndex())
+		{
+			case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+				AddColumnToRows(Column.Key, Values.Get<TArray<int32>>(), Rows);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+				AddColumnToRows(Column.Key, Values.Get<TArray<int64>>(), Rows);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+				AddColumnToRows(Column.Key, Values.Get<TArray<float>>(), Rows);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+				AddColumnToRows(Column.Key, Values.Get<TArray<double>>(), Rows);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+				AddColumnToRows(Column.Key, Values.Get<TArray<bool>>(), Rows);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+				AddColumnToRows(Column.Key, Values.Get<TArray<FString>>(), Rows);
+				break;
+			default:
+				checkNoEntry(); // AddColumn() only accepts array types
+				break;
+		}
+	}
+	return Rows;
+}
@@ -0,0 +1,94 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapCompression.h"
+
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+#include "CleverTapStats.h"
+
+#include "Misc/Compression.h"
+
+#include <atomic>
+
+namespace CleverTapSDK {
+
+namespace {
+
+// totals since startup, for the overall compression ratio
+std::atomic<uint64> TotalInputBytes{ 0 };
+std::atomic<uint64> TotalOutputBytes{ 0 };
+
+FName GetFormatName(ECleverTapCompressionFormat Format)
+{
+	switch (Format)
+	{
+		case ECleverTapCompressionFormat::LZ4:
+			return NAME_LZ4;
+		case ECleverTapCompressionFormat::Zlib:
+			return NAME_Zlib;
+		default:
+			return NAME_None;
+	}
+}
+
+void RecordCompression(int32 InputBytes, int32 OutputBytes)
+{
+	INC_DWORD_STAT_BY(STAT_CleverTapCompressionInputBytes, InputBytes);
+	INC_DWORD_STAT_BY(STAT_CleverTapCompressionOutputBytes, OutputBytes);
+	const uint64 TotalInput = TotalInputBytes.fetch_add(InputBytes, std::memory_order_relaxed) + InputBytes;
+	const uint64 TotalOutput = TotalOutputBytes.fetch_add(OutputBytes, std::memory_order_relaxed) + OutputBytes;
+	SET_FLOAT_STAT(STAT_CleverTapCompressionRatio, TotalOutput > 0 ? float(double(TotalInput) / TotalOutput) : 0.0f);
+}
+
+} // namespace
+
+FCleverTapCompression::FCleverTapCompression(ECleverTapCompressionFormat InFormat, int32 InThresholdBytes)
+	: Format(InFormat), ThresholdBytes(FMath::Max(InThresholdBytes, 0))
+{
+}
+
+ECleverTapCompressionFormat FCleverTapCompression::Compress(
+	TArrayView<const uint8> Data, TArray<uint8>& OutCompressed) const
+{
+	if (Format == ECleverTapCompressionFormat::None || Data.Num() < ThresholdBytes || Data.Num() == 0)
+	{
+		return ECleverTapCompressionFormat::None;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CleverTapCompress);
+	CLEVERTAP_LLM_SCOPE();
+	const FName FormatName = GetFormatName(Format);
+	int32 CompressedBytes = FCompression::CompressMemoryBound(FormatName, Data.Num());
+	OutCompressed.SetNumUninitialized(CompressedBytes, /*bAllowShrinking=*/false);
+	if (!FCompression::CompressMemory(
+			FormatName, OutCompressed.GetData(), CompressedBytes, Data.GetData(), Data.Num(), COMPRESS_BiasSpeed))
+	{
+		UE_LOG(LogCleverTap, Verbose, TEXT("Compressing %d bytes with %s failed."), Data.Num(), *FormatName.ToString());
+		return ECleverTapCompressionFormat::None;
+	}
+
+	RecordCompression(Data.Num(), FMath::Min(CompressedBytes, Data.Num()));
+	if (CompressedBytes >= Data.Num())
+	{
+		return ECleverTapCompressionFormat::None; // incompressible, e.g. already compressed or random ids
+	}
+	OutCompressed.SetNum(CompressedBytes, /*bAllowShrinking=*/false);
+	return Format;
+}
+
+bool FCleverTapCompression::Decompress(ECleverTapCompressionFormat Format, TArrayView<const uint8> Data,
+	int32 UncompressedBytes, TArray<uint8>& OutData)
+{
+	const FName FormatName = GetFormatName(Format);
+	if (FormatName.IsNone() || UncompressedBytes < 0)
+	{
+		return false;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_CleverTapDecompress);
+	CLEVERTAP_LLM_SCOPE();
+	OutData.SetNumUninitialized(UncompressedBytes);
+	return FCompression::UncompressMemory(
+		FormatName, OutData.GetData(), UncompressedBytes, Data.GetData(), Data.Num());
+}
+
+} // namespace CleverTapSDK
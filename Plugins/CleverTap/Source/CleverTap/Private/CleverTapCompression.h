@@ -0,0 +1,43 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapCompressionFormat.h"
+
+#include "CoreMinimal.h"
+
+namespace CleverTapSDK {
+
+/**
+ * Compresses payloads of at least a threshold size with one of the engine's codecs. Payloads are kept as they are
+ *  when they are below the threshold or when compression doesn't make them smaller, so callers record the format
+ *  returned by Compress() with the data.
+ *
+ * The total input and output sizes and the time spent compressing and decompressing are reported by
+ *  "stat CleverTap".
+ */
+class FCleverTapCompression
+{
+public:
+	FCleverTapCompression() = default;
+	FCleverTapCompression(ECleverTapCompressionFormat InFormat, int32 InThresholdBytes);
+
+	/**
+	 * Compresses Data into OutCompressed. Returns the format used, or None if Data should be kept uncompressed.
+	 */
+	ECleverTapCompressionFormat Compress(TArrayView<const uint8> Data, TArray<uint8>& OutCompressed) const;
+
+	/**
+	 * Decompresses Data, which was compressed with Format, into OutData. Returns false if Data is corrupt.
+	 */
+	static bool Decompress(ECleverTapCompressionFormat Format, TArrayView<const uint8> Data, int32 UncompressedBytes,
+		TArray<uint8>& OutData);
+
+	ECleverTapCompressionFormat GetFormat() const { return Format; }
+	int32 GetThresholdBytes() const { return ThresholdBytes; }
+
+private:
+	ECleverTapCompressionFormat Format = ECleverTapCompressionFormat::None;
+	int32 ThresholdBytes = 0;
+};
+
+} // namespace CleverTapSDK
@@ -0,0 +1,141 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapEventBuilder.h"
+
+#include "CleverTapInstance.h"
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+
+#include "Algo/Sort.h"
+
+FCleverTapEventBuilder::FCleverTapEventBuilder(FString InEventName, int32 ExpectedNumProperties)
+	: EventName(MoveTemp(InEventName))
+{
+	CLEVERTAP_LLM_SCOPE();
+	Properties.Reserve(ExpectedNumProperties);
+}
+
+FCleverTapEventBuilder::FCleverTapEventBuilder(const FCleverTapEventSchema& InSchema, int32 ExpectedNumProperties)
+	: EventName(InSchema.GetEventName())
+{
+	CLEVERTAP_LLM_SCOPE();
+	Properties.Reserve(ExpectedNumProperties);
+	Validator.Emplace(InSchema);
+}
+
+FCleverTapEventBuilder& FCleverTapEventBuilder::Add(FString Key, FCleverTapPropertyValue Value)
+{
+	if (Validator.IsSet())
+	{
+		Validator->Add(Key, Value);
+	}
+	return Append(MoveTemp(Key), MoveTemp(Value));
+}
+
+FCleverTapEventBuilder& FCleverTapEventBuilder::Append(FString Key, FCleverTapPropertyValue Value)
+{
+	CLEVERTAP_LLM_SCOPE();
+	Properties.Emplace(MoveTemp(Key), MoveTemp(Value));
+	return *this;
+}
+
+FCleverTapEventBuilder& FCleverTapEventBuilder::Reserve(int32 NumProperties)
+{
+	Properties.Reserve(NumProperties);
+	return *this;
+}
+
+FCleverTapPayload FCleverTapEventBuilder::BuildPayload()
+{
+	CLEVERTAP_LLM_SCOPE();
+	RemoveDuplicateKeys();
+	if (Validator.IsSet())
+	{
+		Validator->Finish(Properties.Num());
+	}
+	return MoveTemp(Properties);
+}
+
+FCleverTapProperties FCleverTapEventBuilder::BuildProperties()
+{
+	CLEVERTAP_LLM_SCOPE();
+	FCleverTapProperties Result;
+	Result.Reserve(Properties.Num());
+	for (TPair<FString, FCleverTapPropertyValue>& Property : Properties)
+	{
+		// TMap::Add() overwrites duplicate keys, so the last value wins without a separate pass
+		Result.Add(MoveTemp(Property.Key), MoveTemp(Property.Value));
+	}
+	Properties.Reset();
+	if (Validator.IsSet())
+	{
+		Validator->Finish(Result.Num());
+	}
+	return Result;
+}
+
+void FCleverTapEventBuilder::Push(ICleverTapInstance& Instance)
+{
+	if (Properties.Num() == 0)
+	{
+		Instance.PushEvent(MoveTemp(EventName));
+	}
+	else
+	{
+		FCleverTapProperties Actions = BuildProperties();
+		Instance.PushEvent(MoveTemp(EventName), MoveTemp(Actions));
+	}
+}
+
+void FCleverTapEventBuilder::RemoveDuplicateKeys()
+{
+	const int32 NumProperties = Properties.Num();
+	if (NumProperties < 2)
+	{
+		return;
+	}
+
+	// Sort indices by key so that duplicates are adjacent, earlier additions first
+	TArray<int32, TInlineAllocator<32>> Order;
+	Order.SetNumUninitialized(NumProperties);
+	for (int32 Index = 0; Index < NumProperties; ++Index)
+	{
+		Order[Index] = Index;
+	}
+	Algo::Sort(Order, [this](int32 A, int32 B) {
+		const int32 Comparison = Properties[A].Key.Compare(Properties[B].Key, ESearchCase::IgnoreCase);
+		return Comparison != 0 ? Comparison < 0 : A < B;
+	});
+
+	TBitArray<> Superseded(false, NumProperties);
+	bool bAnySuperseded = false;
+	for (int32 SortedIndex = 1; SortedIndex < NumProperties; ++SortedIndex)
+	{
+		const int32 Previous = Order[SortedIndex - 1];
+		if (Properties[Previous].Key.Equals(Properties[Order[SortedIndex]].Key, ESearchCase::IgnoreCase))
+		{
+			UE_LOG(LogCleverTap, Verbose, TEXT("Event '%s' has duplicate property '%s'. The last value is used."),
+				*EventName, *Properties[Previous].Key);
+			Superseded[Previous] = true;
+			bAnySuperseded = true;
+		}
+	}
+	if (!bAnySuperseded)
+	{
+		return;
+	}
+
+	// Compact in place, keeping the insertion order of the remaining properties
+	int32 NumKept = 0;
+	for (int32 Index = 0; Index < NumProperties; ++Index)
+	{
+		if (!Superseded[Index])
+		{
+			if (NumKept != Index)
+			{
+				Properties[NumKept] = MoveTemp(Properties[Index]);
+			}
+			++NumKept;
+		}
+	}
+	Properties.SetNum(NumKept, /*bAllowShrinking=*/false);
+}
@@ -0,0 +1,47 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapEventContext.h"
+
+#include "CleverTapMemory.h"
+
+FCleverTapEventContext::FCleverTapEventContext(FCleverTapProperties&& InProperties)
+	: Properties(MoveTemp(InProperties))
+{
+}
+
+FCleverTapEventContextRef FCleverTapEventContext::Create(FCleverTapProperties Properties)
+{
+	CLEVERTAP_LLM_SCOPE();
+	return MakeShareable(new FCleverTapEventContext(MoveTemp(Properties)));
+}
+
+FCleverTapEventContextRef FCleverTapEventContext::With(const FString& Key, FCleverTapPropertyValue Value) const
+{
+	CLEVERTAP_LLM_SCOPE();
+	FCleverTapProperties NewProperties = Properties;
+	NewProperties.Add(Key, MoveTemp(Value));
+	return Create(MoveTemp(NewProperties));
+}
+
+FCleverTapEventContextRef FCleverTapEventContext::With(const FCleverTapProperties& Overrides) const
+{
+	CLEVERTAP_LLM_SCOPE();
+	return Create(MergeWith(Overrides));
+}
+
+FCleverTapEventContextRef FCleverTapEventContext::Without(const FString& Key) const
+{
+	CLEVERTAP_LLM_SCOPE();
+	FCleverTapProperties NewProperties = Properties;
+	NewProperties.Remove(Key);
+	return Create(MoveTemp(NewProperties));
+}
+
+FCleverTapProperties FCleverTapEventContext::MergeWith(const FCleverTapProperties& EventProperties) const
+{
+	CLEVERTAP_LLM_SCOPE();
+	FCleverTapProperties Merged;
+	Merged.Reserve(Properties.Num() + EventProperties.Num());
+	Merged.Append(Properties);
+	Merged.Append(EventProperties);
+	return Merged;
+}
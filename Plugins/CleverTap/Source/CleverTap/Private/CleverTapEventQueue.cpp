@@ -0,0 +1,232 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapEventQueue.h"
+
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+#include "CleverTapStats.h"
+
+#include "Misc/ScopeLock.h"
+
+namespace CleverTapSDK {
+
+FCleverTapEventQueue::FCleverTapEventQueue(int64 BudgetBytes, ECleverTapBufferOverflowPolicy InOverflowPolicy,
+	TUniquePtr<FCleverTapOfflineStore> InStore)
+	: Budget(BudgetBytes), OverflowPolicy(InOverflowPolicy), Store(MoveTemp(InStore))
+{
+	check(OverflowPolicy != ECleverTapBufferOverflowPolicy::SpillToDisk || Store.IsValid());
+}
+
+FCleverTapEventQueue::~FCleverTapEventQueue()
+{
+	FScopeLock ScopeLock(&Lock);
+	if (OverflowPolicy == ECleverTapBufferOverflowPolicy::SpillToDisk)
+	{
+		while (SpillOldest())
+		{
+		}
+		Store->Flush();
+	}
+	while (Head < Records.Num())
+	{
+		PopFront();
+	}
+}
+
+bool FCleverTapEventQueue::Enqueue(FCleverTapEventRecord&& Record)
+{
+	CLEVERTAP_LLM_SCOPE();
+
+	Record.Data.Shrink();
+	const int64 Size = Record.GetAllocatedSize();
+
+	FScopeLock ScopeLock(&Lock);
+	bool bFits = Budget.TryReserve(Size);
+	if (!bFits && OverflowPolicy == ECleverTapBufferOverflowPolicy::SpillToDisk)
+	{
+		while (!bFits && SpillOldest())
+		{
+			bFits = Budget.TryReserve(Size);
+		}
+		if (!bFits)
+		{
+			return Store->Append(Record); // larger than the whole budget; it is still the newest record
+		}
+	}
+	if (!bFits && OverflowPolicy == ECleverTapBufferOverflowPolicy::DropOldest && Budget.CanFit(Size))
+	{
+		// priority records are dropped last, and only to make room for another priority record; they are rare, so
+		//  skipping over them rarely removes records from the middle of the array
+		int32 NumPriorityKept = 0;
+		while (!bFits)
+		{
+			while (Head + NumPriorityKept < Records.Num() && Records[Head + NumPriorityKept].HasPriority())
+			{
+				++NumPriorityKept;
+			}
+			if (Head + NumPriorityKept < Records.Num())
+			{
+				DropRecord(Head + NumPriorityKept);
+			}
+			else if (Record.HasPriority() && NumPriorityKept > 0)
+			{
+				DropRecord(Head);
+				--NumPriorityKept;
+			}
+			else
+			{
+				break;
+			}
+			bFits = Budget.TryReserve(Size);
+		}
+	}
+
+	if (!bFits)
+	{
+		++NumDropped;
+		INC_DWORD_STAT(STAT_CleverTapDroppedEvents);
+		UE_LOG(LogCleverTap, Verbose, TEXT("Buffer budget of %lld bytes exceeded. '%s' dropped."),
+			Budget.GetLimitBytes(), *Record.Name);
+		return false;
+	}
+
+	Records.Add(MoveTemp(Record));
+	INC_DWORD_STAT(STAT_CleverTapBufferedEvents);
+	return true;
+}
+
+void FCleverTapEventQueue::EnqueueFront(TArray<FCleverTapEventRecord>&& InRecords)
+{
+	CLEVERTAP_LLM_SCOPE();
+
+	FScopeLock ScopeLock(&Lock);
+	for (const FCleverTapEventRecord& Record : InRecords)
+	{
+		Budget.Reserve(Record.GetAllocatedSize());
+	}
+
+	// the consumed prefix usually has room for them, as they were dequeued from it
+	const int32 NumRecords = InRecords.Num();
+	if (Head >= NumRecords)
+	{
+		Head -= NumRecords;
+		for (int32 Index = 0; Index < NumRecords; ++Index)
+		{
+			Records[Head + Index] = MoveTemp(InRecords[Index]);
+		}
+	}
+	else
+	{
+		Records.Insert(MoveTemp(InRecords), Head);
+	}
+	INC_DWORD_STAT_BY(STAT_CleverTapBufferedEvents, NumRecords);
+}
+
+int32 FCleverTapEventQueue::Dequeue(int32 MaxRecords, TArray<FCleverTapEventRecord>& OutRecords)
+{
+	FScopeLock ScopeLock(&Lock);
+	int32 NumStored = 0;
+	const int32 NumDequeued = DequeueLocked(MaxRecords, OutRecords, NumStored);
+	if (NumStored > 0)
+	{
+		Store->Acknowledge(NumStored);
+	}
+	return NumDequeued;
+}
+
+int32 FCleverTapEventQueue::DequeueUnacknowledged(
+	int32 MaxRecords, TArray<FCleverTapEventRecord>& OutRecords, int32& OutNumStored)
+{
+	FScopeLock ScopeLock(&Lock);
+	return DequeueLocked(MaxRecords, OutRecords, OutNumStored);
+}
+
+void FCleverTapEventQueue::Acknowledge(int32 NumStored)
+{
+	if (NumStored > 0)
+	{
+		FScopeLock ScopeLock(&Lock);
+		Store->Acknowledge(NumStored);
+	}
+}
+
+int32 FCleverTapEventQueue::DequeueLocked(
+	int32 MaxRecords, TArray<FCleverTapEventRecord>& OutRecords, int32& OutNumStored)
+{
+	OutNumStored = 0;
+	if (Store)
+	{
+		FCleverTapEventRecord Record;
+		while (OutNumStored < MaxRecords && Store->Pop(Record))
+		{
+			OutRecords.Add(MoveTemp(Record));
+			++OutNumStored;
+		}
+	}
+
+	const int32 NumFromMemory = FMath::Min(MaxRecords - OutNumStored, Records.Num() - Head);
+	OutRecords.Reserve(OutRecords.Num() + NumFromMemory);
+	for (int32 Index = 0; Index < NumFromMemory; ++Index)
+	{
+		OutRecords.Add(PopFront());
+	}
+	if (OutNumStored + NumFromMemory > 0)
+	{
+		NumDequeues.fetch_add(1, std::memory_order_relaxed);
+	}
+	return OutNumStored + NumFromMemory;
+}
+
+int32 FCleverTapEventQueue::Num() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Records.Num() - Head + (Store ? Store->Num() : 0);
+}
+
+int64 FCleverTapEventQueue::GetNumDropped() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return NumDropped + (Store ? Store->GetNumEvicted() : 0);
+}
+
+bool FCleverTapEventQueue::SpillOldest()
+{
+	if (Head == Records.Num())
+	{
+		return false;
+	}
+	Store->Append(PopFront());
+	return true;
+}
+
+void FCleverTapEventQueue::DropRecord(int32 Index)
+{
+	if (Index == Head)
+	{
+		PopFront();
+	}
+	else
+	{
+		Budget.Release(Records[Index].GetAllocatedSize());
+		Records.RemoveAt(Index, 1, /*bAllowShrinking=*/false);
+		DEC_DWORD_STAT(STAT_CleverTapBufferedEvents);
+	}
+	++NumDropped;
+	INC_DWORD_STAT(STAT_CleverTapDroppedEvents);
+}
+
+FCleverTapEventRecord FCleverTapEventQueue::PopFront()
+{
+	Budget.Release(Records[Head].GetAllocatedSize());
+	FCleverTapEventRecord Record = MoveTemp(Records[Head]);
+	++Head;
+	DEC_DWORD_STAT(STAT_CleverTapBufferedEvents);
+
+	if (Head * 2 >= Records.Num())
+	{
+		Records.RemoveAt(0, Head, /*bAllowShrinking=*/false);
+		Head = 0;
+	}
+	return Record;
+}
+
+} // namespace CleverTapSDK
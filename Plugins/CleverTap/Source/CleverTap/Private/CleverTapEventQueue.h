@@ -0,0 +1,98 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapBufferPolicy.h"
+#include "CleverTapEventRecord.h"
+#include "CleverTapMemoryBudget.h"
+#include "CleverTapOfflineStore.h"
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+namespace CleverTapSDK {
+
+/**
+ * A FIFO of event records bounded by a byte budget. Safe to use from any thread.
+ *
+ * With the SpillToDisk policy the oldest records move to an offline store once the budget is used up, and the records
+ *  still in memory are moved there when the queue is destroyed, so they are picked up by the next session. Records in
+ *  the store are always older than those in memory, so they are dequeued first.
+ *
+ * Records dequeued with DequeueUnacknowledged() stay in the store until Acknowledge() confirms them, so those in
+ *  flight when the app crashes or shuts down are dequeued again by the next session.
+ */
+class FCleverTapEventQueue
+{
+public:
+	/**
+	 * \param InStore - where records spill to with the SpillToDisk policy. Required for that policy, unused otherwise.
+	 */
+	FCleverTapEventQueue(int64 BudgetBytes, ECleverTapBufferOverflowPolicy InOverflowPolicy,
+		TUniquePtr<FCleverTapOfflineStore> InStore = nullptr);
+	~FCleverTapEventQueue();
+
+	/**
+	 * Adds a record, applying the overflow policy if it doesn't fit in the budget. Returns false if the record itself
+	 *  was dropped. DropOldest drops the oldest records without priority first (see
+	 *  FCleverTapEventRecord::HasPriority()) and keeps priority records unless the new record has priority too.
+	 */
+	bool Enqueue(FCleverTapEventRecord&& Record);
+
+	/**
+	 * Puts records that were dequeued but not delivered back ahead of the records in memory, keeping their order.
+	 *  They were accounted before they were dequeued, so they are kept even if they exceed the budget; the overflow
+	 *  policy applies to the records enqueued after them. Records in the offline store are still dequeued first.
+	 */
+	void EnqueueFront(TArray<FCleverTapEventRecord>&& InRecords);
+
+	/**
+	 * Removes up to MaxRecords of the oldest records and appends them to OutRecords. Returns the number removed.
+	 */
+	int32 Dequeue(int32 MaxRecords, TArray<FCleverTapEventRecord>& OutRecords);
+
+	/**
+	 * Like Dequeue(), but records taken from the offline store stay there until they are acknowledged. Those records
+	 *  come first in OutRecords; OutNumStored is set to their number.
+	 */
+	int32 DequeueUnacknowledged(int32 MaxRecords, TArray<FCleverTapEventRecord>& OutRecords, int32& OutNumStored);
+
+	/**
+	 * Acknowledges the oldest NumStored records taken from the offline store by DequeueUnacknowledged() and not
+	 *  acknowledged yet. Batches of records must be acknowledged in the order they were dequeued.
+	 */
+	void Acknowledge(int32 NumStored);
+
+	/**
+	 * The number of queued records, in memory and on disk.
+	 */
+	int32 Num() const;
+	int64 GetNumDropped() const;
+
+	/**
+	 * The number of dequeues that took records, i.e. of batches taken by the uploader. Lock-free.
+	 */
+	uint64 GetNumDequeues() const { return NumDequeues.load(std::memory_order_relaxed); }
+
+	const FCleverTapMemoryBudget& GetBudget() const { return Budget; }
+
+private:
+	int32 DequeueLocked(int32 MaxRecords, TArray<FCleverTapEventRecord>& OutRecords, int32& OutNumStored);
+	FCleverTapEventRecord PopFront();
+	void DropRecord(int32 Index);
+	bool SpillOldest();
+
+	mutable FCriticalSection Lock;
+	FCleverTapMemoryBudget Budget;
+	const ECleverTapBufferOverflowPolicy OverflowPolicy;
+	TUniquePtr<FCleverTapOfflineStore> Store;
+
+	// records from Head onwards are queued; the consumed prefix is trimmed once it makes up half the array
+	TArray<FCleverTapEventRecord> Records;
+	int32 Head = 0;
+	int64 NumDropped = 0;
+	std::atomic<uint64> NumDequeues{ 0 };
+};
+
+} // namespace CleverTapSDK
@@ -0,0 +1,85 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapEventRecord.h"
+
+#include "CleverTapBinaryFormat.h"
+#include "CleverTapMemory.h"
+
+#include "Misc/DateTime.h"
+
+namespace CleverTapSDK {
+
+FCleverTapEventRecord FCleverTapEventRecord::Make(ECleverTapEventRecordType Type, FString Name)
+{
+	FCleverTapEventRecord Record;
+	Record.Type = Type;
+	const FDateTime Now = FDateTime::UtcNow();
+	Record.TimestampMilliseconds = Now.ToUnixTimestamp() * 1000 + Now.GetMillisecond();
+	Record.Name = MoveTemp(Name);
+	return Record;
+}
+
+void FCleverTapEventRecord::AppendProperties(const FCleverTapProperties& Properties)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const int32 PrefixOffset = BeginPropertySet();
+	FCleverTapBinaryFormat::Write(Properties, Data);
+	EndPropertySet(PrefixOffset);
+}
+
+void FCleverTapEventRecord::AppendProperties(const FCleverTapPayload& Properties)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const int32 PrefixOffset = BeginPropertySet();
+	FCleverTapBinaryFormat::Write(Properties, Data);
+	EndPropertySet(PrefixOffset);
+}
+
+void FCleverTapEventRecord::AppendProperties(
+	TArrayView<const uint8> Encoded, TArrayView<const FCleverTapProperties* const> Overrides)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const int32 PrefixOffset = BeginPropertySet();
+	FCleverTapBinaryFormat::WriteLayered(Encoded, Overrides, Data);
+	EndPropertySet(PrefixOffset);
+}
+
+int32 FCleverTapEventRecord::BeginPropertySet()
+{
+	// reserve the size prefix, to be patched with the encoded size once the set is written
+	return Data.AddUninitialized(sizeof(uint32));
+}
+
+void FCleverTapEventRecord::EndPropertySet(int32 PrefixOffset)
+{
+	const uint32 Size = uint32(Data.Num() - PrefixOffset - sizeof(uint32));
+	FMemory::Memcpy(Data.GetData() + PrefixOffset, &Size, sizeof(Size));
+}
+
+bool FCleverTapEventRecord::ReadProperties(TArray<FCleverTapProperties>& OutPropertySets) const
+{
+	int32 Offset = 0;
+	while (Offset < Data.Num())
+	{
+		uint32 Size = 0;
+		if (Data.Num() - Offset < int32(sizeof(Size)))
+		{
+			return false;
+		}
+		FMemory::Memcpy(&Size, Data.GetData() + Offset, sizeof(Size));
+		Offset += sizeof(Size);
+		if (uint32(Data.Num() - Offset) < Size)
+		{
+			return false;
+		}
+
+		if (!FCleverTapBinaryFormat::Read(
+				TArrayView<const uint8>(Data.GetData() + Offset, Size), OutPropertySets.AddDefaulted_GetRef()))
+		{
+			return false;
+		}
+		Offset += Size;
+	}
+	return true;
+}
+
+} // namespace CleverTapSDK
@@ -0,0 +1,75 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+
+namespace CleverTapSDK {
+
+enum class ECleverTapEventRecordType : uint8
+{
+	Event,
+	ChargedEvent,
+	ProfilePush,
+	UserLogin,
+	ProfileIncrement,
+	ChargedEventColumns,
+};
+
+/**
+ * An event or profile update as buffered by the generic backend.
+ *
+ * The properties are kept in FCleverTapBinaryFormat rather than as property maps, which makes a record a handful of
+ *  flat allocations whose size is known up front. Data holds one or more encoded property sets, each prefixed with its
+ *  size: the event properties, charge details or profile, followed by the items of a charged event. The items of a
+ *  ChargedEventColumns record are a single set of FCleverTapChargedItems columns, one array value per key.
+ */
+struct FCleverTapEventRecord
+{
+	ECleverTapEventRecordType Type = ECleverTapEventRecordType::Event;
+	int64 TimestampMilliseconds = 0;
+	FString Name; // the event name, or the profile key of an increment
+	TArray<uint8> Data;
+
+	static FCleverTapEventRecord Make(ECleverTapEventRecordType Type, FString Name);
+
+	/**
+	 * Appends an encoded property set to Data.
+	 */
+	void AppendProperties(const FCleverTapProperties& Properties);
+	void AppendProperties(const FCleverTapPayload& Properties);
+
+	/**
+	 * Appends a property set of already encoded properties overridden by Overrides, without decoding the encoded
+	 *  ones; see FCleverTapBinaryFormat::WriteLayered().
+	 */
+	void AppendProperties(TArrayView<const uint8> Encoded, TArrayView<const FCleverTapProperties* const> Overrides);
+
+	/**
+	 * Decodes the property sets in Data. Returns false if the data is corrupt.
+	 */
+	bool ReadProperties(TArray<FCleverTapProperties>& OutPropertySets) const;
+
+	/**
+	 * Priority records are dropped last when buffers overflow. Charged events carry revenue, so they have priority.
+	 */
+	bool HasPriority() const { return IsCharged(); }
+
+	bool IsCharged() const
+	{
+		return Type == ECleverTapEventRecordType::ChargedEvent
+			|| Type == ECleverTapEventRecordType::ChargedEventColumns;
+	}
+
+	/**
+	 * The bytes the record holds, as accounted against the buffer budget.
+	 */
+	int64 GetAllocatedSize() const { return sizeof(*this) + Name.GetAllocatedSize() + Data.GetAllocatedSize(); }
+
+private:
+	int32 BeginPropertySet();
+	void EndPropertySet(int32 PrefixOffset);
+};
+
+} // namespace CleverTapSDK
@@ -0,0 +1,288 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapEventSchema.h"
+
+#include "CleverTapLog.h"
+
+namespace {
+
+using namespace CleverTapSDK;
+
+int32 GetArrayLength(const FCleverTapPropertyValue& Value)
+{
+	switch (Value.GetIndex())
+	{
+		case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+			return Value.Get<TArray<int32>>().Num();
+		case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+			return Value.Get<TArray<int64>>().Num();
+		case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+			return Value.Get<TArray<float>>().Num();
+		case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+			return Value.Get<TArray<double>>().Num();
+		case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+			return Value.Get<TArray<bool>>().Num();
+		case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+			return Value.Get<TArray<FString>>().Num();
+		default:
+			return 0;
+	}
+}
+
+bool IsValueWithinLimits(const FString& EventName, const TCHAR* Key, const FCleverTapPropertyValue& Value)
+{
+	if (const FString* String = Value.TryGet<FString>())
+	{
+		if (String->Len() > Limits::MaxStringValueLength)
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("Event '%s': value of '%s' is %d characters long, the limit is %d"),
+				*EventName, Key, String->Len(), Limits::MaxStringValueLength);
+			return false;
+		}
+	}
+	else if (const TArray<FString>* Strings = Value.TryGet<TArray<FString>>())
+	{
+		for (const FString& Item : *Strings)
+		{
+			if (Item.Len() > Limits::MaxStringValueLength)
+			{
+				UE_LOG(LogCleverTap, Warning,
+					TEXT("Event '%s': an item of '%s' is %d characters long, the limit is %d"), *EventName, Key,
+					Item.Len(), Limits::MaxStringValueLength);
+				return false;
+			}
+		}
+	}
+
+	const int32 ArrayLength = GetArrayLength(Value);
+	if (ArrayLength > Limits::MaxArrayLength)
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("Event '%s': '%s' has %d items, the limit is %d"), *EventName, Key,
+			ArrayLength, Limits::MaxArrayLength);
+		return false;
+	}
+	return true;
+}
+
+bool IsKeyWithinLimits(const FString& EventName, const FString& Key)
+{
+	if (Key.IsEmpty() || Key.Len() > Limits::MaxKeyLength)
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("Event '%s': key '%s' must be 1 to %d characters long"), *EventName, *Key,
+			Limits::MaxKeyLength);
+		return false;
+	}
+	return true;
+}
+
+bool IsEventWithinLimits(const FString& EventName, int32 NumProperties)
+{
+	bool bValid = true;
+	if (EventName.IsEmpty() || EventName.Len() > Limits::MaxEventNameLength)
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("Event name '%s' must be 1 to %d characters long"), *EventName,
+			Limits::MaxEventNameLength);
+		bValid = false;
+	}
+	if (NumProperties > Limits::MaxPropertiesPerEvent)
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("Event '%s' has %d properties, the limit is %d"), *EventName, NumProperties,
+			Limits::MaxPropertiesPerEvent);
+		bValid = false;
+	}
+	return bValid;
+}
+
+template <typename PropertiesType>
+bool ValidateLimitsImpl(const FString& EventName, const PropertiesType& Properties)
+{
+	bool bValid = IsEventWithinLimits(EventName, Properties.Num());
+	for (const auto& Property : Properties)
+	{
+		bValid &= IsKeyWithinLimits(EventName, Property.Key);
+		bValid &= IsValueWithinLimits(EventName, *Property.Key, Property.Value);
+	}
+	return bValid;
+}
+
+} // namespace
+
+FCleverTapEventSchema::FCleverTapEventSchema(FString InEventName) : EventName(MoveTemp(InEventName))
+{
+	IsEventWithinLimits(EventName, 0);
+}
+
+FCleverTapEventSchema& FCleverTapEventSchema::Key(FString Name, uint16 TypeMask, ECleverTapSchemaKeyPresence Presence)
+{
+	AddRule(MoveTemp(Name), TypeMask, Presence);
+	return *this;
+}
+
+int32 FCleverTapEventSchema::AddRule(FString Name, uint16 TypeMask, ECleverTapSchemaKeyPresence Presence)
+{
+	check(!RuleIndices.Contains(Name));
+	check(TypeMask != 0);
+	IsKeyWithinLimits(EventName, Name);
+
+	FKeyRule Rule{ Name, TypeMask, int16(INDEX_NONE) };
+	if (Presence == ECleverTapSchemaKeyPresence::Required)
+	{
+		Rule.RequiredIndex = int16(NumRequiredKeys++);
+	}
+	const int32 RuleIndex = Rules.Add(MoveTemp(Rule));
+	RuleIndices.Add(MoveTemp(Name), RuleIndex);
+	return RuleIndex;
+}
+
+int32 FCleverTapEventSchema::FindTypedRule(const TCHAR* Name, int32 Length) const
+{
+	if (const int32* RuleIndex = TypedRuleIndices.Find(Name))
+	{
+		return *RuleIndex;
+	}
+	const int32* RuleIndex = RuleIndices.Find(FString(Length, Name));
+	return RuleIndex ? *RuleIndex : INDEX_NONE;
+}
+
+FCleverTapEventSchema& FCleverTapEventSchema::AllowUnknownKeys(bool bAllow)
+{
+	bAllowUnknownKeys = bAllow;
+	return *this;
+}
+
+bool FCleverTapEventSchema::Validate(const FCleverTapProperties& Properties) const
+{
+	return ValidateImpl(Properties);
+}
+
+bool FCleverTapEventSchema::Validate(const FCleverTapPayload& Properties) const
+{
+	return ValidateImpl(Properties);
+}
+
+bool FCleverTapEventSchema::ValidateLimits(const FString& EventName, const FCleverTapProperties& Properties)
+{
+	return ValidateLimitsImpl(EventName, Properties);
+}
+
+bool FCleverTapEventSchema::ValidateLimits(const FString& EventName, const FCleverTapPayload& Properties)
+{
+	return ValidateLimitsImpl(EventName, Properties);
+}
+
+template <typename PropertiesType> bool FCleverTapEventSchema::ValidateImpl(const PropertiesType& Properties) const
+{
+	bool bValid = IsEventWithinLimits(EventName, Properties.Num());
+
+	TBitArray<> SeenRequiredKeys(false, NumRequiredKeys);
+	for (const auto& Property : Properties)
+	{
+		const int32* RuleIndex = RuleIndices.Find(Property.Key);
+		const FKeyRule* Rule = RuleIndex ? &Rules[*RuleIndex] : nullptr;
+		if (Rule == nullptr)
+		{
+			if (!bAllowUnknownKeys)
+			{
+				UE_LOG(LogCleverTap, Warning, TEXT("Event '%s': '%s' is not part of the event schema"), *EventName,
+					*Property.Key);
+				bValid = false;
+			}
+			else
+			{
+				bValid &= IsKeyWithinLimits(EventName, Property.Key);
+			}
+		}
+		else
+		{
+			if ((Rule->TypeMask & (1u << Property.Value.GetIndex())) == 0)
+			{
+				UE_LOG(LogCleverTap, Warning, TEXT("Event '%s': '%s' has a value of a type not allowed by the schema"),
+					*EventName, *Property.Key);
+				bValid = false;
+			}
+			if (Rule->RequiredIndex != INDEX_NONE)
+			{
+				SeenRequiredKeys[Rule->RequiredIndex] = true;
+			}
+		}
+		bValid &= IsValueWithinLimits(EventName, *Property.Key, Property.Value);
+	}
+
+	if (NumRequiredKeys > 0 && SeenRequiredKeys.Find(false) != INDEX_NONE)
+	{
+		for (const FKeyRule& Rule : Rules)
+		{
+			if (Rule.RequiredIndex != INDEX_NONE && !SeenRequiredKeys[Rule.RequiredIndex])
+			{
+				UE_LOG(LogCleverTap, Warning, TEXT("Event '%s' is missing the required property '%s'"), *EventName,
+					*Rule.Name);
+				bValid = false;
+			}
+		}
+	}
+	return bValid;
+}
+
+FCleverTapEventSchema::FValidator::FValidator(const FCleverTapEventSchema& InSchema)
+	: Schema(InSchema), SeenRequiredKeys(false, InSchema.NumRequiredKeys)
+{
+}
+
+void FCleverTapEventSchema::FValidator::Add(const FString& Key, const FCleverTapPropertyValue& Value)
+{
+	const int32* RuleIndex = Schema.RuleIndices.Find(Key);
+	if (RuleIndex == nullptr && Schema.bAllowUnknownKeys)
+	{
+		bValid &= IsKeyWithinLimits(Schema.EventName, Key);
+	}
+	AddToRule(RuleIndex ? *RuleIndex : INDEX_NONE, *Key, Value);
+}
+
+void FCleverTapEventSchema::FValidator::AddToRule(
+	int32 RuleIndex, const TCHAR* Key, const FCleverTapPropertyValue& Value)
+{
+	if (RuleIndex == INDEX_NONE)
+	{
+		if (!Schema.bAllowUnknownKeys)
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("Event '%s': '%s' is not part of the event schema"), *Schema.EventName,
+				Key);
+			bValid = false;
+		}
+	}
+	else
+	{
+		const FKeyRule& Rule = Schema.Rules[RuleIndex];
+		if ((Rule.TypeMask & (1u << Value.GetIndex())) == 0)
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("Event '%s': '%s' has a value of a type not allowed by the schema"),
+				*Schema.EventName, Key);
+			bValid = false;
+		}
+		if (Rule.RequiredIndex != INDEX_NONE)
+		{
+			SeenRequiredKeys[Rule.RequiredIndex] = true;
+		}
+	}
+	bValid &= IsValueWithinLimits(Schema.EventName, Key, Value);
+}
+
+bool FCleverTapEventSchema::FValidator::Finish(int32 NumProperties)
+{
+	bool bFinishedValid = bValid && IsEventWithinLimits(Schema.EventName, NumProperties);
+	if (Schema.NumRequiredKeys > 0 && SeenRequiredKeys.Find(false) != INDEX_NONE)
+	{
+		for (const FKeyRule& Rule : Schema.Rules)
+		{
+			if (Rule.RequiredIndex != INDEX_NONE && !SeenRequiredKeys[Rule.RequiredIndex])
+			{
+				UE_LOG(LogCleverTap, Warning, TEXT("Event '%s' is missing the required property '%s'"),
+					*Schema.EventName, *Rule.Name);
+				bFinishedValid = false;
+			}
+		}
+	}
+
+	SeenRequiredKeys.Init(false, Schema.NumRequiredKeys);
+	bValid = true;
+	return bFinishedValid;
+}
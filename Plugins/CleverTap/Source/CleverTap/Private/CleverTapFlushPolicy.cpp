@@ -0,0 +1,135 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapFlushPolicy.h"
+
+namespace CleverTapSDK {
+
+namespace {
+
+// weight of the latest upload in the moving averages and the fit
+constexpr double SmoothingFactor = 0.25;
+
+// batches are sized so that the round trip takes at most this share of an upload
+constexpr double MaxRttShare = 0.25;
+
+// events wait at most this many round trips before they are sent
+constexpr double IntervalRoundTrips = 10.0;
+
+// every ProbeInterval-th batch is sent at half the size, or double near the smallest size
+constexpr int64 ProbeInterval = 4;
+
+// the fit is only used when the standard deviation of the upload sizes is at least this share of their mean;
+//  otherwise the round trip time is kept and only the time per byte is updated
+constexpr double MinRelativeBytesDeviation = 0.1;
+
+// the transfer is assumed to take at least this share of the round trip, which bounds the bandwidth estimated from
+//  uploads that took no longer than a round trip
+constexpr double MinTransferRoundTrips = 0.1;
+
+} // namespace
+
+FCleverTapFlushPolicy::FCleverTapFlushPolicy(const FSettings& InSettings) : Settings(InSettings)
+{
+	check(Settings.MinBatchEvents > 0 && Settings.MinBatchEvents <= Settings.MaxBatchEvents);
+	check(Settings.MinIntervalSeconds <= Settings.MaxIntervalSeconds);
+}
+
+bool FCleverTapFlushPolicy::ShouldFlush(double NowSeconds, int32 NumQueuedEvents) const
+{
+	if (NumQueuedEvents == 0 || IsSuspended(NowSeconds))
+	{
+		return false;
+	}
+	return NumQueuedEvents >= GetBatchSize() || NowSeconds - LastFlushSeconds >= GetIntervalSeconds();
+}
+
+int32 FCleverTapFlushPolicy::GetBatchSize() const
+{
+	const int32 Target = GetTargetBatchSize();
+	if (BytesPerEvent <= 0.0 || NumFlushes % ProbeInterval != ProbeInterval - 1)
+	{
+		return Target;
+	}
+	return Target / 2 >= Settings.MinBatchEvents ? Target / 2 : FMath::Min(Target * 2, Settings.MaxBatchEvents);
+}
+
+int32 FCleverTapFlushPolicy::GetTargetBatchSize() const
+{
+	if (BytesPerEvent <= 0.0 || SecondsPerByte <= 0.0)
+	{
+		return Settings.MinBatchEvents;
+	}
+	const double TransferSeconds = RttSeconds * (1.0 - MaxRttShare) / MaxRttShare;
+	const double TargetEvents = FMath::Clamp(TransferSeconds / SecondsPerByte / BytesPerEvent,
+		double(Settings.MinBatchEvents), double(Settings.MaxBatchEvents));
+	return FMath::RoundToInt(TargetEvents);
+}
+
+double FCleverTapFlushPolicy::GetIntervalSeconds() const
+{
+	return FMath::Clamp(RttSeconds * IntervalRoundTrips, Settings.MinIntervalSeconds, Settings.MaxIntervalSeconds);
+}
+
+void FCleverTapFlushPolicy::OnUploadSucceeded(double DurationSeconds, int64 Bytes, int32 NumEvents)
+{
+	NumConsecutiveFailures = 0;
+	SuspendedUntilSeconds = 0.0;
+	if (Bytes <= 0)
+	{
+		return;
+	}
+
+	DurationSeconds = FMath::Max(DurationSeconds, 0.001);
+	const double Size = double(Bytes);
+	constexpr double Decay = 1.0 - SmoothingFactor;
+	SumWeights = Decay * SumWeights + 1.0;
+	SumBytes = Decay * SumBytes + Size;
+	SumSeconds = Decay * SumSeconds + DurationSeconds;
+	SumBytesSquared = Decay * SumBytesSquared + Size * Size;
+	SumBytesSeconds = Decay * SumBytesSeconds + Size * DurationSeconds;
+
+	if (NumRecentDurations == RecentDurationsCapacity)
+	{
+		FMemory::Memmove(RecentDurations, RecentDurations + 1, sizeof(double) * (RecentDurationsCapacity - 1));
+		--NumRecentDurations;
+	}
+	RecentDurations[NumRecentDurations++] = DurationSeconds;
+	double MinDurationSeconds = DurationSeconds;
+	for (int32 Index = 0; Index < NumRecentDurations; ++Index)
+	{
+		MinDurationSeconds = FMath::Min(MinDurationSeconds, RecentDurations[Index]);
+	}
+
+	const double MeanBytes = SumBytes / SumWeights;
+	const double MeanSeconds = SumSeconds / SumWeights;
+	const double BytesVariance = SumBytesSquared / SumWeights - MeanBytes * MeanBytes;
+	const double Covariance = SumBytesSeconds / SumWeights - MeanBytes * MeanSeconds;
+	if (BytesVariance > FMath::Square(MinRelativeBytesDeviation * MeanBytes) && Covariance > 0.0)
+	{
+		SecondsPerByte = Covariance / BytesVariance;
+		RttSeconds = FMath::Clamp(MeanSeconds - SecondsPerByte * MeanBytes, 0.0, MinDurationSeconds);
+	}
+	else
+	{
+		// the sizes are too alike to tell the round trip from the transfer; until the first fit the shortest upload
+		//  stands in for the round trip
+		RttSeconds = SecondsPerByte > 0.0 ? FMath::Min(RttSeconds, MinDurationSeconds) : MinDurationSeconds;
+		SecondsPerByte = FMath::Max(MeanSeconds - RttSeconds, MinTransferRoundTrips * RttSeconds) / MeanBytes;
+	}
+
+	if (NumEvents > 0)
+	{
+		const double Sample = Size / NumEvents;
+		BytesPerEvent = BytesPerEvent > 0.0 ? BytesPerEvent + SmoothingFactor * (Sample - BytesPerEvent) : Sample;
+	}
+}
+
+void FCleverTapFlushPolicy::OnUploadFailed(double NowSeconds, double RetryAfterSeconds)
+{
+	++NumConsecutiveFailures;
+	const double BackoffSeconds = FMath::Min(
+		Settings.InitialBackoffSeconds * double(uint64(1) << FMath::Min(NumConsecutiveFailures - 1, 30)),
+		Settings.MaxBackoffSeconds);
+	SuspendedUntilSeconds = NowSeconds + FMath::Max(BackoffSeconds, RetryAfterSeconds);
+}
+
+} // namespace CleverTapSDK
@@ -0,0 +1,123 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace CleverTapSDK {
+
+/**
+ * Decides when the uploader sends a batch and how many events it holds, based on the round trip time and bandwidth
+ *  measured by previous uploads.
+ *
+ * An upload takes a round trip plus the time to transfer its body at the link's bandwidth. The two are told apart by a
+ *  least squares fit of upload durations against their sizes: the intercept is the round trip time and the slope the
+ *  time per byte. Every fourth batch is sent at half or double the size, so the sizes keep varying enough for the fit
+ *  when the batch size has settled.
+ *
+ * Batches are sized from the bandwidth-delay product so the round trip takes at most a quarter of an upload: batches
+ *  grow with a higher latency or a higher bandwidth, where a round trip costs the transfer of more events, and shrink
+ *  on a lower bandwidth. Sizing by event count alone would go wrong on a slow link: a large batch there takes long
+ *  enough to risk the request timeout, is sent again in full when it fails, and holds back the events queued behind
+ *  it. On a fast link the same batch transfers in a fraction of the round trip, so growing it costs no time. Events
+ *  wait at most ten round trips before they are sent, which keeps the round trips to at most a tenth of the time
+ *  between uploads. Until the first upload completes the smallest batch and interval are used.
+ *
+ * While the endpoint reports errors uploads are suspended with exponential backoff, or for as long as the endpoint
+ *  asks when it throttles.
+ *
+ * The policy reads no clock; all times are passed in, so it behaves deterministically for a given sequence of calls.
+ */
+class FCleverTapFlushPolicy
+{
+public:
+	struct FSettings
+	{
+		int32 MinBatchEvents = 10;
+		int32 MaxBatchEvents = 500;
+		double MinIntervalSeconds = 1.0;
+		double MaxIntervalSeconds = 60.0;
+		double InitialBackoffSeconds = 2.0;
+		double MaxBackoffSeconds = 300.0;
+	};
+
+	explicit FCleverTapFlushPolicy(const FSettings& InSettings);
+
+	/**
+	 * Whether a batch should be sent now: a full batch is queued, or the interval has passed since the previous one.
+	 */
+	bool ShouldFlush(double NowSeconds, int32 NumQueuedEvents) const;
+
+	/**
+	 * Whether uploads are suspended after errors.
+	 */
+	bool IsSuspended(double NowSeconds) const { return NowSeconds < SuspendedUntilSeconds; }
+
+	/**
+	 * The number of events to send in the next batch.
+	 */
+	int32 GetBatchSize() const;
+
+	/**
+	 * The longest time events wait before they are sent.
+	 */
+	double GetIntervalSeconds() const;
+
+	/**
+	 * Records that a batch was sent.
+	 */
+	void OnFlush(double NowSeconds)
+	{
+		LastFlushSeconds = NowSeconds;
+		++NumFlushes;
+	}
+
+	/**
+	 * Records a successful upload of Bytes holding NumEvents that took DurationSeconds from send to response.
+	 */
+	void OnUploadSucceeded(double DurationSeconds, int64 Bytes, int32 NumEvents);
+
+	/**
+	 * Records a failed upload and suspends uploads. RetryAfterSeconds is the delay the endpoint asked for, if any.
+	 */
+	void OnUploadFailed(double NowSeconds, double RetryAfterSeconds = 0.0);
+
+	/**
+	 * The estimated round trip time and bandwidth; zero until the first upload completes.
+	 */
+	double GetRttSeconds() const { return RttSeconds; }
+	double GetBandwidthBytesPerSecond() const { return SecondsPerByte > 0.0 ? 1.0 / SecondsPerByte : 0.0; }
+
+	int32 GetNumConsecutiveFailures() const { return NumConsecutiveFailures; }
+
+private:
+	static constexpr int32 RecentDurationsCapacity = 16;
+
+	/**
+	 * The batch size the estimates call for, before probing.
+	 */
+	int32 GetTargetBatchSize() const;
+
+	const FSettings Settings;
+
+	// exponentially weighted sums over previous uploads for the fit of duration against bytes
+	double SumWeights = 0.0;
+	double SumBytes = 0.0;
+	double SumSeconds = 0.0;
+	double SumBytesSquared = 0.0;
+	double SumBytesSeconds = 0.0;
+
+	// the round trip can't take longer than the shortest recent upload
+	double RecentDurations[RecentDurationsCapacity] = {};
+	int32 NumRecentDurations = 0;
+
+	double RttSeconds = 0.0;
+	double SecondsPerByte = 0.0;
+	double BytesPerEvent = 0.0; // moving average
+
+	int64 NumFlushes = 0;
+	double LastFlushSeconds = 0.0;
+	double SuspendedUntilSeconds = 0.0;
+	int32 NumConsecutiveFailures = 0;
+};
+
+} // namespace CleverTapSDK
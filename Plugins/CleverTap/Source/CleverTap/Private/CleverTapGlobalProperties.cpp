@@ -0,0 +1,168 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapGlobalProperties.h"
+
+#include "CleverTapBinaryFormat.h"
+#include "CleverTapMemory.h"
+
+#include "CoreGlobals.h"
+#include "Misc/ScopeLock.h"
+
+namespace CleverTapSDK {
+
+void FCleverTapGlobalProperties::SetEventContext(FCleverTapEventContextPtr Context)
+{
+	FScopeLock ScopeLock(&Lock);
+	EventContext = MoveTemp(Context);
+	bResolvedIsStale = true;
+}
+
+FCleverTapEventContextPtr FCleverTapGlobalProperties::GetEventContext() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return EventContext;
+}
+
+void FCleverTapGlobalProperties::SetProperty(const FString& Key, FCleverTapPropertyValue Value)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FScopeLock ScopeLock(&Lock);
+	Properties.Add(Key, MoveTemp(Value));
+	bResolvedIsStale = true;
+}
+
+void FCleverTapGlobalProperties::RemoveProperty(const FString& Key)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (Properties.Remove(Key) > 0)
+	{
+		bResolvedIsStale = true;
+	}
+}
+
+FDelegateHandle FCleverTapGlobalProperties::AddProvider(FCleverTapGlobalPropertyProvider Provider)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FScopeLock ScopeLock(&Lock);
+	const FDelegateHandle Handle(FDelegateHandle::GenerateNewHandle);
+	Providers.Add(FProvider{ Handle, MoveTemp(Provider) });
+	EvaluatedEpoch = MAX_uint64; // evaluate the new provider with the next event
+	return Handle;
+}
+
+void FCleverTapGlobalProperties::RemoveProvider(FDelegateHandle Handle)
+{
+	FScopeLock ScopeLock(&Lock);
+	const int32 NumRemoved =
+		Providers.RemoveAll([&Handle](const FProvider& Provider) { return Provider.Handle == Handle; });
+	if (NumRemoved > 0)
+	{
+		EvaluatedEpoch = MAX_uint64;
+		++NumEvaluations; // discards the values of evaluations still running the removed provider
+		if (Providers.Num() == 0)
+		{
+			ProviderValues.Reset();
+			EncodedProviderValues.Reset();
+			bResolvedIsStale = true;
+		}
+	}
+}
+
+FCleverTapEventContextPtr FCleverTapGlobalProperties::Resolve()
+{
+	return Resolve(GFrameCounter);
+}
+
+FCleverTapEventContextPtr FCleverTapGlobalProperties::Resolve(uint64 Epoch)
+{
+	CLEVERTAP_LLM_SCOPE();
+	TArray<FCleverTapGlobalPropertyProvider> ProvidersToEvaluate;
+	uint64 Evaluation = 0;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (Providers.Num() > 0 && EvaluatedEpoch != Epoch)
+		{
+			EvaluatedEpoch = Epoch;
+			Evaluation = ++NumEvaluations;
+			ProvidersToEvaluate.Reserve(Providers.Num());
+			for (const FProvider& Provider : Providers)
+			{
+				ProvidersToEvaluate.Add(Provider.Function);
+			}
+		}
+	}
+
+	// providers may call back into the instance, so they're evaluated without holding the lock
+	FCleverTapPayload NewProviderValues;
+	TArray<uint8> NewEncodedProviderValues;
+	for (const FCleverTapGlobalPropertyProvider& Provider : ProvidersToEvaluate)
+	{
+		Provider(NewProviderValues);
+	}
+	if (ProvidersToEvaluate.Num() > 0)
+	{
+		FCleverTapBinaryFormat::Write(NewProviderValues, NewEncodedProviderValues);
+	}
+
+	FScopeLock ScopeLock(&Lock);
+
+	// an evaluation that another thread started later, or whose providers were removed meanwhile, is outdated
+	if (Evaluation != 0 && Evaluation == NumEvaluations && NewEncodedProviderValues != EncodedProviderValues)
+	{
+		ProviderValues = MoveTemp(NewProviderValues);
+		EncodedProviderValues = MoveTemp(NewEncodedProviderValues);
+		bResolvedIsStale = true;
+	}
+
+	if (bResolvedIsStale)
+	{
+		bResolvedIsStale = false;
+		if (Properties.Num() == 0 && ProviderValues.Num() == 0)
+		{
+			Resolved = EventContext; // nothing to merge, share the attached context as is
+		}
+		else
+		{
+			FCleverTapProperties Merged;
+			if (EventContext.IsValid())
+			{
+				Merged = EventContext->GetProperties();
+			}
+			Merged.Append(Properties);
+			for (const TPair<FString, FCleverTapPropertyValue>& Pair : ProviderValues)
+			{
+				Merged.Add(Pair.Key, Pair.Value); // later providers override earlier ones
+			}
+			Resolved = FCleverTapEventContext::Create(MoveTemp(Merged));
+		}
+	}
+
+	// copied while the lock is held, as another thread may replace the cached context as soon as it's released
+	FCleverTapEventContextPtr Result = Resolved;
+	return Result;
+}
+
+TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> FCleverTapGlobalProperties::ResolveEncoded(uint64 Epoch)
+{
+	const FCleverTapEventContextPtr Context = Resolve(Epoch);
+
+	FScopeLock ScopeLock(&Lock);
+	if (Context != EncodedContext)
+	{
+		EncodedContext = Context;
+		Encoded.Reset();
+		if (Context.IsValid())
+		{
+			CLEVERTAP_LLM_SCOPE();
+			const TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> NewEncoded =
+				MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+			FCleverTapBinaryFormat::Write(Context->GetProperties(), *NewEncoded);
+			Encoded = NewEncoded;
+		}
+	}
+
+	// copied while the lock is held, as with the resolved context
+	TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Result = Encoded;
+	return Result;
+}
+
+} // namespace CleverTapSDK
@@ -0,0 +1,77 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapEventContext.h"
+#include "CleverTapInstance.h"
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+namespace CleverTapSDK {
+
+/**
+ * The properties an instance adds to every event: the attached event context, global properties and the values of
+ *  global property providers.
+ *
+ * All sources are folded into a single immutable FCleverTapEventContext that platforms convert to their native form
+ *  whenever it changes. Precedence from lowest to highest is: event context, global properties, providers; the
+ *  properties of the event itself override all of them. Providers are evaluated at most once per epoch, and a new
+ *  context is only built when their values differ from the previous evaluation, so platforms can tell that nothing
+ *  changed by comparing context pointers. The epoch is the frame for platforms that hand every event to their SDK
+ *  right away, and the upload batch for the generic instance, so the events of one batch share provider values.
+ */
+class FCleverTapGlobalProperties
+{
+public:
+	void SetEventContext(FCleverTapEventContextPtr Context);
+	FCleverTapEventContextPtr GetEventContext() const;
+
+	void SetProperty(const FString& Key, FCleverTapPropertyValue Value);
+	void RemoveProperty(const FString& Key);
+
+	FDelegateHandle AddProvider(FCleverTapGlobalPropertyProvider Provider);
+	void RemoveProvider(FDelegateHandle Handle);
+
+	/**
+	 * Returns the merged properties of all sources, or nullptr if there are none. Evaluates the providers if they have
+	 *  not been evaluated in this epoch, by default the current frame. Safe to call from any thread; providers are
+	 *  called without holding the lock, so they may call back into the instance.
+	 */
+	FCleverTapEventContextPtr Resolve();
+	FCleverTapEventContextPtr Resolve(uint64 Epoch);
+
+	/**
+	 * Like Resolve(), but returns the merged properties in FCleverTapBinaryFormat. They are only encoded again when
+	 *  the resolved context changes, so events can append them to their records as they are.
+	 */
+	TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> ResolveEncoded(uint64 Epoch);
+
+private:
+	struct FProvider
+	{
+		FDelegateHandle Handle;
+		FCleverTapGlobalPropertyProvider Function;
+	};
+
+	// guards all members below, including the cached Resolved context
+	mutable FCriticalSection Lock;
+
+	FCleverTapEventContextPtr EventContext;
+	FCleverTapProperties Properties;
+	TArray<FProvider> Providers;
+
+	// provider values of the last evaluation, in the binary property encoding so they can be compared cheaply
+	FCleverTapPayload ProviderValues;
+	TArray<uint8> EncodedProviderValues;
+	uint64 EvaluatedEpoch = MAX_uint64;
+	uint64 NumEvaluations = 0;
+
+	FCleverTapEventContextPtr Resolved;
+	bool bResolvedIsStale = false;
+
+	// the binary encoding of EncodedContext, the resolved context it was last built for
+	FCleverTapEventContextPtr EncodedContext;
+	TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Encoded;
+};
+
+} // namespace CleverTapSDK
@@ -0,0 +1,219 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+namespace CleverTapSDK {
+
+/**
+ * Opaque handle to an object registered in a TCleverTapHandleTable. Handles are safe to pass through the platform
+ *  bridges in place of raw pointers: a handle to a destroyed object never resolves, even when its slot has been reused.
+ */
+using FCleverTapHandle = uint64;
+
+/**
+ * The handle value that never refers to an object.
+ */
+constexpr FCleverTapHandle InvalidCleverTapHandle = 0;
+
+/**
+ * A fixed size table of generational handles.
+ *
+ * Each slot packs a generation counter and a pin count into a single atomic word. A handle records the slot index and
+ *  the generation at registration time, so validating it is a single load and compare. Unregistering bumps the
+ *  generation, which invalidates all outstanding handles to the slot, and then waits for in-flight pins to be released
+ *  before the slot can be reused.
+ *
+ * Pin() and Resolve() are lock-free. Register() and Unregister() take a lock as they are expected to be rare.
+ */
+template <typename T, uint32 Capacity>
+class TCleverTapHandleTable
+{
+public:
+	/**
+	 * Keeps the object of a pinned handle alive until it goes out of scope.
+	 */
+	class FPinned
+	{
+	public:
+		FPinned(FPinned&& Other) : Table(Other.Table), Index(Other.Index), Object(Other.Object)
+		{
+			Other.Object = nullptr;
+		}
+		~FPinned()
+		{
+			if (Object)
+			{
+				Table.Slots[Index].State.fetch_sub(1, std::memory_order_release);
+			}
+		}
+
+		T* Get() const { return Object; }
+		T* operator->() const { return Object; }
+		explicit operator bool() const { return Object != nullptr; }
+
+	private:
+		friend class TCleverTapHandleTable;
+		FPinned(TCleverTapHandleTable& InTable, uint32 InIndex, T* InObject)
+			: Table(InTable), Index(InIndex), Object(InObject)
+		{
+		}
+
+		TCleverTapHandleTable& Table;
+		uint32 Index;
+		T* Object;
+	};
+
+	TCleverTapHandleTable()
+	{
+		FreeIndices.Reserve(Capacity);
+		for (uint32 Index = Capacity; Index > 0; --Index)
+		{
+			FreeIndices.Add(Index - 1);
+		}
+	}
+
+	/**
+	 * Registers an object and returns its handle, or InvalidCleverTapHandle if the table is full.
+	 */
+	FCleverTapHandle Register(T* Object)
+	{
+		check(Object != nullptr);
+		FScopeLock Lock(&FreeIndicesLock);
+		if (FreeIndices.Num() == 0)
+		{
+			return InvalidCleverTapHandle;
+		}
+
+		const uint32 Index = FreeIndices.Pop(/*bAllowShrinking=*/false);
+		FSlot& Slot = Slots[Index];
+		Slot.Object.store(Object, std::memory_order_relaxed);
+
+		// odd generations are live, even generations are free; the release store publishes the object pointer
+		const uint64 State = Slot.State.load(std::memory_order_relaxed) + GenerationIncrement;
+		Slot.State.store(State, std::memory_order_release);
+		return MakeHandle(Index, GetGeneration(State));
+	}
+
+	/**
+	 * Invalidates the handle and waits for any pins of it to be released. Afterwards the object is no longer reachable
+	 *  through the table and can safely be destroyed.
+	 */
+	void Unregister(FCleverTapHandle Handle)
+	{
+		if (!IsWellFormed(Handle))
+		{
+			return;
+		}
+		const uint32 Index = GetIndex(Handle);
+
+		FSlot& Slot = Slots[Index];
+		uint64 State = Slot.State.load(std::memory_order_acquire);
+		do
+		{
+			if (GetGeneration(State) != GetGeneration(Handle))
+			{
+				return; // stale handle
+			}
+		} while (!Slot.State.compare_exchange_weak(State, State + GenerationIncrement, std::memory_order_acq_rel));
+
+		// pins are short, so yield first and only back off to sleeping if a pin is held across a slow call
+		for (int32 Attempt = 0; GetPinCount(Slot.State.load(std::memory_order_acquire)) != 0; ++Attempt)
+		{
+			if (Attempt < UnregisterYieldAttempts)
+			{
+				FPlatformProcess::Yield();
+			}
+			else
+			{
+				FPlatformProcess::SleepNoStats(UnregisterSleepSeconds);
+			}
+		}
+		Slot.Object.store(nullptr, std::memory_order_relaxed);
+
+		FScopeLock Lock(&FreeIndicesLock);
+		FreeIndices.Add(Index);
+	}
+
+	/**
+	 * Pins the object of a handle so it can't be unregistered while in use. Can be called from any thread. The result
+	 *  is empty if the handle is stale or invalid.
+	 */
+	FPinned Pin(FCleverTapHandle Handle)
+	{
+		if (!IsWellFormed(Handle))
+		{
+			return FPinned(*this, 0, nullptr);
+		}
+		const uint32 Index = GetIndex(Handle);
+
+		FSlot& Slot = Slots[Index];
+		uint64 State = Slot.State.load(std::memory_order_acquire);
+		do
+		{
+			if (GetGeneration(State) != GetGeneration(Handle))
+			{
+				return FPinned(*this, Index, nullptr);
+			}
+		} while (!Slot.State.compare_exchange_weak(State, State + 1, std::memory_order_acq_rel));
+
+		return FPinned(*this, Index, Slot.Object.load(std::memory_order_relaxed));
+	}
+
+	/**
+	 * Returns the object of a handle, or nullptr if the handle is stale or invalid. Without a pin the result is only
+	 *  safe to use on the thread that unregisters objects.
+	 */
+	T* Resolve(FCleverTapHandle Handle) const
+	{
+		if (!IsWellFormed(Handle))
+		{
+			return nullptr;
+		}
+
+		const FSlot& Slot = Slots[GetIndex(Handle)];
+		if (GetGeneration(Slot.State.load(std::memory_order_acquire)) != GetGeneration(Handle))
+		{
+			return nullptr;
+		}
+		return Slot.Object.load(std::memory_order_relaxed);
+	}
+
+private:
+	// Slot state layout: the upper 32 bits hold the generation, the lower 32 bits the pin count
+	static constexpr uint64 GenerationIncrement = uint64(1) << 32;
+
+	static constexpr int32 UnregisterYieldAttempts = 64;
+	static constexpr float UnregisterSleepSeconds = 0.0001f;
+
+	static uint32 GetGeneration(uint64 StateOrHandle) { return uint32(StateOrHandle >> 32); }
+	static uint32 GetPinCount(uint64 State) { return uint32(State); }
+	static uint32 GetIndex(FCleverTapHandle Handle) { return uint32(Handle); }
+	static FCleverTapHandle MakeHandle(uint32 Index, uint32 Generation)
+	{
+		return (FCleverTapHandle(Generation) << 32) | Index;
+	}
+
+	// Handles always carry the odd generation of a live slot, which also rules out InvalidCleverTapHandle
+	static bool IsWellFormed(FCleverTapHandle Handle)
+	{
+		return GetIndex(Handle) < Capacity && (GetGeneration(Handle) & 1) != 0;
+	}
+
+	struct FSlot
+	{
+		std::atomic<uint64> State{ 0 };
+		std::atomic<T*> Object{ nullptr };
+	};
+
+	FSlot Slots[Capacity];
+
+	FCriticalSection FreeIndicesLock;
+	TArray<uint32> FreeIndices;
+};
+
+} // namespace CleverTapSDK
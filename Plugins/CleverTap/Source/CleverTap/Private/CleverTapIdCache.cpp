@@ -0,0 +1,136 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapIdCache.h"
+
+#include "CleverTapMemory.h"
+
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "HAL/PlatformTime.h"
+
+namespace CleverTapSDK {
+
+namespace {
+
+// Platform SDKs switch profiles asynchronously after a login, so the previous id may still be reported for a while.
+// An unchanged id is only trusted again once this much time has passed since the invalidation.
+constexpr double IdSettleSeconds = 5.0;
+
+// How often the pending id is polled after an invalidation
+constexpr float PendingResolveIntervalSeconds = 0.25f;
+
+} // namespace
+
+FCleverTapIdCache::FCleverTapIdCache(FFetchId InFetchId, FOnIdChanged InOnIdChanged)
+	: FetchId(MoveTemp(InFetchId)), OnIdChanged(MoveTemp(InOnIdChanged))
+{
+}
+
+FCleverTapIdCache::~FCleverTapIdCache()
+{
+	if (PendingResolveHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(PendingResolveHandle);
+	}
+}
+
+FString FCleverTapIdCache::Get()
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (CachedId.IsValid())
+		{
+			return *CachedId;
+		}
+	}
+
+	FString FetchedId = FetchId();
+	Resolve(FetchedId);
+	return FetchedId;
+}
+
+void FCleverTapIdCache::Invalidate()
+{
+	check(IsInGameThread());
+	{
+		FWriteScopeLock WriteLock(Lock);
+		IdBeforeInvalidation = CachedId.IsValid() ? *CachedId : LastNotifiedId;
+		CachedId.Reset();
+		InvalidatedAtSeconds = FPlatformTime::Seconds();
+		bInvalidated = true;
+	}
+
+	if (!PendingResolveHandle.IsValid())
+	{
+		PendingResolveHandle = FTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateSP(this, &FCleverTapIdCache::TickPendingResolve), PendingResolveIntervalSeconds);
+	}
+}
+
+void FCleverTapIdCache::Resolve(const FString& FetchedId)
+{
+	CLEVERTAP_LLM_SCOPE();
+	if (FetchedId.IsEmpty())
+	{
+		return; // the platform SDK hasn't assigned an id yet
+	}
+
+	{
+		FWriteScopeLock WriteLock(Lock);
+		if (CachedId.IsValid())
+		{
+			return; // resolved concurrently by another reader
+		}
+
+		if (bInvalidated)
+		{
+			const bool bSettled = FetchedId != IdBeforeInvalidation
+				|| FPlatformTime::Seconds() - InvalidatedAtSeconds >= IdSettleSeconds;
+			if (!bSettled)
+			{
+				return;
+			}
+			bInvalidated = false;
+		}
+
+		CachedId = MakeShared<const FString, ESPMode::ThreadSafe>(FetchedId);
+		if (FetchedId == LastNotifiedId)
+		{
+			return;
+		}
+		LastNotifiedId = FetchedId;
+	}
+
+	NotifyIdChanged(FetchedId);
+}
+
+void FCleverTapIdCache::NotifyIdChanged(const FString& NewId)
+{
+	if (IsInGameThread())
+	{
+		OnIdChanged(NewId);
+		return;
+	}
+
+	AsyncTask(ENamedThreads::GameThread,
+		[WeakThis = TWeakPtr<FCleverTapIdCache, ESPMode::ThreadSafe>(AsShared()), NewId]() {
+			if (TSharedPtr<FCleverTapIdCache, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				This->OnIdChanged(NewId);
+			}
+		});
+}
+
+bool FCleverTapIdCache::TickPendingResolve(float DeltaTime)
+{
+	Get();
+
+	FReadScopeLock ReadLock(Lock);
+	if (CachedId.IsValid())
+	{
+		PendingResolveHandle.Reset();
+		return false; // resolved; stop ticking
+	}
+	return true;
+}
+
+} // namespace CleverTapSDK
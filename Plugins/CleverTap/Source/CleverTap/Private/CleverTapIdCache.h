@@ -0,0 +1,59 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/SharedPointer.h"
+
+namespace CleverTapSDK {
+
+/**
+ * Caches the CleverTap Id of an instance so that reads don't cross the platform bridge.
+ *
+ * The id is fetched on first read and shared as an immutable string afterwards. Invalidate() drops the cached id when
+ *  the user profile may have changed (e.g. OnUserLogin) and resolves the new id in the background. Changes are
+ *  reported on the game thread.
+ */
+class FCleverTapIdCache : public TSharedFromThis<FCleverTapIdCache, ESPMode::ThreadSafe>
+{
+public:
+	using FFetchId = TFunction<FString()>;
+	using FOnIdChanged = TFunction<void(const FString&)>;
+
+	/**
+	 * \param InFetchId - fetches the current id from the platform SDK. Called from the thread that reads the id.
+	 * \param InOnIdChanged - called on the game thread whenever a newly resolved id differs from the previous one.
+	 */
+	FCleverTapIdCache(FFetchId InFetchId, FOnIdChanged InOnIdChanged);
+	~FCleverTapIdCache();
+
+	/**
+	 * Returns the cached id, fetching it from the platform SDK if it is not known yet. Safe to call from any thread.
+	 */
+	FString Get();
+
+	/**
+	 * Drops the cached id and keeps polling the platform SDK until the new id has settled. Must be called on the game
+	 *  thread.
+	 */
+	void Invalidate();
+
+private:
+	void Resolve(const FString& FetchedId);
+	void NotifyIdChanged(const FString& NewId);
+	bool TickPendingResolve(float DeltaTime);
+
+	FFetchId FetchId;
+	FOnIdChanged OnIdChanged;
+
+	FRWLock Lock;
+	TSharedPtr<const FString, ESPMode::ThreadSafe> CachedId;
+	FString LastNotifiedId;
+	FString IdBeforeInvalidation;
+	double InvalidatedAtSeconds = 0.0;
+	bool bInvalidated = false;
+
+	FDelegateHandle PendingResolveHandle;
+};
+
+} // namespace CleverTapSDK
@@ -17,6 +17,21 @@ FCleverTapInstanceConfig FCleverTapInstanceConfig::FromCleverTapConfig(const UCl
 	InstanceConfig.RegionCode = Config->RegionCode;
 	InstanceConfig.IdentityKeys = Config->IdentityKeys;
 	InstanceConfig.LogLevel = Config->GetActiveLogLevel();
+	InstanceConfig.bSendProfileChangesOnly = Config->bSendProfileChangesOnly;
+	InstanceConfig.BufferBudgetKilobytes = Config->BufferBudgetKilobytes;
+	InstanceConfig.BufferOverflowPolicy = Config->BufferOverflowPolicy;
+	InstanceConfig.OfflineStoreMaxMegabytes = Config->OfflineStoreMaxMegabytes;
+	InstanceConfig.CompressionFormat = Config->CompressionFormat;
+	InstanceConfig.CompressionThresholdBytes = Config->CompressionThresholdBytes;
+	InstanceConfig.SessionSummaryEventName = Config->SessionSummaryEventName;
+	InstanceConfig.SessionSummaryIntervalSeconds = Config->SessionSummaryIntervalSeconds;
+	InstanceConfig.MetricsEventName = Config->MetricsEventName;
+	InstanceConfig.MetricsIntervalSeconds = Config->MetricsIntervalSeconds;
+	InstanceConfig.UploadEndpointUrl = Config->UploadEndpointUrl;
+	InstanceConfig.UploadMaxBatchEvents = Config->UploadMaxBatchEvents;
+	InstanceConfig.UploadMinIntervalSeconds = Config->UploadMinIntervalSeconds;
+	InstanceConfig.UploadMaxIntervalSeconds = Config->UploadMaxIntervalSeconds;
+	InstanceConfig.UploadMaxConcurrentBatches = Config->UploadMaxConcurrentBatches;
 	return InstanceConfig;
 }
 
@@ -0,0 +1,745 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapJsonReader.h"
+
+#include "CleverTapMemory.h"
+#include "CleverTapUtilities.h"
+
+#include "Containers/StringConv.h"
+#include "Misc/CString.h"
+#include "Misc/DateTime.h"
+
+namespace {
+
+// Powers of ten that are exactly representable as doubles
+const double ExactPowersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+	1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+// Mantissas with at most this many digits are exactly representable as doubles
+constexpr int32 MaxExactMantissaDigits = 15;
+
+/**
+ * Returns the length of the prefix of Data that contains no '"', '\\' or control characters, testing eight bytes at a
+ *  time with bitwise arithmetic on a 64-bit word (SWAR). bOutAscii is cleared if the prefix contains non-ASCII bytes.
+ */
+int32 GetPlainStringPrefixLength(const uint8* Data, int32 Length, bool& bOutAscii)
+{
+	constexpr uint64 Ones = 0x0101010101010101ull;
+	constexpr uint64 HighBits = 0x8080808080808080ull;
+
+	int32 Index = 0;
+	for (; Index + 8 <= Length; Index += 8)
+	{
+		uint64 Word;
+		FMemory::Memcpy(&Word, Data + Index, sizeof(Word));
+
+		// (X - Ones * N) & ~X & HighBits is non-zero if any byte of X is less than N; bytes of 0x80 and above are
+		// excluded by ~X, which is fine as none of the special characters are above 0x7f
+		const uint64 Quotes = Word ^ (Ones * '"');
+		const uint64 Backslashes = Word ^ (Ones * '\\');
+		const uint64 Special = ((Word - Ones * 0x20) & ~Word) | ((Quotes - Ones) & ~Quotes)
+			| ((Backslashes - Ones) & ~Backslashes);
+		if ((Special & HighBits) != 0)
+		{
+			break;
+		}
+		if ((Word & HighBits) != 0)
+		{
+			bOutAscii = false;
+		}
+	}
+
+	for (; Index < Length; ++Index)
+	{
+		const uint8 Char = Data[Index];
+		if (Char < 0x20 || Char == '"' || Char == '\\')
+		{
+			break;
+		}
+		if (Char >= 0x80)
+		{
+			bOutAscii = false;
+		}
+	}
+	return Index;
+}
+
+bool IsDigit(uint8 Char)
+{
+	return Char >= '0' && Char <= '9';
+}
+
+/**
+ * Parses "YYYY-MM-DD" of a date that exists, e.g. not February 31st.
+ */
+bool TryParseDate(const uint8* Data, int32 Length, FCleverTapDate& OutDate)
+{
+	if (Length != 10 || Data[4] != '-' || Data[7] != '-')
+	{
+		return false;
+	}
+	for (int32 Index : { 0, 1, 2, 3, 5, 6, 8, 9 })
+	{
+		if (!IsDigit(Data[Index]))
+		{
+			return false;
+		}
+	}
+
+	const int32 Year = (Data[0] - '0') * 1000 + (Data[1] - '0') * 100 + (Data[2] - '0') * 10 + (Data[3] - '0');
+	const int32 Month = (Data[5] - '0') * 10 + (Data[6] - '0');
+	const int32 Day = (Data[8] - '0') * 10 + (Data[9] - '0');
+	if (!FDateTime::Validate(Year, Month, Day, 0, 0, 0, 0))
+	{
+		return false;
+	}
+	OutDate = FCleverTapDate(Year, Month, Day);
+	return true;
+}
+
+void AppendUtf8(TArray<uint8>& Output, uint32 CodePoint)
+{
+	if (CodePoint < 0x80)
+	{
+		Output.Add(uint8(CodePoint));
+	}
+	else if (CodePoint < 0x800)
+	{
+		Output.Add(uint8(0xc0 | (CodePoint >> 6)));
+		Output.Add(uint8(0x80 | (CodePoint & 0x3f)));
+	}
+	else if (CodePoint < 0x10000)
+	{
+		Output.Add(uint8(0xe0 | (CodePoint >> 12)));
+		Output.Add(uint8(0x80 | ((CodePoint >> 6) & 0x3f)));
+		Output.Add(uint8(0x80 | (CodePoint & 0x3f)));
+	}
+	else
+	{
+		Output.Add(uint8(0xf0 | (CodePoint >> 18)));
+		Output.Add(uint8(0x80 | ((CodePoint >> 12) & 0x3f)));
+		Output.Add(uint8(0x80 | ((CodePoint >> 6) & 0x3f)));
+		Output.Add(uint8(0x80 | (CodePoint & 0x3f)));
+	}
+}
+
+class FJsonParser
+{
+public:
+	FJsonParser(const uint8* InData, int32 InLength) : Data(InData), Cursor(InData), End(InData + InLength) {}
+
+	template <typename AddPropertyType> bool ParseObject(AddPropertyType&& AddProperty)
+	{
+		SkipWhitespace();
+		if (!Consume('{'))
+		{
+			return Fail(TEXT("Expected '{'"));
+		}
+
+		SkipWhitespace();
+		if (!Consume('}'))
+		{
+			do
+			{
+				SkipWhitespace();
+				if (Cursor == End || *Cursor != '"')
+				{
+					return Fail(TEXT("Expected a member name"));
+				}
+				FString Key;
+				if (!ParseString(Key))
+				{
+					return false;
+				}
+
+				SkipWhitespace();
+				if (!Consume(':'))
+				{
+					return Fail(TEXT("Expected ':'"));
+				}
+
+				SkipWhitespace();
+				FCleverTapPropertyValue Value;
+				bool bIsNull = false;
+				if (!ParseValue(Value, bIsNull))
+				{
+					return false;
+				}
+				if (!bIsNull)
+				{
+					AddProperty(MoveTemp(Key), MoveTemp(Value));
+				}
+				SkipWhitespace();
+			} while (Consume(','));
+
+			if (!Consume('}'))
+			{
+				return Fail(TEXT("Expected ',' or '}'"));
+			}
+		}
+
+		SkipWhitespace();
+		if (Cursor != End)
+		{
+			return Fail(TEXT("Unexpected data after the object"));
+		}
+		return true;
+	}
+
+	FString Error;
+
+private:
+	enum class EArrayKind : uint8
+	{
+		Empty,
+		Bool,
+		String,
+		Integer,
+		Double,
+	};
+
+	bool Fail(const TCHAR* Message)
+	{
+		if (Error.IsEmpty())
+		{
+			Error = FString::Printf(TEXT("%s at offset %d"), Message, int32(Cursor - Data));
+		}
+		return false;
+	}
+
+	void SkipWhitespace()
+	{
+		while (Cursor < End && (*Cursor == ' ' || *Cursor == '\n' || *Cursor == '\r' || *Cursor == '\t'))
+		{
+			++Cursor;
+		}
+	}
+
+	bool Consume(ANSICHAR Char)
+	{
+		if (Cursor < End && *Cursor == uint8(Char))
+		{
+			++Cursor;
+			return true;
+		}
+		return false;
+	}
+
+	bool ConsumeLiteral(const ANSICHAR* Literal, int32 Length)
+	{
+		if (End - Cursor < Length || FMemory::Memcmp(Cursor, Literal, Length) != 0)
+		{
+			return Fail(TEXT("Invalid literal"));
+		}
+		Cursor += Length;
+		return true;
+	}
+
+	bool ParseValue(FCleverTapPropertyValue& OutValue, bool& bOutIsNull)
+	{
+		if (Cursor == End)
+		{
+			return Fail(TEXT("Expected a value"));
+		}
+
+		switch (*Cursor)
+		{
+			case '"':
+			{
+				const uint8* const StringStart = Cursor + 1;
+				FString String;
+				if (!ParseString(String))
+				{
+					return false;
+				}
+
+				FCleverTapDate Date;
+				if (TryParseDate(StringStart, int32(Cursor - StringStart) - 1, Date))
+				{
+					OutValue = FCleverTapPropertyValue(Date);
+				}
+				else
+				{
+					OutValue = FCleverTapPropertyValue(MoveTemp(String));
+				}
+				return true;
+			}
+			case 't':
+				OutValue = FCleverTapPropertyValue(true);
+				return ConsumeLiteral("true", 4);
+			case 'f':
+				OutValue = FCleverTapPropertyValue(false);
+				return ConsumeLiteral("false", 5);
+			case 'n':
+				bOutIsNull = true;
+				return ConsumeLiteral("null", 4);
+			case '[':
+				return ParseArray(OutValue);
+			case '{':
+				return Fail(TEXT("Nested objects are not supported"));
+			default:
+			{
+				int64 Integer = 0;
+				double Double = 0.0;
+				bool bIsInteger = false;
+				if (!ParseNumber(Integer, Double, bIsInteger))
+				{
+					return false;
+				}
+
+				if (!bIsInteger)
+				{
+					OutValue = FCleverTapPropertyValue(Double);
+				}
+				else if (Integer >= MIN_int32 && Integer <= MAX_int32)
+				{
+					OutValue = FCleverTapPropertyValue(int32(Integer));
+				}
+				else
+				{
+					OutValue = FCleverTapPropertyValue(Integer);
+				}
+				return true;
+			}
+		}
+	}
+
+	bool ParseArray(FCleverTapPropertyValue& OutValue)
+	{
+		++Cursor; // '['
+
+		EArrayKind Kind = EArrayKind::Empty;
+		TArray<bool> Bools;
+		TArray<FString> Strings;
+		TArray<int64> Integers;
+		TArray<double> Doubles;
+		bool bAllInt32 = true;
+
+		SkipWhitespace();
+		if (!Consume(']'))
+		{
+			do
+			{
+				SkipWhitespace();
+				if (Cursor == End)
+				{
+					return Fail(TEXT("Unterminated array"));
+				}
+
+				const uint8 First = *Cursor;
+				if (First == '"')
+				{
+					FString String;
+					if (!ParseString(String) || !MergeArrayKind(Kind, EArrayKind::String))
+					{
+						return false;
+					}
+					Strings.Add(MoveTemp(String));
+				}
+				else if (First == 't' || First == 'f')
+				{
+					const bool bValue = First == 't';
+					if (!(bValue ? ConsumeLiteral("true", 4) : ConsumeLiteral("false", 5))
+						|| !MergeArrayKind(Kind, EArrayKind::Bool))
+					{
+						return false;
+					}
+					Bools.Add(bValue);
+				}
+				else if (First == 'n')
+				{
+					// null elements stand for values JSON can't represent, e.g. NaN; they are dropped
+					if (!ConsumeLiteral("null", 4))
+					{
+						return false;
+					}
+				}
+				else if (First == '[' || First == '{')
+				{
+					return Fail(TEXT("Nested arrays and objects are not supported"));
+				}
+				else
+				{
+					int64 Integer = 0;
+					double Double = 0.0;
+					bool bIsInteger = false;
+					if (!ParseNumber(Integer, Double, bIsInteger))
+					{
+						return false;
+					}
+
+					if (bIsInteger && Kind != EArrayKind::Double)
+					{
+						if (!MergeArrayKind(Kind, EArrayKind::Integer))
+						{
+							return false;
+						}
+						bAllInt32 &= Integer >= MIN_int32 && Integer <= MAX_int32;
+						Integers.Add(Integer);
+					}
+					else
+					{
+						if (Kind == EArrayKind::Integer)
+						{
+							// widen the integers seen so far
+							Doubles.Reserve(Integers.Num() + 1);
+							for (int64 Previous : Integers)
+							{
+								Doubles.Add(double(Previous));
+							}
+							Integers.Empty();
+							Kind = EArrayKind::Double;
+						}
+						if (!MergeArrayKind(Kind, EArrayKind::Double))
+						{
+							return false;
+						}
+						Doubles.Add(bIsInteger ? double(Integer) : Double);
+					}
+				}
+				SkipWhitespace();
+			} while (Consume(','));
+
+			if (!Consume(']'))
+			{
+				return Fail(TEXT("Expected ',' or ']'"));
+			}
+		}
+
+		switch (Kind)
+		{
+			case EArrayKind::Empty:
+			case EArrayKind::String:
+				OutValue = FCleverTapPropertyValue(MoveTemp(Strings));
+				break;
+			case EArrayKind::Bool:
+				OutValue = FCleverTapPropertyValue(MoveTemp(Bools));
+				break;
+			case EArrayKind::Integer:
+				if (bAllInt32)
+				{
+					TArray<int32> Narrowed;
+					Narrowed.SetNumUninitialized(Integers.Num());
+					for (int32 Index = 0; Index < Integers.Num(); ++Index)
+					{
+						Narrowed[Index] = int32(Integers[Index]);
+					}
+					OutValue = FCleverTapPropertyValue(MoveTemp(Narrowed));
+				}
+				else
+				{
+					OutValue = FCleverTapPropertyValue(MoveTemp(Integers));
+				}
+				break;
+			case EArrayKind::Double:
+				OutValue = FCleverTapPropertyValue(MoveTemp(Doubles));
+				break;
+		}
+		return true;
+	}
+
+	bool MergeArrayKind(EArrayKind& Kind, EArrayKind ElementKind)
+	{
+		if (Kind != EArrayKind::Empty && Kind != ElementKind)
+		{
+			return Fail(TEXT("Arrays mixing strings, numbers and booleans are not supported"));
+		}
+		Kind = ElementKind;
+		return true;
+	}
+
+	bool ParseNumber(int64& OutInteger, double& OutDouble, bool& bOutIsInteger)
+	{
+		const uint8* const Start = Cursor;
+		const bool bNegative = Consume('-');
+		if (Cursor == End || !IsDigit(*Cursor))
+		{
+			return Fail(TEXT("Invalid value"));
+		}
+
+		// Accumulate up to 19 significant digits, enough for any int64 and beyond the digits a double can hold
+		uint64 Mantissa = 0;
+		int32 NumDigits = 0;
+		int32 Exponent = 0;
+		bool bTruncated = false;
+		const auto AddDigit = [&](uint8 Digit, bool bFraction) {
+			if (NumDigits < 19)
+			{
+				Mantissa = Mantissa * 10 + (Digit - '0');
+				NumDigits += Mantissa != 0 ? 1 : 0; // leading zeros are not significant
+				Exponent -= bFraction ? 1 : 0;
+			}
+			else
+			{
+				bTruncated |= Digit != '0';
+				Exponent += bFraction ? 0 : 1;
+			}
+		};
+
+		if (*Cursor == '0')
+		{
+			++Cursor; // no leading zeros
+		}
+		else
+		{
+			while (Cursor < End && IsDigit(*Cursor))
+			{
+				AddDigit(*Cursor++, false);
+			}
+		}
+
+		bool bIsInteger = true;
+		if (Consume('.'))
+		{
+			bIsInteger = false;
+			if (Cursor == End || !IsDigit(*Cursor))
+			{
+				return Fail(TEXT("Invalid number"));
+			}
+			while (Cursor < End && IsDigit(*Cursor))
+			{
+				AddDigit(*Cursor++, true);
+			}
+		}
+
+		if (Cursor < End && (*Cursor == 'e' || *Cursor == 'E'))
+		{
+			bIsInteger = false;
+			++Cursor;
+			const bool bNegativeExponent = Consume('-');
+			if (!bNegativeExponent)
+			{
+				Consume('+');
+			}
+			if (Cursor == End || !IsDigit(*Cursor))
+			{
+				return Fail(TEXT("Invalid number"));
+			}
+			int32 ExplicitExponent = 0;
+			while (Cursor < End && IsDigit(*Cursor))
+			{
+				ExplicitExponent = FMath::Min(ExplicitExponent * 10 + (*Cursor++ - '0'), 100000);
+			}
+			Exponent += bNegativeExponent ? -ExplicitExponent : ExplicitExponent;
+		}
+
+		if (bIsInteger && Exponent == 0)
+		{
+			const uint64 Limit = bNegative ? uint64(MAX_int64) + 1 : uint64(MAX_int64);
+			if (Mantissa <= Limit)
+			{
+				OutInteger = bNegative ? int64(0 - Mantissa) : int64(Mantissa);
+				bOutIsInteger = true;
+				return true;
+			}
+		}
+
+		bOutIsInteger = false;
+		if (!bTruncated && NumDigits <= MaxExactMantissaDigits && Exponent >= -22 && Exponent <= 22)
+		{
+			// both the mantissa and the power of ten are exact, so a single rounding gives the correct result
+			const double Magnitude = Exponent >= 0 ? double(Mantissa) * ExactPowersOfTen[Exponent]
+												   : double(Mantissa) / ExactPowersOfTen[-Exponent];
+			OutDouble = bNegative ? -Magnitude : Magnitude;
+			return true;
+		}
+
+		// slow path for numbers that need correct rounding of many digits
+		TArray<ANSICHAR, TInlineAllocator<64>> Text;
+		Text.Append(reinterpret_cast<const ANSICHAR*>(Start), int32(Cursor - Start));
+		Text.Add('\0');
+		OutDouble = FCStringAnsi::Atod(Text.GetData());
+		return true;
+	}
+
+	bool ParseString(FString& OutString)
+	{
+		++Cursor; // '"'
+		const uint8* const Start = Cursor;
+
+		bool bAscii = true;
+		Cursor += GetPlainStringPrefixLength(Cursor, int32(End - Cursor), bAscii);
+		if (Cursor < End && *Cursor == '"')
+		{
+			const int32 Length = int32(Cursor - Start);
+			++Cursor;
+			OutString = bAscii ? CleverTapSDK::AsciiToString(Start, Length) : CleverTapSDK::Utf8ToString(Start, Length);
+			return true;
+		}
+
+		// escaped string: unescape into the scratch buffer as UTF-8, then convert
+		Scratch.Reset();
+		Scratch.Append(Start, int32(Cursor - Start));
+		while (Cursor < End)
+		{
+			const uint8 Char = *Cursor++;
+			if (Char == '"')
+			{
+				OutString = CleverTapSDK::Utf8ToString(Scratch.GetData(), Scratch.Num());
+				return true;
+			}
+			if (Char < 0x20)
+			{
+				return Fail(TEXT("Control character in string"));
+			}
+			if (Char != '\\')
+			{
+				Scratch.Add(Char);
+				continue;
+			}
+
+			if (Cursor == End)
+			{
+				break;
+			}
+			switch (*Cursor++)
+			{
+				case '"':
+					Scratch.Add('"');
+					break;
+				case '\\':
+					Scratch.Add('\\');
+					break;
+				case '/':
+					Scratch.Add('/');
+					break;
+				case 'b':
+					Scratch.Add('\b');
+					break;
+				case 'f':
+					Scratch.Add('\f');
+					break;
+				case 'n':
+					Scratch.Add('\n');
+					break;
+				case 'r':
+					Scratch.Add('\r');
+					break;
+				case 't':
+					Scratch.Add('\t');
+					break;
+				case 'u':
+				{
+					uint32 CodePoint = 0;
+					if (!ParseHex4(CodePoint))
+					{
+						return false;
+					}
+					if (CodePoint >= 0xd800 && CodePoint <= 0xdbff)
+					{
+						// combine surrogate pairs, replace unpaired surrogates
+						uint32 Low = 0;
+						if (End - Cursor >= 6 && Cursor[0] == '\\' && Cursor[1] == 'u' && TryParseHex4(Cursor + 2, Low)
+							&& Low >= 0xdc00 && Low <= 0xdfff)
+						{
+							Cursor += 6;
+							CodePoint = 0x10000 + ((CodePoint - 0xd800) << 10) + (Low - 0xdc00);
+						}
+						else
+						{
+							CodePoint = 0xfffd;
+						}
+					}
+					else if (CodePoint >= 0xdc00 && CodePoint <= 0xdfff)
+					{
+						CodePoint = 0xfffd;
+					}
+					AppendUtf8(Scratch, CodePoint);
+					break;
+				}
+				default:
+					return Fail(TEXT("Invalid escape sequence"));
+			}
+		}
+		return Fail(TEXT("Unterminated string"));
+	}
+
+	bool ParseHex4(uint32& OutValue)
+	{
+		if (End - Cursor < 4 || !TryParseHex4(Cursor, OutValue))
+		{
+			return Fail(TEXT("Invalid unicode escape"));
+		}
+		Cursor += 4;
+		return true;
+	}
+
+	static bool TryParseHex4(const uint8* Hex, uint32& OutValue)
+	{
+		uint32 Value = 0;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			const uint8 Char = Hex[Index];
+			uint32 Digit;
+			if (Char >= '0' && Char <= '9')
+			{
+				Digit = Char - '0';
+			}
+			else if (Char >= 'a' && Char <= 'f')
+			{
+				Digit = Char - 'a' + 10;
+			}
+			else if (Char >= 'A' && Char <= 'F')
+			{
+				Digit = Char - 'A' + 10;
+			}
+			else
+			{
+				return false;
+			}
+			Value = (Value << 4) | Digit;
+		}
+		OutValue = Value;
+		return true;
+	}
+
+	const uint8* const Data;
+	const uint8* Cursor;
+	const uint8* const End;
+	TArray<uint8> Scratch;
+};
+
+template <typename AddPropertyType>
+bool ReadImpl(TArrayView<const uint8> Json, FString* OutError, AddPropertyType&& AddProperty)
+{
+	FJsonParser Parser(Json.GetData(), Json.Num());
+	const bool bSuccess = Parser.ParseObject(Forward<AddPropertyType>(AddProperty));
+	if (!bSuccess && OutError != nullptr)
+	{
+		*OutError = MoveTemp(Parser.Error);
+	}
+	return bSuccess;
+}
+
+} // namespace
+
+bool FCleverTapJsonReader::Read(TArrayView<const uint8> Json, FCleverTapProperties& OutProperties, FString* OutError)
+{
+	CLEVERTAP_LLM_SCOPE();
+	return ReadImpl(Json, OutError, [&OutProperties](FString&& Key, FCleverTapPropertyValue&& Value) {
+		OutProperties.Add(MoveTemp(Key), MoveTemp(Value));
+	});
+}
+
+bool FCleverTapJsonReader::Read(TArrayView<const uint8> Json, FCleverTapPayload& OutProperties, FString* OutError)
+{
+	CLEVERTAP_LLM_SCOPE();
+	return ReadImpl(Json, OutError, [&OutProperties](FString&& Key, FCleverTapPropertyValue&& Value) {
+		OutProperties.Emplace(MoveTemp(Key), MoveTemp(Value));
+	});
+}
+
+bool FCleverTapJsonReader::Read(const FString& Json, FCleverTapProperties& OutProperties, FString* OutError)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FTCHARToUTF8 Utf8(*Json, Json.Len());
+	return Read(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length()), OutProperties,
+		OutError);
+}
+
+bool FCleverTapJsonReader::Read(const FString& Json, FCleverTapPayload& OutProperties, FString* OutError)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FTCHARToUTF8 Utf8(*Json, Json.Len());
+	return Read(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length()), OutProperties,
+		OutError);
+}
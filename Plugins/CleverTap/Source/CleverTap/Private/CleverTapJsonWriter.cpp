@@ -0,0 +1,498 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapJsonWriter.h"
+
+#include "CleverTapMemory.h"
+
+#include "Misc/CString.h"
+
+namespace {
+
+const ANSICHAR HexDigits[] = "0123456789abcdef";
+
+/**
+ * Returns the length of the prefix of Data that can be copied to the output as is: printable ASCII other than '"'
+ *  and '\\'. Four UTF-16 code units are tested at a time with bitwise arithmetic on a 64-bit word (SWAR).
+ */
+int32 GetPlainAsciiPrefixLength(const TCHAR* Data, int32 Length)
+{
+	int32 Index = 0;
+	if (sizeof(TCHAR) == sizeof(uint16))
+	{
+		constexpr uint64 Ones = 0x0001000100010001ull;
+		constexpr uint64 HighBits = 0x8000800080008000ull;
+		constexpr uint64 NonAsciiBits = 0xff80ff80ff80ff80ull;
+
+		// (X - Ones * N) & ~X & HighBits is non-zero if any lane of X is less than N, given all lanes are below 0x8000
+		for (; Index + 4 <= Length; Index += 4)
+		{
+			uint64 Word;
+			FMemory::Memcpy(&Word, Data + Index, sizeof(Word));
+			if ((Word & NonAsciiBits) != 0)
+			{
+				break;
+			}
+			const uint64 Control = (Word - Ones * 0x20) & ~Word;
+			const uint64 Quotes = Word ^ (Ones * '"');
+			const uint64 Backslashes = Word ^ (Ones * '\\');
+			const uint64 Special = ((Quotes - Ones) & ~Quotes) | ((Backslashes - Ones) & ~Backslashes);
+			if (((Control | Special) & HighBits) != 0)
+			{
+				break;
+			}
+		}
+	}
+
+	for (; Index < Length; ++Index)
+	{
+		const TCHAR Char = Data[Index];
+		if (Char < 0x20 || Char >= 0x80 || Char == '"' || Char == '\\')
+		{
+			break;
+		}
+	}
+	return Index;
+}
+
+/**
+ * Writes the decimal digits of Value backwards ending at End and returns the first character.
+ */
+ANSICHAR* FormatInteger(int64 Value, ANSICHAR* End)
+{
+	// negate in unsigned arithmetic so that INT64_MIN doesn't overflow
+	uint64 Magnitude = Value < 0 ? 0 - uint64(Value) : uint64(Value);
+	ANSICHAR* Cursor = End;
+	do
+	{
+		*--Cursor = ANSICHAR('0' + Magnitude % 10);
+		Magnitude /= 10;
+	} while (Magnitude != 0);
+
+	if (Value < 0)
+	{
+		*--Cursor = '-';
+	}
+	return Cursor;
+}
+
+/**
+ * Appends ".0" to numbers that would otherwise read back as integers, so that their type survives a round-trip.
+ */
+int32 EnsureFractionOrExponent(ANSICHAR* Buffer, int32 Length)
+{
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		const ANSICHAR Char = Buffer[Index];
+		if (Char == '.' || Char == 'e' || Char == 'E')
+		{
+			return Length;
+		}
+	}
+	Buffer[Length++] = '.';
+	Buffer[Length++] = '0';
+	Buffer[Length] = '\0';
+	return Length;
+}
+
+} // namespace
+
+FCleverTapJsonWriter::FCleverTapJsonWriter(TArray<uint8>& InOutput) : Output(InOutput)
+{
+}
+
+void FCleverTapJsonWriter::BeginObject()
+{
+	BeginValue();
+	WriteRaw('{');
+	bNeedsComma = false;
+}
+
+void FCleverTapJsonWriter::EndObject()
+{
+	WriteRaw('}');
+	bNeedsComma = true;
+}
+
+void FCleverTapJsonWriter::BeginArray()
+{
+	BeginValue();
+	WriteRaw('[');
+	bNeedsComma = false;
+}
+
+void FCleverTapJsonWriter::EndArray()
+{
+	WriteRaw(']');
+	bNeedsComma = true;
+}
+
+void FCleverTapJsonWriter::WriteKey(const FString& Key)
+{
+	BeginValue();
+	WriteString(*Key, Key.Len());
+	WriteRaw(':');
+	bNeedsComma = false;
+}
+
+void FCleverTapJsonWriter::WriteKey(const ANSICHAR* Key)
+{
+	BeginValue();
+	WriteString(Key, FCStringAnsi::Strlen(Key));
+	WriteRaw(':');
+	bNeedsComma = false;
+}
+
+void FCleverTapJsonWriter::WriteNull()
+{
+	BeginValue();
+	WriteRaw("null", 4);
+}
+
+void FCleverTapJsonWriter::WriteValue(bool Value)
+{
+	BeginValue();
+	if (Value)
+	{
+		WriteRaw("true", 4);
+	}
+	else
+	{
+		WriteRaw("false", 5);
+	}
+}
+
+void FCleverTapJsonWriter::WriteValue(int32 Value)
+{
+	WriteValue(int64(Value));
+}
+
+void FCleverTapJsonWriter::WriteValue(int64 Value)
+{
+	BeginValue();
+	ANSICHAR Buffer[NumberBufferSize];
+	ANSICHAR* const End = Buffer + NumberBufferSize;
+	const ANSICHAR* const Start = FormatInteger(Value, End);
+	WriteRaw(Start, int32(End - Start));
+}
+
+void FCleverTapJsonWriter::WriteValue(float Value)
+{
+	if (!FMath::IsFinite(Value))
+	{
+		WriteNull();
+		return;
+	}
+
+	BeginValue();
+	ANSICHAR Buffer[NumberBufferSize];
+	WriteRaw(Buffer, EnsureFractionOrExponent(Buffer, FormatFloat(Value, Buffer)));
+}
+
+void FCleverTapJsonWriter::WriteValue(double Value)
+{
+	if (!FMath::IsFinite(Value))
+	{
+		WriteNull();
+		return;
+	}
+
+	BeginValue();
+	ANSICHAR Buffer[NumberBufferSize];
+	WriteRaw(Buffer, EnsureFractionOrExponent(Buffer, FormatDouble(Value, Buffer)));
+}
+
+void FCleverTapJsonWriter::WriteValue(const FString& Value)
+{
+	BeginValue();
+	WriteString(*Value, Value.Len());
+}
+
+void FCleverTapJsonWriter::WriteValue(const ANSICHAR* Value)
+{
+	BeginValue();
+	WriteString(Value, FCStringAnsi::Strlen(Value));
+}
+
+void FCleverTapJsonWriter::WriteValue(const FCleverTapDate& Value)
+{
+	BeginValue();
+
+	// "YYYY-MM-DD", zero padded like FCleverTapDate::ToString()
+	ANSICHAR Buffer[NumberBufferSize];
+	const int32 Length =
+		FCStringAnsi::Snprintf(Buffer, NumberBufferSize, "\"%04d-%02d-%02d\"", Value.Year, Value.Month, Value.Day);
+	WriteRaw(Buffer, Length);
+}
+
+void FCleverTapJsonWriter::WriteValue(const FCleverTapPropertyValue& Value)
+{
+	switch (Value.GetIndex())
+	{
+		case FCleverTapPropertyValue::IndexOfType<int32>():
+			WriteValue(Value.Get<int32>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<int64>():
+			WriteValue(Value.Get<int64>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<float>():
+			WriteValue(Value.Get<float>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<double>():
+			WriteValue(Value.Get<double>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<bool>():
+			WriteValue(Value.Get<bool>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<FString>():
+			WriteValue(Value.Get<FString>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<FCleverTapDate>():
+			WriteValue(Value.Get<FCleverTapDate>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+			WriteArray(Value.Get<TArray<int32>>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+			WriteArray(Value.Get<TArray<int64>>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+			WriteArray(Value.Get<TArray<float>>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+			WriteArray(Value.Get<TArray<double>>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+			WriteArray(Value.Get<TArray<bool>>());
+			break;
+		case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+			WriteArray(Value.Get<TArray<FString>>());
+			break;
+		default:
+			checkNoEntry();
+			WriteNull();
+			break;
+	}
+}
+
+void FCleverTapJsonWriter::WriteProperties(const FCleverTapProperties& Properties)
+{
+	CLEVERTAP_LLM_SCOPE();
+	WritePropertiesImpl(Properties);
+}
+
+void FCleverTapJsonWriter::WriteProperties(const FCleverTapPayload& Properties)
+{
+	CLEVERTAP_LLM_SCOPE();
+	WritePropertiesImpl(Properties);
+}
+
+FString FCleverTapJsonWriter::ToString(const FCleverTapProperties& Properties)
+{
+	CLEVERTAP_LLM_SCOPE();
+	TArray<uint8> Json;
+	FCleverTapJsonWriter(Json).WriteProperties(Properties);
+	return FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Json.GetData()), Json.Num()));
+}
+
+FString FCleverTapJsonWriter::ToString(const FCleverTapPayload& Properties)
+{
+	CLEVERTAP_LLM_SCOPE();
+	TArray<uint8> Json;
+	FCleverTapJsonWriter(Json).WriteProperties(Properties);
+	return FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Json.GetData()), Json.Num()));
+}
+
+int32 FCleverTapJsonWriter::FormatFloat(float Value, ANSICHAR (&Buffer)[NumberBufferSize])
+{
+	if (!FMath::IsFinite(Value))
+	{
+		return FCStringAnsi::Snprintf(Buffer, NumberBufferSize, "%g", Value);
+	}
+
+	// 7 significant digits are enough for most values, 9 always round-trip
+	int32 Length = FCStringAnsi::Snprintf(Buffer, NumberBufferSize, "%.7g", Value);
+	if (float(FCStringAnsi::Atod(Buffer)) != Value)
+	{
+		Length = FCStringAnsi::Snprintf(Buffer, NumberBufferSize, "%.9g", Value);
+	}
+	return Length;
+}
+
+int32 FCleverTapJsonWriter::FormatDouble(double Value, ANSICHAR (&Buffer)[NumberBufferSize])
+{
+	if (!FMath::IsFinite(Value))
+	{
+		return FCStringAnsi::Snprintf(Buffer, NumberBufferSize, "%g", Value);
+	}
+
+	// 15 significant digits are enough for most values, 17 always round-trip
+	int32 Length = FCStringAnsi::Snprintf(Buffer, NumberBufferSize, "%.15g", Value);
+	if (FCStringAnsi::Atod(Buffer) != Value)
+	{
+		Length = FCStringAnsi::Snprintf(Buffer, NumberBufferSize, "%.17g", Value);
+	}
+	return Length;
+}
+
+template <typename PropertiesType> void FCleverTapJsonWriter::WritePropertiesImpl(const PropertiesType& Properties)
+{
+	BeginObject();
+	for (const TPair<FString, FCleverTapPropertyValue>& Property : Properties)
+	{
+		WriteKey(Property.Key);
+		WriteValue(Property.Value);
+	}
+	EndObject();
+}
+
+template <typename ElementType> void FCleverTapJsonWriter::WriteArray(const TArray<ElementType>& Array)
+{
+	BeginArray();
+	for (const ElementType& Element : Array)
+	{
+		WriteValue(Element);
+	}
+	EndArray();
+}
+
+void FCleverTapJsonWriter::BeginValue()
+{
+	if (bNeedsComma)
+	{
+		WriteRaw(',');
+	}
+	bNeedsComma = true;
+}
+
+void FCleverTapJsonWriter::WriteRaw(const ANSICHAR* Data, int32 Length)
+{
+	Output.Append(reinterpret_cast<const uint8*>(Data), Length);
+}
+
+void FCleverTapJsonWriter::WriteString(const TCHAR* Data, int32 Length)
+{
+	// most strings are plain ASCII, so reserve for that and let escapes and multi-byte characters grow the output
+	Output.Reserve(Output.Num() + Length + 2);
+	WriteRaw('"');
+
+	int32 Index = 0;
+	while (Index < Length)
+	{
+		const int32 PlainLength = GetPlainAsciiPrefixLength(Data + Index, Length - Index);
+		if (PlainLength > 0)
+		{
+			const int32 Start = Output.AddUninitialized(PlainLength);
+			uint8* const Dest = Output.GetData() + Start;
+			for (int32 Offset = 0; Offset < PlainLength; ++Offset)
+			{
+				Dest[Offset] = uint8(Data[Index + Offset]);
+			}
+			Index += PlainLength;
+			if (Index == Length)
+			{
+				break;
+			}
+		}
+
+		uint32 CodePoint = uint32(Data[Index++]);
+		switch (CodePoint)
+		{
+			case '"':
+				WriteRaw("\\\"", 2);
+				continue;
+			case '\\':
+				WriteRaw("\\\\", 2);
+				continue;
+			case '\b':
+				WriteRaw("\\b", 2);
+				continue;
+			case '\f':
+				WriteRaw("\\f", 2);
+				continue;
+			case '\n':
+				WriteRaw("\\n", 2);
+				continue;
+			case '\r':
+				WriteRaw("\\r", 2);
+				continue;
+			case '\t':
+				WriteRaw("\\t", 2);
+				continue;
+			default:
+				break;
+		}
+
+		if (CodePoint < 0x20)
+		{
+			const ANSICHAR Escape[] = { '\\', 'u', '0', '0', HexDigits[CodePoint >> 4], HexDigits[CodePoint & 0xf] };
+			WriteRaw(Escape, UE_ARRAY_COUNT(Escape));
+			continue;
+		}
+
+		if (sizeof(TCHAR) == sizeof(uint16) && CodePoint >= 0xd800 && CodePoint <= 0xdfff)
+		{
+			// combine UTF-16 surrogate pairs, replace unpaired surrogates
+			const uint32 Low = Index < Length ? uint32(Data[Index]) : 0;
+			if (CodePoint <= 0xdbff && Low >= 0xdc00 && Low <= 0xdfff)
+			{
+				CodePoint = 0x10000 + ((CodePoint - 0xd800) << 10) + (Low - 0xdc00);
+				++Index;
+			}
+			else
+			{
+				CodePoint = 0xfffd;
+			}
+		}
+
+		uint8 Encoded[4];
+		int32 EncodedLength;
+		if (CodePoint < 0x800)
+		{
+			Encoded[0] = uint8(0xc0 | (CodePoint >> 6));
+			Encoded[1] = uint8(0x80 | (CodePoint & 0x3f));
+			EncodedLength = 2;
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Encoded[0] = uint8(0xe0 | (CodePoint >> 12));
+			Encoded[1] = uint8(0x80 | ((CodePoint >> 6) & 0x3f));
+			Encoded[2] = uint8(0x80 | (CodePoint & 0x3f));
+			EncodedLength = 3;
+		}
+		else
+		{
+			Encoded[0] = uint8(0xf0 | (CodePoint >> 18));
+			Encoded[1] = uint8(0x80 | ((CodePoint >> 12) & 0x3f));
+			Encoded[2] = uint8(0x80 | ((CodePoint >> 6) & 0x3f));
+			Encoded[3] = uint8(0x80 | (CodePoint & 0x3f));
+			EncodedLength = 4;
+		}
+		Output.Append(Encoded, EncodedLength);
+	}
+
+	WriteRaw('"');
+}
+
+void FCleverTapJsonWriter::WriteString(const ANSICHAR* Data, int32 Length)
+{
+	// ANSI strings are expected to be ASCII; anything else is escaped byte-wise
+	WriteRaw('"');
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		const uint8 Char = uint8(Data[Index]);
+		if (Char == '"' || Char == '\\')
+		{
+			WriteRaw('\\');
+			WriteRaw(ANSICHAR(Char));
+		}
+		else if (Char < 0x20 || Char >= 0x80)
+		{
+			const ANSICHAR Escape[] = { '\\', 'u', '0', '0', HexDigits[Char >> 4], HexDigits[Char & 0xf] };
+			WriteRaw(Escape, UE_ARRAY_COUNT(Escape));
+		}
+		else
+		{
+			WriteRaw(ANSICHAR(Char));
+		}
+	}
+	WriteRaw('"');
+}
@@ -1,6 +1,28 @@
 // Copyright CleverTap All Rights Reserved.
 #include "CleverTapLog.h"
 
+#include "HAL/IConsoleManager.h"
 #include "Logging/LogMacros.h"
 
 DEFINE_LOG_CATEGORY(LogCleverTap);
+
+namespace CleverTapSDK {
+
+#if CLEVERTAP_WITH_PAYLOAD_LOGGING
+static TAutoConsoleVariable<bool> CVarLogPayloads(TEXT("CleverTap.LogPayloads"), false,
+	TEXT("Dumps event and profile payloads to the log. Also requires LogCleverTap Verbose to be enabled, e.g. ")
+		TEXT("'log LogCleverTap Verbose'."),
+	ECVF_Default);
+
+bool ShouldLogPayloads()
+{
+	return CVarLogPayloads.GetValueOnAnyThread();
+}
+#else
+bool ShouldLogPayloads()
+{
+	return false;
+}
+#endif
+
+} // namespace CleverTapSDK
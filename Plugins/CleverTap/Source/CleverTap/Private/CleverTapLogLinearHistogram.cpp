@@ -0,0 +1,95 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapLogLinearHistogram.h"
+
+#include <cmath>
+
+namespace CleverTapSDK {
+
+void FCleverTapLogLinearHistogram::Record(double Value)
+{
+	++Buckets[GetBucketIndex(Value)];
+	Min = Count > 0 ? FMath::Min(Min, Value) : Value;
+	Max = Count > 0 ? FMath::Max(Max, Value) : Value;
+	Sum += Value;
+	++Count;
+}
+
+void FCleverTapLogLinearHistogram::Merge(const FCleverTapLogLinearHistogram& Other)
+{
+	if (Other.Count == 0)
+	{
+		return;
+	}
+	for (int32 Index = 0; Index < NumBuckets; ++Index)
+	{
+		Buckets[Index] += Other.Buckets[Index];
+	}
+	Min = Count > 0 ? FMath::Min(Min, Other.Min) : Other.Min;
+	Max = Count > 0 ? FMath::Max(Max, Other.Max) : Other.Max;
+	Sum += Other.Sum;
+	Count += Other.Count;
+}
+
+void FCleverTapLogLinearHistogram::Reset()
+{
+	FMemory::Memzero(Buckets);
+	Count = 0;
+	Sum = 0.0;
+	Min = 0.0;
+	Max = 0.0;
+}
+
+double FCleverTapLogLinearHistogram::GetPercentile(double Percentile) const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+
+	const uint64 Rank = FMath::Max<uint64>(1, uint64(std::ceil(FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Count)));
+	uint64 Cumulative = 0;
+	for (int32 Index = 0; Index < NumBuckets; ++Index)
+	{
+		Cumulative += Buckets[Index];
+		if (Cumulative >= Rank)
+		{
+			return FMath::Clamp(GetBucketUpperBound(Index), Min, Max);
+		}
+	}
+	return Max;
+}
+
+int32 FCleverTapLogLinearHistogram::GetBucketIndex(double Value)
+{
+	if (!(Value >= std::ldexp(1.0, MinExponent))) // also catches NaN
+	{
+		return 0;
+	}
+	if (Value >= std::ldexp(1.0, MaxExponent))
+	{
+		return NumBuckets - 1;
+	}
+
+	int Exponent = 0;
+	const double Mantissa = std::frexp(Value, &Exponent); // Value = Mantissa * 2^Exponent, Mantissa in [0.5, 1)
+	const int32 Octave = (Exponent - 1) - MinExponent;
+	const int32 SubBucket = FMath::Min(int32((Mantissa * 2.0 - 1.0) * NumSubBuckets), NumSubBuckets - 1);
+	return 1 + Octave * NumSubBuckets + SubBucket;
+}
+
+double FCleverTapLogLinearHistogram::GetBucketUpperBound(int32 Index)
+{
+	if (Index <= 0)
+	{
+		return std::ldexp(1.0, MinExponent);
+	}
+	if (Index >= NumBuckets - 1)
+	{
+		return std::ldexp(1.0, MaxExponent);
+	}
+	const int32 Octave = (Index - 1) / NumSubBuckets;
+	const int32 SubBucket = (Index - 1) % NumSubBuckets;
+	return std::ldexp(1.0 + double(SubBucket + 1) / NumSubBuckets, Octave + MinExponent);
+}
+
+} // namespace CleverTapSDK
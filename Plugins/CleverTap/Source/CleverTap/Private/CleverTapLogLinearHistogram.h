@@ -0,0 +1,49 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace CleverTapSDK {
+
+/**
+ * A fixed size histogram with log-linear buckets: every power of two between 2^MinExponent and 2^MaxExponent is split
+ *  into NumSubBuckets equal buckets, so the relative error of a reported percentile is at most 1 / NumSubBuckets over
+ *  the whole range. Values below the range, including zero and negative values, count in the first bucket and values
+ *  above it in the last. Exact minimum, maximum and sum are tracked alongside.
+ */
+class FCleverTapLogLinearHistogram
+{
+public:
+	static constexpr int32 MinExponent = -10; // ~0.001
+	static constexpr int32 MaxExponent = 22;  // ~4 million
+	static constexpr int32 NumSubBuckets = 8;
+	static constexpr int32 NumBuckets = (MaxExponent - MinExponent) * NumSubBuckets + 2;
+
+	FCleverTapLogLinearHistogram() { Reset(); }
+
+	void Record(double Value);
+	void Merge(const FCleverTapLogLinearHistogram& Other);
+	void Reset();
+
+	/**
+	 * Returns the upper bound of the bucket that holds the given percentile (0-100), clamped to the recorded range.
+	 */
+	double GetPercentile(double Percentile) const;
+
+	uint64 GetCount() const { return Count; }
+	double GetSum() const { return Sum; }
+	double GetMin() const { return Min; }
+	double GetMax() const { return Max; }
+
+	static int32 GetBucketIndex(double Value);
+	static double GetBucketUpperBound(int32 Index);
+
+private:
+	uint32 Buckets[NumBuckets];
+	uint64 Count;
+	double Sum;
+	double Min;
+	double Max;
+};
+
+} // namespace CleverTapSDK
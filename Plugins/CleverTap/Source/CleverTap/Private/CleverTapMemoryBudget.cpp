@@ -0,0 +1,60 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapMemoryBudget.h"
+
+#include "CleverTapStats.h"
+#include "CleverTapUtilities.h"
+
+namespace CleverTapSDK {
+
+FCleverTapMemoryBudget::FCleverTapMemoryBudget(int64 InLimitBytes) : LimitBytes(FMath::Max<int64>(InLimitBytes, 0))
+{
+	SET_MEMORY_STAT(STAT_CleverTapBufferBudget, LimitBytes);
+}
+
+FCleverTapMemoryBudget::~FCleverTapMemoryBudget()
+{
+	DEC_MEMORY_STAT_BY(STAT_CleverTapBufferedMemory, GetUsedBytes());
+}
+
+bool FCleverTapMemoryBudget::TryReserve(int64 Bytes)
+{
+	check(Bytes >= 0);
+	int64 Used = UsedBytes.load(std::memory_order_relaxed);
+	do
+	{
+		if (LimitBytes != 0 && Used + Bytes > LimitBytes)
+		{
+			return false;
+		}
+	} while (!UsedBytes.compare_exchange_weak(Used, Used + Bytes, std::memory_order_relaxed));
+	OnReserved(Used, Bytes);
+	return true;
+}
+
+void FCleverTapMemoryBudget::Reserve(int64 Bytes)
+{
+	check(Bytes >= 0);
+	OnReserved(UsedBytes.fetch_add(Bytes, std::memory_order_relaxed), Bytes);
+}
+
+void FCleverTapMemoryBudget::OnReserved(int64 Used, int64 Bytes)
+{
+	int64 Peak = PeakBytes.load(std::memory_order_relaxed);
+	while (Used + Bytes > Peak && !PeakBytes.compare_exchange_weak(Peak, Used + Bytes, std::memory_order_relaxed))
+	{
+	}
+
+	INC_MEMORY_STAT_BY(STAT_CleverTapBufferedMemory, Bytes);
+	SET_MEMORY_STAT(STAT_CleverTapPeakBufferedMemory, GetPeakBytes());
+}
+
+void FCleverTapMemoryBudget::Release(int64 Bytes)
+{
+	check(Bytes >= 0);
+	const int64 Previous = UsedBytes.fetch_sub(Bytes, std::memory_order_relaxed);
+	check(Previous >= Bytes);
+	CleverTapSDK::Ignore(Previous);
+	DEC_MEMORY_STAT_BY(STAT_CleverTapBufferedMemory, Bytes);
+}
+
+} // namespace CleverTapSDK
@@ -0,0 +1,60 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+namespace CleverTapSDK {
+
+/**
+ * Accounts the bytes of data an instance buffers against a fixed limit and reports current and peak usage as stats
+ *  (stat CleverTap).
+ *
+ * The budget only counts; the owner decides what to drop when a reservation fails. Safe to use from any thread.
+ */
+class FCleverTapMemoryBudget
+{
+public:
+	/**
+	 * \param InLimitBytes - the most bytes that can be reserved at once, or 0 for no limit.
+	 */
+	explicit FCleverTapMemoryBudget(int64 InLimitBytes);
+	~FCleverTapMemoryBudget();
+
+	FCleverTapMemoryBudget(const FCleverTapMemoryBudget&) = delete;
+	FCleverTapMemoryBudget& operator=(const FCleverTapMemoryBudget&) = delete;
+
+	/**
+	 * Reserves Bytes if they fit in the remaining budget. Returns false and reserves nothing otherwise.
+	 */
+	bool TryReserve(int64 Bytes);
+
+	/**
+	 * Reserves Bytes even if that exceeds the limit, for data that was already accounted before it was released.
+	 */
+	void Reserve(int64 Bytes);
+
+	/**
+	 * Returns bytes reserved with TryReserve().
+	 */
+	void Release(int64 Bytes);
+
+	/**
+	 * Returns true if Bytes could ever be reserved, i.e. they are no more than the limit.
+	 */
+	bool CanFit(int64 Bytes) const { return LimitBytes == 0 || Bytes <= LimitBytes; }
+
+	int64 GetLimitBytes() const { return LimitBytes; }
+	int64 GetUsedBytes() const { return UsedBytes.load(std::memory_order_relaxed); }
+	int64 GetPeakBytes() const { return PeakBytes.load(std::memory_order_relaxed); }
+
+private:
+	void OnReserved(int64 Used, int64 Bytes);
+
+	const int64 LimitBytes;
+	std::atomic<int64> UsedBytes{ 0 };
+	std::atomic<int64> PeakBytes{ 0 };
+};
+
+} // namespace CleverTapSDK
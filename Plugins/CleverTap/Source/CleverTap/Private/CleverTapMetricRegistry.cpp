@@ -0,0 +1,395 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapMetricRegistry.h"
+
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapLog.h"
+#include "CleverTapLogLinearHistogram.h"
+#include "CleverTapMemory.h"
+#include "CleverTapUtilities.h"
+
+#include "Containers/Ticker.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+namespace CleverTapSDK {
+
+struct FCleverTapMetricRegistry::FShard
+{
+	struct FCounter
+	{
+		double Sum = 0.0;
+		bool bUpdated = false;
+	};
+
+	struct FGauge
+	{
+		double Value = 0.0;
+		uint64 Cycles = 0; // when the value was set, to find the latest value across shards
+		bool bUpdated = false;
+	};
+
+	std::atomic<bool> bLocked{ false }; // taken by the owning thread to update and by Flush() to merge
+	std::atomic<bool> bRetired{ false }; // set once the owning thread no longer updates the shard
+	TArray<FCounter> Counters;
+	TArray<FGauge> Gauges;
+	TArray<TUniquePtr<FCleverTapLogLinearHistogram>> Histograms; // allocated on first use by the thread
+};
+
+/**
+ * The shards of the registries most recently used by a thread. Entries hold a reference, so a shard stays valid after
+ *  its registry is destroyed until the thread lets go of it.
+ */
+struct FCleverTapMetricRegistry::FShardCache
+{
+	struct FEntry
+	{
+		uint64 RegistryId = 0;
+		TSharedPtr<FShard, ESPMode::ThreadSafe> Shard;
+	};
+
+	static constexpr int32 NumEntries = 4;
+	FEntry Entries[NumEntries];
+	int32 NextEntry = 0;
+
+	~FShardCache()
+	{
+		for (FEntry& Entry : Entries)
+		{
+			Retire(Entry);
+		}
+	}
+
+	static void Retire(FEntry& Entry)
+	{
+		if (Entry.Shard)
+		{
+			Entry.Shard->bRetired.store(true, std::memory_order_release);
+			Entry.Shard.Reset();
+		}
+		Entry.RegistryId = 0;
+	}
+};
+
+namespace {
+
+std::atomic<uint64> NextRegistryId{ 1 };
+
+/**
+ * Holds the spin lock of a shard. The owning thread only finds it taken while Flush() merges the shard.
+ */
+class FShardScopeLock
+{
+public:
+	explicit FShardScopeLock(std::atomic<bool>& InLocked) : Locked(InLocked)
+	{
+		while (Locked.exchange(true, std::memory_order_acquire))
+		{
+			FPlatformProcess::Yield();
+		}
+	}
+
+	~FShardScopeLock() { Locked.store(false, std::memory_order_release); }
+
+	FShardScopeLock(const FShardScopeLock&) = delete;
+	FShardScopeLock& operator=(const FShardScopeLock&) = delete;
+
+private:
+	std::atomic<bool>& Locked;
+};
+
+const TCHAR* GetKindName(int32 Kind)
+{
+	static const TCHAR* const Names[] = { TEXT("counter"), TEXT("gauge"), TEXT("histogram") };
+	return Names[Kind];
+}
+
+} // namespace
+
+FCleverTapMetricRegistry::FCleverTapMetricRegistry(const FCleverTapInstanceConfig& Config, FPushSummary InPushSummary)
+	: Id(NextRegistryId.fetch_add(1, std::memory_order_relaxed))
+	, EventName(Config.MetricsEventName)
+	, Push(MoveTemp(InPushSummary))
+{
+	check(IsInGameThread());
+	IntervalStartSeconds = FPlatformTime::Seconds();
+
+	if (Config.MetricsIntervalSeconds > 0.0f)
+	{
+		IntervalHandle = FTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateRaw(this, &FCleverTapMetricRegistry::TickInterval), Config.MetricsIntervalSeconds);
+	}
+	BackgroundHandle =
+		FCoreDelegates::ApplicationWillEnterBackgroundDelegate.AddRaw(this, &FCleverTapMetricRegistry::Flush);
+}
+
+FCleverTapMetricRegistry::~FCleverTapMetricRegistry()
+{
+	check(IsInGameThread());
+	if (IntervalHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(IntervalHandle);
+	}
+	FCoreDelegates::ApplicationWillEnterBackgroundDelegate.Remove(BackgroundHandle);
+}
+
+FCleverTapCounter FCleverTapMetricRegistry::Counter(FName Name)
+{
+	const int32 Index = FindOrAdd(Name, EKind::Counter);
+	return Index != INDEX_NONE ? FCleverTapCounter(this, Index) : FCleverTapCounter();
+}
+
+FCleverTapGauge FCleverTapMetricRegistry::Gauge(FName Name)
+{
+	const int32 Index = FindOrAdd(Name, EKind::Gauge);
+	return Index != INDEX_NONE ? FCleverTapGauge(this, Index) : FCleverTapGauge();
+}
+
+FCleverTapHistogram FCleverTapMetricRegistry::Histogram(FName Name)
+{
+	const int32 Index = FindOrAdd(Name, EKind::Histogram);
+	return Index != INDEX_NONE ? FCleverTapHistogram(this, Index) : FCleverTapHistogram();
+}
+
+void FCleverTapMetricRegistry::AddToCounter(int32 Index, double Delta)
+{
+	FShard& Shard = GetShard();
+	FShardScopeLock ScopeLock(Shard.bLocked);
+	if (Index >= Shard.Counters.Num())
+	{
+		CLEVERTAP_LLM_SCOPE();
+		Shard.Counters.SetNum(Index + 1);
+	}
+	FShard::FCounter& Counter = Shard.Counters[Index];
+	Counter.Sum += Delta;
+	Counter.bUpdated = true;
+}
+
+void FCleverTapMetricRegistry::SetGauge(int32 Index, double Value)
+{
+	const uint64 Cycles = FPlatformTime::Cycles64();
+	FShard& Shard = GetShard();
+	FShardScopeLock ScopeLock(Shard.bLocked);
+	if (Index >= Shard.Gauges.Num())
+	{
+		CLEVERTAP_LLM_SCOPE();
+		Shard.Gauges.SetNum(Index + 1);
+	}
+	FShard::FGauge& Gauge = Shard.Gauges[Index];
+	Gauge.Value = Value;
+	Gauge.Cycles = Cycles;
+	Gauge.bUpdated = true;
+}
+
+void FCleverTapMetricRegistry::RecordHistogram(int32 Index, double Value)
+{
+	FShard& Shard = GetShard();
+	FShardScopeLock ScopeLock(Shard.bLocked);
+	if (Index >= Shard.Histograms.Num())
+	{
+		CLEVERTAP_LLM_SCOPE();
+		Shard.Histograms.SetNum(Index + 1);
+	}
+	TUniquePtr<FCleverTapLogLinearHistogram>& Histogram = Shard.Histograms[Index];
+	if (!Histogram)
+	{
+		CLEVERTAP_LLM_SCOPE();
+		Histogram = MakeUnique<FCleverTapLogLinearHistogram>();
+	}
+	Histogram->Record(Value);
+}
+
+void FCleverTapMetricRegistry::Flush()
+{
+	FCleverTapProperties Summary;
+	if (TakeSummary(Summary))
+	{
+		Push(EventName, Summary);
+	}
+}
+
+int32 FCleverTapMetricRegistry::GetNumShards() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Shards.Num();
+}
+
+int32 FCleverTapMetricRegistry::FindOrAdd(FName Name, EKind Kind)
+{
+	if (Name.IsNone())
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("Metrics need a name."));
+		return INDEX_NONE;
+	}
+
+	CLEVERTAP_LLM_SCOPE();
+	FScopeLock ScopeLock(&Lock);
+	if (const int32* const Existing = MetricsByName.Find(Name))
+	{
+		const FMetric& Metric = Metrics[*Existing];
+		if (Metric.Kind != Kind)
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("Metric '%s' is already used as a %s."), *Name.ToString(),
+				GetKindName(int32(Metric.Kind)));
+			return INDEX_NONE;
+		}
+		return Metric.Index;
+	}
+
+	const int32 Index = NumMetricsOfKind[int32(Kind)]++;
+	MetricsByName.Add(Name, Metrics.Add(FMetric{ Name, Kind, Index }));
+	return Index;
+}
+
+FCleverTapMetricRegistry::FShardCache& FCleverTapMetricRegistry::GetShardCache()
+{
+	// destroyed when the thread exits, which retires its shards
+	thread_local FShardCache Cache;
+	return Cache;
+}
+
+FCleverTapMetricRegistry::FShard& FCleverTapMetricRegistry::GetShard()
+{
+	for (const FShardCache::FEntry& Entry : GetShardCache().Entries)
+	{
+		if (Entry.RegistryId == Id)
+		{
+			return *Entry.Shard;
+		}
+	}
+	return AddShard();
+}
+
+FCleverTapMetricRegistry::FShard& FCleverTapMetricRegistry::AddShard()
+{
+	CLEVERTAP_LLM_SCOPE();
+	const TSharedRef<FShard, ESPMode::ThreadSafe> Shard = MakeShared<FShard, ESPMode::ThreadSafe>();
+	{
+		FScopeLock ScopeLock(&Lock);
+		Shards.Add(Shard);
+	}
+
+	// a thread that alternates between more registries than the cache holds retires a shard with each switch and
+	//  gets a new one; the retired shards are freed by the next Flush()
+	FShardCache& Cache = GetShardCache();
+	FShardCache::FEntry& Entry = Cache.Entries[Cache.NextEntry];
+	Cache.NextEntry = (Cache.NextEntry + 1) % FShardCache::NumEntries;
+	FShardCache::Retire(Entry);
+	Entry.RegistryId = Id;
+	Entry.Shard = Shard;
+	return *Shard;
+}
+
+bool FCleverTapMetricRegistry::TakeSummary(FCleverTapProperties& OutSummary)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FScopeLock ScopeLock(&Lock);
+
+	const int32 NumCounters = NumMetricsOfKind[int32(EKind::Counter)];
+	const int32 NumGauges = NumMetricsOfKind[int32(EKind::Gauge)];
+	const int32 NumHistograms = NumMetricsOfKind[int32(EKind::Histogram)];
+	TArray<FShard::FCounter> Counters;
+	Counters.SetNum(NumCounters);
+	TArray<FShard::FGauge> Gauges;
+	Gauges.SetNum(NumGauges);
+	TArray<FCleverTapLogLinearHistogram> Histograms;
+	Histograms.SetNum(NumHistograms);
+
+	for (int32 ShardIndex = Shards.Num() - 1; ShardIndex >= 0; --ShardIndex)
+	{
+		FShard* const Shard = Shards[ShardIndex].Get();
+		bool bRetired = false;
+		{
+			FShardScopeLock ShardLock(Shard->bLocked);
+
+			// a retired shard gets no more updates once its lock is taken, so this is its last merge
+			bRetired = Shard->bRetired.load(std::memory_order_acquire);
+			for (int32 Index = 0; Index < Shard->Counters.Num(); ++Index)
+			{
+				FShard::FCounter& Counter = Shard->Counters[Index];
+				Counters[Index].Sum += Counter.Sum;
+				Counters[Index].bUpdated |= Counter.bUpdated;
+				Counter = FShard::FCounter{};
+			}
+			for (int32 Index = 0; Index < Shard->Gauges.Num(); ++Index)
+			{
+				FShard::FGauge& Gauge = Shard->Gauges[Index];
+				if (Gauge.bUpdated && (!Gauges[Index].bUpdated || Gauge.Cycles > Gauges[Index].Cycles))
+				{
+					Gauges[Index] = Gauge;
+				}
+				Gauge.bUpdated = false;
+			}
+			for (int32 Index = 0; Index < Shard->Histograms.Num(); ++Index)
+			{
+				if (FCleverTapLogLinearHistogram* const Histogram = Shard->Histograms[Index].Get())
+				{
+					Histograms[Index].Merge(*Histogram);
+					Histogram->Reset();
+				}
+			}
+		}
+		if (bRetired)
+		{
+			Shards.RemoveAtSwap(ShardIndex);
+		}
+	}
+
+	for (const FMetric& Metric : Metrics)
+	{
+		const FString Name = Metric.Name.ToString();
+		switch (Metric.Kind)
+		{
+			case EKind::Counter:
+				if (Counters[Metric.Index].bUpdated)
+				{
+					OutSummary.Add(Name, NumberToPropertyValue(Counters[Metric.Index].Sum));
+				}
+				break;
+			case EKind::Gauge:
+				if (Gauges[Metric.Index].bUpdated)
+				{
+					OutSummary.Add(Name, NumberToPropertyValue(Gauges[Metric.Index].Value));
+				}
+				break;
+			case EKind::Histogram:
+			{
+				const FCleverTapLogLinearHistogram& Histogram = Histograms[Metric.Index];
+				if (Histogram.GetCount() > 0)
+				{
+					OutSummary.Add(Name + TEXT(" Count"), int64(Histogram.GetCount()));
+					OutSummary.Add(Name + TEXT(" Min"), NumberToPropertyValue(Histogram.GetMin()));
+					OutSummary.Add(Name + TEXT(" Max"), NumberToPropertyValue(Histogram.GetMax()));
+					OutSummary.Add(Name + TEXT(" Mean"), Histogram.GetSum() / Histogram.GetCount());
+					OutSummary.Add(Name + TEXT(" P50"), Histogram.GetPercentile(50.0));
+					OutSummary.Add(Name + TEXT(" P90"), Histogram.GetPercentile(90.0));
+					OutSummary.Add(Name + TEXT(" P99"), Histogram.GetPercentile(99.0));
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+
+	const double NowSeconds = FPlatformTime::Seconds();
+	const bool bHasSummary = OutSummary.Num() > 0;
+	if (bHasSummary)
+	{
+		OutSummary.Add(FString(TEXT("Interval Seconds")), NowSeconds - IntervalStartSeconds);
+	}
+	IntervalStartSeconds = NowSeconds;
+	return bHasSummary;
+}
+
+bool FCleverTapMetricRegistry::TickInterval(float DeltaTime)
+{
+	CleverTapSDK::Ignore(DeltaTime);
+	Flush();
+	return true;
+}
+
+} // namespace CleverTapSDK
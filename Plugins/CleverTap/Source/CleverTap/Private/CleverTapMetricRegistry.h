@@ -0,0 +1,105 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapMetrics.h"
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+struct FCleverTapInstanceConfig;
+
+namespace CleverTapSDK {
+
+/**
+ * The counters, gauges and histograms of an instance, pushed as a single summary event per interval.
+ *
+ * Every thread that updates a metric gets its own shard of values, found through a small thread local cache, so
+ *  updates from different threads never touch the same memory. Each shard has a spin lock that is only contended while
+ *  Flush() merges the shard, so an update costs a single uncontended exchange. A shard is retired when its thread
+ *  exits or drops the registry from its cache, and the next Flush() merges it one last time and frees it.
+ *
+ * The summary is pushed every MetricsIntervalSeconds and when the app enters the background. Owners call Flush()
+ *  before they are destroyed, while they can still push the summary. The registry must be created and destroyed on
+ *  the game thread.
+ */
+class FCleverTapMetricRegistry
+{
+public:
+	/**
+	 * Pushes a summary event. Called without holding any registry lock, so it may push through the owning instance.
+	 */
+	using FPushSummary = TFunction<void(const FString& EventName, const FCleverTapProperties& Summary)>;
+
+	FCleverTapMetricRegistry(const FCleverTapInstanceConfig& Config, FPushSummary InPushSummary);
+	~FCleverTapMetricRegistry();
+
+	FCleverTapMetricRegistry(const FCleverTapMetricRegistry&) = delete;
+	FCleverTapMetricRegistry& operator=(const FCleverTapMetricRegistry&) = delete;
+
+	/**
+	 * Return the handle of the metric with the given name, registering it on first use. The handle is invalid if the
+	 *  name is already used by a metric of another kind.
+	 */
+	FCleverTapCounter Counter(FName Name);
+	FCleverTapGauge Gauge(FName Name);
+	FCleverTapHistogram Histogram(FName Name);
+
+	void AddToCounter(int32 Index, double Delta);
+	void SetGauge(int32 Index, double Value);
+	void RecordHistogram(int32 Index, double Value);
+
+	/**
+	 * Merges the shards of all threads and pushes the summary of the metrics updated since the previous one.
+	 */
+	void Flush();
+
+	/**
+	 * The number of shards not freed yet, for tests.
+	 */
+	int32 GetNumShards() const;
+
+private:
+	enum class EKind : uint8
+	{
+		Counter,
+		Gauge,
+		Histogram,
+		Num,
+	};
+
+	struct FMetric
+	{
+		FName Name;
+		EKind Kind;
+		int32 Index; // among the metrics of the same kind
+	};
+
+	struct FShard;
+	struct FShardCache;
+
+	static FShardCache& GetShardCache();
+
+	int32 FindOrAdd(FName Name, EKind Kind);
+	FShard& GetShard();
+	FShard& AddShard();
+	bool TakeSummary(FCleverTapProperties& OutSummary);
+	bool TickInterval(float DeltaTime);
+
+	const uint64 Id; // unique across registries, so thread local caches never find the shard of a previous registry
+	const FString EventName;
+	const FPushSummary Push;
+
+	// guards the metric table and the list of shards
+	mutable FCriticalSection Lock;
+	TArray<FMetric> Metrics;
+	TMap<FName, int32> MetricsByName;
+	int32 NumMetricsOfKind[int32(EKind::Num)] = {};
+	TArray<TSharedPtr<FShard, ESPMode::ThreadSafe>> Shards; // shared with the thread local caches
+	double IntervalStartSeconds = 0.0;
+
+	FDelegateHandle IntervalHandle;
+	FDelegateHandle BackgroundHandle;
+};
+
+} // namespace CleverTapSDK
@@ -0,0 +1,28 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapMetrics.h"
+
+#include "CleverTapMetricRegistry.h"
+
+void FCleverTapCounter::Add(double Delta) const
+{
+	if (Registry)
+	{
+		Registry->AddToCounter(Index, Delta);
+	}
+}
+
+void FCleverTapGauge::Set(double Value) const
+{
+	if (Registry)
+	{
+		Registry->SetGauge(Index, Value);
+	}
+}
+
+void FCleverTapHistogram::Record(double Value) const
+{
+	if (Registry)
+	{
+		Registry->RecordHistogram(Index, Value);
+	}
+}
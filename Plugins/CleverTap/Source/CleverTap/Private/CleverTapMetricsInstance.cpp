@@ -0,0 +1,72 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapMetricsInstance.h"
+
+#include "CleverTapMemory.h"
+#include "CleverTapMetricRegistry.h"
+#include "CleverTapSessionAggregator.h"
+
+namespace CleverTapSDK {
+
+FCleverTapMetricsInstance::FCleverTapMetricsInstance() = default;
+
+FCleverTapMetricsInstance::FCleverTapMetricsInstance(const FCleverTapInstanceConfig& Config)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const auto PushSummary = [this](const FString& EventName, const FCleverTapProperties& Summary) {
+		PushEvent(EventName, Summary);
+	};
+	SessionAggregator = MakeUnique<FCleverTapSessionAggregator>(Config, PushSummary);
+	MetricRegistry = MakeUnique<FCleverTapMetricRegistry>(Config, PushSummary);
+}
+
+FCleverTapMetricsInstance::~FCleverTapMetricsInstance() = default;
+
+void FCleverTapMetricsInstance::AddSessionCounter(FName Name, double Delta)
+{
+	if (SessionAggregator)
+	{
+		SessionAggregator->AddCounter(Name, Delta);
+	}
+}
+
+void FCleverTapMetricsInstance::SetSessionGauge(FName Name, double Value)
+{
+	if (SessionAggregator)
+	{
+		SessionAggregator->SetGauge(Name, Value);
+	}
+}
+
+void FCleverTapMetricsInstance::EndSession()
+{
+	if (SessionAggregator)
+	{
+		SessionAggregator->EndSession();
+	}
+}
+
+FCleverTapCounter FCleverTapMetricsInstance::Counter(FName Name)
+{
+	return MetricRegistry ? MetricRegistry->Counter(Name) : FCleverTapCounter{};
+}
+
+FCleverTapGauge FCleverTapMetricsInstance::Gauge(FName Name)
+{
+	return MetricRegistry ? MetricRegistry->Gauge(Name) : FCleverTapGauge{};
+}
+
+FCleverTapHistogram FCleverTapMetricsInstance::Histogram(FName Name)
+{
+	return MetricRegistry ? MetricRegistry->Histogram(Name) : FCleverTapHistogram{};
+}
+
+void FCleverTapMetricsInstance::FlushMetrics()
+{
+	EndSession();
+	if (MetricRegistry)
+	{
+		MetricRegistry->Flush();
+	}
+}
+
+} // namespace CleverTapSDK
@@ -0,0 +1,48 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapInstance.h"
+
+#include "CoreMinimal.h"
+
+struct FCleverTapInstanceConfig;
+
+namespace CleverTapSDK {
+
+class FCleverTapMetricRegistry;
+class FCleverTapSessionAggregator;
+
+/**
+ * The base of the instances, implementing the session aggregates and metrics of ICleverTapInstance on the device the
+ *  same way on every platform. Summaries are pushed as events through the PushEvent() of the derived instance.
+ *
+ * Instances made without a config, like the null instance, aggregate nothing and hand out invalid metric handles.
+ */
+class FCleverTapMetricsInstance : public ICleverTapInstance
+{
+public:
+	void AddSessionCounter(FName Name, double Delta) override;
+	void SetSessionGauge(FName Name, double Value) override;
+	void EndSession() override;
+
+	FCleverTapCounter Counter(FName Name) override;
+	FCleverTapGauge Gauge(FName Name) override;
+	FCleverTapHistogram Histogram(FName Name) override;
+
+protected:
+	FCleverTapMetricsInstance();
+	explicit FCleverTapMetricsInstance(const FCleverTapInstanceConfig& Config);
+	~FCleverTapMetricsInstance();
+
+	/**
+	 * Pushes the summaries of what was aggregated so far. Derived instances call this first thing in their
+	 *  destructor, while their PushEvent() still works.
+	 */
+	void FlushMetrics();
+
+private:
+	TUniquePtr<FCleverTapSessionAggregator> SessionAggregator;
+	TUniquePtr<FCleverTapMetricRegistry> MetricRegistry;
+};
+
+} // namespace CleverTapSDK
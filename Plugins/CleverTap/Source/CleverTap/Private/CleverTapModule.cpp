@@ -3,6 +3,7 @@
 
 #include "CleverTapConfig.h"
 #include "CleverTapLog.h"
+#include "CleverTapStartupProfiler.h"
 
 #if WITH_EDITOR
 	#include "ISettingsModule.h"
@@ -12,6 +13,7 @@
 
 void FCleverTapModule::StartupModule()
 {
+	CLEVERTAP_STARTUP_SCOPE("StartupModule");
 	UE_LOG(LogCleverTap, Log, TEXT("CleverTap plugin startup"));
 
 #if WITH_EDITOR
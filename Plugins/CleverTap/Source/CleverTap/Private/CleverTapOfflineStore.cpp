@@ -0,0 +1,662 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapOfflineStore.h"
+
+#include "CleverTapCompression.h"
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+#include "CleverTapUtilities.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Offline store segments are stored in native byte order");
+
+namespace CleverTapSDK {
+
+namespace {
+
+// Segment files start with "CTQ", the format version and whether the segment holds priority records. Segments of
+//  any other version are removed as unreadable.
+constexpr int64 SegmentHeaderBytes = 8;
+const uint8 SegmentMagic[] = { 'C', 'T', 'Q', 1 };
+
+// Set in the type byte of records whose data is compressed. The data is then preceded by the compression format and
+//  the uncompressed size.
+constexpr uint8 CompressedRecordFlag = 0x80;
+constexpr int64 CompressionHeaderBytes = sizeof(uint8) + sizeof(uint32);
+
+// Each record is framed by its payload size and the CRC32 of the payload, so a record torn by a crash is detected
+constexpr int64 RecordFrameBytes = 2 * sizeof(uint32);
+
+// Records are written out once this much is buffered, and whenever the store is flushed
+constexpr int32 WriteBufferBytes = 64 * 1024;
+
+// The type, timestamp, append sequence number and name length of a record
+constexpr uint32 FixedPayloadBytes = sizeof(uint8) + sizeof(int64) + sizeof(uint64) + sizeof(uint32);
+
+const TCHAR* const SegmentExtension = TEXT(".ctq");
+
+IPlatformFile& GetPlatformFile()
+{
+	return FPlatformFileManager::Get().GetPlatformFile();
+}
+
+int64 GetEncodedSize(int32 NameBytes, int32 DataBytes, bool bCompressed)
+{
+	return RecordFrameBytes + FixedPayloadBytes + NameBytes
+		+ (bCompressed ? CompressionHeaderBytes : 0) + DataBytes;
+}
+
+/**
+ * Removes the consumed prefix of Items once it makes up half the array, so consuming from the front is amortized O(1),
+ *  and returns the index of the first item that isn't consumed.
+ */
+template <typename T> int32 TrimConsumed(TArray<T>& Items, int32 NumConsumed)
+{
+	if (NumConsumed * 2 >= Items.Num())
+	{
+		Items.RemoveAt(0, NumConsumed, /*bAllowShrinking=*/false);
+		return 0;
+	}
+	return NumConsumed;
+}
+
+template <typename T> void AppendRaw(TArray<uint8>& Output, const T& Value)
+{
+	Output.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+}
+
+template <typename T> T ReadRaw(const uint8* Data)
+{
+	T Value;
+	FMemory::Memcpy(&Value, Data, sizeof(T));
+	return Value;
+}
+
+/**
+ * Encodes Record with Data in place of its own data, which is either the record data or its compressed form.
+ */
+void EncodeRecord(const FCleverTapEventRecord& Record, uint64 Sequence, const FTCHARToUTF8& Name,
+	ECleverTapCompressionFormat Compression, TArrayView<const uint8> Data, TArray<uint8>& Output)
+{
+	const bool bCompressed = Compression != ECleverTapCompressionFormat::None;
+	const int32 FrameOffset = Output.AddUninitialized(RecordFrameBytes);
+	Output.Add(uint8(Record.Type) | (bCompressed ? CompressedRecordFlag : 0));
+	AppendRaw(Output, Record.TimestampMilliseconds);
+	AppendRaw(Output, Sequence);
+	AppendRaw(Output, uint32(Name.Length()));
+	Output.Append(reinterpret_cast<const uint8*>(Name.Get()), Name.Length());
+	if (bCompressed)
+	{
+		Output.Add(uint8(Compression));
+		AppendRaw(Output, uint32(Record.Data.Num()));
+	}
+	Output.Append(Data.GetData(), Data.Num());
+
+	const int32 PayloadOffset = FrameOffset + RecordFrameBytes;
+	const uint32 PayloadSize = uint32(Output.Num() - PayloadOffset);
+	const uint32 Crc = FCrc::MemCrc32(Output.GetData() + PayloadOffset, PayloadSize);
+	FMemory::Memcpy(Output.GetData() + FrameOffset, &PayloadSize, sizeof(PayloadSize));
+	FMemory::Memcpy(Output.GetData() + FrameOffset + sizeof(PayloadSize), &Crc, sizeof(Crc));
+}
+
+/**
+ * Decodes the record at Offset of a segment. Returns false at the end of the data or if the record is truncated or
+ *  corrupt.
+ */
+bool DecodeRecord(TArrayView<const uint8> Data, int64 Offset, FCleverTapEventRecord* OutRecord, uint64& OutSequence,
+	int64& OutEndOffset)
+{
+	if (Data.Num() - Offset < RecordFrameBytes)
+	{
+		return false;
+	}
+	const uint32 PayloadSize = ReadRaw<uint32>(Data.GetData() + Offset);
+	const uint32 Crc = ReadRaw<uint32>(Data.GetData() + Offset + sizeof(uint32));
+	const int64 PayloadOffset = Offset + RecordFrameBytes;
+	if (PayloadSize < FixedPayloadBytes || Data.Num() - PayloadOffset < int64(PayloadSize))
+	{
+		return false;
+	}
+
+	const uint8* const Payload = Data.GetData() + PayloadOffset;
+	if (FCrc::MemCrc32(Payload, PayloadSize) != Crc)
+	{
+		return false;
+	}
+	const uint32 NameBytes = ReadRaw<uint32>(Payload + FixedPayloadBytes - sizeof(uint32));
+	if (NameBytes > PayloadSize - FixedPayloadBytes)
+	{
+		return false;
+	}
+
+	const bool bCompressed = (Payload[0] & CompressedRecordFlag) != 0;
+	uint32 DataOffset = FixedPayloadBytes + NameBytes;
+	if (bCompressed && PayloadSize - DataOffset < CompressionHeaderBytes)
+	{
+		return false;
+	}
+
+	if (OutRecord)
+	{
+		OutRecord->Type = ECleverTapEventRecordType(Payload[0] & ~CompressedRecordFlag);
+		OutRecord->TimestampMilliseconds = ReadRaw<int64>(Payload + sizeof(uint8));
+		OutRecord->Name = Utf8ToString(Payload + FixedPayloadBytes, NameBytes);
+		if (bCompressed)
+		{
+			const ECleverTapCompressionFormat Format = ECleverTapCompressionFormat(Payload[DataOffset]);
+			const uint32 UncompressedBytes = ReadRaw<uint32>(Payload + DataOffset + sizeof(uint8));
+			DataOffset += CompressionHeaderBytes;
+			const TArrayView<const uint8> Compressed(Payload + DataOffset, PayloadSize - DataOffset);
+			if (UncompressedBytes > uint32(MAX_int32)
+				|| !FCleverTapCompression::Decompress(Format, Compressed, int32(UncompressedBytes), OutRecord->Data))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			OutRecord->Data.Reset();
+			OutRecord->Data.Append(Payload + DataOffset, PayloadSize - DataOffset);
+		}
+	}
+	OutSequence = ReadRaw<uint64>(Payload + sizeof(uint8) + sizeof(int64));
+	OutEndOffset = PayloadOffset + PayloadSize;
+	return true;
+}
+
+bool IsValidSegmentHeader(TArrayView<const uint8> Data)
+{
+	return Data.Num() >= SegmentHeaderBytes && FMemory::Memcmp(Data.GetData(), SegmentMagic, sizeof(SegmentMagic)) == 0;
+}
+
+} // namespace
+
+FCleverTapOfflineStore::FCleverTapOfflineStore(
+	FString InDirectory, int64 InMaxBytes, FCleverTapCompression InCompression, int64 InSegmentBytes)
+	: Directory(MoveTemp(InDirectory))
+	, MaxBytes(InMaxBytes)
+	// at least four segments fit in the footprint, so evicting one never discards most of the store
+	, SegmentBytes(FMath::Clamp<int64>(InSegmentBytes, 4096, FMath::Max<int64>(InMaxBytes / 4, 4096)))
+	, Compression(InCompression)
+{
+	Open();
+}
+
+FCleverTapOfflineStore::~FCleverTapOfflineStore()
+{
+	Flush();
+	for (FChain& Chain : Chains)
+	{
+		Chain.Writer.Reset();
+		UnmapHead(Chain);
+	}
+}
+
+void FCleverTapOfflineStore::Open()
+{
+	CLEVERTAP_LLM_SCOPE();
+	IPlatformFile& PlatformFile = GetPlatformFile();
+	if (!PlatformFile.CreateDirectoryTree(*Directory))
+	{
+		UE_LOG(LogCleverTap, Error, TEXT("Failed to create the offline store directory '%s'"), *Directory);
+		return;
+	}
+
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *Directory, SegmentExtension);
+	TArray<uint64> Sequences;
+	for (const FString& FileName : FileNames)
+	{
+		Sequences.Add(FCString::Strtoui64(*FileName, nullptr, 10));
+	}
+	Sequences.Sort();
+
+	// read position persisted by Flush(): the head segment of each chain and the offset and records consumed in it
+	TArray<uint8> Cursor;
+	FFileHelper::LoadFileToArray(Cursor, *GetCursorPath(), FILEREAD_Silent);
+	constexpr int32 CursorEntryBytes = sizeof(uint64) + sizeof(int64) + sizeof(int32);
+	const bool bHasCursor = Cursor.Num() == CursorEntryBytes * 2;
+
+	for (uint64 Sequence : Sequences)
+	{
+		NextSequence = FMath::Max(NextSequence, Sequence + 1);
+
+		FChain Scan;
+		Scan.Segments.Add(FSegment{ Sequence, 0, 0 });
+		if (!MapHead(Scan))
+		{
+			continue; // unreadable segments are removed by MapHead()
+		}
+
+		const bool bPriority = Scan.HeadData[sizeof(SegmentMagic)] != 0;
+		FChain& Chain = Chains[bPriority ? PriorityChain : NormalChain];
+
+		FSegment Segment{ Sequence, Scan.HeadData.Num(), 0 };
+		int64 Offset = SegmentHeaderBytes;
+		uint64 RecordSequence = 0;
+		while (DecodeRecord(Scan.HeadData, Offset, nullptr, RecordSequence, Offset))
+		{
+			++Segment.NumRecords;
+			NextRecordSequence = FMath::Max(NextRecordSequence, RecordSequence + 1);
+		}
+		UnmapHead(Scan);
+
+		int64 ReadOffset = 0;
+		int32 NumConsumed = 0;
+		if (bHasCursor)
+		{
+			const uint8* const Entry = Cursor.GetData() + (bPriority ? CursorEntryBytes : 0);
+			const uint64 CursorSequence = ReadRaw<uint64>(Entry);
+			if (Sequence < CursorSequence)
+			{
+				PlatformFile.DeleteFile(*GetSegmentPath(Sequence)); // consumed, but not deleted before shutdown
+				continue;
+			}
+			if (Sequence == CursorSequence)
+			{
+				ReadOffset = ReadRaw<int64>(Entry + sizeof(uint64));
+				NumConsumed = FMath::Min(ReadRaw<int32>(Entry + sizeof(uint64) + sizeof(int64)), Segment.NumRecords);
+			}
+		}
+
+		if (Chain.Segments.Num() == 0)
+		{
+			Chain.ReadOffset = ReadOffset;
+			Chain.NumConsumedInHead = NumConsumed;
+		}
+		Chain.Segments.Add(Segment);
+		Chain.NumRecords += Segment.NumRecords - (Chain.Segments.Num() == 1 ? NumConsumed : 0);
+		SizeBytes += Segment.SizeBytes;
+	}
+
+	if (Num() > 0)
+	{
+		UE_LOG(LogCleverTap, Log, TEXT("Offline store opened with %d records (%lld bytes)"), Num(), SizeBytes);
+	}
+
+	while (SizeBytes > MaxBytes && EvictOldestSegment())
+	{
+	}
+}
+
+FString FCleverTapOfflineStore::GetSegmentPath(uint64 Sequence) const
+{
+	return Directory / FString::Printf(TEXT("%020llu%s"), Sequence, SegmentExtension);
+}
+
+FString FCleverTapOfflineStore::GetCursorPath() const
+{
+	return Directory / TEXT("Cursor.bin");
+}
+
+bool FCleverTapOfflineStore::Append(const FCleverTapEventRecord& Record)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const FTCHARToUTF8 Name(*Record.Name);
+	const ECleverTapCompressionFormat Format = Compression.Compress(Record.Data, CompressedData);
+	const bool bCompressed = Format != ECleverTapCompressionFormat::None;
+	const TArrayView<const uint8> Data = bCompressed ? TArrayView<const uint8>(CompressedData) : Record.Data;
+	const int64 RecordBytes = GetEncodedSize(Name.Length(), Data.Num(), bCompressed);
+	if (RecordBytes + SegmentHeaderBytes > MaxBytes)
+	{
+		++NumEvicted;
+		return false;
+	}
+
+	while (SizeBytes + RecordBytes + SegmentHeaderBytes > MaxBytes)
+	{
+		if (!EvictOldestSegment())
+		{
+			++NumEvicted;
+			return false;
+		}
+	}
+
+	const bool bPriority = Record.HasPriority();
+	FChain& Chain = Chains[bPriority ? PriorityChain : NormalChain];
+	if (Chain.Writer)
+	{
+		const FSegment& Tail = Chain.Segments.Last();
+		if (Tail.NumRecords > 0 && Tail.SizeBytes + RecordBytes > SegmentBytes)
+		{
+			Seal(Chain);
+		}
+	}
+	if (!Chain.Writer)
+	{
+		OpenWriter(Chain, bPriority);
+		if (!Chain.Writer)
+		{
+			++NumEvicted;
+			return false;
+		}
+	}
+
+	EncodeRecord(Record, NextRecordSequence++, Name, Format, Data, Chain.OpenSegment);
+	FSegment& Tail = Chain.Segments.Last();
+	Tail.SizeBytes += RecordBytes;
+	++Tail.NumRecords;
+	++Chain.NumRecords;
+	SizeBytes += RecordBytes;
+
+	if (Chain.OpenSegment.Num() - Chain.NumWrittenBytes >= WriteBufferBytes)
+	{
+		FlushWriteBuffer(Chain);
+	}
+	return true;
+}
+
+bool FCleverTapOfflineStore::Pop(FCleverTapEventRecord& OutRecord)
+{
+	FChain& Normal = Chains[NormalChain];
+	FChain& Priority = Chains[PriorityChain];
+	const bool bHasNormal = PeekNext(Normal);
+	const bool bHasPriority = PeekNext(Priority);
+	if (!bHasNormal && !bHasPriority)
+	{
+		return false;
+	}
+
+	// the chains are merged in the order their records were appended
+	const bool bTakePriority =
+		!bHasNormal || (bHasPriority && Priority.NextRecordSequence < Normal.NextRecordSequence);
+	FChain& Chain = bTakePriority ? Priority : Normal;
+	if (Chain.bHeadIsOpen && Chain.NumWrittenBytes < Chain.NextEndOffset)
+	{
+		FlushWriteBuffer(Chain); // so the record is read again after a crash until it is acknowledged
+	}
+	Chain.Unacknowledged.Add(FReadPosition{ Chain.Segments[0].Sequence, Chain.ReadOffset, Chain.NumConsumedInHead });
+	PopOrder.Add(bTakePriority ? PriorityChain : NormalChain);
+	OutRecord = MoveTemp(Chain.Next);
+	Chain.bHasNext = false;
+	Chain.ReadOffset = Chain.NextEndOffset;
+	++Chain.NumConsumedInHead;
+	--Chain.NumRecords;
+	return true;
+}
+
+void FCleverTapOfflineStore::Acknowledge(int32 NumRecords)
+{
+	NumRecords = FMath::Min(NumRecords, GetNumUnacknowledged());
+	if (NumRecords <= 0)
+	{
+		return;
+	}
+	int32 NumAcknowledged[2] = { 0, 0 };
+	for (int32 Index = 0; Index < NumRecords; ++Index)
+	{
+		++NumAcknowledged[PopOrder[PopOrderHead + Index]];
+	}
+	PopOrderHead = TrimConsumed(PopOrder, PopOrderHead + NumRecords);
+
+	for (int32 ChainIndex = 0; ChainIndex < 2; ++ChainIndex)
+	{
+		FChain& Chain = Chains[ChainIndex];
+		Chain.UnacknowledgedHead =
+			TrimConsumed(Chain.Unacknowledged, Chain.UnacknowledgedHead + NumAcknowledged[ChainIndex]);
+		ReleaseRetained(Chain);
+	}
+
+	bCursorChanged = true;
+	if (FPlatformTime::Seconds() - CursorSavedSeconds >= CursorSaveIntervalSeconds)
+	{
+		SaveCursor();
+	}
+}
+
+void FCleverTapOfflineStore::Flush()
+{
+	for (FChain& Chain : Chains)
+	{
+		FlushWriteBuffer(Chain);
+	}
+	if (bCursorChanged)
+	{
+		SaveCursor();
+	}
+}
+
+void FCleverTapOfflineStore::SaveCursor()
+{
+	TArray<uint8> Cursor;
+	for (const FChain& Chain : Chains)
+	{
+		if (Chain.UnacknowledgedHead < Chain.Unacknowledged.Num())
+		{
+			const FReadPosition& Oldest = Chain.Unacknowledged[Chain.UnacknowledgedHead];
+			AppendRaw(Cursor, Oldest.Sequence);
+			AppendRaw(Cursor, Oldest.Offset);
+			AppendRaw(Cursor, Oldest.Index);
+		}
+		else
+		{
+			AppendRaw(Cursor, Chain.Segments.Num() > 0 ? Chain.Segments[0].Sequence : uint64(0));
+			AppendRaw(Cursor, Chain.ReadOffset);
+			AppendRaw(Cursor, Chain.NumConsumedInHead);
+		}
+	}
+	if (!FFileHelper::SaveArrayToFile(Cursor, *GetCursorPath()))
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("Failed to save the offline store read position"));
+	}
+	bCursorChanged = false;
+	CursorSavedSeconds = FPlatformTime::Seconds();
+}
+
+void FCleverTapOfflineStore::OpenWriter(FChain& Chain, bool bPriority)
+{
+	const uint64 Sequence = NextSequence++;
+	Chain.Writer.Reset(GetPlatformFile().OpenWrite(*GetSegmentPath(Sequence)));
+	if (!Chain.Writer)
+	{
+		UE_LOG(LogCleverTap, Error, TEXT("Failed to create offline store segment '%s'"), *GetSegmentPath(Sequence));
+		return;
+	}
+
+	Chain.OpenSegment.Reset();
+	Chain.OpenSegment.Append(SegmentMagic, sizeof(SegmentMagic));
+	Chain.OpenSegment.Add(bPriority ? 1 : 0);
+	Chain.OpenSegment.AddZeroed(SegmentHeaderBytes - sizeof(SegmentMagic) - 1);
+	Chain.NumWrittenBytes = 0;
+	Chain.Segments.Add(FSegment{ Sequence, SegmentHeaderBytes, 0 });
+	SizeBytes += SegmentHeaderBytes;
+}
+
+void FCleverTapOfflineStore::FlushWriteBuffer(FChain& Chain)
+{
+	const int64 NumUnwritten = Chain.OpenSegment.Num() - Chain.NumWrittenBytes;
+	if (Chain.Writer && NumUnwritten > 0)
+	{
+		if (!Chain.Writer->Write(Chain.OpenSegment.GetData() + Chain.NumWrittenBytes, NumUnwritten))
+		{
+			UE_LOG(LogCleverTap, Error, TEXT("Failed to write to the offline store"));
+		}
+		Chain.Writer->Flush();
+		Chain.NumWrittenBytes = Chain.OpenSegment.Num();
+	}
+}
+
+void FCleverTapOfflineStore::Seal(FChain& Chain)
+{
+	FlushWriteBuffer(Chain);
+	Chain.Writer.Reset();
+	if (Chain.bHeadIsOpen)
+	{
+		UnmapHead(Chain); // the reader continues from the same offset in the sealed file
+	}
+	Chain.OpenSegment.Empty();
+	Chain.NumWrittenBytes = 0;
+}
+
+bool FCleverTapOfflineStore::EvictOldestSegment()
+{
+	// the records of retained segments are in flight, so evicting them only gives up their crash safety
+	for (FChain& Retaining : Chains)
+	{
+		if (Retaining.Retained.Num() > 0)
+		{
+			UE_LOG(LogCleverTap, Verbose, TEXT("Offline store is full (%lld bytes). Evicted in-flight segment %llu."),
+				MaxBytes, Retaining.Retained[0].Sequence);
+			DeleteSegment(Retaining.Retained[0]);
+			Retaining.Retained.RemoveAt(0);
+			return true;
+		}
+	}
+
+	FChain& Chain = Chains[NormalChain].Segments.Num() > 0 ? Chains[NormalChain] : Chains[PriorityChain];
+	if (Chain.Segments.Num() == 0)
+	{
+		return false;
+	}
+
+	const int32 NumLost = Chain.Segments[0].NumRecords - Chain.NumConsumedInHead;
+	NumEvicted += NumLost;
+	UE_LOG(LogCleverTap, Warning, TEXT("Offline store is full (%lld bytes). Evicted %d %s records."), MaxBytes,
+		NumLost, &Chain == &Chains[PriorityChain] ? TEXT("priority") : TEXT("normal"));
+	RemoveHeadSegment(Chain);
+	return true;
+}
+
+void FCleverTapOfflineStore::RemoveHeadSegment(FChain& Chain)
+{
+	UnmapHead(Chain);
+	if (Chain.Segments.Num() == 1 && Chain.Writer)
+	{
+		Chain.Writer.Reset();
+		Chain.OpenSegment.Empty();
+		Chain.NumWrittenBytes = 0;
+	}
+
+	const FSegment Segment = Chain.Segments[0];
+	Chain.Segments.RemoveAt(0);
+	Chain.NumRecords -= Segment.NumRecords - Chain.NumConsumedInHead;
+	Chain.ReadOffset = 0;
+	Chain.NumConsumedInHead = 0;
+	Chain.bHasNext = false;
+	bCursorChanged = true;
+
+	// records popped from the segment but not acknowledged yet are read from it again after a crash
+	if (Chain.UnacknowledgedHead < Chain.Unacknowledged.Num()
+		&& Chain.Unacknowledged.Last().Sequence == Segment.Sequence)
+	{
+		Chain.Retained.Add(Segment);
+	}
+	else
+	{
+		DeleteSegment(Segment);
+	}
+}
+
+void FCleverTapOfflineStore::ReleaseRetained(FChain& Chain)
+{
+	while (Chain.Retained.Num() > 0
+		&& (Chain.UnacknowledgedHead == Chain.Unacknowledged.Num()
+			|| Chain.Retained[0].Sequence < Chain.Unacknowledged[Chain.UnacknowledgedHead].Sequence))
+	{
+		DeleteSegment(Chain.Retained[0]);
+		Chain.Retained.RemoveAt(0);
+	}
+}
+
+void FCleverTapOfflineStore::DeleteSegment(const FSegment& Segment)
+{
+	SizeBytes -= Segment.SizeBytes;
+	GetPlatformFile().DeleteFile(*GetSegmentPath(Segment.Sequence));
+}
+
+bool FCleverTapOfflineStore::MapHead(FChain& Chain)
+{
+	while (Chain.Segments.Num() > 0)
+	{
+		if (Chain.Segments.Num() == 1 && Chain.Writer)
+		{
+			// the segment being written is read from memory, so reading doesn't cut segments short
+			Chain.bHeadIsOpen = true;
+			Chain.HeadData = Chain.OpenSegment;
+			Chain.ReadOffset = FMath::Max(Chain.ReadOffset, SegmentHeaderBytes);
+			return true;
+		}
+
+		const FString Path = GetSegmentPath(Chain.Segments[0].Sequence);
+		Chain.MappedFile.Reset(GetPlatformFile().OpenMapped(*Path));
+		if (Chain.MappedFile)
+		{
+			Chain.MappedRegion.Reset(Chain.MappedFile->MapRegion(0, Chain.MappedFile->GetFileSize()));
+		}
+		if (Chain.MappedRegion)
+		{
+			Chain.HeadData = TArrayView<const uint8>(
+				Chain.MappedRegion->GetMappedPtr(), int32(Chain.MappedRegion->GetMappedSize()));
+		}
+		else if (FFileHelper::LoadFileToArray(Chain.LoadedSegment, *Path, FILEREAD_Silent))
+		{
+			Chain.MappedFile.Reset();
+			Chain.HeadData = Chain.LoadedSegment;
+		}
+
+		if (IsValidSegmentHeader(Chain.HeadData))
+		{
+			Chain.ReadOffset = FMath::Max(Chain.ReadOffset, SegmentHeaderBytes);
+			return true;
+		}
+
+		UE_LOG(LogCleverTap, Warning, TEXT("Removing unreadable offline store segment '%s'"), *Path);
+		NumEvicted += Chain.Segments[0].NumRecords - Chain.NumConsumedInHead;
+		RemoveHeadSegment(Chain);
+	}
+	return false;
+}
+
+void FCleverTapOfflineStore::UnmapHead(FChain& Chain)
+{
+	Chain.HeadData = TArrayView<const uint8>();
+	Chain.bHeadIsOpen = false;
+	Chain.MappedRegion.Reset();
+	Chain.MappedFile.Reset();
+	Chain.LoadedSegment.Empty();
+}
+
+bool FCleverTapOfflineStore::PeekNext(FChain& Chain)
+{
+	CLEVERTAP_LLM_SCOPE();
+	while (!Chain.bHasNext)
+	{
+		if (Chain.HeadData.Num() == 0 && !MapHead(Chain))
+		{
+			return false;
+		}
+		if (Chain.bHeadIsOpen)
+		{
+			Chain.HeadData = Chain.OpenSegment; // appends may have reallocated it
+		}
+
+		if (DecodeRecord(Chain.HeadData, Chain.ReadOffset, &Chain.Next, Chain.NextRecordSequence, Chain.NextEndOffset))
+		{
+			Chain.bHasNext = true;
+			break;
+		}
+		if (Chain.bHeadIsOpen)
+		{
+			return false; // every record appended so far is read
+		}
+
+		// the end of the segment, or a record torn by a crash; either way nothing more can be read from it
+		const int32 NumUnread = Chain.Segments[0].NumRecords - Chain.NumConsumedInHead;
+		if (NumUnread > 0)
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("Offline store segment %llu is corrupt. %d records lost."),
+				Chain.Segments[0].Sequence, NumUnread);
+			NumEvicted += NumUnread;
+		}
+		RemoveHeadSegment(Chain);
+	}
+	return true;
+}
+
+} // namespace CleverTapSDK
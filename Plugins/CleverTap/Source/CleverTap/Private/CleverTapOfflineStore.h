@@ -0,0 +1,175 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapCompression.h"
+#include "CleverTapEventRecord.h"
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+namespace CleverTapSDK {
+
+/**
+ * A disk backed FIFO of event records with a bounded footprint, used to keep events across long offline sessions and
+ *  app restarts without holding them in memory.
+ *
+ * Records are appended to fixed size segment files through a write buffer and read back through memory mapped views
+ *  of sealed segments. The segment being written is also kept in memory, up to the segment size, so its records are
+ *  read from there without sealing it early. Record data of at least the compression threshold is stored compressed.
+ *  Priority records (see FCleverTapEventRecord::HasPriority()) go to their own chain of segments. When the footprint
+ *  limit is reached whole segments are evicted oldest first, taking the normal chain before the priority chain, so
+ *  priority records are only lost once nothing else is left to evict. Every record is stamped with a sequence number
+ *  as it is appended, and records are consumed in that order across both chains, regardless of their timestamps.
+ *  Appending, consuming and acknowledging are amortized O(1) per record.
+ *
+ * Records are removed in two steps: Pop() reads a record and Acknowledge() confirms that it was delivered. A segment is
+ *  deleted once all its records are acknowledged. The position of the oldest unacknowledged record is persisted by
+ *  Flush() and, as records are acknowledged, at most every CursorSaveIntervalSeconds, so records in flight when the
+ *  app crashes or shuts down are read again by the next session. After a crash the records acknowledged since the
+ *  position was last saved are read again too.
+ *
+ * Not thread-safe; the owner serializes access.
+ */
+class FCleverTapOfflineStore
+{
+public:
+	static constexpr int64 DefaultSegmentBytes = 256 * 1024;
+	static constexpr double CursorSaveIntervalSeconds = 5.0;
+
+	/**
+	 * Opens the store in Directory and picks up the segments left there by a previous session.
+	 *
+	 * \param InMaxBytes - the most disk space the segments may take up.
+	 * \param InCompression - how record data is compressed before it is written.
+	 * \param InSegmentBytes - the size at which a segment is sealed and a new one is started.
+	 */
+	FCleverTapOfflineStore(FString InDirectory, int64 InMaxBytes, FCleverTapCompression InCompression = {},
+		int64 InSegmentBytes = DefaultSegmentBytes);
+	~FCleverTapOfflineStore();
+
+	FCleverTapOfflineStore(const FCleverTapOfflineStore&) = delete;
+	FCleverTapOfflineStore& operator=(const FCleverTapOfflineStore&) = delete;
+
+	/**
+	 * Appends a record, evicting the oldest segments if the footprint limit is reached. Returns false if the record
+	 *  doesn't fit even in an empty store.
+	 */
+	bool Append(const FCleverTapEventRecord& Record);
+
+	/**
+	 * Reads the oldest unread record. It stays on disk until it is acknowledged. Returns false if no record is left
+	 *  to read.
+	 */
+	bool Pop(FCleverTapEventRecord& OutRecord);
+
+	/**
+	 * Acknowledges the oldest NumRecords popped records that are not acknowledged yet, in the order they were popped.
+	 */
+	void Acknowledge(int32 NumRecords);
+
+	/**
+	 * Writes buffered records to disk and persists the position of the oldest unacknowledged record if it changed.
+	 */
+	void Flush();
+
+	/**
+	 * The number of records not popped yet.
+	 */
+	int32 Num() const { return Chains[0].NumRecords + Chains[1].NumRecords; }
+	int32 GetNumUnacknowledged() const { return PopOrder.Num() - PopOrderHead; }
+	int64 GetSizeBytes() const { return SizeBytes; }
+	int64 GetNumEvicted() const { return NumEvicted; }
+
+private:
+	struct FSegment
+	{
+		uint64 Sequence = 0;
+		int64 SizeBytes = 0;
+		int32 NumRecords = 0;
+	};
+
+	struct FReadPosition
+	{
+		uint64 Sequence = 0;
+		int64 Offset = 0;
+		int32 Index = 0;
+	};
+
+	struct FChain
+	{
+		// oldest first; the last segment is being written to while Writer is open
+		TArray<FSegment> Segments;
+
+		// segments read to the end that still hold unacknowledged records, oldest first
+		TArray<FSegment> Retained;
+
+		// where each popped record that is not acknowledged yet starts, oldest first, from UnacknowledgedHead on
+		TArray<FReadPosition> Unacknowledged;
+		int32 UnacknowledgedHead = 0;
+
+		// the segment being written; the bytes from NumWrittenBytes on are still to be written to the file
+		TUniquePtr<IFileHandle> Writer;
+		TArray<uint8> OpenSegment;
+		int64 NumWrittenBytes = 0;
+
+		// the mapped view of the first segment, or OpenSegment if that is the one being written, and the read
+		//  position in it
+		TUniquePtr<IMappedFileHandle> MappedFile;
+		TUniquePtr<IMappedFileRegion> MappedRegion;
+		TArray<uint8> LoadedSegment; // used instead of a mapping where the platform can't map files
+		TArrayView<const uint8> HeadData;
+		bool bHeadIsOpen = false;
+		int64 ReadOffset = 0;
+		int32 NumConsumedInHead = 0;
+
+		// the next record of the chain and its sequence number, decoded ahead so the chains can be merged
+		bool bHasNext = false;
+		FCleverTapEventRecord Next;
+		uint64 NextRecordSequence = 0;
+		int64 NextEndOffset = 0;
+
+		int32 NumRecords = 0;
+	};
+
+	static constexpr int32 NormalChain = 0;
+	static constexpr int32 PriorityChain = 1;
+
+	void Open();
+	FString GetSegmentPath(uint64 Sequence) const;
+	FString GetCursorPath() const;
+
+	void OpenWriter(FChain& Chain, bool bPriority);
+	void FlushWriteBuffer(FChain& Chain);
+	void Seal(FChain& Chain);
+	void SaveCursor();
+	bool EvictOldestSegment();
+	void RemoveHeadSegment(FChain& Chain);
+	void ReleaseRetained(FChain& Chain);
+	void DeleteSegment(const FSegment& Segment);
+
+	bool MapHead(FChain& Chain);
+	void UnmapHead(FChain& Chain);
+	bool PeekNext(FChain& Chain);
+
+	const FString Directory;
+	const int64 MaxBytes;
+	const int64 SegmentBytes;
+	const FCleverTapCompression Compression;
+	TArray<uint8> CompressedData; // scratch space for Append()
+
+	FChain Chains[2];
+	// the chain of each unacknowledged record, in the order they were popped, from PopOrderHead on
+	TArray<uint8> PopOrder;
+	int32 PopOrderHead = 0;
+	bool bCursorChanged = false;
+	double CursorSavedSeconds = 0.0;
+	uint64 NextSequence = 1; // of segments
+	uint64 NextRecordSequence = 1;
+	int64 SizeBytes = 0;
+	int64 NumEvicted = 0;
+};
+
+} // namespace CleverTapSDK
@@ -0,0 +1,151 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapProfileShadow.h"
+
+#include "CleverTapMemory.h"
+
+#include "Hash/CityHash.h"
+#include "Misc/ScopeLock.h"
+
+namespace CleverTapSDK {
+
+namespace {
+
+// Keys are hashed case-sensitively, as the server treats differently cased keys as different fields
+uint64 HashKey(const FString& Key)
+{
+	return CityHash64(reinterpret_cast<const char*>(*Key), uint32(Key.Len() * sizeof(TCHAR)));
+}
+
+template <typename T> uint64 HashBytes(const T* Data, int32 Num, uint64 Seed)
+{
+	return CityHash64WithSeed(reinterpret_cast<const char*>(Data), uint32(Num * sizeof(T)), Seed);
+}
+
+uint64 HashString(const FString& String, uint64 Seed)
+{
+	return HashBytes(*String, String.Len(), Seed);
+}
+
+// The type index is used as the seed so that e.g. int32(1) and int64(1) hash differently
+uint64 HashValue(const FCleverTapPropertyValue& Value)
+{
+	const uint64 Seed = Value.GetIndex();
+	switch (Value.GetIndex())
+	{
+		case FCleverTapPropertyValue::IndexOfType<int32>():
+			return HashBytes(&Value.Get<int32>(), 1, Seed);
+		case FCleverTapPropertyValue::IndexOfType<int64>():
+			return HashBytes(&Value.Get<int64>(), 1, Seed);
+		case FCleverTapPropertyValue::IndexOfType<float>():
+			return HashBytes(&Value.Get<float>(), 1, Seed);
+		case FCleverTapPropertyValue::IndexOfType<double>():
+			return HashBytes(&Value.Get<double>(), 1, Seed);
+		case FCleverTapPropertyValue::IndexOfType<bool>():
+			return HashBytes(&Value.Get<bool>(), 1, Seed);
+		case FCleverTapPropertyValue::IndexOfType<FString>():
+			return HashString(Value.Get<FString>(), Seed);
+		case FCleverTapPropertyValue::IndexOfType<FCleverTapDate>():
+		{
+			const FCleverTapDate& Date = Value.Get<FCleverTapDate>();
+			const int32 Packed[] = { Date.Year, Date.Month, Date.Day };
+			return HashBytes(Packed, UE_ARRAY_COUNT(Packed), Seed);
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+		{
+			const TArray<int32>& Array = Value.Get<TArray<int32>>();
+			return HashBytes(Array.GetData(), Array.Num(), Seed);
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+		{
+			const TArray<int64>& Array = Value.Get<TArray<int64>>();
+			return HashBytes(Array.GetData(), Array.Num(), Seed);
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+		{
+			const TArray<float>& Array = Value.Get<TArray<float>>();
+			return HashBytes(Array.GetData(), Array.Num(), Seed);
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+		{
+			const TArray<double>& Array = Value.Get<TArray<double>>();
+			return HashBytes(Array.GetData(), Array.Num(), Seed);
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+		{
+			const TArray<bool>& Array = Value.Get<TArray<bool>>();
+			return HashBytes(Array.GetData(), Array.Num(), Seed);
+		}
+		case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+		{
+			uint64 Hash = Seed;
+			for (const FString& Item : Value.Get<TArray<FString>>())
+			{
+				Hash = CityHash128to64({ Hash, HashString(Item, Seed) });
+			}
+			return CityHash128to64({ Hash, uint64(Value.Get<TArray<FString>>().Num()) });
+		}
+		default:
+			checkNoEntry();
+			return 0;
+	}
+}
+
+} // namespace
+
+FCleverTapProfileShadow::FCleverTapProfileShadow(int32 InMaxFields) : MaxFields(InMaxFields)
+{
+}
+
+FCleverTapProperties FCleverTapProfileShadow::FilterChangedFields(const FCleverTapProperties& Profile)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FCleverTapProperties ChangedFields;
+
+	FScopeLock ScopeLock(&Lock);
+	for (const TPair<FString, FCleverTapPropertyValue>& Field : Profile)
+	{
+		if (RecordField(HashKey(Field.Key), HashValue(Field.Value)))
+		{
+			ChangedFields.Add(Field.Key, Field.Value); // values share their string and array data, this doesn't copy it
+		}
+	}
+	return ChangedFields;
+}
+
+void FCleverTapProfileShadow::Reset(const FCleverTapProperties& Profile)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FScopeLock ScopeLock(&Lock);
+	FieldHashes.Reset();
+	for (const TPair<FString, FCleverTapPropertyValue>& Field : Profile)
+	{
+		RecordField(HashKey(Field.Key), HashValue(Field.Value));
+	}
+}
+
+void FCleverTapProfileShadow::Invalidate(const FString& Key)
+{
+	FScopeLock ScopeLock(&Lock);
+	FieldHashes.Remove(HashKey(Key));
+}
+
+bool FCleverTapProfileShadow::RecordField(uint64 KeyHash, uint64 ValueHash)
+{
+	if (uint64* const PushedValueHash = FieldHashes.Find(KeyHash))
+	{
+		if (*PushedValueHash == ValueHash)
+		{
+			return false;
+		}
+		*PushedValueHash = ValueHash;
+		return true;
+	}
+
+	if (FieldHashes.Num() < MaxFields)
+	{
+		FieldHashes.Add(KeyHash, ValueHash);
+	}
+	return true;
+}
+
+} // namespace CleverTapSDK
@@ -0,0 +1,49 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+namespace CleverTapSDK {
+
+/**
+ * A local shadow of the profile fields last pushed by an instance, used to push only the fields that changed.
+ *
+ * Each field is tracked as a 64-bit hash of its key and a 64-bit hash of its value, so memory is bounded by the
+ *  number of tracked fields regardless of the size of the values. Fields beyond the limit are never filtered and are
+ *  always pushed.
+ */
+class FCleverTapProfileShadow
+{
+public:
+	static constexpr int32 DefaultMaxFields = 256;
+
+	explicit FCleverTapProfileShadow(int32 InMaxFields = DefaultMaxFields);
+
+	/**
+	 * Returns the fields of Profile whose values differ from those last pushed, and records them as pushed.
+	 */
+	FCleverTapProperties FilterChangedFields(const FCleverTapProperties& Profile);
+
+	/**
+	 * Forgets all fields, e.g. when the user profile changes, and starts over with the fields of the new profile.
+	 */
+	void Reset(const FCleverTapProperties& Profile);
+
+	/**
+	 * Forgets a single field whose value was changed without going through FilterChangedFields(), e.g. by
+	 *  IncrementValue().
+	 */
+	void Invalidate(const FString& Key);
+
+private:
+	bool RecordField(uint64 KeyHash, uint64 ValueHash);
+
+	FCriticalSection Lock;
+	TMap<uint64, uint64> FieldHashes; // key hash -> value hash
+	int32 MaxFields;
+};
+
+} // namespace CleverTapSDK
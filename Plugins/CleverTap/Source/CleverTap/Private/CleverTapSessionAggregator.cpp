@@ -0,0 +1,206 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapSessionAggregator.h"
+
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+#include "CleverTapUtilities.h"
+
+#include "Containers/Ticker.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+
+namespace CleverTapSDK {
+
+namespace {
+
+constexpr int32 InitialNumSlots = 32;
+
+} // namespace
+
+FCleverTapSessionAggregator::FCleverTapSessionAggregator(
+	const FCleverTapInstanceConfig& Config, FPushSummary InPushSummary)
+	: EventName(Config.SessionSummaryEventName), Push(MoveTemp(InPushSummary))
+{
+	check(IsInGameThread());
+	CLEVERTAP_LLM_SCOPE();
+
+	Slots.SetNum(InitialNumSlots);
+	SessionStartSeconds = PeriodStartSeconds = FPlatformTime::Seconds();
+
+	if (Config.SessionSummaryIntervalSeconds > 0.0f)
+	{
+		IntervalHandle = FTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateRaw(this, &FCleverTapSessionAggregator::TickInterval),
+			Config.SessionSummaryIntervalSeconds);
+	}
+	BackgroundHandle = FCoreDelegates::ApplicationWillEnterBackgroundDelegate.AddRaw(
+		this, &FCleverTapSessionAggregator::EndSession);
+	ForegroundHandle = FCoreDelegates::ApplicationHasEnteredForegroundDelegate.AddLambda([this]() {
+		FScopeLock ScopeLock(&Lock);
+		SessionStartSeconds = PeriodStartSeconds = FPlatformTime::Seconds();
+	});
+}
+
+FCleverTapSessionAggregator::~FCleverTapSessionAggregator()
+{
+	check(IsInGameThread());
+	if (IntervalHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(IntervalHandle);
+	}
+	FCoreDelegates::ApplicationWillEnterBackgroundDelegate.Remove(BackgroundHandle);
+	FCoreDelegates::ApplicationHasEnteredForegroundDelegate.Remove(ForegroundHandle);
+}
+
+void FCleverTapSessionAggregator::AddCounter(FName Name, double Delta)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (FAggregate* const Aggregate = FindOrAdd(Name, EKind::Counter))
+	{
+		Aggregate->Value += Delta;
+		Aggregate->bUpdated = true;
+	}
+}
+
+void FCleverTapSessionAggregator::SetGauge(FName Name, double Value)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (FAggregate* const Aggregate = FindOrAdd(Name, EKind::Gauge))
+	{
+		Aggregate->Min = Aggregate->bUpdated ? FMath::Min(Aggregate->Min, Value) : Value;
+		Aggregate->Max = Aggregate->bUpdated ? FMath::Max(Aggregate->Max, Value) : Value;
+		Aggregate->Value = Value;
+		Aggregate->bUpdated = true;
+	}
+}
+
+void FCleverTapSessionAggregator::EndSession()
+{
+	PushSummary(/*bSessionEnd=*/true);
+}
+
+FCleverTapSessionAggregator::FAggregate* FCleverTapSessionAggregator::FindOrAdd(FName Name, EKind Kind)
+{
+	if (Name.IsNone())
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("Session aggregates need a name."));
+		return nullptr;
+	}
+
+	if ((NumAggregates + 1) * 2 > Slots.Num())
+	{
+		Grow();
+	}
+
+	const uint32 Mask = uint32(Slots.Num() - 1);
+	for (uint32 Index = GetTypeHash(Name) & Mask;; Index = (Index + 1) & Mask)
+	{
+		FAggregate& Slot = Slots[Index];
+		if (Slot.Name == Name)
+		{
+			if (Slot.Kind != Kind)
+			{
+				UE_LOG(LogCleverTap, Warning, TEXT("Session aggregate '%s' is already used as a %s."),
+					*Name.ToString(), Slot.Kind == EKind::Counter ? TEXT("counter") : TEXT("gauge"));
+				return nullptr;
+			}
+			return &Slot;
+		}
+		if (Slot.Name.IsNone())
+		{
+			Slot.Name = Name;
+			Slot.Kind = Kind;
+			++NumAggregates;
+			return &Slot;
+		}
+	}
+}
+
+void FCleverTapSessionAggregator::Grow()
+{
+	CLEVERTAP_LLM_SCOPE();
+	TArray<FAggregate> OldSlots = MoveTemp(Slots);
+	Slots.SetNum(OldSlots.Num() * 2);
+
+	const uint32 Mask = uint32(Slots.Num() - 1);
+	for (FAggregate& Aggregate : OldSlots)
+	{
+		if (Aggregate.Name.IsNone())
+		{
+			continue;
+		}
+		uint32 Index = GetTypeHash(Aggregate.Name) & Mask;
+		while (!Slots[Index].Name.IsNone())
+		{
+			Index = (Index + 1) & Mask;
+		}
+		Slots[Index] = Aggregate;
+	}
+}
+
+bool FCleverTapSessionAggregator::TakeSummary(bool bSessionEnd, FCleverTapProperties& OutSummary)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FScopeLock ScopeLock(&Lock);
+
+	const double NowSeconds = FPlatformTime::Seconds();
+	for (FAggregate& Aggregate : Slots)
+	{
+		if (!Aggregate.bUpdated)
+		{
+			continue;
+		}
+		const FString Name = Aggregate.Name.ToString();
+		OutSummary.Add(Name, NumberToPropertyValue(Aggregate.Value));
+		if (Aggregate.Kind == EKind::Gauge)
+		{
+			OutSummary.Add(Name + TEXT(" Min"), NumberToPropertyValue(Aggregate.Min));
+			OutSummary.Add(Name + TEXT(" Max"), NumberToPropertyValue(Aggregate.Max));
+		}
+		else
+		{
+			Aggregate.Value = 0.0;
+		}
+		Aggregate.bUpdated = false;
+	}
+
+	const bool bHasSummary = OutSummary.Num() > 0;
+	if (bHasSummary)
+	{
+		OutSummary.Add(FString(TEXT("Session Seconds")), NowSeconds - SessionStartSeconds);
+		OutSummary.Add(FString(TEXT("Period Seconds")), NowSeconds - PeriodStartSeconds);
+		OutSummary.Add(FString(TEXT("Session End")), bSessionEnd);
+	}
+
+	PeriodStartSeconds = NowSeconds;
+	if (bSessionEnd)
+	{
+		SessionStartSeconds = NowSeconds;
+		for (FAggregate& Aggregate : Slots)
+		{
+			Aggregate = FAggregate{};
+		}
+		NumAggregates = 0;
+	}
+	return bHasSummary;
+}
+
+void FCleverTapSessionAggregator::PushSummary(bool bSessionEnd)
+{
+	FCleverTapProperties Summary;
+	if (TakeSummary(bSessionEnd, Summary))
+	{
+		Push(EventName, Summary);
+	}
+}
+
+bool FCleverTapSessionAggregator::TickInterval(float DeltaTime)
+{
+	CleverTapSDK::Ignore(DeltaTime);
+	PushSummary(/*bSessionEnd=*/false);
+	return true;
+}
+
+} // namespace CleverTapSDK
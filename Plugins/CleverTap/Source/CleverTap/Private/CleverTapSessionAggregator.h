@@ -0,0 +1,89 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+struct FCleverTapInstanceConfig;
+
+namespace CleverTapSDK {
+
+/**
+ * Accumulates the session counters and gauges of an instance and reports them as a single summary event at the end of
+ *  each session, and optionally at a fixed interval within a session.
+ *
+ * Aggregates live in an open addressing hash table keyed by FName, so an update is a hash of the name index and a
+ *  short linear probe over a contiguous array, without any allocation once a name has been seen. A session starts
+ *  with the aggregator and whenever the app returns to the foreground, and ends when the app enters the background
+ *  or EndSession() is called. Owners call EndSession() before they are destroyed, while they can still push the
+ *  summary.
+ *
+ * Updates are safe from any thread. The aggregator must be created and destroyed on the game thread.
+ */
+class FCleverTapSessionAggregator
+{
+public:
+	/**
+	 * Pushes a summary event. Called without holding the aggregator lock, so it may push through the owning instance.
+	 */
+	using FPushSummary = TFunction<void(const FString& EventName, const FCleverTapProperties& Summary)>;
+
+	FCleverTapSessionAggregator(const FCleverTapInstanceConfig& Config, FPushSummary InPushSummary);
+	~FCleverTapSessionAggregator();
+
+	FCleverTapSessionAggregator(const FCleverTapSessionAggregator&) = delete;
+	FCleverTapSessionAggregator& operator=(const FCleverTapSessionAggregator&) = delete;
+
+	void AddCounter(FName Name, double Delta);
+	void SetGauge(FName Name, double Value);
+
+	/**
+	 * Pushes the summary of the current session and starts a new one.
+	 */
+	void EndSession();
+
+private:
+	enum class EKind : uint8
+	{
+		Counter,
+		Gauge,
+	};
+
+	struct FAggregate
+	{
+		FName Name; // NAME_None marks an empty slot
+		EKind Kind = EKind::Counter;
+		bool bUpdated = false; // since the last summary
+		double Value = 0.0;
+		double Min = 0.0;
+		double Max = 0.0;
+	};
+
+	FAggregate* FindOrAdd(FName Name, EKind Kind);
+	void Grow();
+
+	/**
+	 * Builds the summary of the aggregates updated since the last one and resets them. Returns false if there is
+	 *  nothing to report.
+	 */
+	bool TakeSummary(bool bSessionEnd, FCleverTapProperties& OutSummary);
+	void PushSummary(bool bSessionEnd);
+	bool TickInterval(float DeltaTime);
+
+	const FString EventName;
+	const FPushSummary Push;
+
+	FCriticalSection Lock;
+	TArray<FAggregate> Slots; // the number of slots is a power of two
+	int32 NumAggregates = 0;
+	double SessionStartSeconds = 0.0;
+	double PeriodStartSeconds = 0.0;
+
+	FDelegateHandle IntervalHandle;
+	FDelegateHandle BackgroundHandle;
+	FDelegateHandle ForegroundHandle;
+};
+
+} // namespace CleverTapSDK
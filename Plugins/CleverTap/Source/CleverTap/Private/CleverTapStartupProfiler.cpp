@@ -0,0 +1,101 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapStartupProfiler.h"
+
+#include "CleverTapLog.h"
+
+#include "Misc/ScopeLock.h"
+
+UE_TRACE_CHANNEL_DEFINE(CleverTapChannel)
+
+namespace CleverTapSDK {
+
+FStartupProfiler& FStartupProfiler::Get()
+{
+	static FStartupProfiler Singleton;
+	return Singleton;
+}
+
+void FStartupProfiler::RecordStep(const TCHAR* StepName, double Seconds, bool bTopLevel)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (bReported)
+	{
+		return;
+	}
+	Steps.Add(FStep{ StepName, Seconds });
+	if (bTopLevel)
+	{
+		TotalSeconds += Seconds;
+	}
+}
+
+bool FStartupProfiler::ReportSummary(float BudgetMilliseconds)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (bReported || Depth > 0)
+	{
+		return true; // already reported, or called from within a step that will report once it completes
+	}
+	bReported = true;
+
+	const double TotalMilliseconds = TotalSeconds * 1000.0;
+
+	FString StepSummary;
+	for (const FStep& Step : Steps)
+	{
+		StepSummary += FString::Printf(TEXT(" %s=%.3fms"), Step.Name, Step.Seconds * 1000.0);
+	}
+	UE_LOG(LogCleverTap, Log, TEXT("CleverTap startup: total=%.3fms [%s ]"), TotalMilliseconds, *StepSummary);
+
+	if (BudgetMilliseconds > 0.0f && TotalMilliseconds > BudgetMilliseconds)
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("CleverTap startup took %.3fms, exceeding the startup budget of %.3fms"),
+			TotalMilliseconds, BudgetMilliseconds);
+		return false;
+	}
+	return true;
+}
+
+double FStartupProfiler::GetTotalSeconds() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return TotalSeconds;
+}
+
+int32 FStartupProfiler::GetNumSteps() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Steps.Num();
+}
+
+bool FStartupProfiler::IsReported() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return bReported;
+}
+
+bool FStartupProfiler::EnterStep()
+{
+	FScopeLock ScopeLock(&Lock);
+	return Depth++ == 0;
+}
+
+void FStartupProfiler::ExitStep()
+{
+	FScopeLock ScopeLock(&Lock);
+	--Depth;
+}
+
+FStartupProfiler::FScopedStep::FScopedStep(const TCHAR* InStepName)
+	: StepName(InStepName), StartSeconds(FPlatformTime::Seconds()), bTopLevel(FStartupProfiler::Get().EnterStep())
+{
+}
+
+FStartupProfiler::FScopedStep::~FScopedStep()
+{
+	FStartupProfiler& Profiler = FStartupProfiler::Get();
+	Profiler.ExitStep();
+	Profiler.RecordStep(StepName, FPlatformTime::Seconds() - StartSeconds, bTopLevel);
+}
+
+} // namespace CleverTapSDK
@@ -0,0 +1,93 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+/**
+ * Trace channel for the CleverTap plugin. Enable with -trace=cpu,CleverTap
+ */
+UE_TRACE_CHANNEL_EXTERN(CleverTapChannel)
+
+namespace CleverTapSDK {
+
+/**
+ * Collects fine-grained timings of plugin startup and SDK initialization and reports them as a single summary line
+ *  once the shared instance has been initialized. Steps completed after the summary are not recorded.
+ *
+ * Thread safe; steps may be timed on any thread.
+ */
+class FStartupProfiler
+{
+public:
+	static FStartupProfiler& Get();
+
+	/**
+	 * Records the duration of a named startup step. Steps recorded at the outermost nesting level contribute to the
+	 *  total startup time, nested steps are reported individually. Ignored once the summary has been reported.
+	 */
+	void RecordStep(const TCHAR* StepName, double Seconds, bool bTopLevel);
+
+	/**
+	 * Logs the startup summary line and checks the total against the configured startup budget. Only the first call
+	 *  made outside of any startup step produces output.
+	 *
+	 * Returns false if this call reported a total over a budget greater than 0.
+	 */
+	bool ReportSummary(float BudgetMilliseconds);
+
+	/**
+	 * Total time spent in top-level startup steps so far.
+	 */
+	double GetTotalSeconds() const;
+
+	/**
+	 * The number of steps recorded so far.
+	 */
+	int32 GetNumSteps() const;
+
+	bool IsReported() const;
+
+	/**
+	 * Times a startup step for the lifetime of the scope.
+	 */
+	class FScopedStep
+	{
+	public:
+		explicit FScopedStep(const TCHAR* InStepName);
+		~FScopedStep();
+
+	private:
+		const TCHAR* StepName;
+		double StartSeconds;
+		bool bTopLevel;
+	};
+
+private:
+	struct FStep
+	{
+		const TCHAR* Name;
+		double Seconds;
+	};
+
+	bool EnterStep();
+	void ExitStep();
+
+	mutable FCriticalSection Lock;
+	TArray<FStep, TInlineAllocator<16>> Steps;
+	double TotalSeconds = 0.0;
+	int32 Depth = 0;
+	bool bReported = false;
+};
+
+} // namespace CleverTapSDK
+
+/**
+ * Times a startup step and emits a matching CPU trace event on the CleverTap trace channel.
+ */
+#define CLEVERTAP_STARTUP_SCOPE(StepName)                                                                              \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(TEXT("CleverTap::") TEXT(StepName), CleverTapChannel);               \
+	CleverTapSDK::FStartupProfiler::FScopedStep ANONYMOUS_VARIABLE(CleverTapStartupStep)(TEXT(StepName))
@@ -0,0 +1,22 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapStats.h"
+
+#include "CleverTapMemory.h"
+
+LLM_DEFINE_TAG(CleverTap);
+
+DEFINE_STAT(STAT_CleverTapBufferedMemory);
+DEFINE_STAT(STAT_CleverTapPeakBufferedMemory);
+DEFINE_STAT(STAT_CleverTapBufferBudget);
+DEFINE_STAT(STAT_CleverTapBufferedEvents);
+DEFINE_STAT(STAT_CleverTapDroppedEvents);
+DEFINE_STAT(STAT_CleverTapCompress);
+DEFINE_STAT(STAT_CleverTapDecompress);
+DEFINE_STAT(STAT_CleverTapCompressionInputBytes);
+DEFINE_STAT(STAT_CleverTapCompressionOutputBytes);
+DEFINE_STAT(STAT_CleverTapCompressionRatio);
+DEFINE_STAT(STAT_CleverTapUploadedEvents);
+DEFINE_STAT(STAT_CleverTapUploadFailures);
+DEFINE_STAT(STAT_CleverTapUploadBatchSize);
+DEFINE_STAT(STAT_CleverTapUploadRtt);
+DEFINE_STAT(STAT_CleverTapUploadsInFlight);
@@ -0,0 +1,25 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("CleverTap"), STATGROUP_CleverTap, STATCAT_Advanced);
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Buffered Memory"), STAT_CleverTapBufferedMemory, STATGROUP_CleverTap, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Peak Buffered Memory"), STAT_CleverTapPeakBufferedMemory, STATGROUP_CleverTap, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Buffer Budget"), STAT_CleverTapBufferBudget, STATGROUP_CleverTap, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Buffered Events"), STAT_CleverTapBufferedEvents, STATGROUP_CleverTap, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Dropped Events"), STAT_CleverTapDroppedEvents, STATGROUP_CleverTap, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Compress"), STAT_CleverTapCompress, STATGROUP_CleverTap, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Decompress"), STAT_CleverTapDecompress, STATGROUP_CleverTap, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Compression Input Bytes"), STAT_CleverTapCompressionInputBytes,
+	STATGROUP_CleverTap, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Compression Output Bytes"), STAT_CleverTapCompressionOutputBytes,
+	STATGROUP_CleverTap, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Compression Ratio"), STAT_CleverTapCompressionRatio, STATGROUP_CleverTap, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Uploaded Events"), STAT_CleverTapUploadedEvents, STATGROUP_CleverTap, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Upload Failures"), STAT_CleverTapUploadFailures, STATGROUP_CleverTap, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Upload Batch Size"), STAT_CleverTapUploadBatchSize, STATGROUP_CleverTap, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Upload RTT (ms)"), STAT_CleverTapUploadRtt, STATGROUP_CleverTap, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Uploads In Flight"), STAT_CleverTapUploadsInFlight, STATGROUP_CleverTap, );
@@ -4,7 +4,9 @@
 #include "CleverTapConfig.h"
 #include "CleverTapInstanceConfig.h"
 #include "CleverTapLog.h"
+#include "CleverTapMemory.h"
 #include "CleverTapPlatformSDK.h"
+#include "CleverTapStartupProfiler.h"
 #include "CleverTapUtilities.h"
 #include "NullCleverTapInstance.h"
 #include "UObject/UObjectBase.h"
@@ -44,22 +46,41 @@ const UCleverTapConfig* TryResolveCleverTapConfig(const UCleverTapConfig* MaybeE
 	return DefaultConfig;
 }
 
+void ReportStartupSummary()
+{
+	const UCleverTapConfig* const Config =
+		UObjectInitialized() ? UCleverTapConfig::StaticClass()->GetDefaultObject<UCleverTapConfig>() : nullptr;
+	CleverTapSDK::FStartupProfiler::Get().ReportSummary(IsValid(Config) ? Config->StartupBudgetMilliseconds : 0.0f);
+}
+
 } // namespace
 
 void UCleverTapSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	CleverTapSDK::Ignore(Collection);
-
-	const UCleverTapConfig* const Config = UCleverTapConfig::StaticClass()->GetDefaultObject<UCleverTapConfig>();
-	if (!ensure(IsValid(Config)))
 	{
-		UE_LOG(LogCleverTap, Error, TEXT("UCleverTapConfig was invalid. Subsystem will not be initialized."));
-		return;
+		CLEVERTAP_STARTUP_SCOPE("SubsystemInitialize");
+
+		const UCleverTapConfig* Config = nullptr;
+		{
+			CLEVERTAP_STARTUP_SCOPE("ConfigResolve");
+			Config = UCleverTapConfig::StaticClass()->GetDefaultObject<UCleverTapConfig>();
+		}
+		if (!ensure(IsValid(Config)))
+		{
+			UE_LOG(LogCleverTap, Error, TEXT("UCleverTapConfig was invalid. Subsystem will not be initialized."));
+			return;
+		}
+
+		if (Config->bAutoInitializeSharedInstance)
+		{
+			InitializeSharedInstance(Config);
+		}
 	}
 
-	if (Config->bAutoInitializeSharedInstance)
+	if (IsSharedInstanceInitialized())
 	{
-		InitializeSharedInstance(Config);
+		ReportStartupSummary();
 	}
 }
 
@@ -70,14 +91,22 @@ ICleverTapInstance& UCleverTapSubsystem::InitializeSharedInstance(const UCleverT
 		return *SharedInstanceImpl; // Already initialized
 	}
 
-	Config = TryResolveCleverTapConfig(Config);
+	{
+		CLEVERTAP_STARTUP_SCOPE("ConfigResolve");
+		Config = TryResolveCleverTapConfig(Config);
+	}
 	if (!IsValid(Config))
 	{
 		UE_LOG(LogCleverTap, Error, TEXT("UCleverTapConfig was invalid. Initialization will not occur."));
 		return CommonNullInstance();
 	}
 
-	return InitializeSharedInstance(FCleverTapInstanceConfig::FromCleverTapConfig(Config));
+	FCleverTapInstanceConfig InstanceConfig;
+	{
+		CLEVERTAP_STARTUP_SCOPE("FromCleverTapConfig");
+		InstanceConfig = FCleverTapInstanceConfig::FromCleverTapConfig(Config);
+	}
+	return InitializeSharedInstance(InstanceConfig);
 }
 
 ICleverTapInstance& UCleverTapSubsystem::InitializeSharedInstance(const FCleverTapInstanceConfig& Config)
@@ -89,9 +118,14 @@ ICleverTapInstance& UCleverTapSubsystem::InitializeSharedInstance(const FCleverT
 
 	UE_LOG(LogCleverTap, Log, TEXT("Initializing the shared CleverTap instance"));
 
-	SharedInstanceImpl = FCleverTapPlatformSDK::InitializeSharedInstance(Config);
+	{
+		CLEVERTAP_STARTUP_SCOPE("PlatformInitialize");
+		CLEVERTAP_LLM_SCOPE();
+		SharedInstanceImpl = FCleverTapPlatformSDK::InitializeSharedInstance(Config);
+	}
 	UE_CLOG(
 		SharedInstanceImpl == nullptr, LogCleverTap, Fatal, TEXT("Failed to initialize the CleverTap shared instance"));
+	ReportStartupSummary();
 	return *SharedInstanceImpl;
 }
 
@@ -102,7 +136,11 @@ ICleverTapInstance& UCleverTapSubsystem::InitializeSharedInstance(const FString&
 		return *SharedInstanceImpl; // Already initialized
 	}
 
-	const UCleverTapConfig* const Config = TryResolveCleverTapConfig();
+	const UCleverTapConfig* Config = nullptr;
+	{
+		CLEVERTAP_STARTUP_SCOPE("ConfigResolve");
+		Config = TryResolveCleverTapConfig();
+	}
 	if (!IsValid(Config))
 	{
 		UE_LOG(LogCleverTap, Error, TEXT("UCleverTapConfig was invalid. Initialization will not occur."));
@@ -120,7 +158,12 @@ ICleverTapInstance& UCleverTapSubsystem::InitializeSharedInstance(
 		return *SharedInstanceImpl; // Already initialized
 	}
 
-	return InitializeSharedInstance(FCleverTapInstanceConfig::FromCleverTapConfig(&Config), CleverTapId);
+	FCleverTapInstanceConfig InstanceConfig;
+	{
+		CLEVERTAP_STARTUP_SCOPE("FromCleverTapConfig");
+		InstanceConfig = FCleverTapInstanceConfig::FromCleverTapConfig(&Config);
+	}
+	return InitializeSharedInstance(InstanceConfig, CleverTapId);
 }
 
 ICleverTapInstance& UCleverTapSubsystem::InitializeSharedInstance(
@@ -141,9 +184,14 @@ ICleverTapInstance& UCleverTapSubsystem::InitializeSharedInstance(
 
 	UE_LOG(LogCleverTap, Log, TEXT("Initializing the shared CleverTap instance with CleverTap Id '%s'"), *CleverTapId);
 
-	SharedInstanceImpl = FCleverTapPlatformSDK::InitializeSharedInstance(Config, CleverTapId);
+	{
+		CLEVERTAP_STARTUP_SCOPE("PlatformInitialize");
+		CLEVERTAP_LLM_SCOPE();
+		SharedInstanceImpl = FCleverTapPlatformSDK::InitializeSharedInstance(Config, CleverTapId);
+	}
 	UE_CLOG(
 		SharedInstanceImpl == nullptr, LogCleverTap, Fatal, TEXT("Failed to initialize the CleverTap shared instance"));
+	ReportStartupSummary();
 	return *SharedInstanceImpl;
 }
 
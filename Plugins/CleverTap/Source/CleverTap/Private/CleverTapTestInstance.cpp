@@ -0,0 +1,73 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapTestInstance.h"
+
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapUploader.h"
+#include "GenericPlatformCleverTapInstance.h"
+
+#if !UE_BUILD_SHIPPING
+
+using CleverTapSDK::GenericPlatform::FGenericPlatformCleverTapInstance;
+
+namespace {
+
+// The offline store directory is shared with the shared instance, so an isolated instance must not use it
+FCleverTapInstanceConfig WithoutOfflineStore(const FCleverTapInstanceConfig& Config)
+{
+	FCleverTapInstanceConfig Isolated = Config;
+	if (Isolated.BufferOverflowPolicy == ECleverTapBufferOverflowPolicy::SpillToDisk)
+	{
+		Isolated.BufferOverflowPolicy = ECleverTapBufferOverflowPolicy::DropOldest;
+	}
+	return Isolated;
+}
+
+} // namespace
+
+FCleverTapTestInstance::FCleverTapTestInstance(const FCleverTapInstanceConfig& Config)
+	: Instance(MakeUnique<FGenericPlatformCleverTapInstance>(WithoutOfflineStore(Config)))
+{
+}
+
+FCleverTapTestInstance::~FCleverTapTestInstance() = default;
+
+ICleverTapInstance& FCleverTapTestInstance::Get()
+{
+	return *Instance;
+}
+
+int32 FCleverTapTestInstance::GetNumBuffered() const
+{
+	return Instance->GetQueue().Num();
+}
+
+int32 FCleverTapTestInstance::DiscardBuffered(int32 MaxRecords)
+{
+	TArray<CleverTapSDK::FCleverTapEventRecord> Discarded;
+	return Instance->GetQueue().Dequeue(MaxRecords, Discarded);
+}
+
+int64 FCleverTapTestInstance::GetNumDropped() const
+{
+	return Instance->GetQueue().GetNumDropped();
+}
+
+bool FCleverTapTestInstance::IsUploadIdle() const
+{
+	const CleverTapSDK::FCleverTapUploader* const Uploader = Instance->GetUploader();
+	return Uploader && Uploader->IsIdle();
+}
+
+int32 FCleverTapTestInstance::GetUploadBatchSize() const
+{
+	const CleverTapSDK::FCleverTapUploader* const Uploader = Instance->GetUploader();
+	return Uploader ? Uploader->GetPolicy().GetBatchSize() : 0;
+}
+
+double FCleverTapTestInstance::GetUploadRttSeconds() const
+{
+	const CleverTapSDK::FCleverTapUploader* const Uploader = Instance->GetUploader();
+	return Uploader ? Uploader->GetPolicy().GetRttSeconds() : 0.0;
+}
+
+#endif // !UE_BUILD_SHIPPING
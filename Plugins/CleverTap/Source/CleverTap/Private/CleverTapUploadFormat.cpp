@@ -0,0 +1,183 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapUploadFormat.h"
+
+#include "CleverTapJsonWriter.h"
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+
+namespace CleverTapSDK {
+
+namespace {
+
+const ANSICHAR* GetTypeName(ECleverTapEventRecordType Type)
+{
+	switch (Type)
+	{
+		case ECleverTapEventRecordType::Event:
+			return "event";
+		case ECleverTapEventRecordType::ChargedEvent:
+		case ECleverTapEventRecordType::ChargedEventColumns:
+			return "charged";
+		case ECleverTapEventRecordType::ProfilePush:
+			return "profile";
+		case ECleverTapEventRecordType::UserLogin:
+			return "login";
+		case ECleverTapEventRecordType::ProfileIncrement:
+			return "increment";
+		default:
+			return "unknown";
+	}
+}
+
+/**
+ * Calls Visit with the element type of a charged item column. Returns false for values that can't be columns.
+ */
+template <typename VisitorType> bool VisitColumn(const FCleverTapPropertyValue& Column, VisitorType&& Visit)
+{
+	switch (Column.GetIndex())
+	{
+		case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+			Visit(int32{});
+			return true;
+		case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+			Visit(int64{});
+			return true;
+		case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+			Visit(float{});
+			return true;
+		case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+			Visit(double{});
+			return true;
+		case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+			Visit(bool{});
+			return true;
+		case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+			Visit(FString{});
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Returns the number of items held by charged item columns, or INDEX_NONE if they aren't columns of equal length.
+ */
+int32 GetNumItems(const FCleverTapProperties& Columns)
+{
+	int32 NumItems = INDEX_NONE;
+	for (const TPair<FString, FCleverTapPropertyValue>& Column : Columns)
+	{
+		int32 Length = INDEX_NONE;
+		const bool bIsColumn = VisitColumn(Column.Value, [&Column, &Length](auto Element)
+		{
+			Length = Column.Value.Get<TArray<decltype(Element)>>().Num();
+		});
+		if (!bIsColumn || (NumItems != INDEX_NONE && Length != NumItems))
+		{
+			return INDEX_NONE;
+		}
+		NumItems = Length;
+	}
+	return NumItems == INDEX_NONE ? 0 : NumItems;
+}
+
+/**
+ * Writes the items of charged item columns as one object per item, as if they had been pushed as rows.
+ */
+void WriteColumnItems(FCleverTapJsonWriter& Writer, const FCleverTapProperties& Columns, int32 NumItems)
+{
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		Writer.BeginObject();
+		for (const TPair<FString, FCleverTapPropertyValue>& Column : Columns)
+		{
+			Writer.WriteKey(Column.Key);
+			VisitColumn(Column.Value, [&Writer, &Column, Index](auto Element)
+			{
+				Writer.WriteValue(Column.Value.Get<TArray<decltype(Element)>>()[Index]);
+			});
+		}
+		Writer.EndObject();
+	}
+}
+
+} // namespace
+
+int32 WriteUploadBody(const FString& BatchId, const FString& SessionId, int32 Sequence,
+	TArrayView<const FCleverTapEventRecord> Records, TArray<uint8>& OutBody)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FCleverTapJsonWriter Writer(OutBody);
+	Writer.BeginObject();
+	Writer.WriteKey("batch");
+	Writer.WriteValue(BatchId);
+	Writer.WriteKey("session");
+	Writer.WriteValue(SessionId);
+	Writer.WriteKey("seq");
+	Writer.WriteValue(Sequence);
+	Writer.WriteKey("events");
+	Writer.BeginArray();
+
+	int32 NumWritten = 0;
+	TArray<FCleverTapProperties> PropertySets;
+	for (const FCleverTapEventRecord& Record : Records)
+	{
+		PropertySets.Reset();
+		bool bValid = Record.ReadProperties(PropertySets) && PropertySets.Num() > 0;
+		const bool bColumns = Record.Type == ECleverTapEventRecordType::ChargedEventColumns;
+		int32 NumColumnItems = 0;
+		if (bValid && bColumns)
+		{
+			NumColumnItems = PropertySets.Num() == 2 ? GetNumItems(PropertySets[1]) : INDEX_NONE;
+			bValid = NumColumnItems != INDEX_NONE;
+		}
+		if (!bValid)
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("Skipping corrupt buffered record '%s'."), *Record.Name);
+			continue;
+		}
+
+		Writer.BeginObject();
+		Writer.WriteKey("type");
+		Writer.WriteValue(GetTypeName(Record.Type));
+		Writer.WriteKey("ts");
+		Writer.WriteValue(Record.TimestampMilliseconds);
+		if (Record.Type == ECleverTapEventRecordType::UserLogin)
+		{
+			Writer.WriteKey("identity");
+			Writer.WriteValue(Record.Name);
+		}
+		else if (!Record.IsCharged() && Record.Type != ECleverTapEventRecordType::ProfilePush)
+		{
+			Writer.WriteKey("name");
+			Writer.WriteValue(Record.Name);
+		}
+		Writer.WriteKey("properties");
+		Writer.WriteProperties(PropertySets[0]);
+		if (Record.IsCharged())
+		{
+			Writer.WriteKey("items");
+			Writer.BeginArray();
+			if (bColumns)
+			{
+				WriteColumnItems(Writer, PropertySets[1], NumColumnItems);
+			}
+			else
+			{
+				for (int32 Index = 1; Index < PropertySets.Num(); ++Index)
+				{
+					Writer.WriteProperties(PropertySets[Index]);
+				}
+			}
+			Writer.EndArray();
+		}
+		Writer.EndObject();
+		++NumWritten;
+	}
+
+	Writer.EndArray();
+	Writer.EndObject();
+	return NumWritten;
+}
+
+} // namespace CleverTapSDK
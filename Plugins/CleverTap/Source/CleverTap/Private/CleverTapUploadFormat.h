@@ -0,0 +1,17 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapEventRecord.h"
+
+#include "CoreMinimal.h"
+
+namespace CleverTapSDK {
+
+/**
+ * Writes the JSON body of an upload request for a batch of records, as described in CleverTapUploadProtocol.h.
+ *  Records whose data is corrupt are skipped. Returns the number of events written.
+ */
+int32 WriteUploadBody(const FString& BatchId, const FString& SessionId, int32 Sequence,
+	TArrayView<const FCleverTapEventRecord> Records, TArray<uint8>& OutBody);
+
+} // namespace CleverTapSDK
@@ -0,0 +1,269 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapUploader.h"
+
+#include "CleverTapEventQueue.h"
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+#include "CleverTapStats.h"
+#include "CleverTapUploadFormat.h"
+#include "CleverTapUploadProtocol.h"
+#include "CleverTapUtilities.h"
+
+#include "Containers/Ticker.h"
+#include "HAL/PlatformTime.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Misc/Guid.h"
+
+namespace CleverTapSDK {
+
+namespace {
+
+// how often the uploader checks whether a batch is due
+constexpr float TickIntervalSeconds = 0.1f;
+
+constexpr float RequestTimeoutSeconds = 30.0f;
+
+FCleverTapFlushPolicy::FSettings MakePolicySettings(const FCleverTapInstanceConfig& Config)
+{
+	FCleverTapFlushPolicy::FSettings Settings;
+	Settings.MaxBatchEvents = FMath::Max(Config.UploadMaxBatchEvents, 1);
+	Settings.MinBatchEvents = FMath::Min(Settings.MinBatchEvents, Settings.MaxBatchEvents);
+	Settings.MinIntervalSeconds = FMath::Max(double(Config.UploadMinIntervalSeconds), 0.0);
+	Settings.MaxIntervalSeconds = FMath::Max(double(Config.UploadMaxIntervalSeconds), Settings.MinIntervalSeconds);
+	return Settings;
+}
+
+bool IsRetryable(int32 ResponseCode)
+{
+	return ResponseCode == 408 || ResponseCode == 429 || ResponseCode >= 500;
+}
+
+} // namespace
+
+FCleverTapUploader::FCleverTapUploader(FCleverTapEventQueue& InQueue, const FCleverTapInstanceConfig& Config)
+	: Queue(InQueue)
+	, EndpointUrl(Config.UploadEndpointUrl)
+	, AccountId(Config.ProjectId)
+	, Token(Config.ProjectToken)
+	, SessionId(FGuid::NewGuid().ToString(EGuidFormats::Digits))
+	, MaxConcurrentBatches(FMath::Max(Config.UploadMaxConcurrentBatches, 1))
+	, Compression(Config.CompressionFormat, Config.CompressionThresholdBytes)
+	, Policy(MakePolicySettings(Config))
+{
+	check(IsInGameThread());
+	Policy.OnFlush(FPlatformTime::Seconds());
+	TickHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FCleverTapUploader::Tick), TickIntervalSeconds);
+}
+
+FCleverTapUploader::~FCleverTapUploader()
+{
+	check(IsInGameThread());
+	FTicker::GetCoreTicker().RemoveTicker(TickHandle);
+
+	// the offline store acknowledges in the order records were taken, so only the stored records of the leading
+	//  completed batches are acknowledged; those of every batch from the first unfinished one on stay in the store
+	//  and are read again by the next session. The records of unfinished batches that came from memory go back to the
+	//  head of the queue in the order they were taken
+	bool bLeading = true;
+	int32 NumAcknowledged = 0;
+	TArray<FCleverTapEventRecord> Unfinished;
+	for (const TUniquePtr<FBatch>& Batch : Batches)
+	{
+		if (Batch->Request.IsValid())
+		{
+			Batch->Request->OnProcessRequestComplete().Unbind();
+			Batch->Request->CancelRequest();
+			DEC_DWORD_STAT(STAT_CleverTapUploadsInFlight);
+		}
+		bLeading &= Batch->bCompleted;
+		if (bLeading)
+		{
+			NumAcknowledged += Batch->NumStored;
+		}
+		if (!Batch->bCompleted)
+		{
+			for (int32 Index = Batch->NumStored; Index < Batch->Records.Num(); ++Index)
+			{
+				Unfinished.Add(MoveTemp(Batch->Records[Index]));
+			}
+		}
+	}
+	Queue.Acknowledge(NumAcknowledged);
+	Queue.EnqueueFront(MoveTemp(Unfinished));
+}
+
+bool FCleverTapUploader::IsIdle() const
+{
+	return Batches.Num() == 0 && Queue.Num() == 0;
+}
+
+int32 FCleverTapUploader::GetNumInFlight() const
+{
+	int32 NumInFlight = 0;
+	for (const TUniquePtr<FBatch>& Batch : Batches)
+	{
+		NumInFlight += Batch->Request.IsValid() ? 1 : 0;
+	}
+	return NumInFlight;
+}
+
+bool FCleverTapUploader::Tick(float DeltaTime)
+{
+	CleverTapSDK::Ignore(DeltaTime);
+	const double NowSeconds = FPlatformTime::Seconds();
+	if (Policy.IsSuspended(NowSeconds))
+	{
+		return true;
+	}
+
+	// batches that failed, or that waited for earlier batches because they hold a login
+	for (const TUniquePtr<FBatch>& Batch : Batches)
+	{
+		if (!Batch->bCompleted && !Batch->Request.IsValid() && CanSend(*Batch) && !Policy.IsSuspended(NowSeconds))
+		{
+			Send(*Batch, NowSeconds);
+		}
+	}
+
+	while (CanTakeBatch() && Policy.ShouldFlush(NowSeconds, Queue.Num()))
+	{
+		FBatch& Batch = TakeBatch();
+		if (CanSend(Batch))
+		{
+			Send(Batch, NowSeconds);
+		}
+	}
+	return true;
+}
+
+bool FCleverTapUploader::CanTakeBatch() const
+{
+	return Batches.Num() < MaxConcurrentBatches
+		&& !Batches.ContainsByPredicate([](const TUniquePtr<FBatch>& Batch) { return Batch->bHasLogin; });
+}
+
+bool FCleverTapUploader::CanSend(const FBatch& Batch) const
+{
+	return !Batch.bHasLogin || Batches[0].Get() == &Batch;
+}
+
+FCleverTapUploader::FBatch& FCleverTapUploader::TakeBatch()
+{
+	CLEVERTAP_LLM_SCOPE();
+	FBatch& Batch = *Batches.Add_GetRef(MakeUnique<FBatch>());
+	Queue.DequeueUnacknowledged(Policy.GetBatchSize(), Batch.Records, Batch.NumStored);
+	Batch.Id = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+	Batch.Sequence = NextSequence++;
+	Batch.bHasLogin = Batch.Records.ContainsByPredicate(
+		[](const FCleverTapEventRecord& Record) { return Record.Type == ECleverTapEventRecordType::UserLogin; });
+
+	TArray<uint8> Json;
+	Batch.NumEvents = WriteUploadBody(Batch.Id, SessionId, Batch.Sequence, Batch.Records, Json);
+	Batch.UncompressedBytes = Json.Num();
+	Batch.Compression = Compression.Compress(Json, Batch.Body);
+	if (Batch.Compression == ECleverTapCompressionFormat::None)
+	{
+		Batch.Body = MoveTemp(Json);
+	}
+	return Batch;
+}
+
+void FCleverTapUploader::Send(FBatch& Batch, double NowSeconds)
+{
+	const FHttpRequestPtr Request = FHttpModule::Get().CreateRequest();
+	Request->SetURL(EndpointUrl);
+	Request->SetVerb(TEXT("POST"));
+	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+	Request->SetHeader(UploadProtocol::AccountIdHeader, AccountId);
+	Request->SetHeader(UploadProtocol::TokenHeader, Token);
+	if (Batch.Compression != ECleverTapCompressionFormat::None)
+	{
+		Request->SetHeader(UploadProtocol::CompressionHeader,
+			Batch.Compression == ECleverTapCompressionFormat::LZ4 ? TEXT("LZ4") : TEXT("Zlib"));
+		Request->SetHeader(UploadProtocol::UncompressedLengthHeader, FString::FromInt(Batch.UncompressedBytes));
+	}
+	Request->SetContent(Batch.Body);
+	Request->SetTimeout(RequestTimeoutSeconds);
+	Request->OnProcessRequestComplete().BindRaw(this, &FCleverTapUploader::HandleResponse);
+
+	Batch.Request = Request;
+	Batch.StartSeconds = NowSeconds;
+	Policy.OnFlush(NowSeconds);
+	INC_DWORD_STAT(STAT_CleverTapUploadsInFlight);
+
+	// some HTTP implementations report a request that fails to start through the delegate, others only return false
+	if (!Request->ProcessRequest() && Batch.Request == Request)
+	{
+		Request->OnProcessRequestComplete().Unbind();
+		Batch.Request.Reset();
+		DEC_DWORD_STAT(STAT_CleverTapUploadsInFlight);
+		Policy.OnUploadFailed(NowSeconds);
+	}
+}
+
+void FCleverTapUploader::HandleResponse(FHttpRequestPtr CompletedRequest, FHttpResponsePtr Response, bool bConnected)
+{
+	const int32 BatchIndex = Batches.IndexOfByPredicate(
+		[&CompletedRequest](const TUniquePtr<FBatch>& Batch) { return Batch->Request == CompletedRequest; });
+	if (BatchIndex == INDEX_NONE)
+	{
+		return;
+	}
+	FBatch& Batch = *Batches[BatchIndex];
+	Batch.Request.Reset();
+	DEC_DWORD_STAT(STAT_CleverTapUploadsInFlight);
+
+	const double NowSeconds = FPlatformTime::Seconds();
+	const double DurationSeconds = NowSeconds - Batch.StartSeconds;
+	const int32 ResponseCode = bConnected && Response.IsValid() ? Response->GetResponseCode() : 0;
+	if (ResponseCode >= 200 && ResponseCode < 300)
+	{
+		Policy.OnUploadSucceeded(DurationSeconds, Batch.Body.Num(), Batch.NumEvents);
+		INC_DWORD_STAT_BY(STAT_CleverTapUploadedEvents, Batch.NumEvents);
+		SET_FLOAT_STAT(STAT_CleverTapUploadRtt, float(Policy.GetRttSeconds() * 1000.0));
+		SET_DWORD_STAT(STAT_CleverTapUploadBatchSize, Policy.GetBatchSize());
+		UE_LOG(LogCleverTap, Verbose, TEXT("Uploaded batch %s with %d events in %.0f ms."), *Batch.Id,
+			Batch.NumEvents, DurationSeconds * 1000.0);
+		Batch.bCompleted = true;
+	}
+	else if (ResponseCode == 0 || IsRetryable(ResponseCode))
+	{
+		// the other batches in flight likely fail for the same reason, so only the first failure backs off
+		if (!Policy.IsSuspended(NowSeconds))
+		{
+			double RetryAfterSeconds = 0.0;
+			if (Response.IsValid())
+			{
+				LexFromString(RetryAfterSeconds, *Response->GetHeader(TEXT("Retry-After")));
+			}
+			Policy.OnUploadFailed(NowSeconds, RetryAfterSeconds);
+		}
+		INC_DWORD_STAT(STAT_CleverTapUploadFailures);
+		UE_LOG(LogCleverTap, Log, TEXT("Uploading batch %s failed (%d). Retrying after %d failures in a row."),
+			*Batch.Id, ResponseCode, Policy.GetNumConsecutiveFailures());
+	}
+	else
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("Batch %s with %d events was rejected by the endpoint (%d) and is dropped."),
+			*Batch.Id, Batch.NumEvents, ResponseCode);
+		INC_DWORD_STAT_BY(STAT_CleverTapDroppedEvents, Batch.NumEvents);
+		Batch.bCompleted = true;
+	}
+	ReleaseCompleted();
+}
+
+void FCleverTapUploader::ReleaseCompleted()
+{
+	int32 NumReleased = 0;
+	while (NumReleased < Batches.Num() && Batches[NumReleased]->bCompleted)
+	{
+		Queue.Acknowledge(Batches[NumReleased]->NumStored);
+		++NumReleased;
+	}
+	Batches.RemoveAt(0, NumReleased);
+}
+
+} // namespace CleverTapSDK
@@ -0,0 +1,97 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapCompression.h"
+#include "CleverTapEventRecord.h"
+#include "CleverTapFlushPolicy.h"
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+
+struct FCleverTapInstanceConfig;
+
+namespace CleverTapSDK {
+
+class FCleverTapEventQueue;
+
+/**
+ * Uploads the records buffered by the generic backend to UploadEndpointUrl in batches, as described in
+ *  CleverTapUploadProtocol.h. When and how much is sent is decided by an FCleverTapFlushPolicy.
+ *
+ * Up to UploadMaxConcurrentBatches batches are in flight at once, so throughput isn't capped at one batch per round
+ *  trip; the HTTP module reuses its connections to the endpoint across requests. A batch is taken off the queue when
+ *  it is sent and kept until the endpoint acknowledges or rejects it; failed batches are sent again with the same id
+ *  once the policy resumes uploads. Batches are acknowledged to the queue in the order they were taken, so the offline
+ *  store only deletes a segment once every batch holding its records is done. Batches holding a login are sent on
+ *  their own, which keeps the events of one user from overtaking those of another.
+ *
+ * Batches still in flight when the uploader is destroyed are cancelled. Their records that came from the offline store
+ *  stay there unacknowledged, and the others go back to the head of the queue in their original order, ahead of the
+ *  records enqueued meanwhile that are still in memory; with the SpillToDisk policy the next session reads them back
+ *  in that order. Records that spilled to the store while the batches were in flight are read before the records
+ *  put back, though, and the stored records of batches that completed behind an unfinished one can't be
+ *  acknowledged yet, so they are sent again by the next session.
+ *
+ * Runs on the game thread.
+ */
+class FCleverTapUploader
+{
+public:
+	FCleverTapUploader(FCleverTapEventQueue& InQueue, const FCleverTapInstanceConfig& Config);
+	~FCleverTapUploader();
+
+	FCleverTapUploader(const FCleverTapUploader&) = delete;
+	FCleverTapUploader& operator=(const FCleverTapUploader&) = delete;
+
+	/**
+	 * Whether every queued record has been uploaded.
+	 */
+	bool IsIdle() const;
+
+	int32 GetNumInFlight() const;
+	const FCleverTapFlushPolicy& GetPolicy() const { return Policy; }
+
+private:
+	struct FBatch
+	{
+		FString Id;
+		int32 Sequence = 0;
+		TArray<FCleverTapEventRecord> Records;
+		int32 NumStored = 0; // the leading records that are still in the offline store until acknowledged
+		int32 NumEvents = 0;
+		bool bHasLogin = false;
+
+		TArray<uint8> Body;
+		int32 UncompressedBytes = 0;
+		ECleverTapCompressionFormat Compression = ECleverTapCompressionFormat::None;
+
+		FHttpRequestPtr Request;
+		double StartSeconds = 0.0;
+		bool bCompleted = false;
+	};
+
+	bool Tick(float DeltaTime);
+	bool CanTakeBatch() const;
+	bool CanSend(const FBatch& Batch) const;
+	FBatch& TakeBatch();
+	void Send(FBatch& Batch, double NowSeconds);
+	void HandleResponse(FHttpRequestPtr CompletedRequest, FHttpResponsePtr Response, bool bConnected);
+	void ReleaseCompleted();
+
+	FCleverTapEventQueue& Queue;
+	const FString EndpointUrl;
+	const FString AccountId;
+	const FString Token;
+	const FString SessionId;
+	const int32 MaxConcurrentBatches;
+	const FCleverTapCompression Compression;
+	FCleverTapFlushPolicy Policy;
+
+	// in the order they were taken from the queue; completed batches are kept until all earlier ones complete
+	TArray<TUniquePtr<FBatch>> Batches;
+	int32 NextSequence = 0;
+
+	FDelegateHandle TickHandle;
+};
+
+} // namespace CleverTapSDK
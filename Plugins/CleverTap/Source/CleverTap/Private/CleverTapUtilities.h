@@ -1,6 +1,9 @@
 // Copyright CleverTap All Rights Reserved.
 #pragma once
 
+#include "CleverTapProperties.h"
+
+#include "Containers/StringConv.h"
 #include "Containers/UnrealString.h"
 #include "Math/Color.h"
 
@@ -28,4 +31,57 @@ FORCEINLINE FString ColorToHexString(const FColor& Color)
 	return FString::Printf(TEXT("#%02X%02X%02X"), Color.R, Color.G, Color.B);
 }
 
+/**
+ * Converts an aggregated number to a property value. Whole numbers, e.g. counts of occurrences, become integers as
+ *  they read better in the dashboard.
+ */
+inline FCleverTapPropertyValue NumberToPropertyValue(double Value)
+{
+	const double Whole = FMath::RoundToDouble(Value);
+	if (Whole == Value && FMath::Abs(Value) < double(MAX_int64 / 2))
+	{
+		return FCleverTapPropertyValue(int64(Whole));
+	}
+	return FCleverTapPropertyValue(Value);
+}
+
+/**
+ * Widens text that is known to be plain ASCII to an FString.
+ */
+inline FString AsciiToString(const uint8* Data, int32 Length)
+{
+	FString Result;
+	if (Length > 0)
+	{
+		TArray<TCHAR>& Chars = Result.GetCharArray();
+		Chars.SetNumUninitialized(Length + 1);
+		for (int32 Index = 0; Index < Length; ++Index)
+		{
+			Chars[Index] = TCHAR(Data[Index]);
+		}
+		Chars[Length] = TEXT('\0');
+	}
+	return Result;
+}
+
+/**
+ * Converts UTF-8 text to an FString. Plain ASCII, the common case for property keys and values, is widened directly
+ *  without going through the generic conversion.
+ */
+inline FString Utf8ToString(const uint8* Data, int32 Length)
+{
+	int32 AsciiLength = 0;
+	while (AsciiLength < Length && Data[AsciiLength] < 0x80)
+	{
+		++AsciiLength;
+	}
+
+	if (AsciiLength < Length)
+	{
+		FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Data), Length);
+		return FString(Converted.Length(), Converted.Get());
+	}
+	return AsciiToString(Data, Length);
+}
+
 } // namespace CleverTapSDK
@@ -0,0 +1,188 @@
+// Copyright CleverTap All Rights Reserved.
+#include "GenericPlatformCleverTapInstance.h"
+
+#include "CleverTapChargedItems.h"
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapLog.h"
+#include "CleverTapMemory.h"
+#include "CleverTapProfileShadow.h"
+#include "CleverTapUploader.h"
+#include "CleverTapUtilities.h"
+
+#include "CoreGlobals.h"
+#include "Misc/Paths.h"
+
+namespace CleverTapSDK { namespace GenericPlatform {
+
+namespace {
+
+bool UsesOfflineStore(const FCleverTapInstanceConfig& Config)
+{
+	return Config.BufferOverflowPolicy == ECleverTapBufferOverflowPolicy::SpillToDisk &&
+		Config.OfflineStoreMaxMegabytes > 0;
+}
+
+ECleverTapBufferOverflowPolicy GetOverflowPolicy(const FCleverTapInstanceConfig& Config)
+{
+	if (Config.BufferOverflowPolicy == ECleverTapBufferOverflowPolicy::SpillToDisk && !UsesOfflineStore(Config))
+	{
+		UE_LOG(LogCleverTap, Warning, TEXT("SpillToDisk requires OfflineStoreMaxMegabytes > 0. Using DropOldest."));
+		return ECleverTapBufferOverflowPolicy::DropOldest;
+	}
+	return Config.BufferOverflowPolicy;
+}
+
+TUniquePtr<FCleverTapOfflineStore> MakeOfflineStore(const FCleverTapInstanceConfig& Config)
+{
+	if (!UsesOfflineStore(Config))
+	{
+		return nullptr;
+	}
+	CLEVERTAP_LLM_SCOPE();
+	return MakeUnique<FCleverTapOfflineStore>(FPaths::ProjectSavedDir() / TEXT("CleverTap") / TEXT("OfflineStore"),
+		int64(Config.OfflineStoreMaxMegabytes) * 1024 * 1024,
+		FCleverTapCompression(Config.CompressionFormat, Config.CompressionThresholdBytes));
+}
+
+} // namespace
+
+FGenericPlatformCleverTapInstance::FGenericPlatformCleverTapInstance(const FCleverTapInstanceConfig& Config)
+	: FCleverTapMetricsInstance(Config)
+	, Queue(int64(Config.BufferBudgetKilobytes) * 1024, GetOverflowPolicy(Config), MakeOfflineStore(Config))
+{
+	if (Config.bSendProfileChangesOnly)
+	{
+		ProfileShadow = MakeUnique<FCleverTapProfileShadow>();
+	}
+	if (!Config.UploadEndpointUrl.IsEmpty())
+	{
+		CLEVERTAP_LLM_SCOPE();
+		Uploader = MakeUnique<FCleverTapUploader>(Queue, Config);
+	}
+}
+
+FGenericPlatformCleverTapInstance::~FGenericPlatformCleverTapInstance()
+{
+	FlushMetrics();
+}
+
+void FGenericPlatformCleverTapInstance::OnUserLogin(const FCleverTapProperties& Profile)
+{
+	EnqueueProperties(ECleverTapEventRecordType::UserLogin, FString{}, Profile);
+	ResetProfileShadow(Profile);
+}
+
+void FGenericPlatformCleverTapInstance::OnUserLogin(const FCleverTapProperties& Profile, const FString& CleverTapId)
+{
+	EnqueueProperties(ECleverTapEventRecordType::UserLogin, CleverTapId, Profile);
+	ResetProfileShadow(Profile);
+}
+
+void FGenericPlatformCleverTapInstance::PushProfile(const FCleverTapProperties& Profile)
+{
+	if (ProfileShadow)
+	{
+		const FCleverTapProperties ChangedFields = ProfileShadow->FilterChangedFields(Profile);
+		if (ChangedFields.Num() > 0)
+		{
+			EnqueueProperties(ECleverTapEventRecordType::ProfilePush, FString{}, ChangedFields);
+		}
+		return;
+	}
+	EnqueueProperties(ECleverTapEventRecordType::ProfilePush, FString{}, Profile);
+}
+
+void FGenericPlatformCleverTapInstance::PushEvent(const FString& EventName, const FCleverTapProperties& Actions)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const FCleverTapProperties* const Layers[] = { &Actions };
+	Queue.Enqueue(MakeRecordWithGlobals(ECleverTapEventRecordType::Event, EventName, Layers));
+}
+
+void FGenericPlatformCleverTapInstance::PushEvent(
+	const FString& EventName, const FCleverTapEventContextRef& Context, const FCleverTapProperties& Actions)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const FCleverTapProperties* const Layers[] = { &Context->GetProperties(), &Actions };
+	Queue.Enqueue(MakeRecordWithGlobals(ECleverTapEventRecordType::Event, EventName, Layers));
+}
+
+void FGenericPlatformCleverTapInstance::PushChargedEvent(
+	const FCleverTapProperties& ChargeDetails, const TArray<FCleverTapProperties>& Items)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const FCleverTapProperties* const Layers[] = { &ChargeDetails };
+	FCleverTapEventRecord Record = MakeRecordWithGlobals(ECleverTapEventRecordType::ChargedEvent, FString{}, Layers);
+	for (const FCleverTapProperties& Item : Items)
+	{
+		Record.AppendProperties(Item);
+	}
+	Queue.Enqueue(MoveTemp(Record));
+}
+
+void FGenericPlatformCleverTapInstance::PushChargedEvent(
+	const FCleverTapProperties& ChargeDetails, const FCleverTapChargedItems& Items)
+{
+	CLEVERTAP_LLM_SCOPE();
+	const FCleverTapProperties* const Layers[] = { &ChargeDetails };
+	FCleverTapEventRecord Record =
+		MakeRecordWithGlobals(ECleverTapEventRecordType::ChargedEventColumns, FString{}, Layers);
+	Record.AppendProperties(Items.GetColumns()); // expanded to items as the upload is written
+	Queue.Enqueue(MoveTemp(Record));
+}
+
+void FGenericPlatformCleverTapInstance::PromptForPushPermission(bool bFallbackToSettings)
+{
+	CleverTapSDK::Ignore(bFallbackToSettings);
+}
+
+void FGenericPlatformCleverTapInstance::PromptForPushPermission(
+	const FCleverTapPushPrimerAlertConfig& PushPrimerAlertConfig)
+{
+	CleverTapSDK::Ignore(PushPrimerAlertConfig);
+}
+
+void FGenericPlatformCleverTapInstance::PromptForPushPermission(
+	const FCleverTapPushPrimerHalfInterstitialConfig& PushPrimerHalfInterstitialConfig)
+{
+	CleverTapSDK::Ignore(PushPrimerHalfInterstitialConfig);
+}
+
+void FGenericPlatformCleverTapInstance::EnqueueProperties(
+	ECleverTapEventRecordType Type, const FString& Name, const FCleverTapProperties& Properties)
+{
+	CLEVERTAP_LLM_SCOPE();
+	FCleverTapEventRecord Record = FCleverTapEventRecord::Make(Type, Name);
+	Record.AppendProperties(Properties);
+	Queue.Enqueue(MoveTemp(Record));
+}
+
+FCleverTapEventRecord FGenericPlatformCleverTapInstance::MakeRecordWithGlobals(
+	ECleverTapEventRecordType Type, const FString& Name, TArrayView<const FCleverTapProperties* const> Layers)
+{
+	// without an uploader there are no batches, so providers are evaluated once per frame as on the other platforms
+	const uint64 ProviderEpoch = Uploader ? Queue.GetNumDequeues() : GFrameCounter;
+	const TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Globals = GlobalProperties.ResolveEncoded(ProviderEpoch);
+
+	FCleverTapEventRecord Record = FCleverTapEventRecord::Make(Type, Name);
+	Record.AppendProperties(Globals.IsValid() ? TArrayView<const uint8>(*Globals) : TArrayView<const uint8>(), Layers);
+	return Record;
+}
+
+void FGenericPlatformCleverTapInstance::ResetProfileShadow(const FCleverTapProperties& LoginProfile)
+{
+	if (ProfileShadow)
+	{
+		ProfileShadow->Reset(LoginProfile);
+	}
+}
+
+void FGenericPlatformCleverTapInstance::InvalidateProfileShadow(const FString& Key)
+{
+	if (ProfileShadow)
+	{
+		ProfileShadow->Invalidate(Key);
+	}
+}
+
+}} // namespace CleverTapSDK::GenericPlatform
@@ -0,0 +1,117 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapEventQueue.h"
+#include "CleverTapGlobalProperties.h"
+#include "CleverTapMetricsInstance.h"
+
+#include "CoreMinimal.h"
+
+struct FCleverTapInstanceConfig;
+
+namespace CleverTapSDK {
+
+class FCleverTapProfileShadow;
+class FCleverTapUploader;
+
+namespace GenericPlatform {
+
+/**
+ * The instance for platforms without a CleverTap SDK. Events and profile updates are buffered as records in a queue
+ *  bounded by the configured byte budget and, when UploadEndpointUrl is set, uploaded from there; everything else
+ *  behaves like the null instance.
+ */
+class FGenericPlatformCleverTapInstance : public FCleverTapMetricsInstance
+{
+public:
+	explicit FGenericPlatformCleverTapInstance(const FCleverTapInstanceConfig& Config);
+	~FGenericPlatformCleverTapInstance();
+
+	// Records are encoded as they are enqueued, so moving payloads in gains nothing over the copying overloads
+	using ICleverTapInstance::OnUserLogin;
+	using ICleverTapInstance::PushChargedEvent;
+	using ICleverTapInstance::PushEvent;
+	using ICleverTapInstance::PushProfile;
+
+	FString GetCleverTapId() override { return FString{}; }
+
+	void OnUserLogin(const FCleverTapProperties& Profile) override;
+	void OnUserLogin(const FCleverTapProperties& Profile, const FString& CleverTapId) override;
+	void PushProfile(const FCleverTapProperties& Profile) override;
+
+	void PushEvent(const FString& EventName) override { PushEvent(EventName, FCleverTapProperties{}); }
+	void PushEvent(const FString& EventName, const FCleverTapProperties& Actions) override;
+	void PushEvent(const FString& EventName, const FCleverTapEventContextRef& Context,
+		const FCleverTapProperties& Actions) override;
+	void PushChargedEvent(
+		const FCleverTapProperties& ChargeDetails, const TArray<FCleverTapProperties>& Items) override;
+	void PushChargedEvent(const FCleverTapProperties& ChargeDetails, const FCleverTapChargedItems& Items) override;
+
+	void SetEventContext(FCleverTapEventContextPtr Context) override
+	{
+		GlobalProperties.SetEventContext(MoveTemp(Context));
+	}
+
+	FCleverTapEventContextPtr GetEventContext() const override { return GlobalProperties.GetEventContext(); }
+
+	void SetGlobalProperty(const FString& Key, FCleverTapPropertyValue Value) override
+	{
+		GlobalProperties.SetProperty(Key, MoveTemp(Value));
+	}
+
+	void RemoveGlobalProperty(const FString& Key) override { GlobalProperties.RemoveProperty(Key); }
+
+	FDelegateHandle AddGlobalPropertyProvider(FCleverTapGlobalPropertyProvider Provider) override
+	{
+		return GlobalProperties.AddProvider(MoveTemp(Provider));
+	}
+
+	void RemoveGlobalPropertyProvider(FDelegateHandle Handle) override { GlobalProperties.RemoveProvider(Handle); }
+
+	void DecrementValue(const FString& Key, int Amount) override { EnqueueIncrement(Key, -Amount); }
+	void DecrementValue(const FString& Key, double Amount) override { EnqueueIncrement(Key, -Amount); }
+	void IncrementValue(const FString& Key, int Amount) override { EnqueueIncrement(Key, Amount); }
+	void IncrementValue(const FString& Key, double Amount) override { EnqueueIncrement(Key, Amount); }
+
+	void IsPushPermissionGrantedAsync(TFunction<void(bool)> Callback) override { Callback(false); }
+	void PromptForPushPermission(bool bFallbackToSettings) override;
+	void PromptForPushPermission(const FCleverTapPushPrimerAlertConfig& PushPrimerAlertConfig) override;
+	void PromptForPushPermission(
+		const FCleverTapPushPrimerHalfInterstitialConfig& PushPrimerHalfInterstitialConfig) override;
+
+	/**
+	 * The buffered records and the uploader, null without an UploadEndpointUrl, for tests to inspect what the
+	 *  instance enqueued and sent.
+	 */
+	FCleverTapEventQueue& GetQueue() { return Queue; }
+	const FCleverTapEventQueue& GetQueue() const { return Queue; }
+	const FCleverTapUploader* GetUploader() const { return Uploader.Get(); }
+
+private:
+	void EnqueueProperties(ECleverTapEventRecordType Type, const FString& Name, const FCleverTapProperties& Properties);
+
+	template <typename T> void EnqueueIncrement(const FString& Key, T Amount)
+	{
+		FCleverTapProperties Properties;
+		Properties.Add(TEXT("Amount"), Amount);
+		EnqueueProperties(ECleverTapEventRecordType::ProfileIncrement, Key, Properties);
+		InvalidateProfileShadow(Key);
+	}
+
+	/**
+	 * Makes a record whose first property set is the resolved global properties overridden by each of Layers.
+	 */
+	FCleverTapEventRecord MakeRecordWithGlobals(
+		ECleverTapEventRecordType Type, const FString& Name, TArrayView<const FCleverTapProperties* const> Layers);
+	void ResetProfileShadow(const FCleverTapProperties& LoginProfile);
+	void InvalidateProfileShadow(const FString& Key);
+
+	FCleverTapGlobalProperties GlobalProperties;
+	FCleverTapEventQueue Queue;
+	TUniquePtr<FCleverTapProfileShadow> ProfileShadow;
+	TUniquePtr<FCleverTapUploader> Uploader; // destroyed before the queue it returns unacknowledged records to
+};
+
+} // namespace GenericPlatform
+
+} // namespace CleverTapSDK
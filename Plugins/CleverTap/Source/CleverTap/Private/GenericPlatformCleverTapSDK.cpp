@@ -1,9 +1,9 @@
 // Copyright CleverTap All Rights Reserved.
 #include "GenericPlatformCleverTapSDK.h"
 
-#include "CleverTapInstanceConfig.h"
+#include "CleverTapStartupProfiler.h"
 #include "CleverTapUtilities.h"
-#include "NullCleverTapInstance.h"
+#include "GenericPlatformCleverTapInstance.h"
 
 namespace CleverTapSDK { namespace GenericPlatform {
 
@@ -14,15 +14,16 @@ void FGenericPlatformSDK::SetLogLevel(ECleverTapLogLevel Level)
 
 TUniquePtr<ICleverTapInstance> FGenericPlatformSDK::InitializeSharedInstance(const FCleverTapInstanceConfig& Config)
 {
-	CleverTapSDK::Ignore(Config);
-	return MakeUnique<FNullCleverTapInstance>();
+	CLEVERTAP_STARTUP_SCOPE("GetDefaultInstance");
+	return MakeUnique<FGenericPlatformCleverTapInstance>(Config);
 }
 
 TUniquePtr<ICleverTapInstance> FGenericPlatformSDK::InitializeSharedInstance(
 	const FCleverTapInstanceConfig& Config, const FString& CleverTapId)
 {
-	CleverTapSDK::Ignore(Config, CleverTapId);
-	return MakeUnique<FNullCleverTapInstance>();
+	CleverTapSDK::Ignore(CleverTapId);
+	CLEVERTAP_STARTUP_SCOPE("GetDefaultInstance");
+	return MakeUnique<FGenericPlatformCleverTapInstance>(Config);
 }
 
 }} // namespace CleverTapSDK::GenericPlatform
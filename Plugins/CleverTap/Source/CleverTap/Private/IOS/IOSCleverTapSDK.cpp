@@ -1,11 +1,21 @@
 // Copyright CleverTap All Rights Reserved.
 #include "IOS/IOSCleverTapSDK.h"
 
+#include "CleverTapChargedItems.h"
+#include "CleverTapEventContext.h"
+#include "CleverTapGlobalProperties.h"
+#include "CleverTapIdCache.h"
 #include "CleverTapInstance.h"
 #include "CleverTapInstanceConfig.h"
+#include "CleverTapJsonWriter.h"
 #include "CleverTapLog.h"
+#include "CleverTapMetricsInstance.h"
+#include "CleverTapProfileShadow.h"
+#include "CleverTapStartupProfiler.h"
 #include "CleverTapUtilities.h"
 
+#include "Misc/ScopeLock.h"
+
 #import <CleverTapSDK/CleverTap.h>
 #import <CleverTapSDK/CTLocalInApp.h>
 
@@ -54,9 +64,11 @@ NSArray* ConvertToNSArray(const TArray<T>& Values)
 	return ObjCValues;
 }
 
-NSDictionary* ConvertToNSDictionary(const FCleverTapProperties& Properties)
+// Converts properties to a new dictionary. If Base is set the result starts as a copy of it, so the converted
+// properties take precedence over its entries.
+NSDictionary* ConvertToNSDictionary(const FCleverTapProperties& Properties, NSDictionary* Base = nil)
 {
-	NSMutableDictionary* result = [[NSMutableDictionary alloc] init];
+	NSMutableDictionary* result = Base != nil ? [Base mutableCopy] : [[NSMutableDictionary alloc] init];
 
 	for (const FCleverTapProperties::ElementType& Entry : Properties)
 	{
@@ -165,12 +177,70 @@ NSArray* ConvertToNSArray(const TArray<FCleverTapProperties>& Items)
 	return result;
 }
 
-class FIOSCleverTapInstance : public ICleverTapInstance
+template <typename T>
+void AddColumnToNSDictionaries(NSString* Key, const TArray<T>& Values, NSArray<NSMutableDictionary*>* Items)
+{
+	NSArray* Column = ConvertToNSArray(Values);
+	[Items enumerateObjectsUsingBlock:^(NSMutableDictionary* Item, NSUInteger Index, BOOL* Stop) {
+		Item[Key] = Column[Index];
+	}];
+}
+
+NSArray* ConvertToNSArray(const FCleverTapChargedItems& Items)
+{
+	NSMutableArray<NSMutableDictionary*>* result = [NSMutableArray arrayWithCapacity:Items.Num()];
+	for (int32 Index = 0; Index < Items.Num(); ++Index)
+	{
+		[result addObject:[NSMutableDictionary dictionaryWithCapacity:Items.GetColumns().Num()]];
+	}
+
+	// each column is converted to an NSArray in one go and then distributed over the items
+	for (const TPair<FString, FCleverTapPropertyValue>& Column : Items.GetColumns())
+	{
+		NSString* Key = Column.Key.GetNSString();
+		const FCleverTapPropertyValue& Values = Column.Value;
+		switch (Values.GetIndex())
+		{
+			case FCleverTapPropertyValue::IndexOfType<TArray<int32>>():
+				AddColumnToNSDictionaries(Key, Values.Get<TArray<int32>>(), result);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<int64>>():
+				AddColumnToNSDictionaries(Key, Values.Get<TArray<int64>>(), result);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<float>>():
+				AddColumnToNSDictionaries(Key, Values.Get<TArray<float>>(), result);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<double>>():
+				AddColumnToNSDictionaries(Key, Values.Get<TArray<double>>(), result);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<bool>>():
+				AddColumnToNSDictionaries(Key, Values.Get<TArray<bool>>(), result);
+				break;
+			case FCleverTapPropertyValue::IndexOfType<TArray<FString>>():
+				AddColumnToNSDictionaries(Key, Values.Get<TArray<FString>>(), result);
+				break;
+		}
+	}
+
+	return result;
+}
+
+class FIOSCleverTapInstance : public CleverTapSDK::FCleverTapMetricsInstance
 {
 public:
-	explicit FIOSCleverTapInstance(CleverTap* InNativeInstance)
-		: NativeInstance{ InNativeInstance }, SDKListener{ [[CleverTapSDKListener alloc] initWithCppInstance:this] }
+	FIOSCleverTapInstance(CleverTap* InNativeInstance, const FCleverTapInstanceConfig& Config)
+		: CleverTapSDK::FCleverTapMetricsInstance{ Config }
+		, NativeInstance{ InNativeInstance }
+		, SDKListener{ [[CleverTapSDKListener alloc] initWithCppInstance:this] }
+		, IdCache{ MakeShared<CleverTapSDK::FCleverTapIdCache, ESPMode::ThreadSafe>(
+			  [this]() { return FString{ [NativeInstance profileGetCleverTapID] }; },
+			  [this](const FString& CleverTapId) { OnCleverTapIdChanged.Broadcast(CleverTapId); }) }
 	{
+		if (Config.bSendProfileChangesOnly)
+		{
+			ProfileShadow = MakeUnique<CleverTapSDK::FCleverTapProfileShadow>();
+		}
+
 		if (NativeInstance != nil)
 		{
 			// TODO: Not exposed
@@ -178,57 +248,142 @@ public:
 		}
 	}
 
-	~FIOSCleverTapInstance() { [SDKListener release]; }
+	~FIOSCleverTapInstance()
+	{
+		FlushMetrics();
+
+		[SDKListener release];
+		[NativeEventContext release];
+		[NativeCallContext release];
+	}
+
+	// The bridge converts payloads to native objects synchronously, so moving them in gains nothing over the copying
+	//  overloads; pull in the forwarding rvalue overloads rather than hiding them
+	using ICleverTapInstance::OnUserLogin;
+	using ICleverTapInstance::PushChargedEvent;
+	using ICleverTapInstance::PushEvent;
+	using ICleverTapInstance::PushProfile;
 
 	// <ICleverTapInstance>
-	FString GetCleverTapId() override { return FString{ [NativeInstance profileGetCleverTapID] }; }
+	FString GetCleverTapId() override { return IdCache->Get(); }
 
 	void OnUserLogin(const FCleverTapProperties& Profile) override
 	{
 		[NativeInstance onUserLogin:ConvertToNSDictionary(Profile)];
+		IdCache->Invalidate();
+		ResetProfileShadow(Profile);
 	}
 
 	void OnUserLogin(const FCleverTapProperties& Profile, const FString& CleverTapId) override
 	{
 		[NativeInstance onUserLogin:ConvertToNSDictionary(Profile) withCleverTapID:CleverTapId.GetNSString()];
+		IdCache->Invalidate();
+		ResetProfileShadow(Profile);
 	}
 
 	void PushProfile(const FCleverTapProperties& Profile) override
 	{
+		if (ProfileShadow)
+		{
+			const FCleverTapProperties ChangedFields = ProfileShadow->FilterChangedFields(Profile);
+			if (ChangedFields.Num() > 0)
+			{
+				[NativeInstance profilePush:ConvertToNSDictionary(ChangedFields)];
+			}
+			return;
+		}
 		[NativeInstance profilePush:ConvertToNSDictionary(Profile)];
 	}
 
-	void PushEvent(const FString& EventName) override { [NativeInstance recordEvent:EventName.GetNSString()]; }
+	void PushEvent(const FString& EventName) override
+	{
+		if (NSDictionary* Context = RetainEventContext())
+		{
+			[NativeInstance recordEvent:EventName.GetNSString() withProps:Context];
+			[Context release];
+			return;
+		}
+		[NativeInstance recordEvent:EventName.GetNSString()];
+	}
 
 	void PushEvent(const FString& EventName, const FCleverTapProperties& Actions) override
 	{
-		[NativeInstance recordEvent:EventName.GetNSString() withProps:ConvertToNSDictionary(Actions)];
+		CLEVERTAP_LOG_PAYLOAD(
+			TEXT("EventName: '%s', Actions: %s"), *EventName, *FCleverTapJsonWriter::ToString(Actions));
+		PushEventWithContext(EventName, Actions, RetainEventContext());
+	}
+
+	void PushEvent(const FString& EventName, const FCleverTapEventContextRef& Context,
+		const FCleverTapProperties& Actions) override
+	{
+		CLEVERTAP_LOG_PAYLOAD(
+			TEXT("EventName: '%s', Actions: %s"), *EventName, *FCleverTapJsonWriter::ToString(Actions));
+		PushEventWithContext(EventName, Actions, RetainCallContext(Context));
 	}
 
 	void PushChargedEvent(const FCleverTapProperties& ChargeDetails, const TArray<FCleverTapProperties>& Items) override
 	{
-		[NativeInstance recordChargedEventWithDetails:ConvertToNSDictionary(ChargeDetails)
+		CLEVERTAP_LOG_PAYLOAD(TEXT("ChargeDetails: %s, Items: %d"), *FCleverTapJsonWriter::ToString(ChargeDetails),
+			Items.Num());
+		NSDictionary* Context = RetainEventContext();
+		[NativeInstance recordChargedEventWithDetails:ConvertToNSDictionary(ChargeDetails, Context)
 											 andItems:ConvertToNSArray(Items)];
+		[Context release];
 	}
 
+	void PushChargedEvent(const FCleverTapProperties& ChargeDetails, const FCleverTapChargedItems& Items) override
+	{
+		CLEVERTAP_LOG_PAYLOAD(TEXT("ChargeDetails: %s, Items: %d"), *FCleverTapJsonWriter::ToString(ChargeDetails),
+			Items.Num());
+		NSDictionary* Context = RetainEventContext();
+		[NativeInstance recordChargedEventWithDetails:ConvertToNSDictionary(ChargeDetails, Context)
+											 andItems:ConvertToNSArray(Items)];
+		[Context release];
+	}
+
+	void SetEventContext(FCleverTapEventContextPtr Context) override
+	{
+		GlobalProperties.SetEventContext(MoveTemp(Context));
+	}
+
+	FCleverTapEventContextPtr GetEventContext() const override { return GlobalProperties.GetEventContext(); }
+
+	void SetGlobalProperty(const FString& Key, FCleverTapPropertyValue Value) override
+	{
+		GlobalProperties.SetProperty(Key, MoveTemp(Value));
+	}
+
+	void RemoveGlobalProperty(const FString& Key) override { GlobalProperties.RemoveProperty(Key); }
+
+	FDelegateHandle AddGlobalPropertyProvider(FCleverTapGlobalPropertyProvider Provider) override
+	{
+		return GlobalProperties.AddProvider(MoveTemp(Provider));
+	}
+
+	void RemoveGlobalPropertyProvider(FDelegateHandle Handle) override { GlobalProperties.RemoveProvider(Handle); }
+
 	void DecrementValue(const FString& Key, int Amount) override
 	{
 		[NativeInstance profileDecrementValueBy:[NSNumber numberWithInt:Amount] forKey:Key.GetNSString()];
+		InvalidateProfileField(Key);
 	}
 
 	void DecrementValue(const FString& Key, double Amount) override
 	{
 		[NativeInstance profileDecrementValueBy:[NSNumber numberWithDouble:Amount] forKey:Key.GetNSString()];
+		InvalidateProfileField(Key);
 	}
 
 	void IncrementValue(const FString& Key, int Amount) override
 	{
 		[NativeInstance profileIncrementValueBy:[NSNumber numberWithInt:Amount] forKey:Key.GetNSString()];
+		InvalidateProfileField(Key);
 	}
 
 	void IncrementValue(const FString& Key, double Amount) override
 	{
 		[NativeInstance profileIncrementValueBy:[NSNumber numberWithDouble:Amount] forKey:Key.GetNSString()];
+		InvalidateProfileField(Key);
 	}
 
 	void IsPushPermissionGrantedAsync(TFunction<void(bool)> Callback) override
@@ -305,8 +460,88 @@ public:
 	// </ICleverTapInstance>
 
 private:
+	// Converts the resolved global properties to a dictionary if they changed since the last conversion. Must be
+	// called with EventContextLock held.
+	void UpdateNativeEventContext(FCleverTapEventContextPtr&& Resolved)
+	{
+		if (ConvertedEventContext.Get() != Resolved.Get())
+		{
+			const bool bHasProperties = Resolved.IsValid() && Resolved->Num() > 0;
+			[NativeEventContext release];
+			NativeEventContext = bHasProperties ? ConvertToNSDictionary(Resolved->GetProperties()) : nil;
+			ConvertedEventContext = MoveTemp(Resolved);
+		}
+	}
+
+	// Returns the dictionary of the global properties retained for the caller, or nil if there are none
+	NSDictionary* RetainEventContext()
+	{
+		FCleverTapEventContextPtr Resolved = GlobalProperties.Resolve();
+
+		FScopeLock Lock(&EventContextLock);
+		UpdateNativeEventContext(MoveTemp(Resolved));
+		return [NativeEventContext retain];
+	}
+
+	// Returns the dictionary of a call context merged over the global properties, retained for the caller. The
+	// dictionary of the most recent call context is cached, so pushing events with the same context converts it once.
+	NSDictionary* RetainCallContext(const FCleverTapEventContextRef& Context)
+	{
+		FCleverTapEventContextPtr Resolved = GlobalProperties.Resolve();
+
+		FScopeLock Lock(&EventContextLock);
+		UpdateNativeEventContext(MoveTemp(Resolved));
+		if (CallContext.Get() != &Context.Get() || CallContextBase.Get() != ConvertedEventContext.Get())
+		{
+			CallContext = Context;
+			CallContextBase = ConvertedEventContext;
+			[NativeCallContext release];
+			NativeCallContext = ConvertToNSDictionary(Context->GetProperties(), NativeEventContext);
+		}
+		return [NativeCallContext retain];
+	}
+
+	// Pushes an event whose properties are merged over a context dictionary; releases the context
+	void PushEventWithContext(const FString& EventName, const FCleverTapProperties& Actions, NSDictionary* Context)
+	{
+		[NativeInstance recordEvent:EventName.GetNSString() withProps:ConvertToNSDictionary(Actions, Context)];
+		[Context release];
+	}
+
+	void ResetProfileShadow(const FCleverTapProperties& LoginProfile)
+	{
+		if (ProfileShadow)
+		{
+			ProfileShadow->Reset(LoginProfile);
+		}
+	}
+
+	void InvalidateProfileField(const FString& Key)
+	{
+		if (ProfileShadow)
+		{
+			ProfileShadow->Invalidate(Key);
+		}
+	}
+
 	CleverTap* NativeInstance{};
 	CleverTapSDKListener* SDKListener{};
+	TSharedRef<CleverTapSDK::FCleverTapIdCache, ESPMode::ThreadSafe> IdCache;
+
+	// last pushed profile fields, only set when PushProfile() sends changed fields only
+	TUniquePtr<CleverTapSDK::FCleverTapProfileShadow> ProfileShadow;
+
+	// event context, global properties and providers, resolved into a single context per change
+	CleverTapSDK::FCleverTapGlobalProperties GlobalProperties;
+
+	// dictionaries of the resolved global properties and of the most recent call context merged over them, converted
+	// once per change
+	FCriticalSection EventContextLock;
+	FCleverTapEventContextPtr ConvertedEventContext;
+	NSDictionary* NativeEventContext{};
+	FCleverTapEventContextPtr CallContext;
+	FCleverTapEventContextPtr CallContextBase;
+	NSDictionary* NativeCallContext{};
 };
 
 } // namespace
@@ -333,6 +568,7 @@ namespace CleverTapSDK { namespace IOS {
 
 void FPlatformSDK::SetLogLevel(ECleverTapLogLevel Level)
 {
+	CLEVERTAP_STARTUP_SCOPE("SetDebugLevel");
 	int const ObjCLevel = [Level] {
 		switch (Level)
 		{
@@ -364,10 +600,17 @@ TUniquePtr<ICleverTapInstance> FPlatformSDK::InitializeSharedInstance(const FCle
 	NSString* AccountId = Config.ProjectId.GetNSString();
 	NSString* Token = Config.ProjectToken.GetNSString();
 	NSString* Region = Config.RegionCode.GetNSString();
-	[CleverTap setCredentialsWithAccountID:AccountId token:Token region:Region];
+	{
+		CLEVERTAP_STARTUP_SCOPE("SetDefaultConfig");
+		[CleverTap setCredentialsWithAccountID:AccountId token:Token region:Region];
+	}
 
-	CleverTap* const SharedInst = [CleverTap sharedInstance];
-	return MakeUnique<FIOSCleverTapInstance>(SharedInst);
+	CleverTap* SharedInst = nil;
+	{
+		CLEVERTAP_STARTUP_SCOPE("GetDefaultInstance");
+		SharedInst = [CleverTap sharedInstance];
+	}
+	return MakeUnique<FIOSCleverTapInstance>(SharedInst, Config);
 }
 
 TUniquePtr<ICleverTapInstance> FPlatformSDK::InitializeSharedInstance(
@@ -378,10 +621,17 @@ TUniquePtr<ICleverTapInstance> FPlatformSDK::InitializeSharedInstance(
 	NSString* AccountId = Config.ProjectId.GetNSString();
 	NSString* Token = Config.ProjectToken.GetNSString();
 	NSString* Region = Config.RegionCode.GetNSString();
-	[CleverTap setCredentialsWithAccountID:AccountId token:Token region:Region];
+	{
+		CLEVERTAP_STARTUP_SCOPE("SetDefaultConfig");
+		[CleverTap setCredentialsWithAccountID:AccountId token:Token region:Region];
+	}
 
-	CleverTap* const SharedInst = [CleverTap sharedInstanceWithCleverTapID:CleverTapId.GetNSString()];
-	return MakeUnique<FIOSCleverTapInstance>(SharedInst);
+	CleverTap* SharedInst = nil;
+	{
+		CLEVERTAP_STARTUP_SCOPE("GetDefaultInstance");
+		SharedInst = [CleverTap sharedInstanceWithCleverTapID:CleverTapId.GetNSString()];
+	}
+	return MakeUnique<FIOSCleverTapInstance>(SharedInst, Config);
 }
 
 }} // namespace CleverTapSDK::IOS
@@ -18,11 +18,26 @@ void FNullCleverTapInstance::OnUserLogin(const FCleverTapProperties& Profile, co
 	CleverTapSDK::Ignore(Profile, CleverTapId);
 }
 
+void FNullCleverTapInstance::OnUserLogin(FCleverTapProperties&& Profile)
+{
+	CleverTapSDK::Ignore(Profile);
+}
+
+void FNullCleverTapInstance::OnUserLogin(FCleverTapProperties&& Profile, FString&& CleverTapId)
+{
+	CleverTapSDK::Ignore(Profile, CleverTapId);
+}
+
 void FNullCleverTapInstance::PushProfile(const FCleverTapProperties& Profile)
 {
 	CleverTapSDK::Ignore(Profile);
 }
 
+void FNullCleverTapInstance::PushProfile(FCleverTapProperties&& Profile)
+{
+	CleverTapSDK::Ignore(Profile);
+}
+
 void FNullCleverTapInstance::PushEvent(const FString& EventName)
 {
 	CleverTapSDK::Ignore(EventName);
@@ -39,6 +54,65 @@ void FNullCleverTapInstance::PushChargedEvent(
 	CleverTapSDK::Ignore(ChargeDetails, Items);
 }
 
+void FNullCleverTapInstance::PushEvent(FString&& EventName)
+{
+	CleverTapSDK::Ignore(EventName);
+}
+
+void FNullCleverTapInstance::PushEvent(FString&& EventName, FCleverTapProperties&& Actions)
+{
+	CleverTapSDK::Ignore(EventName, Actions);
+}
+
+void FNullCleverTapInstance::PushChargedEvent(
+	FCleverTapProperties&& ChargeDetails, TArray<FCleverTapProperties>&& Items)
+{
+	CleverTapSDK::Ignore(ChargeDetails, Items);
+}
+
+void FNullCleverTapInstance::PushChargedEvent(
+	const FCleverTapProperties& ChargeDetails, const FCleverTapChargedItems& Items)
+{
+	CleverTapSDK::Ignore(ChargeDetails, Items);
+}
+
+void FNullCleverTapInstance::PushEvent(
+	const FString& EventName, const FCleverTapEventContextRef& Context, const FCleverTapProperties& Actions)
+{
+	CleverTapSDK::Ignore(EventName, Context, Actions);
+}
+
+void FNullCleverTapInstance::SetEventContext(FCleverTapEventContextPtr Context)
+{
+	EventContext = MoveTemp(Context);
+}
+
+FCleverTapEventContextPtr FNullCleverTapInstance::GetEventContext() const
+{
+	return EventContext;
+}
+
+void FNullCleverTapInstance::SetGlobalProperty(const FString& Key, FCleverTapPropertyValue Value)
+{
+	CleverTapSDK::Ignore(Key, Value);
+}
+
+void FNullCleverTapInstance::RemoveGlobalProperty(const FString& Key)
+{
+	CleverTapSDK::Ignore(Key);
+}
+
+FDelegateHandle FNullCleverTapInstance::AddGlobalPropertyProvider(FCleverTapGlobalPropertyProvider Provider)
+{
+	CleverTapSDK::Ignore(Provider);
+	return FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+}
+
+void FNullCleverTapInstance::RemoveGlobalPropertyProvider(FDelegateHandle Handle)
+{
+	CleverTapSDK::Ignore(Handle);
+}
+
 void FNullCleverTapInstance::DecrementValue(const FString& Key, int Amount)
 {
 	CleverTapSDK::Ignore(Key, Amount);
@@ -1,25 +1,42 @@
 // Copyright CleverTap All Rights Reserved.
 #pragma once
 
-#include "CleverTapInstance.h"
+#include "CleverTapMetricsInstance.h"
 
 /**
- * A CleverTap instance implementation that does nothing and returns default values.
+ * A CleverTap instance implementation that does nothing and returns default values. Its metrics aggregate nothing
+ *  either, as it is made without a config.
  */
-class FNullCleverTapInstance : public ICleverTapInstance
+class FNullCleverTapInstance : public CleverTapSDK::FCleverTapMetricsInstance
 {
 public:
 	FString GetCleverTapId() override;
 
 	void OnUserLogin(const FCleverTapProperties& Profile) override;
 	void OnUserLogin(const FCleverTapProperties& Profile, const FString& CleverTapId) override;
+	void OnUserLogin(FCleverTapProperties&& Profile) override;
+	void OnUserLogin(FCleverTapProperties&& Profile, FString&& CleverTapId) override;
 
 	void PushProfile(const FCleverTapProperties& Profile) override;
+	void PushProfile(FCleverTapProperties&& Profile) override;
 
 	void PushEvent(const FString& EventName) override;
 	void PushEvent(const FString& EventName, const FCleverTapProperties& Actions) override;
 	void PushChargedEvent(
 		const FCleverTapProperties& ChargeDetails, const TArray<FCleverTapProperties>& Items) override;
+	void PushEvent(FString&& EventName) override;
+	void PushEvent(FString&& EventName, FCleverTapProperties&& Actions) override;
+	void PushChargedEvent(FCleverTapProperties&& ChargeDetails, TArray<FCleverTapProperties>&& Items) override;
+	void PushChargedEvent(const FCleverTapProperties& ChargeDetails, const FCleverTapChargedItems& Items) override;
+	void PushEvent(const FString& EventName, const FCleverTapEventContextRef& Context,
+		const FCleverTapProperties& Actions) override;
+
+	void SetEventContext(FCleverTapEventContextPtr Context) override;
+	FCleverTapEventContextPtr GetEventContext() const override;
+	void SetGlobalProperty(const FString& Key, FCleverTapPropertyValue Value) override;
+	void RemoveGlobalProperty(const FString& Key) override;
+	FDelegateHandle AddGlobalPropertyProvider(FCleverTapGlobalPropertyProvider Provider) override;
+	void RemoveGlobalPropertyProvider(FDelegateHandle Handle) override;
 
 	void DecrementValue(const FString& Key, int Amount) override;
 	void DecrementValue(const FString& Key, double Amount) override;
@@ -32,4 +49,7 @@ public:
 	void PromptForPushPermission(const FCleverTapPushPrimerAlertConfig& PushPrimerAlertConfig) override;
 	void PromptForPushPermission(
 		const FCleverTapPushPrimerHalfInterstitialConfig& PushPrimerHalfInterstitialConfig) override;
+
+private:
+	FCleverTapEventContextPtr EventContext;
 };
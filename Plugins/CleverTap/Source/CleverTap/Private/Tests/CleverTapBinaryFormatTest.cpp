@@ -0,0 +1,231 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapBinaryFormat.h"
+#include "CleverTapJsonReader.h"
+#include "CleverTapJsonWriter.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+const int64 Int64s[] = { MAX_int64, MIN_int64, int64(1) << 40 };
+const double Doubles[] = { 0.1, 1.0 / 3.0, 123456789.125, 1e300, -2.2250738585072014e-308 };
+const float Floats[] = { 0.1f, 1.0f / 3.0f, 16777216.0f, 3.40282347e38f, -1.17549435e-38f };
+const FCleverTapDate Dates[] = { FCleverTapDate(2024, 2, 29), FCleverTapDate(1999, 12, 31), FCleverTapDate(1, 1, 1) };
+
+/**
+ * Properties of the types that need the widest encodings: int64 beyond the int32 range, doubles and float arrays that
+ *  need every significant digit, and dates.
+ */
+FCleverTapProperties MakeNumericProperties()
+{
+	FCleverTapProperties Properties;
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Int64s); ++Index)
+	{
+		Properties.Add(FString::Printf(TEXT("Int64 %d"), Index), Int64s[Index]);
+	}
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Doubles); ++Index)
+	{
+		Properties.Add(FString::Printf(TEXT("Double %d"), Index), Doubles[Index]);
+	}
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Dates); ++Index)
+	{
+		Properties.Add(FString::Printf(TEXT("Date %d"), Index), Dates[Index]);
+	}
+	Properties.Add(TEXT("Int64s"), TArray<int64>(Int64s, UE_ARRAY_COUNT(Int64s)));
+	Properties.Add(TEXT("Doubles"), TArray<double>(Doubles, UE_ARRAY_COUNT(Doubles)));
+	Properties.Add(TEXT("Floats"), TArray<float>(Floats, UE_ARRAY_COUNT(Floats)));
+	return Properties;
+}
+
+void TestTrueFor(FAutomationTestBase& Test, const TCHAR* Format, const TCHAR* What, bool bValue)
+{
+	Test.TestTrue(FString::Printf(TEXT("%s: %s"), Format, What), bValue);
+}
+
+/**
+ * Checks the properties read back hold the values of MakeNumericProperties(). Float arrays read back from JSON as
+ *  doubles, so they are compared after narrowing.
+ */
+void TestNumericProperties(FAutomationTestBase& Test, const TCHAR* Format, const FCleverTapProperties& Read)
+{
+	TestTrueFor(Test, Format, TEXT("every property reads back"), Read.Num() == MakeNumericProperties().Num());
+
+	bool bInt64sMatch = true;
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Int64s); ++Index)
+	{
+		const FCleverTapPropertyValue* Value = Read.Find(FString::Printf(TEXT("Int64 %d"), Index));
+		bInt64sMatch &= Value && Value->IsType<int64>() && Value->Get<int64>() == Int64s[Index];
+	}
+	TestTrueFor(Test, Format, TEXT("int64 values round trip"), bInt64sMatch);
+
+	bool bDoublesMatch = true;
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Doubles); ++Index)
+	{
+		const FCleverTapPropertyValue* Value = Read.Find(FString::Printf(TEXT("Double %d"), Index));
+		bDoublesMatch &= Value && Value->IsType<double>() && Value->Get<double>() == Doubles[Index];
+	}
+	TestTrueFor(Test, Format, TEXT("double values round trip"), bDoublesMatch);
+
+	bool bDatesMatch = true;
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Dates); ++Index)
+	{
+		const FCleverTapPropertyValue* Value = Read.Find(FString::Printf(TEXT("Date %d"), Index));
+		const FCleverTapDate* Date = Value ? Value->TryGet<FCleverTapDate>() : nullptr;
+		bDatesMatch &= Date && Date->Year == Dates[Index].Year && Date->Month == Dates[Index].Month
+			&& Date->Day == Dates[Index].Day;
+	}
+	TestTrueFor(Test, Format, TEXT("dates round trip"), bDatesMatch);
+
+	const FCleverTapPropertyValue* Int64Array = Read.Find(TEXT("Int64s"));
+	TestTrueFor(Test, Format, TEXT("int64 arrays round trip"),
+		Int64Array && Int64Array->IsType<TArray<int64>>()
+			&& Int64Array->Get<TArray<int64>>() == TArray<int64>(Int64s, UE_ARRAY_COUNT(Int64s)));
+
+	const FCleverTapPropertyValue* DoubleArray = Read.Find(TEXT("Doubles"));
+	TestTrueFor(Test, Format, TEXT("double arrays round trip"),
+		DoubleArray && DoubleArray->IsType<TArray<double>>()
+			&& DoubleArray->Get<TArray<double>>() == TArray<double>(Doubles, UE_ARRAY_COUNT(Doubles)));
+
+	TArray<float> ReadFloats;
+	if (const FCleverTapPropertyValue* FloatArray = Read.Find(TEXT("Floats")))
+	{
+		if (const TArray<float>* AsFloats = FloatArray->TryGet<TArray<float>>())
+		{
+			ReadFloats = *AsFloats;
+		}
+		else if (const TArray<double>* AsDoubles = FloatArray->TryGet<TArray<double>>())
+		{
+			for (double Element : *AsDoubles)
+			{
+				ReadFloats.Add(float(Element));
+			}
+		}
+	}
+	TestTrueFor(Test, Format, TEXT("float arrays round trip"),
+		ReadFloats == TArray<float>(Floats, UE_ARRAY_COUNT(Floats)));
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapBinaryFormatStringsTest, "CleverTap.BinaryFormat.Strings",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapBinaryFormatStringsTest::RunTest(const FString& Parameters)
+{
+	// plain ASCII, Latin-1, CJK and a character outside the basic multilingual plane
+	const FString Strings[] = {
+		TEXT("Crossbow"), TEXT("Café"), TEXT("弓"), FString(UTF8_TO_TCHAR("\xf0\x9f\x8f\xb9")) };
+
+	FCleverTapPayload Written;
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Strings); ++Index)
+	{
+		Written.Emplace(FString::Printf(TEXT("Key é %d"), Index), Strings[Index]);
+	}
+	Written.Emplace(TEXT("Weapons"), TArray<FString>{ Strings[0], Strings[1], Strings[3] });
+
+	TArray<uint8> Data;
+	FCleverTapBinaryFormat::Write(Written, Data);
+
+	FCleverTapPayload Read;
+	FString Error;
+	if (!TestTrue(TEXT("The properties read back"), FCleverTapBinaryFormat::Read(Data, Read, &Error)))
+	{
+		AddError(Error);
+		return false;
+	}
+	if (!TestEqual(TEXT("All properties read back"), Read.Num(), Written.Num()))
+	{
+		return false;
+	}
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(Strings); ++Index)
+	{
+		TestEqual(TEXT("Keys round trip"), Read[Index].Key, Written[Index].Key);
+		TestEqual(TEXT("Strings round trip"), Read[Index].Value.Get<FString>(), Strings[Index]);
+	}
+	TestTrue(TEXT("String arrays round trip"),
+		Read.Last().Value.Get<TArray<FString>>() == Written.Last().Value.Get<TArray<FString>>());
+
+	// "Café" is stored as its UTF-8 bytes, whatever the size of TCHAR
+	const FTCHARToUTF8 Utf8(*Strings[1]);
+	bool bFoundUtf8 = false;
+	for (int32 Offset = 0; Offset + Utf8.Length() <= Data.Num() && !bFoundUtf8; ++Offset)
+	{
+		bFoundUtf8 = FMemory::Memcmp(Data.GetData() + Offset, Utf8.Get(), Utf8.Length()) == 0;
+	}
+	TestTrue(TEXT("Non-ASCII strings are stored as UTF-8"), bFoundUtf8);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapBinaryFormatRoundTripTest, "CleverTap.BinaryFormat.RoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapBinaryFormatRoundTripTest::RunTest(const FString& Parameters)
+{
+	TArray<uint8> Data;
+	FCleverTapBinaryFormat::Write(MakeNumericProperties(), Data);
+
+	FCleverTapProperties Read;
+	FString Error;
+	if (!TestTrue(TEXT("The properties read back"), FCleverTapBinaryFormat::Read(Data, Read, &Error)))
+	{
+		AddError(Error);
+		return false;
+	}
+	TestNumericProperties(*this, TEXT("Binary"), Read);
+
+	TestTrue(TEXT("Float arrays keep their type"), Read[TEXT("Floats")].IsType<TArray<float>>());
+	Data[3] = 2;
+	TestFalse(TEXT("Data of another version is rejected"), FCleverTapBinaryFormat::Read(Data, Read));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapJsonWriterRoundTripTest, "CleverTap.JsonWriter.RoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapJsonWriterRoundTripTest::RunTest(const FString& Parameters)
+{
+	TArray<uint8> Json;
+	FCleverTapJsonWriter(Json).WriteProperties(MakeNumericProperties());
+
+	FCleverTapProperties Read;
+	FString Error;
+	if (!TestTrue(TEXT("The JSON reads back"), FCleverTapJsonReader::Read(Json, Read, &Error)))
+	{
+		AddError(Error);
+		return false;
+	}
+	TestNumericProperties(*this, TEXT("JSON"), Read);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapJsonReaderDatesTest, "CleverTap.JsonReader.Dates",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapJsonReaderDatesTest::RunTest(const FString& Parameters)
+{
+	FCleverTapProperties Properties;
+	const bool bRead = FCleverTapJsonReader::Read(FString(TEXT(
+		"{\"Leap\":\"2024-02-29\",\"NotLeap\":\"2023-02-29\",\"Impossible\":\"2025-02-31\",\"April\":\"2025-04-31\","
+		"\"Valid\":\"2025-12-31\",\"Text\":\"Café\"}")),
+		Properties);
+	if (!TestTrue(TEXT("The JSON reads"), bRead))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("Leap days are dates"), Properties[TEXT("Leap")].IsType<FCleverTapDate>());
+	TestTrue(TEXT("Valid days are dates"), Properties[TEXT("Valid")].IsType<FCleverTapDate>());
+	TestTrue(TEXT("February 29th of a common year stays a string"), Properties[TEXT("NotLeap")].IsType<FString>());
+	TestTrue(TEXT("February 31st stays a string"), Properties[TEXT("Impossible")].IsType<FString>());
+	TestTrue(TEXT("April 31st stays a string"), Properties[TEXT("April")].IsType<FString>());
+	TestEqual(TEXT("Non-ASCII strings decode"), Properties[TEXT("Text")].Get<FString>(), FString(TEXT("Café")));
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
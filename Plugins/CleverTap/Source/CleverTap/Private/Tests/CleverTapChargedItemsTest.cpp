@@ -0,0 +1,114 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapChargedItems.h"
+#include "CleverTapEventRecord.h"
+#include "CleverTapUploadFormat.h"
+
+#include "Containers/StringConv.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+FCleverTapChargedItems MakeCart()
+{
+	FCleverTapChargedItems Items;
+	Items.AddColumn(TEXT("Product"), TArray<FString>{ TEXT("Sword"), TEXT("Shield") })
+		.AddColumn(TEXT("Quantity"), TArray<int32>{ 1, 2 })
+		.AddColumn(TEXT("Price"), TArray<double>{ 4.99, 2.99 })
+		.AddColumn(TEXT("Gift"), TArray<bool>{ false, true });
+	return Items;
+}
+
+FString ToUploadBody(const FCleverTapEventRecord& Record)
+{
+	TArray<uint8> Body;
+	WriteUploadBody(TEXT("Batch"), TEXT("Session"), 0, MakeArrayView(&Record, 1), Body);
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Body.GetData()), Body.Num());
+	return FString(Converted.Length(), Converted.Get());
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapChargedItemsColumnsTest, "CleverTap.ChargedItems.Columns",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapChargedItemsColumnsTest::RunTest(const FString& Parameters)
+{
+	FCleverTapChargedItems Items = MakeCart();
+	TestEqual(TEXT("The first column sets the number of items"), Items.Num(), 2);
+
+	AddExpectedError(
+		TEXT("Charged item column 'Color' has 3 values, expected 2"), EAutomationExpectedErrorFlags::Contains, 1);
+	Items.AddColumn(TEXT("Color"), TArray<FString>{ TEXT("Red"), TEXT("Green"), TEXT("Blue") });
+	TestEqual(TEXT("A column of another length is rejected"), Items.GetColumns().Num(), 4);
+	TestEqual(TEXT("A rejected column doesn't change the number of items"), Items.Num(), 2);
+
+	Items.AddColumn(TEXT("Quantity"), TArray<int32>{ 3, 4 });
+	TestEqual(TEXT("A column with an existing key replaces it"), Items.GetColumns().Num(), 4);
+
+	const TArray<FCleverTapProperties> Rows = Items.ToRows();
+	if (!TestEqual(TEXT("There is one row per item"), Rows.Num(), 2))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Rows hold every column"), Rows[1].Num(), 4);
+	TestEqual(TEXT("Strings are split by item"), Rows[1][TEXT("Product")].Get<FString>(), FString(TEXT("Shield")));
+	TestEqual(TEXT("Replaced columns are split by item"), Rows[1][TEXT("Quantity")].Get<int32>(), 4);
+	TestEqual(TEXT("Doubles are split by item"), Rows[0][TEXT("Price")].Get<double>(), 4.99);
+	TestTrue(TEXT("Booleans are split by item"), Rows[1][TEXT("Gift")].Get<bool>());
+
+	FCleverTapChargedItems Single;
+	Single.AddColumn(TEXT("Product"), TArray<FString>{ TEXT("Sword") });
+	Single.AddColumn(TEXT("Product"), TArray<FString>{ TEXT("Sword"), TEXT("Shield") });
+	TestEqual(TEXT("Replacing the only column sets the number of items again"), Single.Num(), 2);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapChargedItemsUploadTest, "CleverTap.ChargedItems.Upload",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapChargedItemsUploadTest::RunTest(const FString& Parameters)
+{
+	const FCleverTapChargedItems Items = MakeCart();
+	FCleverTapProperties ChargeDetails;
+	ChargeDetails.Add(TEXT("Amount"), 10.97);
+
+	// the columns are buffered as they are and only expanded to items as the upload is written
+	FCleverTapEventRecord Columns =
+		FCleverTapEventRecord::Make(ECleverTapEventRecordType::ChargedEventColumns, FString{});
+	Columns.TimestampMilliseconds = 1000;
+	Columns.AppendProperties(ChargeDetails);
+	Columns.AppendProperties(Items.GetColumns());
+
+	FCleverTapEventRecord Rows = FCleverTapEventRecord::Make(ECleverTapEventRecordType::ChargedEvent, FString{});
+	Rows.TimestampMilliseconds = 1000;
+	Rows.AppendProperties(ChargeDetails);
+	for (const FCleverTapProperties& Item : Items.ToRows())
+	{
+		Rows.AppendProperties(Item);
+	}
+
+	TestTrue(TEXT("Buffered columns have priority like charged events"), Columns.HasPriority());
+	TestTrue(TEXT("Columns take less space than rows"), Columns.Data.Num() < Rows.Data.Num());
+	TestEqual(TEXT("Columns upload as the same items as rows"), ToUploadBody(Columns), ToUploadBody(Rows));
+
+	FCleverTapEventRecord Uneven =
+		FCleverTapEventRecord::Make(ECleverTapEventRecordType::ChargedEventColumns, FString{});
+	Uneven.AppendProperties(ChargeDetails);
+	FCleverTapPayload UnevenColumns;
+	UnevenColumns.Emplace(TEXT("Product"), TArray<FString>{ TEXT("Sword"), TEXT("Shield") });
+	UnevenColumns.Emplace(TEXT("Quantity"), TArray<int32>{ 1 });
+	Uneven.AppendProperties(UnevenColumns);
+	AddExpectedError(TEXT("Skipping corrupt buffered record"), EAutomationExpectedErrorFlags::Contains, 1);
+	TArray<uint8> Body;
+	TestEqual(TEXT("Columns of different lengths are skipped"),
+		WriteUploadBody(TEXT("Batch"), TEXT("Session"), 0, MakeArrayView(&Uneven, 1), Body), 0);
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
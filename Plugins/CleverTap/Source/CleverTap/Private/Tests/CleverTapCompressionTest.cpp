@@ -0,0 +1,166 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapCompression.h"
+#include "CleverTapEventRecord.h"
+#include "CleverTapOfflineStore.h"
+
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+constexpr int32 ThresholdBytes = 256;
+
+/**
+ * Text that repeats, like the property names and values of similar events.
+ */
+TArray<uint8> MakeCompressible(int32 NumBytes)
+{
+	static const ANSICHAR Text[] = "{\"Level\":12,\"Weapon\":\"Sword\",\"Map\":\"Harbor\"}";
+	TArray<uint8> Data;
+	Data.Reserve(NumBytes);
+	while (Data.Num() < NumBytes)
+	{
+		Data.Add(uint8(Text[Data.Num() % (sizeof(Text) - 1)]));
+	}
+	return Data;
+}
+
+TArray<uint8> MakeIncompressible(int32 NumBytes)
+{
+	FRandomStream Random(42);
+	TArray<uint8> Data;
+	Data.SetNumUninitialized(NumBytes);
+	for (uint8& Byte : Data)
+	{
+		Byte = uint8(Random.RandRange(0, 255));
+	}
+	return Data;
+}
+
+FCleverTapEventRecord MakeRecord(int32 Index, TArray<uint8> Data)
+{
+	FCleverTapEventRecord Record =
+		FCleverTapEventRecord::Make(ECleverTapEventRecordType::Event, FString::Printf(TEXT("Event %d"), Index));
+	Record.Data = MoveTemp(Data);
+	return Record;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapCompressionRoundTripTest, "CleverTap.Compression.RoundTrip",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapCompressionRoundTripTest::RunTest(const FString& Parameters)
+{
+	const TArray<uint8> Data = MakeCompressible(4096);
+	for (ECleverTapCompressionFormat Format : { ECleverTapCompressionFormat::LZ4, ECleverTapCompressionFormat::Zlib })
+	{
+		const FString FormatName = Format == ECleverTapCompressionFormat::LZ4 ? TEXT("LZ4") : TEXT("Zlib");
+		const FCleverTapCompression Compression(Format, ThresholdBytes);
+		TArray<uint8> Compressed;
+		const ECleverTapCompressionFormat Used = Compression.Compress(Data, Compressed);
+		if (!TestTrue(FormatName + TEXT(" compresses repetitive data"), Used == Format))
+		{
+			continue;
+		}
+		TestTrue(FormatName + TEXT(" makes the data smaller"), Compressed.Num() < Data.Num() / 2);
+
+		TArray<uint8> Decompressed;
+		TestTrue(FormatName + TEXT(" decompresses"),
+			FCleverTapCompression::Decompress(Format, Compressed, Data.Num(), Decompressed));
+		TestTrue(FormatName + TEXT(" restores the data"), Decompressed == Data);
+	}
+
+	TArray<uint8> Decompressed;
+	TestFalse(TEXT("Uncompressed data can't be decompressed"),
+		FCleverTapCompression::Decompress(ECleverTapCompressionFormat::None, Data, Data.Num(), Decompressed));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapCompressionPassThroughTest, "CleverTap.Compression.PassThrough",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapCompressionPassThroughTest::RunTest(const FString& Parameters)
+{
+	const FCleverTapCompression Compression(ECleverTapCompressionFormat::LZ4, ThresholdBytes);
+	TArray<uint8> Compressed;
+	TestTrue(TEXT("Data below the threshold is kept as it is"),
+		Compression.Compress(MakeCompressible(ThresholdBytes - 1), Compressed) == ECleverTapCompressionFormat::None);
+	TestTrue(TEXT("Data at the threshold is compressed"),
+		Compression.Compress(MakeCompressible(ThresholdBytes), Compressed) == ECleverTapCompressionFormat::LZ4);
+	TestTrue(TEXT("Empty data is kept as it is"),
+		Compression.Compress(TArray<uint8>(), Compressed) == ECleverTapCompressionFormat::None);
+
+	const FCleverTapCompression Disabled;
+	TestTrue(TEXT("Nothing is compressed without a format"),
+		Disabled.Compress(MakeCompressible(4096), Compressed) == ECleverTapCompressionFormat::None);
+
+	for (ECleverTapCompressionFormat Format : { ECleverTapCompressionFormat::LZ4, ECleverTapCompressionFormat::Zlib })
+	{
+		TestTrue(TEXT("Data that compression doesn't make smaller is kept as it is"),
+			FCleverTapCompression(Format, ThresholdBytes).Compress(MakeIncompressible(4096), Compressed)
+				== ECleverTapCompressionFormat::None);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapCompressionStoreTest, "CleverTap.Compression.OfflineStore",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapCompressionStoreTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("CleverTapCompressedStore");
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+
+	// large records are compressed, small and incompressible ones are stored as they are
+	TArray<FCleverTapEventRecord> Records;
+	Records.Add(MakeRecord(0, MakeCompressible(8192)));
+	Records.Add(MakeRecord(1, MakeCompressible(16)));
+	Records.Add(MakeRecord(2, MakeIncompressible(1024)));
+	Records.Add(MakeRecord(3, MakeCompressible(1024)));
+	int64 DataBytes = 0;
+	for (const FCleverTapEventRecord& Record : Records)
+	{
+		DataBytes += Record.Data.Num();
+	}
+
+	{
+		FCleverTapOfflineStore Store(
+			Directory, 1024 * 1024, FCleverTapCompression(ECleverTapCompressionFormat::Zlib, ThresholdBytes));
+		for (const FCleverTapEventRecord& Record : Records)
+		{
+			Store.Append(Record);
+		}
+		TestTrue(TEXT("Compressed records take less space"), Store.GetSizeBytes() < DataBytes);
+	}
+	{
+		// the format is stored with each record, so reading doesn't depend on the configured compression
+		FCleverTapOfflineStore Store(Directory, 1024 * 1024);
+		TestEqual(TEXT("Every record is read back after reopening"), Store.Num(), Records.Num());
+		FCleverTapEventRecord Record;
+		for (const FCleverTapEventRecord& Expected : Records)
+		{
+			if (!TestTrue(TEXT("The record is read back"), Store.Pop(Record)))
+			{
+				break;
+			}
+			TestEqual(TEXT("The name is read back"), Record.Name, Expected.Name);
+			TestTrue(FString::Printf(TEXT("The data of '%s' is read back"), *Expected.Name),
+				Record.Data == Expected.Data);
+		}
+		Store.Acknowledge(Store.GetNumUnacknowledged());
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
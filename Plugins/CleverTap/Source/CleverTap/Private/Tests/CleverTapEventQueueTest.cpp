@@ -0,0 +1,325 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapEventQueue.h"
+#include "CleverTapOfflineStore.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+FCleverTapEventRecord MakeRecord(const TCHAR* Name, int64 TimestampMilliseconds = 0)
+{
+	const bool bCharged = FCString::Strncmp(Name, TEXT("Charge"), 6) == 0;
+	FCleverTapEventRecord Record = FCleverTapEventRecord::Make(
+		bCharged ? ECleverTapEventRecordType::ChargedEvent : ECleverTapEventRecordType::Event, Name);
+	if (TimestampMilliseconds != 0)
+	{
+		Record.TimestampMilliseconds = TimestampMilliseconds;
+	}
+	return Record;
+}
+
+FString JoinNames(const TArray<FCleverTapEventRecord>& Records)
+{
+	TArray<FString> Names;
+	for (const FCleverTapEventRecord& Record : Records)
+	{
+		Names.Add(Record.Name);
+	}
+	return FString::Join(Names, TEXT(", "));
+}
+
+/**
+ * A record name of about 140 bytes, so a few dozen records fill a small store.
+ */
+FString MakeLongName(const TCHAR* Kind, int32 Index)
+{
+	return FString::Printf(TEXT("%s %03d %s"), Kind, Index, *FString::ChrN(128, TEXT('x')));
+}
+
+TArray<FString> FindSegmentFiles(const FString& Directory)
+{
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *Directory, TEXT(".ctq"));
+	return FileNames;
+}
+
+int64 GetSegmentFilesBytes(const FString& Directory)
+{
+	int64 SizeBytes = 0;
+	for (const FString& FileName : FindSegmentFiles(Directory))
+	{
+		SizeBytes += IFileManager::Get().FileSize(*(Directory / FileName));
+	}
+	return SizeBytes;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapEventQueueDropOldestTest, "CleverTap.EventQueue.DropOldest",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapEventQueueDropOldestTest::RunTest(const FString& Parameters)
+{
+	// all names have the same length, so every record takes the same share of a budget of three records
+	FCleverTapEventQueue Queue(3 * MakeRecord(TEXT("Normal 0")).GetAllocatedSize(),
+		ECleverTapBufferOverflowPolicy::DropOldest);
+	const TCHAR* const Names[] = { TEXT("Charge 0"), TEXT("Normal 1"), TEXT("Normal 2"), TEXT("Normal 3"),
+		TEXT("Normal 4"), TEXT("Charge 5"), TEXT("Normal 6"), TEXT("Charge 7") };
+	for (const TCHAR* Name : Names)
+	{
+		TestTrue(FString::Printf(TEXT("'%s' is buffered"), Name), Queue.Enqueue(MakeRecord(Name)));
+	}
+	TestFalse(TEXT("A normal record doesn't displace priority records"), Queue.Enqueue(MakeRecord(TEXT("Normal 8"))));
+	TestTrue(TEXT("A priority record displaces the oldest priority record"),
+		Queue.Enqueue(MakeRecord(TEXT("Charge 9"))));
+	TestEqual(TEXT("Dropped records"), Queue.GetNumDropped(), int64(7));
+
+	TArray<FCleverTapEventRecord> Records;
+	Queue.Dequeue(10, Records);
+	TestEqual(TEXT("Priority records are dropped last"), JoinNames(Records),
+		FString(TEXT("Charge 5, Charge 7, Charge 9")));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapEventQueueEnqueueFrontTest, "CleverTap.EventQueue.EnqueueFront",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapEventQueueEnqueueFrontTest::RunTest(const FString& Parameters)
+{
+	const int64 RecordBytes = MakeRecord(TEXT("Normal 0")).GetAllocatedSize();
+	FCleverTapEventQueue Queue(3 * RecordBytes, ECleverTapBufferOverflowPolicy::DropOldest);
+	Queue.Enqueue(MakeRecord(TEXT("Normal 1")));
+	Queue.Enqueue(MakeRecord(TEXT("Normal 2")));
+	Queue.Enqueue(MakeRecord(TEXT("Normal 3")));
+
+	// the first two are in flight while newer records fill the budget
+	TArray<FCleverTapEventRecord> InFlight;
+	Queue.Dequeue(2, InFlight);
+	Queue.Enqueue(MakeRecord(TEXT("Normal 4")));
+	Queue.Enqueue(MakeRecord(TEXT("Normal 5")));
+
+	Queue.EnqueueFront(MoveTemp(InFlight));
+	TestEqual(TEXT("Records put back are kept beyond the budget"), Queue.Num(), 5);
+	TestEqual(TEXT("Nothing is dropped"), Queue.GetNumDropped(), int64(0));
+	TestTrue(TEXT("The budget accounts for them"), Queue.GetBudget().GetUsedBytes() == 5 * RecordBytes);
+
+	TArray<FCleverTapEventRecord> Records;
+	Queue.Dequeue(10, Records);
+	TestEqual(TEXT("Records put back come first, in their order"), JoinNames(Records),
+		FString(TEXT("Normal 1, Normal 2, Normal 3, Normal 4, Normal 5")));
+	TestTrue(TEXT("The budget is released"), Queue.GetBudget().GetUsedBytes() == 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapOfflineStoreOrderTest, "CleverTap.OfflineStore.AppendOrder",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapOfflineStoreOrderTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("CleverTapOfflineStore");
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+
+	// the clock goes backwards between appends, so timestamps disagree with the order the records were appended in
+	FString Popped;
+	{
+		FCleverTapOfflineStore Store(Directory, 1024 * 1024);
+		Store.Append(MakeRecord(TEXT("Normal 1"), 4000));
+		Store.Append(MakeRecord(TEXT("Charge 2"), 3000));
+		Store.Append(MakeRecord(TEXT("Normal 3"), 2000));
+		Store.Append(MakeRecord(TEXT("Charge 4"), 1000));
+
+		FCleverTapEventRecord Record;
+		for (int32 Index = 0; Index < 2 && Store.Pop(Record); ++Index)
+		{
+			Popped += Record.Name + TEXT(", ");
+		}
+		Store.Acknowledge(2);
+	}
+	{
+		// the sequence continues after the records left by the previous session
+		FCleverTapOfflineStore Store(Directory, 1024 * 1024);
+		Store.Append(MakeRecord(TEXT("Normal 5"), 500));
+		Store.Append(MakeRecord(TEXT("Charge 6"), 100));
+
+		FCleverTapEventRecord Record;
+		while (Store.Pop(Record))
+		{
+			Popped += Record.Name + TEXT(", ");
+		}
+		Store.Acknowledge(Store.GetNumUnacknowledged());
+	}
+	TestEqual(TEXT("Records are popped in the order they were appended"), Popped,
+		FString(TEXT("Normal 1, Charge 2, Normal 3, Charge 4, Normal 5, Charge 6, ")));
+
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapOfflineStoreFootprintTest, "CleverTap.OfflineStore.FootprintBound",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapOfflineStoreFootprintTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("CleverTapOfflineStore");
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+
+	constexpr int64 MaxBytes = 16 * 1024;
+	{
+		FCleverTapOfflineStore Store(Directory, MaxBytes, FCleverTapCompression{}, 4096);
+		bool bWithinBound = true;
+		for (int32 Index = 0; Index < 500; ++Index)
+		{
+			TestTrue(TEXT("Records that fit in the store are appended"),
+				Store.Append(MakeRecord(*MakeLongName(TEXT("Normal"), Index))));
+			bWithinBound &= Store.GetSizeBytes() <= MaxBytes;
+		}
+		TestTrue(TEXT("The footprint stays within the limit"), bWithinBound);
+		TestTrue(TEXT("Old records are evicted"), Store.GetNumEvicted() > 0);
+
+		Store.Flush();
+		TestTrue(TEXT("The segment files stay within the limit"), GetSegmentFilesBytes(Directory) <= MaxBytes);
+		TestEqual(TEXT("The footprint is what the segment files take up"), Store.GetSizeBytes(),
+			GetSegmentFilesBytes(Directory));
+
+		FCleverTapEventRecord Record;
+		TestFalse(TEXT("A record larger than the store is rejected"),
+			Store.Append(MakeRecord(*FString::ChrN(MaxBytes, TEXT('x')))));
+		TestTrue(TEXT("Rejecting it leaves the records in place"), Store.Pop(Record));
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapOfflineStoreEvictionTest, "CleverTap.OfflineStore.EvictsPriorityLast",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapOfflineStoreEvictionTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("CleverTapOfflineStore");
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+
+	// every fourth record has priority, and those alone take up less than half the store
+	constexpr int32 NumRecords = 200;
+	{
+		FCleverTapOfflineStore Store(Directory, 16 * 1024, FCleverTapCompression{}, 4096);
+		for (int32 Index = 0; Index < NumRecords; ++Index)
+		{
+			Store.Append(MakeRecord(*MakeLongName(Index % 4 == 0 ? TEXT("Charge") : TEXT("Normal"), Index)));
+		}
+		TestTrue(TEXT("Records are evicted"), Store.GetNumEvicted() > 0);
+
+		int32 NumCharged = 0;
+		int32 NumNormal = 0;
+		FString PreviousName;
+		bool bInOrder = true;
+		FCleverTapEventRecord Record;
+		while (Store.Pop(Record))
+		{
+			++(Record.HasPriority() ? NumCharged : NumNormal);
+			bInOrder &= FCString::Atoi(*Record.Name.Mid(7)) > FCString::Atoi(*PreviousName.Mid(7))
+				|| PreviousName.IsEmpty();
+			PreviousName = Record.Name;
+		}
+		Store.Acknowledge(Store.GetNumUnacknowledged());
+
+		TestEqual(TEXT("Every priority record is kept"), NumCharged, NumRecords / 4);
+		TestTrue(TEXT("Normal records are evicted"), NumNormal < NumRecords * 3 / 4);
+		TestEqual(TEXT("Every record is either kept or evicted"), int64(NumCharged + NumNormal) + Store.GetNumEvicted(),
+			int64(NumRecords));
+		TestTrue(TEXT("The records kept are popped in the order they were appended"), bInOrder);
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapOfflineStoreRecoveryTest, "CleverTap.OfflineStore.RecoversUnacknowledged",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapOfflineStoreRecoveryTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("CleverTapOfflineStore");
+	const FString CrashDirectory = FPaths::AutomationTransientDir() / TEXT("CleverTapOfflineStoreCrash");
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+	IFileManager::Get().DeleteDirectory(*CrashDirectory, /*RequireExists=*/false, /*Tree=*/true);
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	{
+		FCleverTapOfflineStore Store(Directory, 1024 * 1024);
+		for (int32 Index = 1; Index <= 5; ++Index)
+		{
+			Store.Append(MakeRecord(*FString::Printf(TEXT("Normal %d"), Index)));
+		}
+		FCleverTapEventRecord Record;
+		Store.Pop(Record);
+		Store.Pop(Record);
+		Store.Pop(Record);
+		Store.Acknowledge(1);
+
+		// what is on disk if the app crashes now, without the store being flushed
+		PlatformFile.CopyDirectoryTree(*CrashDirectory, *Directory, /*bOverwriteAllExisting=*/true);
+	}
+	{
+		FCleverTapOfflineStore Store(CrashDirectory, 1024 * 1024);
+		TArray<FCleverTapEventRecord> Records;
+		FCleverTapEventRecord Record;
+		while (Store.Pop(Record))
+		{
+			Records.Add(MoveTemp(Record));
+		}
+		Store.Acknowledge(Store.GetNumUnacknowledged());
+		TestEqual(TEXT("After a crash the unacknowledged records are read again, in order"), JoinNames(Records),
+			FString(TEXT("Normal 2, Normal 3, Normal 4, Normal 5")));
+	}
+	{
+		FCleverTapOfflineStore Store(Directory, 1024 * 1024);
+		FCleverTapEventRecord Record;
+		TestTrue(TEXT("After a shutdown the unacknowledged records are read again"),
+			Store.Pop(Record) && Record.Name == TEXT("Normal 2"));
+		Store.Acknowledge(1);
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+	IFileManager::Get().DeleteDirectory(*CrashDirectory, /*RequireExists=*/false, /*Tree=*/true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapOfflineStoreOpenSegmentTest, "CleverTap.OfflineStore.ReadsOpenSegment",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapOfflineStoreOpenSegmentTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("CleverTapOfflineStore");
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+
+	{
+		// reading each record as soon as it is appended doesn't seal the segment being written
+		FCleverTapOfflineStore Store(Directory, 1024 * 1024);
+		bool bReadBack = true;
+		for (int32 Index = 0; Index < 100; ++Index)
+		{
+			const FString Name = FString::Printf(TEXT("Normal %d"), Index);
+			Store.Append(MakeRecord(*Name));
+			FCleverTapEventRecord Record;
+			bReadBack &= Store.Pop(Record) && Record.Name == Name;
+			Store.Acknowledge(1);
+		}
+		TestTrue(TEXT("Each record is read back"), bReadBack);
+		TestEqual(TEXT("The records share a segment"), FindSegmentFiles(Directory).Num(), 1);
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists=*/false, /*Tree=*/true);
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,78 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapEventBuilder.h"
+#include "CleverTapEventSchema.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+constexpr auto Level = CLEVERTAP_SCHEMA_KEY(int32, "Level");
+constexpr auto Score = CLEVERTAP_SCHEMA_KEY(int64, "Score");
+constexpr auto Weapon = CLEVERTAP_SCHEMA_KEY(FString, "Weapon");
+
+FCleverTapEventSchema MakeLevelCompleteSchema()
+{
+	return FCleverTapEventSchema(TEXT("Level Complete"))
+		.Key(Level, ECleverTapSchemaKeyPresence::Required)
+		.Key(Score)
+		.Key(Weapon);
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapEventSchemaValidatorTest, "CleverTap.EventSchema.Validator",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapEventSchemaValidatorTest::RunTest(const FString& Parameters)
+{
+	const FCleverTapEventSchema Schema = MakeLevelCompleteSchema();
+	FCleverTapEventSchema::FValidator Validator(Schema);
+
+	Validator.Add(Level, FCleverTapPropertyValue(3));
+	Validator.Add(Score, FCleverTapPropertyValue(int64(1200)));
+	TestTrue(TEXT("An event with typed keys of the schema is valid"), Validator.Finish(2));
+
+	Validator.Add(TEXT("Level"), FCleverTapPropertyValue(3));
+	TestTrue(TEXT("Keys added by name are found too"), Validator.Finish(1));
+
+	AddExpectedError(TEXT("is missing the required property 'Level'"), EAutomationExpectedErrorFlags::Contains, 1);
+	Validator.Add(Score, FCleverTapPropertyValue(int64(1200)));
+	TestFalse(TEXT("An event without a required key is invalid"), Validator.Finish(1));
+
+	AddExpectedError(TEXT("has a value of a type not allowed"), EAutomationExpectedErrorFlags::Contains, 1);
+	Validator.Add(Level, FCleverTapPropertyValue(3));
+	Validator.Add(TEXT("Score"), FCleverTapPropertyValue(FString(TEXT("High"))));
+	TestFalse(TEXT("A value of the wrong type is invalid"), Validator.Finish(2));
+
+	AddExpectedError(TEXT("is not part of the event schema"), EAutomationExpectedErrorFlags::Contains, 1);
+	Validator.Add(Level, FCleverTapPropertyValue(3));
+	Validator.Add(TEXT("Difficulty"), FCleverTapPropertyValue(2));
+	TestFalse(TEXT("An unknown key is invalid"), Validator.Finish(2));
+
+	Validator.Add(Level, FCleverTapPropertyValue(3));
+	TestTrue(TEXT("Finish starts over for the next event"), Validator.Finish(1));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapEventSchemaBuilderTest, "CleverTap.EventSchema.Builder",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapEventSchemaBuilderTest::RunTest(const FString& Parameters)
+{
+	const FCleverTapEventSchema Schema = MakeLevelCompleteSchema();
+	FCleverTapPayload Payload =
+		FCleverTapEventBuilder(Schema, 3).Add(Level, 3).Add(Weapon, TEXT("Crossbow")).Add(Level, 4).BuildPayload();
+
+	TestEqual(TEXT("Duplicate keys are removed"), Payload.Num(), 2);
+	TestEqual(TEXT("The last value of a key wins"), Payload[1].Value.Get<int32>(), 4);
+	TestEqual(TEXT("String keys take TCHAR strings"), Payload[0].Value.Get<FString>(), FString(TEXT("Crossbow")));
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
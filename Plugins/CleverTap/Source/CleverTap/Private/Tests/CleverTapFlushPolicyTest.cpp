@@ -0,0 +1,119 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapFlushPolicy.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+constexpr int64 BytesPerEvent = 1000;
+
+/**
+ * Sends NumUploads batches over a scripted link, each taking a round trip plus its transfer at the given bandwidth.
+ */
+void SimulateUploads(FCleverTapFlushPolicy& Policy, double& NowSeconds, double RttSeconds,
+	double BandwidthBytesPerSecond, int32 NumUploads)
+{
+	for (int32 Index = 0; Index < NumUploads; ++Index)
+	{
+		const int32 NumEvents = Policy.GetBatchSize();
+		const int64 Bytes = NumEvents * BytesPerEvent;
+		const double DurationSeconds = RttSeconds + Bytes / BandwidthBytesPerSecond;
+		Policy.OnFlush(NowSeconds);
+		Policy.OnUploadSucceeded(DurationSeconds, Bytes, NumEvents);
+		NowSeconds += DurationSeconds;
+	}
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapFlushPolicyAdaptsTest, "CleverTap.FlushPolicy.Adapts",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapFlushPolicyAdaptsTest::RunTest(const FString& Parameters)
+{
+	FCleverTapFlushPolicy::FSettings Settings;
+	Settings.MaxBatchEvents = 1000;
+	FCleverTapFlushPolicy Policy(Settings);
+	TestEqual(TEXT("The first batch has the smallest size"), Policy.GetBatchSize(), Settings.MinBatchEvents);
+	TestEqual(TEXT("The first interval is the shortest"), Policy.GetIntervalSeconds(), Settings.MinIntervalSeconds);
+
+	struct FLink
+	{
+		const TCHAR* Name;
+		double RttSeconds;
+		double BandwidthBytesPerSecond;
+		int32 ExpectedBatchSize;
+	};
+	// the round trip takes a quarter of each upload, so a batch transfers for three round trips: 3 * RTT * bandwidth
+	const FLink Links[] = {
+		{ TEXT("Baseline"), 0.2, 100000.0, 60 },
+		{ TEXT("Higher latency"), 1.0, 100000.0, 300 },
+		{ TEXT("Higher bandwidth"), 0.2, 1000000.0, 600 },
+		{ TEXT("Lower bandwidth"), 0.2, 20000.0, 12 },
+	};
+
+	// the same policy moves between links, so each estimate has to recover from the previous one
+	double NowSeconds = 0.0;
+	for (const FLink& Link : Links)
+	{
+		// a multiple of the probe interval, so the next batch isn't a probe
+		SimulateUploads(Policy, NowSeconds, Link.RttSeconds, Link.BandwidthBytesPerSecond, 64);
+
+		TestTrue(FString::Printf(TEXT("%s: the round trip time is estimated (%f)"), Link.Name, Policy.GetRttSeconds()),
+			FMath::IsNearlyEqual(Policy.GetRttSeconds(), Link.RttSeconds, Link.RttSeconds * 0.01));
+		TestTrue(FString::Printf(TEXT("%s: the bandwidth is estimated (%f)"), Link.Name,
+				Policy.GetBandwidthBytesPerSecond()),
+			FMath::IsNearlyEqual(Policy.GetBandwidthBytesPerSecond(), Link.BandwidthBytesPerSecond,
+				Link.BandwidthBytesPerSecond * 0.01));
+		TestTrue(FString::Printf(TEXT("%s: batches hold %d events (%d)"), Link.Name, Link.ExpectedBatchSize,
+				Policy.GetBatchSize()),
+			FMath::Abs(Policy.GetBatchSize() - Link.ExpectedBatchSize) <= 1);
+		const double ExpectedIntervalSeconds = FMath::Clamp(Link.RttSeconds * 10.0, Settings.MinIntervalSeconds,
+			Settings.MaxIntervalSeconds);
+		TestTrue(FString::Printf(TEXT("%s: events wait ten round trips (%f)"), Link.Name, Policy.GetIntervalSeconds()),
+			FMath::IsNearlyEqual(Policy.GetIntervalSeconds(), ExpectedIntervalSeconds, ExpectedIntervalSeconds * 0.01));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapFlushPolicySuspensionTest, "CleverTap.FlushPolicy.Suspension",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapFlushPolicySuspensionTest::RunTest(const FString& Parameters)
+{
+	FCleverTapFlushPolicy::FSettings Settings;
+	FCleverTapFlushPolicy Policy(Settings);
+	const int32 BatchSize = Policy.GetBatchSize();
+
+	Policy.OnFlush(100.0);
+	TestFalse(TEXT("Nothing is sent when nothing is queued"), Policy.ShouldFlush(200.0, 0));
+	TestTrue(TEXT("A full batch is sent at once"), Policy.ShouldFlush(100.0, BatchSize));
+	TestFalse(TEXT("A partial batch waits for the interval"), Policy.ShouldFlush(100.5, 1));
+	TestTrue(TEXT("A partial batch is sent after the interval"), Policy.ShouldFlush(101.0, 1));
+
+	Policy.OnUploadFailed(100.0);
+	TestTrue(TEXT("The first failure suspends for the initial backoff"),
+		Policy.IsSuspended(101.9) && !Policy.IsSuspended(102.0));
+	TestFalse(TEXT("Nothing is sent while suspended"), Policy.ShouldFlush(101.0, BatchSize));
+
+	Policy.OnUploadFailed(103.0);
+	TestTrue(TEXT("The backoff doubles with every failure"), Policy.IsSuspended(106.9) && !Policy.IsSuspended(107.0));
+	TestEqual(TEXT("Consecutive failures"), Policy.GetNumConsecutiveFailures(), 2);
+
+	Policy.OnUploadFailed(110.0, 30.0);
+	TestTrue(TEXT("A longer Retry-After is honored"), Policy.IsSuspended(139.9) && !Policy.IsSuspended(140.0));
+
+	Policy.OnUploadSucceeded(0.5, BatchSize * BytesPerEvent, BatchSize);
+	TestEqual(TEXT("A success resets the failures"), Policy.GetNumConsecutiveFailures(), 0);
+	TestFalse(TEXT("A success lifts the suspension"), Policy.IsSuspended(120.0));
+	TestTrue(TEXT("Uploads resume after a success"), Policy.ShouldFlush(120.0, Policy.GetBatchSize()));
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,152 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapGlobalProperties.h"
+#include "CleverTapInstanceConfig.h"
+#include "GenericPlatformCleverTapInstance.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+FString FindString(const FCleverTapProperties& Properties, const TCHAR* Key)
+{
+	const FCleverTapPropertyValue* const Value = Properties.Find(Key);
+	return Value && Value->IsType<FString>() ? Value->Get<FString>() : FString(TEXT("<missing>"));
+}
+
+/**
+ * The first property set of each buffered record.
+ */
+TArray<FCleverTapProperties> DequeueProperties(GenericPlatform::FGenericPlatformCleverTapInstance& Instance)
+{
+	TArray<FCleverTapEventRecord> Records;
+	Instance.GetQueue().Dequeue(MAX_int32, Records);
+	TArray<FCleverTapProperties> Properties;
+	for (const FCleverTapEventRecord& Record : Records)
+	{
+		TArray<FCleverTapProperties> PropertySets;
+		Record.ReadProperties(PropertySets);
+		Properties.Add(PropertySets.Num() > 0 ? PropertySets[0] : FCleverTapProperties{});
+	}
+	return Properties;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapGlobalPropertiesPrecedenceTest, "CleverTap.GlobalProperties.Precedence",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapGlobalPropertiesPrecedenceTest::RunTest(const FString& Parameters)
+{
+	FCleverTapGlobalProperties GlobalProperties;
+	TestFalse(TEXT("Nothing resolves without sources"), GlobalProperties.Resolve().IsValid());
+
+	// every source sets the keys of the sources below it, so each key shows which source wins
+	GlobalProperties.SetEventContext(FCleverTapEventContext::Create({
+		{ TEXT("Context"), FString(TEXT("Context")) },
+		{ TEXT("Static"), FString(TEXT("Context")) },
+		{ TEXT("Provider"), FString(TEXT("Context")) },
+		{ TEXT("Event"), FString(TEXT("Context")) },
+	}));
+	GlobalProperties.SetProperty(TEXT("Static"), FString(TEXT("Static")));
+	GlobalProperties.SetProperty(TEXT("Provider"), FString(TEXT("Static")));
+	GlobalProperties.SetProperty(TEXT("Event"), FString(TEXT("Static")));
+	GlobalProperties.AddProvider([](FCleverTapPayload& OutProperties)
+	{
+		OutProperties.Emplace(TEXT("Provider"), FString(TEXT("First provider")));
+		OutProperties.Emplace(TEXT("Event"), FString(TEXT("First provider")));
+		OutProperties.Emplace(TEXT("Later provider"), FString(TEXT("First provider")));
+	});
+	GlobalProperties.AddProvider([](FCleverTapPayload& OutProperties)
+	{
+		OutProperties.Emplace(TEXT("Later provider"), FString(TEXT("Second provider")));
+	});
+
+	const FCleverTapEventContextPtr Resolved = GlobalProperties.Resolve();
+	if (!TestTrue(TEXT("The sources resolve"), Resolved.IsValid()))
+	{
+		return false;
+	}
+
+	// the generic instance merges the event properties over the resolved context the same way
+	const FCleverTapProperties Merged = Resolved->MergeWith({ { TEXT("Event"), FString(TEXT("Event")) } });
+	TestEqual(TEXT("The event context is the base"), FindString(Merged, TEXT("Context")), FString(TEXT("Context")));
+	TestEqual(TEXT("Static properties override the event context"), FindString(Merged, TEXT("Static")),
+		FString(TEXT("Static")));
+	TestEqual(TEXT("Providers override static properties"), FindString(Merged, TEXT("Provider")),
+		FString(TEXT("First provider")));
+	TestEqual(TEXT("Later providers override earlier ones"), FindString(Merged, TEXT("Later provider")),
+		FString(TEXT("Second provider")));
+	TestEqual(TEXT("Event properties override every global source"), FindString(Merged, TEXT("Event")),
+		FString(TEXT("Event")));
+	TestEqual(TEXT("Nothing else is added"), Merged.Num(), 5);
+
+	TestTrue(TEXT("Unchanged sources share the resolved context"), GlobalProperties.Resolve() == Resolved);
+
+	GlobalProperties.RemoveProperty(TEXT("Static"));
+	const FCleverTapEventContextPtr WithoutStatic = GlobalProperties.Resolve();
+	TestTrue(TEXT("A change resolves a new context"), WithoutStatic.IsValid() && WithoutStatic != Resolved);
+	if (WithoutStatic.IsValid())
+	{
+		TestEqual(TEXT("Removing a static property uncovers the event context"),
+			FindString(WithoutStatic->GetProperties(), TEXT("Static")), FString(TEXT("Context")));
+	}
+	TestEqual(TEXT("Resolved contexts are immutable"), FindString(Resolved->GetProperties(), TEXT("Static")),
+		FString(TEXT("Static")));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapGlobalPropertiesInstanceTest, "CleverTap.GlobalProperties.Instance",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapGlobalPropertiesInstanceTest::RunTest(const FString& Parameters)
+{
+	GenericPlatform::FGenericPlatformCleverTapInstance Generic{ FCleverTapInstanceConfig{} };
+	ICleverTapInstance& Instance = Generic;
+
+	Instance.SetGlobalProperty(TEXT("Game Mode"), TEXT("Ranked"));
+	Instance.SetGlobalProperty(TEXT("Map"), FString(TEXT("Global")));
+	Instance.SetGlobalProperty(TEXT("Weapon"), FString(TEXT("Global")));
+	Instance.AddGlobalPropertyProvider([](FCleverTapPayload& OutProperties)
+	{
+		OutProperties.Emplace(TEXT("Provider"), FString(TEXT("Provider")));
+	});
+
+	// each layer overrides the keys of the layers below it
+	const FCleverTapEventContextRef Context = FCleverTapEventContext::Create({
+		{ TEXT("Map"), FString(TEXT("Context")) },
+		{ TEXT("Weapon"), FString(TEXT("Context")) },
+	});
+	const FCleverTapProperties Actions = { { TEXT("Weapon"), FString(TEXT("Event")) } };
+	const FCleverTapProperties ChargeDetails = { { TEXT("Map"), FString(TEXT("Charge")) } };
+	Instance.PushEvent(TEXT("Kill"), Context, Actions);
+	Instance.PushEvent(TEXT("Spawn"), FCleverTapProperties{});
+	Instance.PushChargedEvent(ChargeDetails, TArray<FCleverTapProperties>{});
+
+	const TArray<FCleverTapProperties> Events = DequeueProperties(Generic);
+	if (!TestEqual(TEXT("Every event is buffered"), Events.Num(), 3))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Global properties given as TCHAR strings are strings"), FindString(Events[0], TEXT("Game Mode")),
+		FString(TEXT("Ranked")));
+	TestEqual(TEXT("Providers add their properties"), FindString(Events[0], TEXT("Provider")),
+		FString(TEXT("Provider")));
+	TestEqual(TEXT("A per-call context overrides global properties"), FindString(Events[0], TEXT("Map")),
+		FString(TEXT("Context")));
+	TestEqual(TEXT("Event properties override the per-call context"), FindString(Events[0], TEXT("Weapon")),
+		FString(TEXT("Event")));
+	TestEqual(TEXT("Each key is sent once"), Events[0].Num(), 4);
+	TestEqual(TEXT("Events without properties get the global properties"), FindString(Events[1], TEXT("Map")),
+		FString(TEXT("Global")));
+	TestEqual(TEXT("Charge details override global properties"), FindString(Events[2], TEXT("Map")),
+		FString(TEXT("Charge")));
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,114 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapHandleTable.h"
+
+#include "Async/Async.h"
+#include "Misc/AutomationTest.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+struct FTestObject
+{
+	std::atomic<bool> bAlive{ false };
+};
+
+using FTestTable = TCleverTapHandleTable<FTestObject, 4>;
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapHandleTableTest, "CleverTap.HandleTable.Basics",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapHandleTableTest::RunTest(const FString& Parameters)
+{
+	TCleverTapHandleTable<FTestObject, 2> Table;
+	FTestObject First;
+	FTestObject Second;
+
+	const FCleverTapHandle FirstHandle = Table.Register(&First);
+	TestTrue(TEXT("Register returns a valid handle"), FirstHandle != InvalidCleverTapHandle);
+	TestTrue(TEXT("A live handle resolves"), Table.Resolve(FirstHandle) == &First);
+	TestTrue(TEXT("The invalid handle never resolves"), Table.Resolve(InvalidCleverTapHandle) == nullptr);
+
+	Table.Unregister(FirstHandle);
+	TestTrue(TEXT("An unregistered handle doesn't resolve"), Table.Resolve(FirstHandle) == nullptr);
+	TestFalse(TEXT("An unregistered handle can't be pinned"), bool(Table.Pin(FirstHandle)));
+
+	const FCleverTapHandle SecondHandle = Table.Register(&Second);
+	TestTrue(TEXT("A reused slot gets a new handle"), SecondHandle != FirstHandle);
+	TestTrue(TEXT("A stale handle doesn't resolve to the new object"), Table.Resolve(FirstHandle) == nullptr);
+	Table.Unregister(FirstHandle);
+	TestTrue(TEXT("Unregistering a stale handle keeps the new object"), Table.Resolve(SecondHandle) == &Second);
+
+	TestTrue(TEXT("The table holds Capacity objects"), Table.Register(&First) != InvalidCleverTapHandle);
+	TestTrue(TEXT("A full table refuses to register"), Table.Register(&First) == InvalidCleverTapHandle);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapHandleTableConcurrencyTest, "CleverTap.HandleTable.PinWhileUnregistering",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapHandleTableConcurrencyTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumReaders = 4;
+	constexpr int32 NumIterations = 20000;
+
+	FTestTable Table;
+	FTestObject Objects[2];
+	std::atomic<FCleverTapHandle> CurrentHandle{ InvalidCleverTapHandle };
+	std::atomic<bool> bStop{ false };
+	std::atomic<int32> NumPinned{ 0 };
+	std::atomic<int32> NumUsedAfterUnregister{ 0 };
+
+	TArray<TFuture<void>> Readers;
+	for (int32 ReaderIndex = 0; ReaderIndex < NumReaders; ++ReaderIndex)
+	{
+		Readers.Add(Async(EAsyncExecution::Thread, [&Table, &CurrentHandle, &bStop, &NumPinned,
+			&NumUsedAfterUnregister] {
+			while (!bStop.load(std::memory_order_acquire))
+			{
+				const FTestTable::FPinned Pinned = Table.Pin(CurrentHandle.load(std::memory_order_acquire));
+				if (Pinned)
+				{
+					NumPinned.fetch_add(1, std::memory_order_relaxed);
+					if (!Pinned->bAlive.load(std::memory_order_acquire))
+					{
+						NumUsedAfterUnregister.fetch_add(1, std::memory_order_relaxed);
+					}
+				}
+			}
+		}));
+	}
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		FTestObject& Object = Objects[Iteration % 2];
+		Object.bAlive.store(true, std::memory_order_release);
+		const FCleverTapHandle Handle = Table.Register(&Object);
+		CurrentHandle.store(Handle, std::memory_order_release);
+		FPlatformProcess::Yield();
+
+		// once Unregister returns no reader may still hold the object
+		Table.Unregister(Handle);
+		Object.bAlive.store(false, std::memory_order_release);
+	}
+
+	bStop.store(true, std::memory_order_release);
+	for (TFuture<void>& Reader : Readers)
+	{
+		Reader.Wait();
+	}
+
+	TestEqual(TEXT("No object is used after Unregister returned"), NumUsedAfterUnregister.load(), 0);
+	AddInfo(FString::Printf(TEXT("%d pins succeeded"), NumPinned.load()));
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
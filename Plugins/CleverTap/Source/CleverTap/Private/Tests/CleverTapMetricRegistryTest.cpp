@@ -0,0 +1,203 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapLogLinearHistogram.h"
+#include "CleverTapMetricRegistry.h"
+
+#include "HAL/Thread.h"
+#include "Misc/AutomationTest.h"
+
+#include <limits>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+using FHistogram = FCleverTapLogLinearHistogram;
+
+// the largest ratio between the upper bound of a bucket and a value in it
+constexpr double MaxBucketRatio = 1.0 + 1.0 / FHistogram::NumSubBuckets;
+
+/**
+ * The number in Summary under Key, whether it was reported as an integer or not, or -1 if there is none.
+ */
+double GetNumber(const FCleverTapProperties& Summary, const FString& Key)
+{
+	const FCleverTapPropertyValue* const Value = Summary.Find(Key);
+	if (!Value)
+	{
+		return -1.0;
+	}
+	if (const int64* const Integer = Value->TryGet<int64>())
+	{
+		return double(*Integer);
+	}
+	const double* const Number = Value->TryGet<double>();
+	return Number ? *Number : -1.0;
+}
+
+FCleverTapInstanceConfig MakeConfig()
+{
+	FCleverTapInstanceConfig Config;
+	Config.MetricsIntervalSeconds = 0.0f; // only flushed by the tests
+	return Config;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapHistogramBucketsTest, "CleverTap.Metrics.HistogramBuckets",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapHistogramBucketsTest::RunTest(const FString& Parameters)
+{
+	const double RangeMin = FMath::Pow(2.0, double(FHistogram::MinExponent));
+	const double RangeMax = FMath::Pow(2.0, double(FHistogram::MaxExponent));
+
+	bool bValueBelowBound = true;
+	bool bBoundWithinRatio = true;
+	bool bBoundStartsNextBucket = true;
+	bool bMonotonic = true;
+	int32 PreviousIndex = 0;
+	for (double Value = RangeMin; Value < RangeMax; Value *= 1.01)
+	{
+		const int32 Index = FHistogram::GetBucketIndex(Value);
+		const double UpperBound = FHistogram::GetBucketUpperBound(Index);
+		bValueBelowBound &= Value < UpperBound;
+		bBoundWithinRatio &= UpperBound <= Value * MaxBucketRatio;
+		bBoundStartsNextBucket &= FHistogram::GetBucketIndex(UpperBound) == Index + 1;
+		bMonotonic &= Index >= PreviousIndex;
+		PreviousIndex = Index;
+	}
+	TestTrue(TEXT("Values are below the upper bound of their bucket"), bValueBelowBound);
+	TestTrue(TEXT("Upper bounds are within the relative error of the values in the bucket"), bBoundWithinRatio);
+	TestTrue(TEXT("Upper bounds are exclusive"), bBoundStartsNextBucket);
+	TestTrue(TEXT("Larger values never go to smaller buckets"), bMonotonic);
+
+	TestEqual(TEXT("The smallest value in range has the first bucket in range"), FHistogram::GetBucketIndex(RangeMin),
+		1);
+	TestEqual(TEXT("Zero goes to the first bucket"), FHistogram::GetBucketIndex(0.0), 0);
+	TestEqual(TEXT("Negative values go to the first bucket"), FHistogram::GetBucketIndex(-5.0), 0);
+	TestEqual(TEXT("NaN goes to the first bucket"),
+		FHistogram::GetBucketIndex(std::numeric_limits<double>::quiet_NaN()), 0);
+	TestEqual(TEXT("Values above the range go to the last bucket"), FHistogram::GetBucketIndex(RangeMax * 4.0),
+		FHistogram::NumBuckets - 1);
+	TestEqual(TEXT("The first bucket in range ends one sub-bucket up"), FHistogram::GetBucketUpperBound(1),
+		RangeMin * MaxBucketRatio);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapHistogramPercentilesTest, "CleverTap.Metrics.HistogramPercentiles",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapHistogramPercentilesTest::RunTest(const FString& Parameters)
+{
+	FHistogram Empty;
+	TestEqual(TEXT("An empty histogram reports zero"), Empty.GetPercentile(50.0), 0.0);
+
+	// 1 to 1000, split between two histograms so the percentiles come from the merge
+	FHistogram Odd;
+	FHistogram Even;
+	for (int32 Value = 1; Value <= 1000; ++Value)
+	{
+		(Value % 2 ? Odd : Even).Record(double(Value));
+	}
+	FHistogram Merged;
+	Merged.Merge(Odd);
+	Merged.Merge(Empty);
+	Merged.Merge(Even);
+
+	TestEqual(TEXT("Merging adds up the counts"), Merged.GetCount(), uint64(1000));
+	TestEqual(TEXT("Merging adds up the sums"), Merged.GetSum(), 500500.0);
+	TestEqual(TEXT("Merging keeps the smallest minimum"), Merged.GetMin(), 1.0);
+	TestEqual(TEXT("Merging keeps the largest maximum"), Merged.GetMax(), 1000.0);
+
+	const double Percentiles[] = { 1.0, 50.0, 90.0, 99.0 };
+	for (double Percentile : Percentiles)
+	{
+		const double Exact = Percentile * 10.0;
+		const double Reported = Merged.GetPercentile(Percentile);
+		TestTrue(FString::Printf(TEXT("P%g is within the relative error of the exact value"), Percentile),
+			Reported >= Exact && Reported <= Exact * MaxBucketRatio);
+	}
+	TestEqual(TEXT("Percentiles are clamped to the maximum"), Merged.GetPercentile(100.0), 1000.0);
+
+	Merged.Reset();
+	TestEqual(TEXT("Resetting empties the histogram"), Merged.GetCount(), uint64(0));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapMetricRegistryThreadsTest, "CleverTap.Metrics.MergeAcrossThreads",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapMetricRegistryThreadsTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumThreads = 4;
+	constexpr int32 NumUpdates = 1000;
+
+	TArray<FCleverTapProperties> Pushed;
+	FCleverTapMetricRegistry Registry(MakeConfig(), [&Pushed](const FString&, const FCleverTapProperties& Summary) {
+		Pushed.Add(Summary);
+	});
+	const FCleverTapCounter Counter = Registry.Counter(TEXT("Counter"));
+	const FCleverTapGauge Gauge = Registry.Gauge(TEXT("Gauge"));
+	const FCleverTapHistogram Histogram = Registry.Histogram(TEXT("Histogram"));
+
+	TArray<TUniquePtr<FThread>> Threads;
+	for (int32 ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+	{
+		Threads.Add(MakeUnique<FThread>(TEXT("CleverTapMetricsTest"), [=]() {
+			for (int32 Update = 0; Update < NumUpdates; ++Update)
+			{
+				Counter.Add();
+				Gauge.Set(double(ThreadIndex));
+				Histogram.Record(double(ThreadIndex + 1));
+			}
+		}));
+	}
+	Counter.Add(10.0);
+	for (const TUniquePtr<FThread>& Thread : Threads)
+	{
+		Thread->Join();
+	}
+
+	Registry.Flush();
+	if (!TestEqual(TEXT("A flush pushes one summary"), Pushed.Num(), 1))
+	{
+		return false;
+	}
+	const FCleverTapProperties& Summary = Pushed[0];
+	TestEqual(TEXT("Counters add up across threads"), GetNumber(Summary, TEXT("Counter")),
+		double(NumThreads * NumUpdates + 10));
+	const double GaugeValue = GetNumber(Summary, TEXT("Gauge"));
+	TestTrue(TEXT("Gauges report a value set by one of the threads"), GaugeValue >= 0.0 && GaugeValue < NumThreads);
+	TestEqual(TEXT("Histograms count the values of every thread"), GetNumber(Summary, TEXT("Histogram Count")),
+		double(NumThreads * NumUpdates));
+	TestEqual(TEXT("Histograms merge the minimum"), GetNumber(Summary, TEXT("Histogram Min")), 1.0);
+	TestEqual(TEXT("Histograms merge the maximum"), GetNumber(Summary, TEXT("Histogram Max")), double(NumThreads));
+	TestEqual(TEXT("Histograms merge the mean"), GetNumber(Summary, TEXT("Histogram Mean")),
+		(1.0 + NumThreads) / 2.0);
+	TestEqual(TEXT("The shards of exited threads are freed"), Registry.GetNumShards(), 1);
+
+	Registry.Flush();
+	TestEqual(TEXT("Nothing is pushed without updates"), Pushed.Num(), 1);
+
+	// switching between more registries than the thread local cache holds retires the shards that fall out of it
+	const auto IgnoreSummary = [](const FString&, const FCleverTapProperties&) {};
+	TArray<TUniquePtr<FCleverTapMetricRegistry>> Others;
+	for (int32 Index = 0; Index < 4; ++Index)
+	{
+		Others.Add(MakeUnique<FCleverTapMetricRegistry>(MakeConfig(), IgnoreSummary));
+		Others.Last()->Counter(TEXT("Other")).Add();
+	}
+	Counter.Add();
+	TestEqual(TEXT("A thread gets a new shard once its shard falls out of the cache"), Registry.GetNumShards(), 2);
+	Registry.Flush();
+	TestEqual(TEXT("Updates to a retired shard are kept"), GetNumber(Pushed.Last(), TEXT("Counter")), 1.0);
+	TestEqual(TEXT("Retired shards are freed by the flush"), Registry.GetNumShards(), 1);
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,102 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapAllocationTracker.h"
+#include "CleverTapInstanceConfig.h"
+#include "GenericPlatformCleverTapInstance.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+/**
+ * Counts the allocations made by this thread while a callable runs.
+ */
+template <typename TCallable>
+int32 CountAllocations(TCallable&& Callable)
+{
+	FCleverTapAllocationTracker& Tracker = FCleverTapAllocationTracker::Get();
+	Tracker.Install();
+	Callable();
+	Tracker.Uninstall();
+	return Tracker.GetNumAllocations();
+}
+
+/**
+ * The string property of the only property set of the next buffered record, or an empty string.
+ */
+FString DequeueWeapon(GenericPlatform::FGenericPlatformCleverTapInstance& Instance)
+{
+	TArray<FCleverTapEventRecord> Records;
+	TArray<FCleverTapProperties> PropertySets;
+	if (Instance.GetQueue().Dequeue(1, Records) == 0 || !Records[0].ReadProperties(PropertySets))
+	{
+		return FString{};
+	}
+	const FCleverTapPropertyValue* Weapon = PropertySets.Num() > 0 ? PropertySets[0].Find(TEXT("Weapon")) : nullptr;
+	const FString* Name = Weapon ? Weapon->TryGet<FString>() : nullptr;
+	return Name ? *Name : FString{};
+}
+
+FCleverTapProperties MakeProperties()
+{
+	FCleverTapProperties Properties;
+	Properties.Add(TEXT("Level"), 12);
+	Properties.Add(TEXT("Weapon"), FString(TEXT("Crossbow")));
+	Properties.Add(TEXT("Score"), 1234.5);
+	return Properties;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapMoveOverloadsTest, "CleverTap.Instance.MoveOverloadsDontAllocate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapMoveOverloadsTest::RunTest(const FString& Parameters)
+{
+	GenericPlatform::FGenericPlatformCleverTapInstance Generic{ FCleverTapInstanceConfig{} };
+	ICleverTapInstance& Instance = Generic;
+
+	// the generic instance encodes the payload into a record as it is enqueued, so moving it in can't avoid that
+	//  record's allocations, but it must never add any on top of the copying overload
+	int32 NumCopyAllocations = 0;
+	{
+		FString Name = TEXT("Level Completed");
+		FCleverTapProperties Properties = MakeProperties();
+		NumCopyAllocations = CountAllocations([&] { Instance.PushEvent(Name, Properties); });
+		TestTrue(TEXT("The copying PushEvent() allocates, so the counter works"), NumCopyAllocations > 0);
+		TestEqual(
+			TEXT("The copied event keeps its string property"), DequeueWeapon(Generic), FString(TEXT("Crossbow")));
+	}
+	{
+		FString Name = TEXT("Level Completed");
+		FCleverTapProperties Properties = MakeProperties();
+		const int32 NumAllocations =
+			CountAllocations([&] { Instance.PushEvent(MoveTemp(Name), MoveTemp(Properties)); });
+		TestTrue(FString::Printf(TEXT("Moving into PushEvent() allocates no more than copying (%d, %d)"),
+					 NumAllocations, NumCopyAllocations),
+			NumAllocations <= NumCopyAllocations);
+		TestEqual(TEXT("The moved event keeps its string property"), DequeueWeapon(Generic), FString(TEXT("Crossbow")));
+	}
+	{
+		FCleverTapProperties ChargeDetails = MakeProperties();
+		TArray<FCleverTapProperties> Items;
+		Items.Add(MakeProperties());
+		Items.Add(MakeProperties());
+		const int32 NumCopyChargedAllocations =
+			CountAllocations([&] { Instance.PushChargedEvent(ChargeDetails, Items); });
+		const int32 NumAllocations =
+			CountAllocations([&] { Instance.PushChargedEvent(MoveTemp(ChargeDetails), MoveTemp(Items)); });
+		TestTrue(FString::Printf(TEXT("Moving into PushChargedEvent() allocates no more than copying (%d, %d)"),
+					 NumAllocations, NumCopyChargedAllocations),
+			NumAllocations <= NumCopyChargedAllocations);
+		TestEqual(TEXT("Both charged events are buffered"), Generic.GetQueue().Num(), 2);
+	}
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
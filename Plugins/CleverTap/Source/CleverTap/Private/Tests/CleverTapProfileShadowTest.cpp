@@ -0,0 +1,156 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapProfileShadow.h"
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+constexpr int32 NumKeys = 12;
+constexpr int32 NumValueIds = 6;
+
+/**
+ * A distinct value for every id, cycling through the property value types.
+ */
+FCleverTapPropertyValue MakeValue(int32 ValueId)
+{
+	switch (ValueId % 5)
+	{
+		case 0:
+			return FCleverTapPropertyValue(ValueId);
+		case 1:
+			return FCleverTapPropertyValue(double(ValueId) + 0.5);
+		case 2:
+			return FCleverTapPropertyValue(FString::Printf(TEXT("Value %d"), ValueId));
+		case 3:
+			return FCleverTapPropertyValue(TArray<int32>{ ValueId, ValueId + 1 });
+		default:
+			return FCleverTapPropertyValue(FCleverTapDate(2000 + ValueId, 1, 1));
+	}
+}
+
+FString MakeKey(int32 KeyIndex)
+{
+	return FString::Printf(TEXT("Field %d"), KeyIndex);
+}
+
+/**
+ * The profile as the server sees it: the id of the last value received for each key.
+ */
+using FServerProfile = TMap<FString, int32>;
+
+void Receive(FServerProfile& Server, const FCleverTapProperties& Fields, const TMap<FString, int32>& ValueIds)
+{
+	for (const TPair<FString, FCleverTapPropertyValue>& Field : Fields)
+	{
+		Server.Add(Field.Key, ValueIds[Field.Key]);
+	}
+}
+
+/**
+ * Applies the same random sequence of logins, pushes and increments to a server receiving every push in full and to
+ *  one receiving only the fields the shadow lets through, and checks that both end up with the same profile.
+ */
+bool RunSequence(FAutomationTestBase& Test, int32 Seed, int32 MaxFields)
+{
+	FRandomStream Random(Seed);
+	FCleverTapProfileShadow Shadow(MaxFields);
+	FServerProfile FullServer;
+	FServerProfile FilteredServer;
+	int32 NextIncrementId = 1000;
+
+	for (int32 Step = 0; Step < 500; ++Step)
+	{
+		FCleverTapProperties Profile;
+		TMap<FString, int32> ValueIds;
+		const int32 NumFields = Random.RandRange(1, 5);
+		for (int32 FieldIndex = 0; FieldIndex < NumFields; ++FieldIndex)
+		{
+			const FString Key = MakeKey(Random.RandRange(0, NumKeys - 1));
+			const int32 ValueId = Random.RandRange(0, NumValueIds - 1);
+			Profile.Add(Key, MakeValue(ValueId));
+			ValueIds.Add(Key, ValueId);
+		}
+
+		const int32 Operation = Random.RandRange(0, 9);
+		if (Operation == 0)
+		{
+			// a login replaces the profile on both servers and seeds the shadow
+			FullServer.Reset();
+			FilteredServer.Reset();
+			Receive(FullServer, Profile, ValueIds);
+			Receive(FilteredServer, Profile, ValueIds);
+			Shadow.Reset(Profile);
+		}
+		else if (Operation == 1)
+		{
+			// an increment changes the field on the server without going through the shadow
+			const FString Key = MakeKey(Random.RandRange(0, NumKeys - 1));
+			FullServer.Add(Key, NextIncrementId);
+			FilteredServer.Add(Key, NextIncrementId);
+			++NextIncrementId;
+			Shadow.Invalidate(Key);
+		}
+		else
+		{
+			Receive(FullServer, Profile, ValueIds);
+			Receive(FilteredServer, Shadow.FilterChangedFields(Profile), ValueIds);
+		}
+
+		if (!FullServer.OrderIndependentCompareEqual(FilteredServer))
+		{
+			Test.AddError(FString::Printf(
+				TEXT("Seed %d, %d tracked fields: the profiles differ after step %d"), Seed, MaxFields, Step));
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapProfileShadowEndStateTest, "CleverTap.ProfileShadow.EndState",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapProfileShadowEndStateTest::RunTest(const FString& Parameters)
+{
+	for (int32 Seed = 1; Seed <= 20; ++Seed)
+	{
+		RunSequence(*this, Seed, FCleverTapProfileShadow::DefaultMaxFields);
+		RunSequence(*this, Seed, 4); // fewer tracked fields than keys
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapProfileShadowFilterTest, "CleverTap.ProfileShadow.Filter",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapProfileShadowFilterTest::RunTest(const FString& Parameters)
+{
+	FCleverTapProfileShadow Shadow;
+	FCleverTapProperties Profile;
+	Profile.Add(TEXT("Name"), FString(TEXT("Ada")));
+	Profile.Add(TEXT("Level"), 3);
+
+	TestEqual(TEXT("The first push sends every field"), Shadow.FilterChangedFields(Profile).Num(), 2);
+	TestEqual(TEXT("An unchanged push sends nothing"), Shadow.FilterChangedFields(Profile).Num(), 0);
+
+	Profile.Add(TEXT("Level"), 4);
+	const FCleverTapProperties Changed = Shadow.FilterChangedFields(Profile);
+	TestTrue(TEXT("Only the changed field is sent"), Changed.Num() == 1 && Changed.Contains(TEXT("Level")));
+
+	Profile.Add(TEXT("Level"), int64(4));
+	TestEqual(TEXT("A value of another type is a change"), Shadow.FilterChangedFields(Profile).Num(), 1);
+
+	Shadow.Invalidate(TEXT("Name"));
+	TestEqual(TEXT("An invalidated field is sent again"), Shadow.FilterChangedFields(Profile).Num(), 1);
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,50 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapProperties.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapPropertyValueCopyOnWriteTest, "CleverTap.Properties.CopyOnWrite",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapPropertyValueCopyOnWriteTest::RunTest(const FString& Parameters)
+{
+	{
+		FCleverTapPropertyValue Original(FString(TEXT("Crossbow")));
+		const FCleverTapPropertyValue& ConstOriginal = Original;
+		const FCleverTapPropertyValue Copy = Original;
+		TestTrue(TEXT("Copies share their contents"), &ConstOriginal.Get<FString>() == &Copy.Get<FString>());
+
+		Original.Get<FString>() += TEXT("s");
+		TestEqual(TEXT("Writing detaches the written value"), Original.Get<FString>(), FString(TEXT("Crossbows")));
+		TestEqual(TEXT("Writing leaves the copies unchanged"), Copy.Get<FString>(), FString(TEXT("Crossbow")));
+	}
+	{
+		FCleverTapPropertyValue Original(TArray<int32>{ 1, 2, 3 });
+		TArray<int32>& Array = *Original.TryGet<TArray<int32>>();
+		const FCleverTapPropertyValue Copy = Original;
+		Array.Add(4);
+		TestEqual(TEXT("A held reference writes to its own value"), Original.Get<TArray<int32>>().Num(), 4);
+		TestEqual(TEXT("Copies made after a mutable access don't see later writes"),
+			Copy.Get<TArray<int32>>().Num(), 3);
+
+		const FCleverTapPropertyValue SecondCopy = Copy;
+		TestTrue(TEXT("Copies of an unwritten value still share their contents"),
+			&Copy.Get<TArray<int32>>() == &SecondCopy.Get<TArray<int32>>());
+	}
+	{
+		FCleverTapPropertyValue Original(FCleverTapDate(2025, 12, 31));
+		FCleverTapPropertyValue Copy = Original;
+		Copy.Get<FCleverTapDate>().Day = 30;
+		TestEqual(TEXT("Dates are copied on write"), Original.Get<FCleverTapDate>().Day, 31);
+		TestEqual(TEXT("Dates keep their fields"), Copy.Get<FCleverTapDate>().ToString(), FString(TEXT("2025-12-30")));
+	}
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,147 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapSessionAggregator.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+struct FPushedSummary
+{
+	FString EventName;
+	FCleverTapProperties Summary;
+};
+
+FCleverTapSessionAggregator::FPushSummary CollectInto(TArray<FPushedSummary>& Pushed)
+{
+	return [&Pushed](const FString& EventName, const FCleverTapProperties& Summary) {
+		Pushed.Add(FPushedSummary{ EventName, Summary });
+	};
+}
+
+/**
+ * The number in Summary under Key, whether it was reported as an integer or not, or -1 if there is none.
+ */
+double GetNumber(const FCleverTapProperties& Summary, const FString& Key)
+{
+	const FCleverTapPropertyValue* const Value = Summary.Find(Key);
+	if (!Value)
+	{
+		return -1.0;
+	}
+	if (const int64* const Integer = Value->TryGet<int64>())
+	{
+		return double(*Integer);
+	}
+	const double* const Number = Value->TryGet<double>();
+	return Number ? *Number : -1.0;
+}
+
+} // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapSessionAggregatorSummaryTest, "CleverTap.SessionAggregator.Summary",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapSessionAggregatorSummaryTest::RunTest(const FString& Parameters)
+{
+	FCleverTapInstanceConfig Config;
+	Config.SessionSummaryEventName = TEXT("Test Summary");
+	TArray<FPushedSummary> Pushed;
+	FCleverTapSessionAggregator Aggregator(Config, CollectInto(Pushed));
+
+	Aggregator.AddCounter(TEXT("Kills"), 1.0);
+	Aggregator.AddCounter(TEXT("Kills"), 2.0);
+	Aggregator.AddCounter(TEXT("Gold"), 2.5);
+	Aggregator.SetGauge(TEXT("Fps"), 60.0);
+	Aggregator.SetGauge(TEXT("Fps"), 30.0);
+	Aggregator.SetGauge(TEXT("Fps"), 45.0);
+
+	AddExpectedError(TEXT("Session aggregate 'Kills' is already used as a counter"),
+		EAutomationExpectedErrorFlags::Contains, 1);
+	Aggregator.SetGauge(TEXT("Kills"), 100.0);
+
+	Aggregator.EndSession();
+	if (!TestEqual(TEXT("Ending the session pushes one summary"), Pushed.Num(), 1))
+	{
+		return false;
+	}
+	const FCleverTapProperties& Summary = Pushed[0].Summary;
+	TestEqual(TEXT("The summary has the configured name"), Pushed[0].EventName, Config.SessionSummaryEventName);
+	TestEqual(TEXT("Counters add up"), GetNumber(Summary, TEXT("Kills")), 3.0);
+	TestEqual(TEXT("Counters keep fractions"), GetNumber(Summary, TEXT("Gold")), 2.5);
+	TestEqual(TEXT("Gauges report the last value"), GetNumber(Summary, TEXT("Fps")), 45.0);
+	TestEqual(TEXT("Gauges report the minimum"), GetNumber(Summary, TEXT("Fps Min")), 30.0);
+	TestEqual(TEXT("Gauges report the maximum"), GetNumber(Summary, TEXT("Fps Max")), 60.0);
+	TestTrue(TEXT("The summary reports the session length"), GetNumber(Summary, TEXT("Session Seconds")) >= 0.0);
+	TestTrue(TEXT("The summary reports the period length"), GetNumber(Summary, TEXT("Period Seconds")) >= 0.0);
+	const FCleverTapPropertyValue* const SessionEnd = Summary.Find(TEXT("Session End"));
+	TestTrue(TEXT("The summary marks the end of the session"), SessionEnd && SessionEnd->Get<bool>());
+	TestEqual(TEXT("The summary holds nothing else"), Summary.Num(), 8);
+
+	Aggregator.EndSession();
+	TestEqual(TEXT("Nothing is pushed for a session without updates"), Pushed.Num(), 1);
+
+	Aggregator.AddCounter(TEXT("Kills"), 1.0);
+	Aggregator.EndSession();
+	if (!TestEqual(TEXT("The next session pushes its own summary"), Pushed.Num(), 2))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Counters restart in a new session"), GetNumber(Pushed[1].Summary, TEXT("Kills")), 1.0);
+	TestFalse(TEXT("Aggregates not updated in the session are left out"), Pushed[1].Summary.Contains(TEXT("Fps")));
+
+	AddExpectedError(TEXT("Session aggregates need a name"), EAutomationExpectedErrorFlags::Contains, 1);
+	Aggregator.AddCounter(NAME_None, 1.0);
+	Aggregator.EndSession();
+	TestEqual(TEXT("Aggregates without a name are ignored"), Pushed.Num(), 2);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapSessionAggregatorGrowthTest, "CleverTap.SessionAggregator.Growth",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapSessionAggregatorGrowthTest::RunTest(const FString& Parameters)
+{
+	// far more names than the initial table holds, updated a second time once the table has grown
+	constexpr int32 NumNames = 1000;
+	TArray<FName> Names;
+	for (int32 Index = 0; Index < NumNames; ++Index)
+	{
+		Names.Add(FName(*FString::Printf(TEXT("Counter %d"), Index)));
+	}
+
+	TArray<FPushedSummary> Pushed;
+	FCleverTapSessionAggregator Aggregator(FCleverTapInstanceConfig{}, CollectInto(Pushed));
+	for (int32 Round = 0; Round < 2; ++Round)
+	{
+		for (int32 Index = 0; Index < NumNames; ++Index)
+		{
+			Aggregator.AddCounter(Names[Index], double(Index));
+		}
+	}
+	Aggregator.SetGauge(TEXT("Gauge"), 1.0);
+	Aggregator.EndSession();
+
+	if (!TestEqual(TEXT("One summary is pushed"), Pushed.Num(), 1))
+	{
+		return false;
+	}
+	const FCleverTapProperties& Summary = Pushed[0].Summary;
+	TestEqual(TEXT("Every aggregate is reported once"), Summary.Num(), NumNames + 3 + 3);
+	bool bAllAddUp = true;
+	for (int32 Index = 0; Index < NumNames; ++Index)
+	{
+		bAllAddUp &= GetNumber(Summary, Names[Index].ToString()) == 2.0 * Index;
+	}
+	TestTrue(TEXT("Growing the table keeps every counter"), bAllAddUp);
+	TestEqual(TEXT("Growing the table keeps every gauge"), GetNumber(Summary, TEXT("Gauge Max")), 1.0);
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,63 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapConfig.h"
+#include "CleverTapStartupProfiler.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapStartupProfilerBudgetTest, "CleverTap.StartupProfiler.Budget",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapStartupProfilerBudgetTest::RunTest(const FString& Parameters)
+{
+	{
+		FStartupProfiler Profiler;
+		Profiler.RecordStep(TEXT("Outer"), 0.004, true);
+		Profiler.RecordStep(TEXT("Inner"), 0.003, false);
+		TestEqual(TEXT("Only top-level steps count towards the total"), Profiler.GetTotalSeconds(), 0.004);
+		TestTrue(TEXT("A total within the budget passes"), Profiler.ReportSummary(5.0f));
+
+		Profiler.RecordStep(TEXT("Late"), 1.0, true);
+		TestEqual(TEXT("Steps after the summary are not recorded"), Profiler.GetNumSteps(), 2);
+		TestEqual(TEXT("Steps after the summary don't add to the total"), Profiler.GetTotalSeconds(), 0.004);
+	}
+	{
+		FStartupProfiler Profiler;
+		Profiler.RecordStep(TEXT("Slow"), 0.010, true);
+		AddExpectedError(TEXT("exceeding the startup budget"), EAutomationExpectedErrorFlags::Contains, 1);
+		TestFalse(TEXT("A total over the budget fails"), Profiler.ReportSummary(5.0f));
+		TestTrue(TEXT("Only the first summary is checked"), Profiler.ReportSummary(5.0f));
+	}
+	{
+		FStartupProfiler Profiler;
+		Profiler.RecordStep(TEXT("Slow"), 10.0, true);
+		TestTrue(TEXT("A budget of 0 disables the check"), Profiler.ReportSummary(0.0f));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapStartupWithinBudgetTest, "CleverTap.StartupProfiler.StartupWithinBudget",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapStartupWithinBudgetTest::RunTest(const FString& Parameters)
+{
+	const UCleverTapConfig* const Config = GetDefault<UCleverTapConfig>();
+	const float BudgetMilliseconds = Config->StartupBudgetMilliseconds;
+	if (BudgetMilliseconds <= 0.0f)
+	{
+		AddInfo(TEXT("StartupBudgetMilliseconds is 0; the startup time is not checked."));
+		return true;
+	}
+
+	const double TotalMilliseconds = FStartupProfiler::Get().GetTotalSeconds() * 1000.0;
+	TestTrue(FString::Printf(TEXT("Startup took %.3fms, the budget is %.3fms"), TotalMilliseconds, BudgetMilliseconds),
+		TotalMilliseconds <= BudgetMilliseconds);
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,120 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapEventQueue.h"
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapOfflineStore.h"
+#include "CleverTapUploader.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+constexpr int32 BatchEvents = 10;
+constexpr int32 NumStored = 5;
+constexpr int32 NumInMemory = 10;
+constexpr int32 NumEnqueuedLater = 5;
+constexpr double TimeoutSeconds = 5.0;
+
+FCleverTapEventRecord MakeRecord(int32 Index)
+{
+	return FCleverTapEventRecord::Make(ECleverTapEventRecordType::Event, FString::Printf(TEXT("Event %02d"), Index));
+}
+
+/**
+ * The queue and uploader of one run; declared so the uploader is destroyed before the queue.
+ */
+struct FUploaderRun
+{
+	FString Directory;
+	TUniquePtr<FCleverTapEventQueue> Queue;
+	TUniquePtr<FCleverTapUploader> Uploader;
+	double StartSeconds = 0.0;
+};
+
+} // namespace
+
+/**
+ * Waits until the uploader has taken the queued records, destroys it and the queue while the batches are unfinished,
+ *  then checks what the next session reads from the offline store.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FCleverTapShutDownUploaderCommand, TSharedRef<FUploaderRun>, Run,
+	FAutomationTestBase*, Test);
+
+bool FCleverTapShutDownUploaderCommand::Update()
+{
+	const bool bTaken = Run->Queue->Num() == 0;
+	if (!bTaken && FPlatformTime::Seconds() - Run->StartSeconds < TimeoutSeconds)
+	{
+		return false;
+	}
+
+	Test->TestTrue(TEXT("The uploader takes the queued records"), bTaken);
+	Test->TestTrue(TEXT("The batches are unfinished"), !Run->Uploader->IsIdle());
+	for (int32 Index = NumStored + NumInMemory; Index < NumStored + NumInMemory + NumEnqueuedLater; ++Index)
+	{
+		Run->Queue->Enqueue(MakeRecord(Index));
+	}
+	Run->Uploader.Reset();
+	Run->Queue.Reset();
+
+	TArray<FString> Names;
+	{
+		FCleverTapOfflineStore Store(Run->Directory, 1024 * 1024);
+		FCleverTapEventRecord Record;
+		while (Store.Pop(Record))
+		{
+			Names.Add(Record.Name);
+		}
+		Store.Acknowledge(Store.GetNumUnacknowledged());
+	}
+	TArray<FString> Expected;
+	for (int32 Index = 0; Index < NumStored + NumInMemory + NumEnqueuedLater; ++Index)
+	{
+		Expected.Add(MakeRecord(Index).Name);
+	}
+	Test->TestEqual(TEXT("The next session reads every record once, in the order it was enqueued"),
+		FString::Join(Names, TEXT(", ")), FString::Join(Expected, TEXT(", ")));
+
+	IFileManager::Get().DeleteDirectory(*Run->Directory, /*RequireExists=*/false, /*Tree=*/true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapUploaderShutdownTest, "CleverTap.Uploader.SpillToDiskShutdown",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapUploaderShutdownTest::RunTest(const FString& Parameters)
+{
+	const TSharedRef<FUploaderRun> Run = MakeShared<FUploaderRun>();
+	Run->Directory = FPaths::AutomationTransientDir() / TEXT("CleverTapUploaderStore");
+	IFileManager::Get().DeleteDirectory(*Run->Directory, /*RequireExists=*/false, /*Tree=*/true);
+
+	// the oldest records spill to the store, so the first batch holds both stored records and records from memory
+	const int64 RecordBytes = MakeRecord(0).GetAllocatedSize();
+	Run->Queue = MakeUnique<FCleverTapEventQueue>(NumInMemory * RecordBytes,
+		ECleverTapBufferOverflowPolicy::SpillToDisk, MakeUnique<FCleverTapOfflineStore>(Run->Directory, 1024 * 1024));
+	for (int32 Index = 0; Index < NumStored + NumInMemory; ++Index)
+	{
+		Run->Queue->Enqueue(MakeRecord(Index));
+	}
+
+	// an address reserved for documentation, so the requests never complete; two batches take every record
+	FCleverTapInstanceConfig Config;
+	Config.UploadEndpointUrl = TEXT("http://192.0.2.1/events");
+	Config.UploadMaxBatchEvents = BatchEvents;
+	Config.UploadMinIntervalSeconds = 0.0f;
+	Config.UploadMaxConcurrentBatches = 2;
+	Run->StartSeconds = FPlatformTime::Seconds();
+	Run->Uploader = MakeUnique<FCleverTapUploader>(*Run->Queue, Config);
+	ADD_LATENT_AUTOMATION_COMMAND(FCleverTapShutDownUploaderCommand(Run, this));
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
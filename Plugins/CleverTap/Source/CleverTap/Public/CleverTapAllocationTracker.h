@@ -0,0 +1,65 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+#include <atomic>
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Stands in for GMalloc while installed and tracks the allocations of the installing thread: how many are made and
+ *  how many bytes they hold. Everything is forwarded to the replaced allocator, so allocations can be freed after the
+ *  tracker is uninstalled, and allocations of other threads are forwarded without being tracked. Bytes are only
+ *  tracked with allocators that report allocation sizes.
+ *
+ * Used by the automation tests and the CleverTapBenchmark module; not available in Shipping builds.
+ */
+class CLEVERTAP_API FCleverTapAllocationTracker final : public FMalloc
+{
+public:
+	/**
+	 * The tracker shared by tests and benchmarks. It is never destroyed, as other threads may still be calling into it
+	 *  after it is uninstalled.
+	 */
+	static FCleverTapAllocationTracker& Get();
+
+	/**
+	 * Replaces GMalloc and starts tracking the calling thread from zero.
+	 */
+	void Install();
+	void Uninstall();
+
+	/**
+	 * The number of allocations and reallocations made by the tracked thread since Install().
+	 */
+	int32 GetNumAllocations() const { return NumAllocations.load(std::memory_order_relaxed); }
+
+	/**
+	 * The bytes allocated minus the bytes freed by the tracked thread since Install().
+	 */
+	int64 GetLiveBytes() const { return LiveBytes; }
+
+	void* Malloc(SIZE_T Count, uint32 Alignment) override;
+	void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override;
+	void Free(void* Original) override;
+	bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override;
+	SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override;
+	void Trim(bool bTrimThreadCaches) override;
+	bool IsInternallyThreadSafe() const override;
+	const TCHAR* GetDescriptiveName() override;
+
+private:
+	FCleverTapAllocationTracker() = default;
+
+	bool IsTrackedThread() const;
+	void TrackBytes(void* Pointer, int64 Sign);
+
+	FMalloc* Inner = nullptr;
+	uint32 TrackedThreadId = 0;
+	std::atomic<int32> NumAllocations{ 0 };
+	int64 LiveBytes = 0; // only changed by the tracked thread
+};
+
+#endif // !UE_BUILD_SHIPPING
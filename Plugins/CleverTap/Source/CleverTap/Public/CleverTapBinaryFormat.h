@@ -0,0 +1,43 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+
+/**
+ * A compact binary encoding of CleverTap properties for storage on disk, e.g. offline event queues.
+ *
+ * Unlike JSON the encoding is lossless: every FCleverTapPropertyValue reads back with the type and value it was written
+ *  with. Integers are stored as variable length integers, floating point values as their raw little endian bits and
+ *  strings as UTF-8, flagged when they contain non-ASCII characters so plain ASCII can be widened without decoding.
+ *  The encoding is the same whatever the size of TCHAR on the platform.
+ *
+ * The encoding is versioned by its header but has no forward compatibility; data written by another version is
+ *  rejected.
+ */
+class CLEVERTAP_API FCleverTapBinaryFormat
+{
+public:
+	/**
+	 * Appends the encoded properties to Output.
+	 */
+	static void Write(const FCleverTapProperties& Properties, TArray<uint8>& Output);
+	static void Write(const FCleverTapPayload& Properties, TArray<uint8>& Output);
+
+	/**
+	 * Appends properties encoded by Write() followed by the properties of each of Overrides as a single encoded set,
+	 *  without decoding them. Keys may repeat; reading into FCleverTapProperties keeps the last value of a key, so each
+	 *  override takes precedence over the encoded properties and the overrides before it. Encoded may be empty.
+	 */
+	static void WriteLayered(TArrayView<const uint8> Encoded, TArrayView<const FCleverTapProperties* const> Overrides,
+		TArray<uint8>& Output);
+
+	/**
+	 * Decodes properties written by Write(). Returns false and describes the problem in OutError if the data is
+	 *  truncated, corrupt or of an unknown version. Properties decoded before the error are left in OutProperties.
+	 *  Of keys that repeat, FCleverTapProperties keeps the last value and FCleverTapPayload all of them.
+	 */
+	static bool Read(TArrayView<const uint8> Data, FCleverTapProperties& OutProperties, FString* OutError = nullptr);
+	static bool Read(TArrayView<const uint8> Data, FCleverTapPayload& OutProperties, FString* OutError = nullptr);
+};
@@ -0,0 +1,21 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CleverTapBufferPolicy.generated.h"
+
+/**
+ * What an instance does with new events once its buffered events exceed the configured byte budget
+ */
+UENUM(BlueprintType)
+enum class ECleverTapBufferOverflowPolicy : uint8
+{
+	// (Default) Drop the oldest buffered events until the new event fits. Charged events are dropped last.
+	DropOldest,
+
+	// Keep the buffered events and drop the new event
+	DropNewest,
+
+	// Move the oldest buffered events to the offline store on disk, which is bounded by OfflineStoreMaxMegabytes
+	SpillToDisk,
+};
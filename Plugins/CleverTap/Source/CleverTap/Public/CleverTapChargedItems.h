@@ -0,0 +1,58 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+
+/**
+ * The items of a charged event stored by column: one key per column and one typed array holding the values of that
+ *  key for all items.
+ *
+ * Compared to TArray<FCleverTapProperties> each key is stored once instead of once per item, and the platform SDKs
+ *  convert each column in a single bulk operation instead of building every item property by property. The generic
+ *  instance buffers the columns as they are and only splits them into items as the upload is written.
+ *
+ * \code
+ * FCleverTapChargedItems Items;
+ * Items.AddColumn(TEXT("Product"), TArray<FString>{ TEXT("Sword"), TEXT("Shield") })
+ * 	.AddColumn(TEXT("Quantity"), TArray<int32>{ 1, 2 })
+ * 	.AddColumn(TEXT("Price"), TArray<double>{ 4.99, 2.99 });
+ * CleverTap.PushChargedEvent(ChargeDetails, Items);
+ * \endcode
+ */
+class CLEVERTAP_API FCleverTapChargedItems
+{
+public:
+	/**
+	 * Adds a column holding one value per item. The first column sets the number of items; columns with a different
+	 *  number of values are rejected with an error. Adding a column with the key of an existing column replaces it.
+	 *  Values can be int32, int64, float, double, bool or FString.
+	 */
+	template <typename T> FCleverTapChargedItems& AddColumn(FString Key, TArray<T> Values)
+	{
+		const int32 NumValues = Values.Num();
+		return AddColumnValues(MoveTemp(Key), NumValues, FCleverTapPropertyValue(MoveTemp(Values)));
+	}
+
+	/**
+	 * Returns the number of items.
+	 */
+	int32 Num() const { return NumItems; }
+
+	/**
+	 * Returns the columns as key and array value pairs, in the order they were added.
+	 */
+	const FCleverTapPayload& GetColumns() const { return Columns; }
+
+	/**
+	 * Converts the columns to one set of properties per item.
+	 */
+	TArray<FCleverTapProperties> ToRows() const;
+
+private:
+	FCleverTapChargedItems& AddColumnValues(FString Key, int32 NumValues, FCleverTapPropertyValue&& Values);
+
+	FCleverTapPayload Columns;
+	int32 NumItems = 0;
+};
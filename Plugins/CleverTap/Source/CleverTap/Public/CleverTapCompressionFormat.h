@@ -0,0 +1,21 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CleverTapCompressionFormat.generated.h"
+
+/**
+ * The codec used to compress large event payloads before they are stored on disk or uploaded
+ */
+UENUM(BlueprintType)
+enum class ECleverTapCompressionFormat : uint8
+{
+	// Payloads are never compressed
+	None,
+
+	// (Default) Fast compression and very fast decompression with a moderate ratio
+	LZ4,
+
+	// A better ratio than LZ4 at a higher CPU cost
+	Zlib,
+};
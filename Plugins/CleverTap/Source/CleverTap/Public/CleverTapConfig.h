@@ -2,6 +2,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "CleverTapBufferPolicy.h"
+#include "CleverTapCompressionFormat.h"
 #include "CleverTapLogLevel.h"
 #include "CleverTapConfig.generated.h"
 
@@ -88,6 +90,116 @@ public:
 	UPROPERTY(config, EditAnywhere, BlueprintReadOnly)
 	ECleverTapLogLevel ShippingLogLevel = ECleverTapLogLevel::Off;
 
+	/**
+	 * Time budget in milliseconds for plugin startup and shared instance initialization. A warning is logged with the
+	 *  startup summary when initialization exceeds this budget. Set to 0 to disable the check.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float StartupBudgetMilliseconds = 0.0f;
+
+	/**
+	 * When true, PushProfile() only sends the profile fields whose values changed since they were last pushed by this
+	 *  app session. Fields changed through other means (e.g. the dashboard or another device) are not detected, so
+	 *  only enable this when the app is the sole writer of the fields it pushes.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly)
+	bool bSendProfileChangesOnly = false;
+
+	/**
+	 * The most memory in kilobytes an instance uses to buffer events that have not been sent yet, or 0 for no limit.
+	 *  Only platforms without a CleverTap SDK buffer events in the plugin; the Android and iOS SDKs manage their own
+	 *  queues. Current and peak usage are reported by "stat CleverTap".
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	int32 BufferBudgetKilobytes = 512;
+
+	/**
+	 * What happens to events once the buffer budget is exhausted.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly)
+	ECleverTapBufferOverflowPolicy BufferOverflowPolicy = ECleverTapBufferOverflowPolicy::DropOldest;
+
+	/**
+	 * The most disk space in megabytes the offline store uses with the SpillToDisk overflow policy. The store lives in
+	 *  Saved/CleverTap/OfflineStore and keeps events across app restarts. Once it is full the oldest events are
+	 *  evicted, charged events last.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "1"))
+	int32 OfflineStoreMaxMegabytes = 16;
+
+	/**
+	 * The codec used for event data of at least CompressionThresholdBytes before it is written to the offline store,
+	 *  e.g. events with long string or array properties. Data that doesn't get smaller is stored as it is. The
+	 *  compression ratio and time are reported by "stat CleverTap".
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly)
+	ECleverTapCompressionFormat CompressionFormat = ECleverTapCompressionFormat::LZ4;
+
+	/**
+	 * The size in bytes from which event data is compressed. Small payloads rarely compress well enough to be worth
+	 *  the CPU time.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	int32 CompressionThresholdBytes = 1024;
+
+	/**
+	 * The name of the event that reports the counters and gauges recorded with AddSessionCounter() and
+	 *  SetSessionGauge().
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly)
+	FString SessionSummaryEventName = TEXT("Session Summary");
+
+	/**
+	 * How often in seconds a summary of the session counters and gauges is pushed during a session, or 0 to only push
+	 *  it when the session ends. Long sessions that end with the app being killed lose less data with an interval.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float SessionSummaryIntervalSeconds = 0.0f;
+
+	/**
+	 * The name of the event that reports the metrics recorded with Counter(), Gauge() and Histogram().
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly)
+	FString MetricsEventName = TEXT("Metrics");
+
+	/**
+	 * How often in seconds the metrics are pushed, or 0 to only push them when the app enters the background.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float MetricsIntervalSeconds = 60.0f;
+
+	/**
+	 * The URL buffered events are uploaded to on platforms without a CleverTap SDK, or empty to not upload them. The
+	 *  requests are described in CleverTapUploadProtocol.h.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly)
+	FString UploadEndpointUrl;
+
+	/**
+	 * The most events sent in one upload request. Batches grow towards this size when the round trip time is high.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "1"))
+	int32 UploadMaxBatchEvents = 500;
+
+	/**
+	 * The shortest interval in seconds between uploads.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float UploadMinIntervalSeconds = 1.0f;
+
+	/**
+	 * The longest interval in seconds between uploads while events are buffered.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "0"))
+	float UploadMaxIntervalSeconds = 60.0f;
+
+	/**
+	 * The most upload requests in flight at once. With more than one, throughput is no longer capped at one batch per
+	 *  round trip; batches may then arrive out of order and carry a sequence number to restore it.
+	 */
+	UPROPERTY(config, EditAnywhere, BlueprintReadOnly, meta = (ClampMin = "1"))
+	int32 UploadMaxConcurrentBatches = 4;
+
 	/**
 	 * Android Only: When true, automatically integrate Google Firebase Messaging.
 	 * Requires a valid AndroidGoogleServicesJsonPath.
@@ -0,0 +1,106 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapEventSchema.h"
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+#include "Misc/Optional.h"
+
+class ICleverTapInstance;
+
+/**
+ * Builds the properties of an event without hashing each key as it is added.
+ *
+ * Properties are appended in insertion order to a single array that is sized up front from the capacity hint.
+ *  Duplicate keys are resolved in one pass when the event is built: the last value added for a key wins, matching
+ *  FCleverTapProperties::Add(). Like FCleverTapProperties, keys are compared case-insensitively.
+ *
+ * \code
+ * FCleverTapEventBuilder(TEXT("Level Complete"), 3)
+ * 	.Add(TEXT("Level"), LevelIndex)
+ * 	.Add(TEXT("Score"), Score)
+ * 	.Add(TEXT("Duration"), DurationSeconds)
+ * 	.Push(CleverTap);
+ * \endcode
+ */
+class CLEVERTAP_API FCleverTapEventBuilder
+{
+public:
+	/**
+	 * \param InEventName - name of the event, can be empty when only the properties are built.
+	 * \param ExpectedNumProperties - number of properties the event is expected to have. Reserving the exact number
+	 *                                keeps construction to a single allocation.
+	 */
+	explicit FCleverTapEventBuilder(FString InEventName = FString{}, int32 ExpectedNumProperties = 0);
+
+	/**
+	 * Builds an event described by a schema. Each property is validated against the schema as it is added, and the
+	 *  property count and required keys when the event is built. The schema must outlive the builder.
+	 *
+	 * \param ExpectedNumProperties - number of properties the event is expected to have.
+	 */
+	explicit FCleverTapEventBuilder(const FCleverTapEventSchema& InSchema, int32 ExpectedNumProperties = 0);
+
+	/**
+	 * Appends a property. Duplicate keys are not detected until the event is built.
+	 */
+	FCleverTapEventBuilder& Add(FString Key, FCleverTapPropertyValue Value);
+
+	/**
+	 * Appends a property with a typed schema key. Passing a value of any other type than the type of the key is a
+	 *  compile error, even if it would convert implicitly; only string keys also take TCHAR strings.
+	 */
+	template <typename T, typename V> FCleverTapEventBuilder& Add(const TCleverTapSchemaKey<T>& Key, V&& Value)
+	{
+		using FValueType = typename TDecay<V>::Type;
+		static_assert(TIsSame<FValueType, T>::Value
+				|| (TIsSame<T, FString>::Value
+					&& (TIsSame<FValueType, const TCHAR*>::Value || TIsSame<FValueType, TCHAR*>::Value)),
+			"The value must have the exact type of the schema key");
+
+		FCleverTapPropertyValue PropertyValue(T(Forward<V>(Value)));
+		if (Validator.IsSet())
+		{
+			Validator->Add(Key, PropertyValue);
+		}
+		return Append(FString(Key.Length, Key.Name), MoveTemp(PropertyValue));
+	}
+
+	/**
+	 * Ensures there is room for at least the given total number of properties.
+	 */
+	FCleverTapEventBuilder& Reserve(int32 NumProperties);
+
+	/**
+	 * Number of properties added so far, including duplicates.
+	 */
+	int32 Num() const { return Properties.Num(); }
+
+	const FString& GetEventName() const { return EventName; }
+
+	/**
+	 * Moves the properties out of the builder as an insertion-ordered payload without duplicate keys.
+	 */
+	FCleverTapPayload BuildPayload();
+
+	/**
+	 * Moves the properties out of the builder as FCleverTapProperties, for use with the ICleverTapInstance API.
+	 */
+	FCleverTapProperties BuildProperties();
+
+	/**
+	 * Builds the event and records it on the given instance, moving the name and properties into the call.
+	 */
+	void Push(ICleverTapInstance& Instance);
+
+private:
+	FCleverTapEventBuilder& Append(FString Key, FCleverTapPropertyValue Value);
+	void RemoveDuplicateKeys();
+
+	FString EventName;
+	FCleverTapPayload Properties;
+
+	// validates each property as it is added when the event is built from a schema
+	TOptional<FCleverTapEventSchema::FValidator> Validator;
+};
@@ -0,0 +1,63 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+
+class FCleverTapEventContext;
+
+using FCleverTapEventContextRef = TSharedRef<const FCleverTapEventContext, ESPMode::ThreadSafe>;
+using FCleverTapEventContextPtr = TSharedPtr<const FCleverTapEventContext, ESPMode::ThreadSafe>;
+
+/**
+ * An immutable set of properties shared by many events, e.g. the build version, platform, session id and map.
+ *
+ * A context is attached to an instance with ICleverTapInstance::SetEventContext() or to a single event with the
+ *  PushEvent() overload that takes one. Instead of copying the shared properties into every event, the platform SDKs
+ *  convert a context to their native representation once and merge it with the event properties as the event is
+ *  converted. Contexts never change after they have been created, so to change a property create a new context, e.g.
+ *  with With() or Without(), and attach that instead.
+ *
+ * \code
+ * CleverTap.SetEventContext(FCleverTapEventContext::Create({
+ * 	{ TEXT("Build"), BuildVersion },
+ * 	{ TEXT("Platform"), PlatformName },
+ * }));
+ * \endcode
+ */
+class CLEVERTAP_API FCleverTapEventContext
+{
+public:
+	static FCleverTapEventContextRef Create(FCleverTapProperties Properties);
+
+	const FCleverTapProperties& GetProperties() const { return Properties; }
+	int32 Num() const { return Properties.Num(); }
+
+	/**
+	 * Returns a new context with a property added or replaced.
+	 */
+	FCleverTapEventContextRef With(const FString& Key, FCleverTapPropertyValue Value) const;
+
+	/**
+	 * Returns a new context with properties added or replaced.
+	 */
+	FCleverTapEventContextRef With(const FCleverTapProperties& Overrides) const;
+
+	/**
+	 * Returns a new context without a property.
+	 */
+	FCleverTapEventContextRef Without(const FString& Key) const;
+
+	/**
+	 * Returns the context properties merged with the properties of an event. Event properties take precedence over
+	 *  context properties with the same key.
+	 */
+	FCleverTapProperties MergeWith(const FCleverTapProperties& EventProperties) const;
+
+private:
+	explicit FCleverTapEventContext(FCleverTapProperties&& InProperties);
+
+	const FCleverTapProperties Properties;
+};
@@ -0,0 +1,171 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+
+namespace CleverTapSDK { namespace Limits {
+
+/**
+ * Limits enforced by CleverTap on recorded events. Events exceeding them are truncated or discarded server-side.
+ */
+constexpr int32 MaxEventNameLength = 512;
+constexpr int32 MaxKeyLength = 120;
+constexpr int32 MaxStringValueLength = 512;
+constexpr int32 MaxArrayLength = 100;
+constexpr int32 MaxPropertiesPerEvent = 256;
+
+}} // namespace CleverTapSDK::Limits
+
+/**
+ * A property key of an event schema, typed with the FCleverTapPropertyValue type its values must have. Declare keys
+ *  with CLEVERTAP_SCHEMA_KEY so that the key name is checked against CleverTap's limits at compile time.
+ */
+template <typename T> struct TCleverTapSchemaKey
+{
+	using ValueType = T;
+
+	const TCHAR* Name;
+	int32 Length;
+
+	static constexpr uint16 TypeMask() { return uint16(1u << FCleverTapPropertyValue::IndexOfType<T>()); }
+};
+
+namespace CleverTapSDK {
+
+template <typename T, SIZE_T Length> constexpr TCleverTapSchemaKey<T> MakeSchemaKey(const TCHAR* Name)
+{
+	static_assert(Length > 0, "CleverTap property keys can't be empty");
+	static_assert(Length <= Limits::MaxKeyLength, "CleverTap property key exceeds the maximum key length");
+	return TCleverTapSchemaKey<T>{ Name, int32(Length) };
+}
+
+} // namespace CleverTapSDK
+
+/**
+ * Declares a typed schema key, e.g. static constexpr auto Score = CLEVERTAP_SCHEMA_KEY(int32, "Score");
+ */
+#define CLEVERTAP_SCHEMA_KEY(Type, Name) CleverTapSDK::MakeSchemaKey<Type, UE_ARRAY_COUNT(TEXT(Name)) - 1>(TEXT(Name))
+
+/**
+ * Whether a key must be present in every event of a schema.
+ */
+enum class ECleverTapSchemaKeyPresence : uint8
+{
+	Optional,
+	Required,
+};
+
+/**
+ * Describes the properties of an event: the keys it may have and the value types allowed for each key.
+ *
+ * The allowed types of each key are precomputed into a bit mask indexed by FCleverTapPropertyValue::GetIndex(), so
+ *  validating a property is a single key lookup and mask test. Events built with typed keys are validated by an
+ *  FValidator, which finds the rule of a typed key by the address of its name rather than by hashing the name. Every
+ *  event is also checked against CleverTap's limits on name, key and value lengths, array sizes and property count.
+ *
+ * \code
+ * static constexpr auto Level = CLEVERTAP_SCHEMA_KEY(int32, "Level");
+ * static constexpr auto Score = CLEVERTAP_SCHEMA_KEY(int64, "Score");
+ *
+ * static const FCleverTapEventSchema LevelComplete = FCleverTapEventSchema(TEXT("Level Complete"))
+ * 	.Key(Level, ECleverTapSchemaKeyPresence::Required)
+ * 	.Key(Score);
+ *
+ * FCleverTapEventBuilder(LevelComplete).Add(Level, 3).Add(Score, int64(1200)).Push(CleverTap);
+ * \endcode
+ */
+class CLEVERTAP_API FCleverTapEventSchema
+{
+public:
+	explicit FCleverTapEventSchema(FString InEventName);
+
+	/**
+	 * Adds a typed key to the schema.
+	 */
+	template <typename T>
+	FCleverTapEventSchema& Key(const TCleverTapSchemaKey<T>& InKey,
+		ECleverTapSchemaKeyPresence Presence = ECleverTapSchemaKeyPresence::Optional)
+	{
+		TypedRuleIndices.Add(InKey.Name, AddRule(FString(InKey.Length, InKey.Name), InKey.TypeMask(), Presence));
+		return *this;
+	}
+
+	/**
+	 * Adds a key whose values may have any of the types in TypeMask, a combination of
+	 *  1 << FCleverTapPropertyValue::IndexOfType<T>() bits. Used by data driven schemas.
+	 */
+	FCleverTapEventSchema& Key(FString Name, uint16 TypeMask, ECleverTapSchemaKeyPresence Presence);
+
+	/**
+	 * Allows properties with keys that are not part of the schema. They are still checked against CleverTap's limits.
+	 */
+	FCleverTapEventSchema& AllowUnknownKeys(bool bAllow = true);
+
+	const FString& GetEventName() const { return EventName; }
+
+	/**
+	 * Checks the event properties against the schema and logs a warning for each violation. Returns true if the
+	 *  properties are valid.
+	 */
+	bool Validate(const FCleverTapProperties& Properties) const;
+	bool Validate(const FCleverTapPayload& Properties) const;
+
+	/**
+	 * Checks an event against CleverTap's limits only. Returns true if the event is within the limits.
+	 */
+	static bool ValidateLimits(const FString& EventName, const FCleverTapProperties& Properties);
+	static bool ValidateLimits(const FString& EventName, const FCleverTapPayload& Properties);
+
+	/**
+	 * Validates an event property by property as it is built, logging a warning for each violation.
+	 *
+	 * A typed key registered with Key() is found by the address of its name and checked against the type mask of its
+	 *  rule, so adding it doesn't hash or compare strings. Keys added by name, and typed keys declared separately from
+	 *  the ones registered, fall back to a lookup by name.
+	 */
+	class CLEVERTAP_API FValidator
+	{
+	public:
+		explicit FValidator(const FCleverTapEventSchema& InSchema);
+
+		template <typename T> void Add(const TCleverTapSchemaKey<T>& Key, const FCleverTapPropertyValue& Value)
+		{
+			AddToRule(Schema.FindTypedRule(Key.Name, Key.Length), Key.Name, Value);
+		}
+		void Add(const FString& Key, const FCleverTapPropertyValue& Value);
+
+		/**
+		 * Checks the property count and the required keys, and returns true if the event is valid. Starts over for
+		 *  the next event.
+		 */
+		bool Finish(int32 NumProperties);
+
+	private:
+		void AddToRule(int32 RuleIndex, const TCHAR* Key, const FCleverTapPropertyValue& Value);
+
+		const FCleverTapEventSchema& Schema;
+		TBitArray<> SeenRequiredKeys;
+		bool bValid = true;
+	};
+
+private:
+	struct FKeyRule
+	{
+		FString Name;
+		uint16 TypeMask;
+		int16 RequiredIndex; // INDEX_NONE for optional keys
+	};
+
+	template <typename PropertiesType> bool ValidateImpl(const PropertiesType& Properties) const;
+	int32 FindTypedRule(const TCHAR* Name, int32 Length) const;
+	int32 AddRule(FString Name, uint16 TypeMask, ECleverTapSchemaKeyPresence Presence);
+
+	FString EventName;
+	TArray<FKeyRule> Rules;
+	TMap<FString, int32> RuleIndices;
+	TMap<const TCHAR*, int32> TypedRuleIndices; // by the address of the name of a typed key
+	int32 NumRequiredKeys = 0;
+	bool bAllowUnknownKeys = false;
+};
@@ -1,6 +1,9 @@
 // Copyright CleverTap All Rights Reserved.
 #pragma once
 
+#include "CleverTapChargedItems.h"
+#include "CleverTapEventContext.h"
+#include "CleverTapMetrics.h"
 #include "CleverTapProperties.h"
 #include "CleverTapPushPrimerConfig.h"
 
@@ -11,6 +14,16 @@
  */
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnPushPermissionResponse, bool bGranted);
 
+/**
+ * Delegate type that broadcasts the new CleverTap Id when the id associated with an instance changes
+ */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCleverTapIdChanged, const FString& CleverTapId);
+
+/**
+ * Function type that adds global properties whose values change over time, e.g. the current frame rate, to events
+ */
+using FCleverTapGlobalPropertyProvider = TFunction<void(FCleverTapPayload& OutProperties)>;
+
 /**
  * A CleverTap API instance
  */
@@ -21,7 +34,8 @@ public:
 
 	/**
 	 * Gets the CleverTap Id associated with this instance. The CleverTap Id is a unique identifier
-	 *  assigned to the user profile.
+	 *  assigned to the user profile. The id is cached after the first read, so this is cheap to call
+	 *  frequently and from any thread.
 	 */
 	virtual FString GetCleverTapId() = 0;
 
@@ -34,6 +48,12 @@ public:
 	 */
 	virtual void OnUserLogin(const FCleverTapProperties& Profile) = 0;
 
+	/**
+	 * Overload of OnUserLogin() that takes ownership of the profile, so implementations that defer the call can move
+	 *  it instead of copying it. Forwards to the copying overload by default.
+	 */
+	virtual void OnUserLogin(FCleverTapProperties&& Profile) { OnUserLogin(Profile); }
+
 	/**
 	 * Called to enrich an anonymous user profile with identifying information about the user and provide them a custom
 	 *  CleverTap identifier. CleverTap provides pre-defined profile properties such as name, phone, gender, age, and so
@@ -43,11 +63,25 @@ public:
 	 */
 	virtual void OnUserLogin(const FCleverTapProperties& Profile, const FString& CleverTapId) = 0;
 
+	/**
+	 * Overload of OnUserLogin() that takes ownership of the profile and id, so implementations that defer the call can
+	 *  move them instead of copying them. Forwards to the copying overload by default.
+	 */
+	virtual void OnUserLogin(FCleverTapProperties&& Profile, FString&& CleverTapId)
+	{
+		OnUserLogin(Profile, CleverTapId);
+	}
+
 	/**
 	 * Update a user's profile with additional properties.
 	 */
 	virtual void PushProfile(const FCleverTapProperties& Profile) = 0;
 
+	/**
+	 * Overload of PushProfile() that takes ownership of the profile. Forwards to the copying overload by default.
+	 */
+	virtual void PushProfile(FCleverTapProperties&& Profile) { PushProfile(Profile); }
+
 	/**
 	 * Decrement a user profile property by the specified amount. The property type must be an integer, float, or
 	 *  double. The Amount value should be zero or greater than zero.
@@ -77,12 +111,35 @@ public:
 	 */
 	virtual void PushEvent(const FString& EventName) = 0;
 
+	/**
+	 * Overload of PushEvent() that takes ownership of the event name. Forwards to the copying overload by default.
+	 */
+	virtual void PushEvent(FString&& EventName) { PushEvent(EventName); }
+
 	/**
 	 * Record a user event on the user's profile with the specified event name and the associated key:value pair based
 	 *  event properties.
 	 */
 	virtual void PushEvent(const FString& EventName, const FCleverTapProperties& Actions) = 0;
 
+	/**
+	 * Overload of PushEvent() that takes ownership of the event name and properties. Forwards to the copying overload
+	 *  by default.
+	 */
+	virtual void PushEvent(FString&& EventName, FCleverTapProperties&& Actions) { PushEvent(EventName, Actions); }
+
+	/**
+	 * Overload of PushEvent() that adds the properties of a context to this event only. Event properties take
+	 *  precedence over the context, which takes precedence over the global properties of the instance. Reusing the
+	 *  same context across calls lets platforms reuse its native form. Merges the properties before forwarding to the
+	 *  copying overload by default.
+	 */
+	virtual void PushEvent(
+		const FString& EventName, const FCleverTapEventContextRef& Context, const FCleverTapProperties& Actions)
+	{
+		PushEvent(EventName, Context->MergeWith(Actions));
+	}
+
 	/**
 	 * Record a special user event to capture key details about transaction purchases. The charge details allows you to
 	 *  capture properties of the transaction such as categories, transaction amount, transaction id, and user
@@ -92,6 +149,109 @@ public:
 	virtual void PushChargedEvent(
 		const FCleverTapProperties& ChargeDetails, const TArray<FCleverTapProperties>& Items) = 0;
 
+	/**
+	 * Overload of PushChargedEvent() that takes ownership of the charge details and items. Forwards to the copying
+	 *  overload by default.
+	 */
+	virtual void PushChargedEvent(FCleverTapProperties&& ChargeDetails, TArray<FCleverTapProperties>&& Items)
+	{
+		PushChargedEvent(ChargeDetails, Items);
+	}
+
+	/**
+	 * Overload of PushChargedEvent() that takes the items by column. Platforms convert each column in one bulk
+	 *  operation rather than every item separately. Converts the columns to one set of properties per item and
+	 *  forwards to the copying overload by default.
+	 */
+	virtual void PushChargedEvent(const FCleverTapProperties& ChargeDetails, const FCleverTapChargedItems& Items)
+	{
+		PushChargedEvent(ChargeDetails, Items.ToRows());
+	}
+
+	/**
+	 * Attaches a context whose properties are added to every event pushed with this instance afterwards, including
+	 *  the charge details of charged events. The context is converted to its native form once per change rather than
+	 *  with every event. Pass nullptr to detach the current context.
+	 *
+	 * Properties added to events by the instance take precedence in this order, from highest to lowest: the properties
+	 *  of the event itself, a context passed to PushEvent(), global property providers, global properties and last the
+	 *  event context.
+	 */
+	virtual void SetEventContext(FCleverTapEventContextPtr Context) = 0;
+
+	/**
+	 * Gets the context attached with SetEventContext(), if any.
+	 */
+	virtual FCleverTapEventContextPtr GetEventContext() const = 0;
+
+	/**
+	 * Sets a property that is added to every event pushed with this instance afterwards, including the charge details
+	 *  of charged events. See SetEventContext() for the order of precedence.
+	 */
+	virtual void SetGlobalProperty(const FString& Key, FCleverTapPropertyValue Value) = 0;
+
+	/**
+	 * Removes a property set with SetGlobalProperty().
+	 */
+	virtual void RemoveGlobalProperty(const FString& Key) = 0;
+
+	/**
+	 * Registers a function that adds properties to every event pushed with this instance. Providers are evaluated at
+	 *  most once per frame, on the thread that pushes the first event of the frame, and their values are shared by all
+	 *  events of that frame. Where the plugin uploads events itself in batches, they are evaluated once per batch
+	 *  instead, and their values are shared by the events pushed between two batches. Later providers take precedence
+	 *  over earlier ones.
+	 */
+	virtual FDelegateHandle AddGlobalPropertyProvider(FCleverTapGlobalPropertyProvider Provider) = 0;
+
+	/**
+	 * Unregisters a provider added with AddGlobalPropertyProvider().
+	 */
+	virtual void RemoveGlobalPropertyProvider(FDelegateHandle Handle) = 0;
+
+	/**
+	 * Adds Delta to a counter of the current session, e.g. the time spent in a game mode or the currency earned. The
+	 *  counters and gauges of a session are pushed as a single summary event when the session ends, i.e. when the app
+	 *  enters the background, and optionally at the interval set by SessionSummaryIntervalSeconds. Each summary holds
+	 *  the aggregates updated since the previous one, keyed by name, along with "Session Seconds", "Period Seconds"
+	 *  and "Session End". Counters restart from zero after every summary. Safe to call from any thread.
+	 */
+	virtual void AddSessionCounter(FName Name, double Delta = 1.0) = 0;
+
+	/**
+	 * Sets a gauge of the current session, e.g. the current frame rate. Summaries report the last value as well as the
+	 *  minimum and maximum since the previous summary, as "<Name> Min" and "<Name> Max". Safe to call from any thread.
+	 */
+	virtual void SetSessionGauge(FName Name, double Value) = 0;
+
+	/**
+	 * Pushes the summary of the current session now and starts a new session, e.g. when the player returns to the main
+	 *  menu. Must be called on the game thread.
+	 */
+	virtual void EndSession() = 0;
+
+	/**
+	 * Gets the counter with the given name, registering it on first use. Counters, gauges and histograms are
+	 *  aggregated on the device and pushed as a single summary event every MetricsIntervalSeconds and when the app
+	 *  enters the background, in place of an event per update. The summary holds the metrics updated during the
+	 *  interval, keyed by name, and "Interval Seconds". Returns an invalid handle that ignores updates if the name is
+	 *  already used by a metric of another kind. Look handles up once and keep them rather than looking them up with
+	 *  every update.
+	 */
+	virtual FCleverTapCounter Counter(FName Name) = 0;
+
+	/**
+	 * Gets the gauge with the given name, registering it on first use. See Counter().
+	 */
+	virtual FCleverTapGauge Gauge(FName Name) = 0;
+
+	/**
+	 * Gets the histogram with the given name, registering it on first use. Its values are reported as
+	 *  "<Name> Count", "<Name> Min", "<Name> Max", "<Name> Mean", "<Name> P50", "<Name> P90" and "<Name> P99". See
+	 *  Counter().
+	 */
+	virtual FCleverTapHistogram Histogram(FName Name) = 0;
+
 	/**
 	 * Asynchronously gets the push permission status. The callback receives a value of true if push notification
 	 *  permission has been granted by the user.
@@ -131,4 +291,10 @@ public:
 	 * Delegate that broadcasts the eventual user response to PromptForPushPermission()
 	 */
 	FOnPushPermissionResponse OnPushPermissionResponse;
+
+	/**
+	 * Delegate that broadcasts on the game thread when the CleverTap Id of this instance is first resolved or changes,
+	 *  for example after OnUserLogin() switches to another user profile.
+	 */
+	FOnCleverTapIdChanged OnCleverTapIdChanged;
 };
@@ -1,6 +1,8 @@
 // Copyright CleverTap All Rights Reserved.
 #pragma once
 
+#include "CleverTapBufferPolicy.h"
+#include "CleverTapCompressionFormat.h"
 #include "CleverTapLogLevel.h"
 #include "CoreMinimal.h"
 
@@ -46,6 +48,80 @@ struct FCleverTapInstanceConfig
 	 */
 	ECleverTapLogLevel LogLevel{ ECleverTapLogLevel::Info };
 
+	/**
+	 * When true, PushProfile() only sends the profile fields that changed since they were last pushed.
+	 */
+	bool bSendProfileChangesOnly{ false };
+
+	/**
+	 * The most memory in kilobytes the instance uses to buffer events that have not been sent yet, or 0 for no limit.
+	 *  Only platforms without a CleverTap SDK buffer events in the plugin; the Android and iOS SDKs manage their own
+	 *  queues.
+	 */
+	int32 BufferBudgetKilobytes{ 512 };
+
+	/**
+	 * What happens to events once the buffer budget is exhausted.
+	 */
+	ECleverTapBufferOverflowPolicy BufferOverflowPolicy{ ECleverTapBufferOverflowPolicy::DropOldest };
+
+	/**
+	 * The most disk space in megabytes the offline store uses with the SpillToDisk overflow policy.
+	 */
+	int32 OfflineStoreMaxMegabytes{ 16 };
+
+	/**
+	 * The codec used for event data of at least CompressionThresholdBytes before it is written to the offline store.
+	 */
+	ECleverTapCompressionFormat CompressionFormat{ ECleverTapCompressionFormat::LZ4 };
+
+	/**
+	 * The size in bytes from which event data is compressed.
+	 */
+	int32 CompressionThresholdBytes{ 1024 };
+
+	/**
+	 * The name of the event that reports the session counters and gauges.
+	 */
+	FString SessionSummaryEventName{ TEXT("Session Summary") };
+
+	/**
+	 * How often in seconds a summary of the session counters and gauges is pushed during a session, or 0 to only push
+	 *  it when the session ends.
+	 */
+	float SessionSummaryIntervalSeconds{ 0.0f };
+
+	/**
+	 * The name of the event that reports the counters, gauges and histograms of the instance.
+	 */
+	FString MetricsEventName{ TEXT("Metrics") };
+
+	/**
+	 * How often in seconds the metrics are pushed, or 0 to only push them when the app enters the background.
+	 */
+	float MetricsIntervalSeconds{ 60.0f };
+
+	/**
+	 * The URL buffered events are uploaded to on platforms without a CleverTap SDK, or empty to not upload them.
+	 */
+	FString UploadEndpointUrl;
+
+	/**
+	 * The most events sent in one upload request.
+	 */
+	int32 UploadMaxBatchEvents{ 500 };
+
+	/**
+	 * The range in seconds of the interval between uploads, which adapts to the measured round trip time.
+	 */
+	float UploadMinIntervalSeconds{ 1.0f };
+	float UploadMaxIntervalSeconds{ 60.0f };
+
+	/**
+	 * The most upload requests in flight at once.
+	 */
+	int32 UploadMaxConcurrentBatches{ 4 };
+
 	/**
 	 * Create a FCleverTapInstanceConfig from the UObject based UCleverTapConfig.
 	 */
@@ -0,0 +1,40 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+
+/**
+ * Parses a JSON object into CleverTap properties in a single pass, without building an intermediate DOM.
+ *
+ * Member values are mapped to FCleverTapPropertyValue types as follows:
+ *  - true/false: bool
+ *  - integers: int32 if they fit, int64 otherwise
+ *  - numbers with a fraction or exponent, or integers beyond the int64 range: double
+ *  - strings in ISO 8601 date format ("YYYY-MM-DD"): FCleverTapDate
+ *  - other strings: FString
+ *  - arrays of the above: the array type of their elements, with integers widened to int64 or double as needed.
+ *    Empty arrays become TArray<FString>.
+ *  - null: the member is skipped
+ *
+ * Together with FCleverTapJsonWriter this round-trips every type except float and TArray<float>, which read back as
+ *  double, and int64 values small enough to fit an int32. Nested objects, nested arrays and arrays mixing strings,
+ *  numbers and booleans are rejected. Use FCleverTapBinaryFormat for lossless storage.
+ */
+class CLEVERTAP_API FCleverTapJsonReader
+{
+public:
+	/**
+	 * Parses UTF-8 JSON text. Returns false and describes the problem in OutError if the text is not a valid JSON
+	 *  object of supported values. Properties parsed before the error are left in OutProperties.
+	 */
+	static bool Read(TArrayView<const uint8> Json, FCleverTapProperties& OutProperties, FString* OutError = nullptr);
+	static bool Read(TArrayView<const uint8> Json, FCleverTapPayload& OutProperties, FString* OutError = nullptr);
+
+	/**
+	 * Parses JSON text held in an FString.
+	 */
+	static bool Read(const FString& Json, FCleverTapProperties& OutProperties, FString* OutError = nullptr);
+	static bool Read(const FString& Json, FCleverTapPayload& OutProperties, FString* OutError = nullptr);
+};
@@ -0,0 +1,82 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+
+#include "CoreMinimal.h"
+
+/**
+ * Streams JSON as UTF-8 directly from CleverTap properties, without building an intermediate FJsonObject tree.
+ *
+ * Numbers are written with enough significant digits to parse back to the same value (see FormatDouble()), which
+ *  isn't always the shortest such form; doubles always include a decimal point or exponent so they can be told apart
+ *  from integers when parsed. Non-finite numbers are written as null.
+ *  FCleverTapDate values are written as ISO 8601 date strings ("YYYY-MM-DD").
+ *
+ * The writer doesn't validate the structure it is asked to write, e.g. that keys are only written inside objects.
+ */
+class CLEVERTAP_API FCleverTapJsonWriter
+{
+public:
+	/**
+	 * Creates a writer that appends to Output.
+	 */
+	explicit FCleverTapJsonWriter(TArray<uint8>& InOutput);
+
+	void BeginObject();
+	void EndObject();
+	void BeginArray();
+	void EndArray();
+
+	/**
+	 * Writes the key of the next object member.
+	 */
+	void WriteKey(const FString& Key);
+	void WriteKey(const ANSICHAR* Key);
+
+	void WriteNull();
+	void WriteValue(bool Value);
+	void WriteValue(int32 Value);
+	void WriteValue(int64 Value);
+	void WriteValue(float Value);
+	void WriteValue(double Value);
+	void WriteValue(const FString& Value);
+	void WriteValue(const ANSICHAR* Value);
+	void WriteValue(const FCleverTapDate& Value);
+	void WriteValue(const FCleverTapPropertyValue& Value);
+
+	/**
+	 * Writes the properties as a JSON object.
+	 */
+	void WriteProperties(const FCleverTapProperties& Properties);
+	void WriteProperties(const FCleverTapPayload& Properties);
+
+	/**
+	 * Renders the properties as a JSON object string, e.g. for debug output.
+	 */
+	static FString ToString(const FCleverTapProperties& Properties);
+	static FString ToString(const FCleverTapPayload& Properties);
+
+	/**
+	 * Formats a number so that it parses back to the same value: with 7 significant digits for floats and 15 for
+	 *  doubles if those round-trip, otherwise with 9 and 17, which always do. The result is therefore not always the
+	 *  shortest round-trip representation, e.g. a double that needs 16 digits is written with 17. Non-finite numbers
+	 *  are formatted as by printf. Returns the length written to Buffer, excluding the null terminator.
+	 */
+	static constexpr int32 NumberBufferSize = 32;
+	static int32 FormatFloat(float Value, ANSICHAR (&Buffer)[NumberBufferSize]);
+	static int32 FormatDouble(double Value, ANSICHAR (&Buffer)[NumberBufferSize]);
+
+private:
+	template <typename PropertiesType> void WritePropertiesImpl(const PropertiesType& Properties);
+	template <typename ElementType> void WriteArray(const TArray<ElementType>& Array);
+
+	void BeginValue();
+	void WriteRaw(const ANSICHAR* Data, int32 Length);
+	void WriteRaw(ANSICHAR Char) { Output.Add(uint8(Char)); }
+	void WriteString(const TCHAR* Data, int32 Length);
+	void WriteString(const ANSICHAR* Data, int32 Length);
+
+	TArray<uint8>& Output;
+	bool bNeedsComma = false;
+};
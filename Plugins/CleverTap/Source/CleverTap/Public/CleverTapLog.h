@@ -3,4 +3,54 @@
 
 #include "Logging/LogMacros.h"
 
-DECLARE_LOG_CATEGORY_EXTERN(LogCleverTap, Log, All);
+/**
+ * The most verbose LogCleverTap messages compiled into shipping builds. Everything more verbose is stripped at
+ *  compile time, including the evaluation of its arguments.
+ */
+#ifndef CLEVERTAP_SHIPPING_LOG_VERBOSITY
+#define CLEVERTAP_SHIPPING_LOG_VERBOSITY Warning
+#endif
+
+// exported, as the benchmark and stand-in modules of the plugin log to it as well
+#if UE_BUILD_SHIPPING
+CLEVERTAP_API DECLARE_LOG_CATEGORY_EXTERN(LogCleverTap, Log, CLEVERTAP_SHIPPING_LOG_VERBOSITY);
+#else
+CLEVERTAP_API DECLARE_LOG_CATEGORY_EXTERN(LogCleverTap, Log, All);
+#endif
+
+/**
+ * Whether the payload dump mode (CleverTap.LogPayloads) is compiled in. Off in shipping builds by default.
+ */
+#ifndef CLEVERTAP_WITH_PAYLOAD_LOGGING
+#define CLEVERTAP_WITH_PAYLOAD_LOGGING !UE_BUILD_SHIPPING
+#endif
+
+namespace CleverTapSDK {
+
+/**
+ * Returns true if event and profile payloads should be dumped to the log (CleverTap.LogPayloads).
+ */
+CLEVERTAP_API bool ShouldLogPayloads();
+
+} // namespace CleverTapSDK
+
+/**
+ * Logs the contents of an event or profile payload at Verbose level. Payloads are typically expensive to format (a
+ *  round-trip through the platform SDK), so the arguments are only evaluated when Verbose logging is active for
+ *  LogCleverTap and CleverTap.LogPayloads is enabled.
+ */
+#if CLEVERTAP_WITH_PAYLOAD_LOGGING
+#define CLEVERTAP_LOG_PAYLOAD(Format, ...)                                                                             \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if (UE_LOG_ACTIVE(LogCleverTap, Verbose) && CleverTapSDK::ShouldLogPayloads())                                 \
+		{                                                                                                              \
+			UE_LOG(LogCleverTap, Verbose, Format, ##__VA_ARGS__);                                                      \
+		}                                                                                                              \
+	} while (0)
+#else
+#define CLEVERTAP_LOG_PAYLOAD(Format, ...)                                                                             \
+	do                                                                                                                 \
+	{                                                                                                                  \
+	} while (0)
+#endif
@@ -0,0 +1,17 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Low Level Memory Tracker tag for the allocations of the CleverTap plugin: property values, event contexts and global
+ *  properties, serialized buffers and the queues of the generic backend. Run with -llm to report them as "CleverTap".
+ */
+LLM_DECLARE_TAG_API(CleverTap, CLEVERTAP_API);
+
+/**
+ * Attributes the allocations made in the current scope to the CleverTap LLM tag. Compiles to nothing when LLM is
+ *  disabled.
+ */
+#define CLEVERTAP_LLM_SCOPE() LLM_SCOPE_BYTAG(CleverTap)
@@ -0,0 +1,86 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace CleverTapSDK {
+class FCleverTapMetricRegistry;
+} // namespace CleverTapSDK
+
+/**
+ * A counter of an instance, obtained with ICleverTapInstance::Counter(). Reports the sum of the values added during
+ *  each metrics interval.
+ *
+ * Metric handles are cheap to copy and should be looked up once and kept, e.g. in a static or a member, rather than
+ *  looked up by name with every update. Updates are safe from any thread and only touch data of the calling thread.
+ *  Handles must not outlive the instance they were obtained from; default constructed handles ignore all updates.
+ */
+class CLEVERTAP_API FCleverTapCounter
+{
+public:
+	FCleverTapCounter() = default;
+
+	void Add(double Delta = 1.0) const;
+
+	bool IsValid() const { return Registry != nullptr; }
+
+private:
+	friend class CleverTapSDK::FCleverTapMetricRegistry;
+	FCleverTapCounter(CleverTapSDK::FCleverTapMetricRegistry* InRegistry, int32 InIndex)
+		: Registry(InRegistry), Index(InIndex)
+	{
+	}
+
+	CleverTapSDK::FCleverTapMetricRegistry* Registry = nullptr;
+	int32 Index = INDEX_NONE;
+};
+
+/**
+ * A gauge of an instance, obtained with ICleverTapInstance::Gauge(). Reports the last value set before the end of
+ *  each metrics interval. See FCleverTapCounter for the lifetime and threading of handles.
+ */
+class CLEVERTAP_API FCleverTapGauge
+{
+public:
+	FCleverTapGauge() = default;
+
+	void Set(double Value) const;
+
+	bool IsValid() const { return Registry != nullptr; }
+
+private:
+	friend class CleverTapSDK::FCleverTapMetricRegistry;
+	FCleverTapGauge(CleverTapSDK::FCleverTapMetricRegistry* InRegistry, int32 InIndex)
+		: Registry(InRegistry), Index(InIndex)
+	{
+	}
+
+	CleverTapSDK::FCleverTapMetricRegistry* Registry = nullptr;
+	int32 Index = INDEX_NONE;
+};
+
+/**
+ * A histogram of an instance, obtained with ICleverTapInstance::Histogram(), e.g. for load times or frame times.
+ *  Reports the count, minimum, maximum, mean and the 50th, 90th and 99th percentiles of the values recorded during
+ *  each metrics interval. Values are kept in fixed size log-linear buckets, so percentiles are within 12.5% of the
+ *  exact value for values between 0.001 and 4 million. See FCleverTapCounter for the lifetime and threading of handles.
+ */
+class CLEVERTAP_API FCleverTapHistogram
+{
+public:
+	FCleverTapHistogram() = default;
+
+	void Record(double Value) const;
+
+	bool IsValid() const { return Registry != nullptr; }
+
+private:
+	friend class CleverTapSDK::FCleverTapMetricRegistry;
+	FCleverTapHistogram(CleverTapSDK::FCleverTapMetricRegistry* InRegistry, int32 InIndex)
+		: Registry(InRegistry), Index(InIndex)
+	{
+	}
+
+	CleverTapSDK::FCleverTapMetricRegistry* Registry = nullptr;
+	int32 Index = INDEX_NONE;
+};
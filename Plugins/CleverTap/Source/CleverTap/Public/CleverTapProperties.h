@@ -1,8 +1,10 @@
 // Copyright CleverTap All Rights Reserved.
 #pragma once
 
+#include "CleverTapMemory.h"
 #include "CoreMinimal.h"
-#include "Misc/TVariant.h"
+
+#include <atomic>
 
 /**
  * Represents a date for CleverTap profile properties.
@@ -39,73 +41,322 @@ struct FCleverTapDate
 	FString ToString() const { return FString::Printf(TEXT("%04d-%02d-%02d"), Year, Month, Day); }
 };
 
+namespace CleverTapSDK { namespace Details {
+
+/**
+ * Index and storage of each type allowed in an FCleverTapPropertyValue. Scalars are stored inline, strings, dates and
+ *  arrays in a shared, reference counted box.
+ */
+template <typename T> struct TPropertyValueType;
+
+template <> struct TPropertyValueType<int32> { enum { Index = 0, bBoxed = false }; };
+template <> struct TPropertyValueType<int64> { enum { Index = 1, bBoxed = false }; };
+template <> struct TPropertyValueType<float> { enum { Index = 2, bBoxed = false }; };
+template <> struct TPropertyValueType<double> { enum { Index = 3, bBoxed = false }; };
+template <> struct TPropertyValueType<bool> { enum { Index = 4, bBoxed = false }; };
+template <> struct TPropertyValueType<FString> { enum { Index = 5, bBoxed = true }; };
+template <> struct TPropertyValueType<FCleverTapDate> { enum { Index = 6, bBoxed = true }; };
+template <> struct TPropertyValueType<TArray<int32>> { enum { Index = 7, bBoxed = true }; };
+template <> struct TPropertyValueType<TArray<int64>> { enum { Index = 8, bBoxed = true }; };
+template <> struct TPropertyValueType<TArray<float>> { enum { Index = 9, bBoxed = true }; };
+template <> struct TPropertyValueType<TArray<double>> { enum { Index = 10, bBoxed = true }; };
+template <> struct TPropertyValueType<TArray<bool>> { enum { Index = 11, bBoxed = true }; };
+template <> struct TPropertyValueType<TArray<FString>> { enum { Index = 12, bBoxed = true }; };
+
+struct FPropertyValueBox
+{
+	std::atomic<int32> RefCount{ 1 };
+
+	// set once a mutable reference to the value has been handed out; copies made afterwards clone the box instead of
+	//  sharing it, so writes through that reference never show up in them
+	bool bUnshareable = false;
+};
+
+template <typename T> struct TPropertyValueBox : FPropertyValueBox
+{
+	template <typename... TArgs> explicit TPropertyValueBox(TArgs&&... Args) : Value(Forward<TArgs>(Args)...) {}
+
+	T Value;
+};
+
+}} // namespace CleverTapSDK::Details
+
 /**
  * Variant type for allowed property value types.
+ *
+ * Values are 16 bytes: scalars are stored inline, strings, dates and arrays in a reference counted box that is shared
+ *  between copies of the value. Copying a value doesn't copy string or array contents; they are only cloned when a
+ *  shared value is accessed for writing through the non-const Get()/TryGet(). A value whose contents have been
+ *  accessed for writing is copied by cloning from then on, so the reference handed out stays private to it.
  */
 class FCleverTapPropertyValue
 {
 public:
-	using VariantType = TVariant<int32, int64, float, double, bool, FString, FCleverTapDate, TArray<int32>,
-		TArray<int64>, TArray<float>, TArray<double>, TArray<bool>, TArray<FString>>;
-
 	// Default constructors
-	FCleverTapPropertyValue() = default;
+	FCleverTapPropertyValue() : TypeIndex(IndexOfType<int32>()) { Storage.Box = nullptr; }
 
 	// Type-specific constructors
-	FCleverTapPropertyValue(int32 InValue) : Value(TInPlaceType<int32>(), InValue) {}
-	FCleverTapPropertyValue(int64 InValue) : Value(TInPlaceType<int64>(), InValue) {}
-	FCleverTapPropertyValue(double InValue) : Value(TInPlaceType<double>(), InValue) {}
-	FCleverTapPropertyValue(float InValue) : Value(TInPlaceType<float>(), InValue) {}
-	FCleverTapPropertyValue(bool InValue) : Value(TInPlaceType<bool>(), InValue) {}
-	FCleverTapPropertyValue(const ANSICHAR* InValue) : Value(TInPlaceType<FString>(), FString(InValue)) {}
-	FCleverTapPropertyValue(const FString& InValue) : Value(TInPlaceType<FString>(), InValue) {}
-	FCleverTapPropertyValue(FString&& InValue) : Value(TInPlaceType<FString>(), MoveTemp(InValue)) {}
-	FCleverTapPropertyValue(const FCleverTapDate& InValue) : Value(TInPlaceType<FCleverTapDate>(), InValue) {}
-	FCleverTapPropertyValue(const TArray<int32>& InValue) : Value(TInPlaceType<TArray<int32>>(), InValue) {}
-	FCleverTapPropertyValue(TArray<int32>&& InValue) : Value(TInPlaceType<TArray<int32>>(), MoveTemp(InValue)) {}
-	FCleverTapPropertyValue(const TArray<int64>& InValue) : Value(TInPlaceType<TArray<int64>>(), InValue) {}
-	FCleverTapPropertyValue(TArray<int64>&& InValue) : Value(TInPlaceType<TArray<int64>>(), MoveTemp(InValue)) {}
-	FCleverTapPropertyValue(const TArray<float>& InValue) : Value(TInPlaceType<TArray<float>>(), InValue) {}
-	FCleverTapPropertyValue(TArray<float>&& InValue) : Value(TInPlaceType<TArray<float>>(), MoveTemp(InValue)) {}
-	FCleverTapPropertyValue(const TArray<double>& InValue) : Value(TInPlaceType<TArray<double>>(), InValue) {}
-	FCleverTapPropertyValue(TArray<double>&& InValue) : Value(TInPlaceType<TArray<double>>(), MoveTemp(InValue)) {}
-	FCleverTapPropertyValue(const TArray<bool>& InValue) : Value(TInPlaceType<TArray<bool>>(), InValue) {}
-	FCleverTapPropertyValue(TArray<bool>&& InValue) : Value(TInPlaceType<TArray<bool>>(), MoveTemp(InValue)) {}
-	FCleverTapPropertyValue(const TArray<FString>& InValue) : Value(TInPlaceType<TArray<FString>>(), InValue) {}
-	FCleverTapPropertyValue(TArray<FString>&& InValue) : Value(TInPlaceType<TArray<FString>>(), MoveTemp(InValue)) {}
+	FCleverTapPropertyValue(int32 InValue) { Construct<int32>(InValue); }
+	FCleverTapPropertyValue(int64 InValue) { Construct<int64>(InValue); }
+	FCleverTapPropertyValue(double InValue) { Construct<double>(InValue); }
+	FCleverTapPropertyValue(float InValue) { Construct<float>(InValue); }
+	FCleverTapPropertyValue(bool InValue) { Construct<bool>(InValue); }
+	FCleverTapPropertyValue(const ANSICHAR* InValue) { Construct<FString>(InValue); }
+	FCleverTapPropertyValue(const TCHAR* InValue) { Construct<FString>(InValue); }
+	FCleverTapPropertyValue(const FString& InValue) { Construct<FString>(InValue); }
+	FCleverTapPropertyValue(FString&& InValue) { Construct<FString>(MoveTemp(InValue)); }
+	FCleverTapPropertyValue(const FCleverTapDate& InValue) { Construct<FCleverTapDate>(InValue); }
+	FCleverTapPropertyValue(const TArray<int32>& InValue) { Construct<TArray<int32>>(InValue); }
+	FCleverTapPropertyValue(TArray<int32>&& InValue) { Construct<TArray<int32>>(MoveTemp(InValue)); }
+	FCleverTapPropertyValue(const TArray<int64>& InValue) { Construct<TArray<int64>>(InValue); }
+	FCleverTapPropertyValue(TArray<int64>&& InValue) { Construct<TArray<int64>>(MoveTemp(InValue)); }
+	FCleverTapPropertyValue(const TArray<float>& InValue) { Construct<TArray<float>>(InValue); }
+	FCleverTapPropertyValue(TArray<float>&& InValue) { Construct<TArray<float>>(MoveTemp(InValue)); }
+	FCleverTapPropertyValue(const TArray<double>& InValue) { Construct<TArray<double>>(InValue); }
+	FCleverTapPropertyValue(TArray<double>&& InValue) { Construct<TArray<double>>(MoveTemp(InValue)); }
+	FCleverTapPropertyValue(const TArray<bool>& InValue) { Construct<TArray<bool>>(InValue); }
+	FCleverTapPropertyValue(TArray<bool>&& InValue) { Construct<TArray<bool>>(MoveTemp(InValue)); }
+	FCleverTapPropertyValue(const TArray<FString>& InValue) { Construct<TArray<FString>>(InValue); }
+	FCleverTapPropertyValue(TArray<FString>&& InValue) { Construct<TArray<FString>>(MoveTemp(InValue)); }
 
 	// Copy constructor
-	FCleverTapPropertyValue(const FCleverTapPropertyValue& Other) = default;
+	FCleverTapPropertyValue(const FCleverTapPropertyValue& Other) : Storage(Other.Storage), TypeIndex(Other.TypeIndex)
+	{
+		if (IsBoxed())
+		{
+			if (Storage.Box->bUnshareable)
+			{
+				Storage.Box = CloneBox();
+			}
+			else
+			{
+				Storage.Box->RefCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
 
 	// Move constructor
-	FCleverTapPropertyValue(FCleverTapPropertyValue&& Other) noexcept = default;
+	FCleverTapPropertyValue(FCleverTapPropertyValue&& Other) noexcept
+		: Storage(Other.Storage), TypeIndex(Other.TypeIndex)
+	{
+		Other.ResetToDefault();
+	}
 
 	// Copy assignment operator
-	FCleverTapPropertyValue& operator=(const FCleverTapPropertyValue& Other) = default;
+	FCleverTapPropertyValue& operator=(const FCleverTapPropertyValue& Other)
+	{
+		if (this != &Other)
+		{
+			*this = FCleverTapPropertyValue(Other);
+		}
+		return *this;
+	}
 
 	// Move assignment operator
-	FCleverTapPropertyValue& operator=(FCleverTapPropertyValue&& Other) noexcept = default;
+	FCleverTapPropertyValue& operator=(FCleverTapPropertyValue&& Other) noexcept
+	{
+		if (this != &Other)
+		{
+			ReleaseBox();
+			Storage = Other.Storage;
+			TypeIndex = Other.TypeIndex;
+			Other.ResetToDefault();
+		}
+		return *this;
+	}
 
 	// Destructor
-	~FCleverTapPropertyValue() = default;
+	~FCleverTapPropertyValue() { ReleaseBox(); }
 
 	// Variant Methods
-	template <typename U> bool IsType() const { return Value.IsType<U>(); }
-	template <typename U> U& Get() { return Value.Get<U>(); }
-	template <typename U> const U& Get() const { return Value.Get<U>(); }
-	template <typename U> U* TryGet() { return Value.TryGet<U>(); }
-	template <typename U> const U* TryGet() const { return Value.TryGet<U>(); }
-	template <typename U> void Set(typename TIdentity<U>::Type&& InValue) { Value.Set<U>(MoveTemp(InValue)); }
-	template <typename U> void Set(const typename TIdentity<U>::Type& InValue) { Value.Set<U>(InValue); }
+	template <typename U> bool IsType() const { return TypeIndex == IndexOfType<U>(); }
+	template <typename U> U& Get()
+	{
+		check(IsType<U>());
+		return *GetPointer<U>(TBoxedTag<U>());
+	}
+	template <typename U> const U& Get() const
+	{
+		check(IsType<U>());
+		return *GetPointer<U>(TBoxedTag<U>());
+	}
+	template <typename U> U* TryGet() { return IsType<U>() ? GetPointer<U>(TBoxedTag<U>()) : nullptr; }
+	template <typename U> const U* TryGet() const { return IsType<U>() ? GetPointer<U>(TBoxedTag<U>()) : nullptr; }
+	template <typename U> void Set(typename TIdentity<U>::Type&& InValue) { Emplace<U>(MoveTemp(InValue)); }
+	template <typename U> void Set(const typename TIdentity<U>::Type& InValue) { Emplace<U>(InValue); }
 	template <typename U, typename... TArgs> void Emplace(TArgs&&... Args)
 	{
-		Value.Emplace<U>(Forward<TArgs>(Args)...);
+		// construct before releasing the current value, which the arguments may refer to
+		FCleverTapPropertyValue NewValue(EConstruct::Uninitialized);
+		NewValue.Construct<U>(Forward<TArgs>(Args)...);
+		*this = MoveTemp(NewValue);
+	}
+	template <typename U> static constexpr SIZE_T IndexOfType()
+	{
+		return CleverTapSDK::Details::TPropertyValueType<U>::Index;
 	}
-	template <typename U> static constexpr SIZE_T IndexOfType() { return VariantType::IndexOfType<U>(); }
-	SIZE_T GetIndex() const { return Value.GetIndex(); }
+	SIZE_T GetIndex() const { return TypeIndex; }
 
 private:
-	VariantType Value;
+	template <typename U>
+	using TBoxedTag = TIntegralConstant<bool, CleverTapSDK::Details::TPropertyValueType<U>::bBoxed != 0>;
+	template <typename U> using TBox = CleverTapSDK::Details::TPropertyValueBox<U>;
+
+	enum class EConstruct
+	{
+		Uninitialized
+	};
+	explicit FCleverTapPropertyValue(EConstruct) {}
+
+	template <typename U, typename... TArgs> void Construct(TArgs&&... Args)
+	{
+		ConstructAs<U>(TBoxedTag<U>(), Forward<TArgs>(Args)...);
+		TypeIndex = uint8(IndexOfType<U>());
+	}
+	template <typename U, typename... TArgs> void ConstructAs(TIntegralConstant<bool, false>, TArgs&&... Args)
+	{
+		static_assert(sizeof(U) <= sizeof(Storage.Inline) && alignof(U) <= alignof(uint64), "Type can't be inline");
+		new (Storage.Inline) U(Forward<TArgs>(Args)...);
+	}
+	template <typename U, typename... TArgs> void ConstructAs(TIntegralConstant<bool, true>, TArgs&&... Args)
+	{
+		CLEVERTAP_LLM_SCOPE();
+		Storage.Box = new TBox<U>(Forward<TArgs>(Args)...);
+	}
+
+	template <typename U> U* GetPointer(TIntegralConstant<bool, false>)
+	{
+		return reinterpret_cast<U*>(Storage.Inline);
+	}
+	template <typename U> const U* GetPointer(TIntegralConstant<bool, false>) const
+	{
+		return reinterpret_cast<const U*>(Storage.Inline);
+	}
+	template <typename U> U* GetPointer(TIntegralConstant<bool, true>)
+	{
+		// copy on write: detach from other values sharing the box before handing out a mutable reference
+		TBox<U>* Box = static_cast<TBox<U>*>(Storage.Box);
+		if (Box->RefCount.load(std::memory_order_acquire) != 1)
+		{
+			TBox<U>* Detached = static_cast<TBox<U>*>(CloneBoxAs<U>());
+			ReleaseBox();
+			Storage.Box = Detached;
+			Box = Detached;
+		}
+		Box->bUnshareable = true;
+		return &Box->Value;
+	}
+	template <typename U> const U* GetPointer(TIntegralConstant<bool, true>) const
+	{
+		return &static_cast<const TBox<U>*>(Storage.Box)->Value;
+	}
+
+	template <typename U> CleverTapSDK::Details::FPropertyValueBox* CloneBoxAs() const
+	{
+		CLEVERTAP_LLM_SCOPE();
+		return new TBox<U>(static_cast<const TBox<U>*>(Storage.Box)->Value);
+	}
+
+	CleverTapSDK::Details::FPropertyValueBox* CloneBox() const
+	{
+		switch (TypeIndex)
+		{
+			case IndexOfType<FString>():
+				return CloneBoxAs<FString>();
+			case IndexOfType<FCleverTapDate>():
+				return CloneBoxAs<FCleverTapDate>();
+			case IndexOfType<TArray<int32>>():
+				return CloneBoxAs<TArray<int32>>();
+			case IndexOfType<TArray<int64>>():
+				return CloneBoxAs<TArray<int64>>();
+			case IndexOfType<TArray<float>>():
+				return CloneBoxAs<TArray<float>>();
+			case IndexOfType<TArray<double>>():
+				return CloneBoxAs<TArray<double>>();
+			case IndexOfType<TArray<bool>>():
+				return CloneBoxAs<TArray<bool>>();
+			case IndexOfType<TArray<FString>>():
+				return CloneBoxAs<TArray<FString>>();
+			default:
+				checkNoEntry();
+				return nullptr;
+		}
+	}
+
+	bool IsBoxed() const
+	{
+		switch (TypeIndex)
+		{
+			case IndexOfType<FString>():
+			case IndexOfType<FCleverTapDate>():
+			case IndexOfType<TArray<int32>>():
+			case IndexOfType<TArray<int64>>():
+			case IndexOfType<TArray<float>>():
+			case IndexOfType<TArray<double>>():
+			case IndexOfType<TArray<bool>>():
+			case IndexOfType<TArray<FString>>():
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	void ReleaseBox()
+	{
+		if (!IsBoxed() || Storage.Box->RefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		switch (TypeIndex)
+		{
+			case IndexOfType<FString>():
+				delete static_cast<TBox<FString>*>(Storage.Box);
+				break;
+			case IndexOfType<FCleverTapDate>():
+				delete static_cast<TBox<FCleverTapDate>*>(Storage.Box);
+				break;
+			case IndexOfType<TArray<int32>>():
+				delete static_cast<TBox<TArray<int32>>*>(Storage.Box);
+				break;
+			case IndexOfType<TArray<int64>>():
+				delete static_cast<TBox<TArray<int64>>*>(Storage.Box);
+				break;
+			case IndexOfType<TArray<float>>():
+				delete static_cast<TBox<TArray<float>>*>(Storage.Box);
+				break;
+			case IndexOfType<TArray<double>>():
+				delete static_cast<TBox<TArray<double>>*>(Storage.Box);
+				break;
+			case IndexOfType<TArray<bool>>():
+				delete static_cast<TBox<TArray<bool>>*>(Storage.Box);
+				break;
+			case IndexOfType<TArray<FString>>():
+				delete static_cast<TBox<TArray<FString>>*>(Storage.Box);
+				break;
+		}
+	}
+
+	void ResetToDefault()
+	{
+		Storage.Box = nullptr;
+		TypeIndex = uint8(IndexOfType<int32>());
+	}
+
+	union
+	{
+		alignas(uint64) uint8 Inline[8];
+		CleverTapSDK::Details::FPropertyValueBox* Box;
+	} Storage;
+	uint8 TypeIndex;
 };
 
+static_assert(sizeof(FCleverTapPropertyValue) == 16, "FCleverTapPropertyValue is expected to be 16 bytes");
+
 using FCleverTapProperties = TMap<FString, FCleverTapPropertyValue>;
+
+/**
+ * Insertion-ordered list of properties. Unlike FCleverTapProperties it is a single flat allocation without a hash
+ *  index, which makes it cheaper to build and to move through the event pipeline. Keys are expected to be unique.
+ */
+using FCleverTapPayload = TArray<TPair<FString, FCleverTapPropertyValue>>;
@@ -0,0 +1,66 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapInstance.h"
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+struct FCleverTapInstanceConfig;
+
+namespace CleverTapSDK { namespace GenericPlatform {
+class FGenericPlatformCleverTapInstance;
+}} // namespace CleverTapSDK::GenericPlatform
+
+/**
+ * An instance of the generic backend that is isolated from the shared instance, for the benchmarks and the tests of
+ *  other modules. Its events are buffered in a queue of its own and, when UploadEndpointUrl is set, uploaded from
+ *  there; they never reach the shared instance, the CleverTap SDK of the platform or the offline store, so SpillToDisk
+ *  is treated as DropOldest.
+ *
+ * Runs on the game thread, except for the ICleverTapInstance calls that are safe from any thread. Not available in
+ *  Shipping builds.
+ */
+class CLEVERTAP_API FCleverTapTestInstance
+{
+public:
+	explicit FCleverTapTestInstance(const FCleverTapInstanceConfig& Config);
+	~FCleverTapTestInstance();
+
+	FCleverTapTestInstance(const FCleverTapTestInstance&) = delete;
+	FCleverTapTestInstance& operator=(const FCleverTapTestInstance&) = delete;
+
+	ICleverTapInstance& Get();
+
+	/**
+	 * The number of buffered records that haven't been taken for upload yet.
+	 */
+	int32 GetNumBuffered() const;
+
+	/**
+	 * Removes up to MaxRecords of the oldest buffered records without uploading them. Returns the number removed.
+	 */
+	int32 DiscardBuffered(int32 MaxRecords);
+
+	/**
+	 * The number of records dropped by the overflow policy.
+	 */
+	int64 GetNumDropped() const;
+
+	/**
+	 * Whether every buffered record has been uploaded. Always false without an UploadEndpointUrl.
+	 */
+	bool IsUploadIdle() const;
+
+	/**
+	 * The batch size and round trip time the flush policy of the uploader settled on, or zero without one.
+	 */
+	int32 GetUploadBatchSize() const;
+	double GetUploadRttSeconds() const;
+
+private:
+	TUniquePtr<CleverTapSDK::GenericPlatform::FGenericPlatformCleverTapInstance> Instance;
+};
+
+#endif // !UE_BUILD_SHIPPING
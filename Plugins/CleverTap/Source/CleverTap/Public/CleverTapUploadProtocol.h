@@ -0,0 +1,46 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The requests the generic uploader sends to UploadEndpointUrl on platforms without a CleverTap SDK.
+ *
+ * Each batch is a POST whose body is a UTF-8 JSON object:
+ *
+ *  { "batch": "7C0B8B5A4E1D4C2E9F3A6B5D8E2F1A0C", "session": "0E4D2C1B3A5F4E6D8C7B9A0F1E2D3C4B", "seq": 12,
+ *    "events": [
+ *      { "type": "event", "ts": 1700000000000, "name": "Level Complete", "properties": { "Level": 3 } },
+ *      { "type": "charged", "ts": 1700000000500, "properties": { "Amount": 300 }, "items": [ { "Quantity": 1 } ] },
+ *      { "type": "profile", "ts": ..., "properties": { ... } },
+ *      { "type": "login", "ts": ..., "identity": "custom id or empty", "properties": { ... } },
+ *      { "type": "increment", "ts": ..., "name": "profile key", "properties": { "Amount": -2 } } ] }
+ *
+ * "batch" is unique to the batch and "ts" is the time the event was recorded in milliseconds since the Unix epoch. A
+ *  batch is sent again with the same id until it is acknowledged, so endpoints should treat repeated ids as
+ *  duplicates. Batches not acknowledged when the app exits are sent again by its next run under a new id.
+ *
+ * Several batches may be in flight at once, so they can arrive out of order. "session" identifies the uploader that
+ *  sent the batch and "seq" numbers its batches from 0 in the order their events were recorded; applying the batches
+ *  of a session in "seq" order restores the order of the events. A batch that contains a login is only sent once
+ *  every earlier batch is acknowledged, and no later batch is sent before it is acknowledged, so the events of one
+ *  user are never received after those of the next user.
+ *
+ * A 2xx response acknowledges the batch. 408, 429, 5xx and connection failures are retried later; 429 and 503 may
+ *  carry a Retry-After header in seconds. Other 4xx responses reject the batch, which is dropped.
+ */
+namespace CleverTapSDK { namespace UploadProtocol {
+
+/**
+ * The project id and token of the instance.
+ */
+constexpr const TCHAR* AccountIdHeader = TEXT("X-CleverTap-Account-Id");
+constexpr const TCHAR* TokenHeader = TEXT("X-CleverTap-Token");
+
+/**
+ * Set when the body is compressed: "LZ4" or "Zlib", and the size of the JSON body before compression.
+ */
+constexpr const TCHAR* CompressionHeader = TEXT("X-CleverTap-Compression");
+constexpr const TCHAR* UncompressedLengthHeader = TEXT("X-CleverTap-Uncompressed-Length");
+
+}} // namespace CleverTapSDK::UploadProtocol
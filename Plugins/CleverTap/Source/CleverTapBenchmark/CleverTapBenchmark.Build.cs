@@ -0,0 +1,21 @@
+// Copyright CleverTap All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class CleverTapBenchmark : ModuleRules
+{
+	public CleverTapBenchmark(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CleverTap",
+				"Core",
+				"Json",
+				"Projects",
+			}
+		);
+	}
+}
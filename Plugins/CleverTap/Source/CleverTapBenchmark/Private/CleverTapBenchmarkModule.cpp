@@ -0,0 +1,75 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapBenchmarkRunner.h"
+#include "CleverTapUploadBenchmark.h"
+
+#include "CleverTapLog.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace CleverTapSDK { namespace Benchmark {
+
+namespace {
+
+void RunBenchmarks(const TArray<FString>& Args)
+{
+	FString Filter;
+	double MinSampleSeconds = 0.05;
+	for (const FString& Arg : Args)
+	{
+		if (!FParse::Value(*Arg, TEXT("Filter="), Filter) && !FParse::Value(*Arg, TEXT("MinTime="), MinSampleSeconds))
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("CleverTap.Benchmark: ignoring unknown argument '%s'"), *Arg);
+		}
+	}
+
+	FRunner Runner(Filter, MinSampleSeconds);
+	RunAll(Runner);
+
+	const FString BaseName = FPaths::ProfilingDir() / TEXT("CleverTap")
+		/ FString::Printf(TEXT("Benchmark-%s"), *FDateTime::Now().ToString());
+	const FString JsonPath = BaseName + TEXT(".json");
+	const FString CsvPath = BaseName + TEXT(".csv");
+	if (FFileHelper::SaveStringToFile(Runner.ToJson(), *JsonPath)
+		&& FFileHelper::SaveStringToFile(Runner.ToCsv(), *CsvPath))
+	{
+		UE_LOG(LogCleverTap, Display, TEXT("CleverTap.Benchmark: %d results written to %s and %s"),
+			Runner.GetResults().Num(), *JsonPath, *CsvPath);
+	}
+	else
+	{
+		UE_LOG(LogCleverTap, Error, TEXT("CleverTap.Benchmark: failed to write results to %s"), *BaseName);
+	}
+}
+
+FAutoConsoleCommand BenchmarkCommand(TEXT("CleverTap.Benchmark"),
+	TEXT("Runs the CleverTap micro-benchmarks and writes the results as JSON and CSV to the profiling directory.\n")
+	TEXT("Arguments: Filter=<substring> MinTime=<seconds per sample>"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmarks));
+
+/**
+ * Stops the upload benchmark started from the console before the CleverTap module it uploads through is unloaded.
+ */
+class FCleverTapBenchmarkModule : public IModuleInterface
+{
+public:
+	virtual void ShutdownModule() override { StopUploadBenchmark(); }
+};
+
+} // namespace
+
+}} // namespace CleverTapSDK::Benchmark
+
+IMPLEMENT_MODULE(CleverTapSDK::Benchmark::FCleverTapBenchmarkModule, CleverTapBenchmark)
+
+#else
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, CleverTapBenchmark)
+
+#endif // !UE_BUILD_SHIPPING
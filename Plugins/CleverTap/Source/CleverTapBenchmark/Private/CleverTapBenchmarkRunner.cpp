@@ -0,0 +1,148 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapBenchmarkRunner.h"
+
+#include "CleverTapAllocationTracker.h"
+#include "CleverTapJsonWriter.h"
+#include "CleverTapLog.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+
+namespace CleverTapSDK { namespace Benchmark {
+
+namespace {
+
+FString GetPluginVersion()
+{
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("CleverTap"));
+	return Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString(TEXT("unknown"));
+}
+
+} // namespace
+
+FRunner::FRunner(FString InFilter, double InMinSampleSeconds)
+	: Filter(MoveTemp(InFilter)), MinSampleSeconds(InMinSampleSeconds)
+{
+}
+
+bool FRunner::ShouldRun(const TCHAR* Name) const
+{
+	return Filter.IsEmpty() || FCString::Stristr(Name, *Filter) != nullptr;
+}
+
+void FRunner::AddResult(const TCHAR* Name, int64 Iterations,
+	TArray<double, TInlineAllocator<NumSamples>>& SampleSeconds, int64 BytesPerIteration)
+{
+	SampleSeconds.Sort();
+
+	FResult& Result = Results.AddDefaulted_GetRef();
+	Result.Name = Name;
+	Result.IterationsPerSample = Iterations;
+	Result.NumSamples = SampleSeconds.Num();
+	Result.MedianNanoseconds = SampleSeconds[SampleSeconds.Num() / 2] * 1e9 / double(Iterations);
+	Result.MinNanoseconds = SampleSeconds[0] * 1e9 / double(Iterations);
+	Result.BytesPerIteration = BytesPerIteration;
+
+	if (BytesPerIteration > 0)
+	{
+		UE_LOG(LogCleverTap, Display, TEXT("%-48s %12.1f ns %10.1f MB/s"), Name, Result.MedianNanoseconds,
+			Result.GetMegabytesPerSecond());
+	}
+	else
+	{
+		UE_LOG(LogCleverTap, Display, TEXT("%-48s %12.1f ns"), Name, Result.MedianNanoseconds);
+	}
+}
+
+void FRunner::BeginMeasuringMemory()
+{
+	FCleverTapAllocationTracker::Get().Install();
+}
+
+int64 FRunner::EndMeasuringMemory()
+{
+	FCleverTapAllocationTracker& Tracker = FCleverTapAllocationTracker::Get();
+	Tracker.Uninstall();
+	return Tracker.GetLiveBytes();
+}
+
+void FRunner::AddMemoryResult(const TCHAR* Name, int64 AllocatedBytes, int64 NumItems)
+{
+	FResult& Result = Results.AddDefaulted_GetRef();
+	Result.Name = Name;
+	Result.AllocatedBytes = AllocatedBytes;
+	Result.NumItems = NumItems;
+	UE_LOG(LogCleverTap, Display, TEXT("%-48s %12.1f bytes/item %10.1f MB"), Name, Result.GetBytesPerItem(),
+		double(AllocatedBytes) / (1024.0 * 1024.0));
+}
+
+FString FRunner::ToJson() const
+{
+	TArray<uint8> Json;
+	FCleverTapJsonWriter Writer(Json);
+	Writer.BeginObject();
+	Writer.WriteKey("pluginVersion");
+	Writer.WriteValue(GetPluginVersion());
+	Writer.WriteKey("platform");
+	Writer.WriteValue(FString(FPlatformProperties::IniPlatformName()));
+	Writer.WriteKey("buildConfiguration");
+	Writer.WriteValue(FString(LexToString(FApp::GetBuildConfiguration())));
+	Writer.WriteKey("timestamp");
+	Writer.WriteValue(FDateTime::UtcNow().ToIso8601());
+	Writer.WriteKey("results");
+	Writer.BeginArray();
+	for (const FResult& Result : Results)
+	{
+		Writer.BeginObject();
+		Writer.WriteKey("name");
+		Writer.WriteValue(Result.Name);
+		if (Result.NumItems > 0)
+		{
+			Writer.WriteKey("allocatedBytes");
+			Writer.WriteValue(Result.AllocatedBytes);
+			Writer.WriteKey("items");
+			Writer.WriteValue(Result.NumItems);
+			Writer.WriteKey("bytesPerItem");
+			Writer.WriteValue(Result.GetBytesPerItem());
+			Writer.EndObject();
+			continue;
+		}
+		Writer.WriteKey("iterationsPerSample");
+		Writer.WriteValue(Result.IterationsPerSample);
+		Writer.WriteKey("samples");
+		Writer.WriteValue(Result.NumSamples);
+		Writer.WriteKey("medianNs");
+		Writer.WriteValue(Result.MedianNanoseconds);
+		Writer.WriteKey("minNs");
+		Writer.WriteValue(Result.MinNanoseconds);
+		if (Result.BytesPerIteration > 0)
+		{
+			Writer.WriteKey("bytesPerIteration");
+			Writer.WriteValue(Result.BytesPerIteration);
+			Writer.WriteKey("medianMBps");
+			Writer.WriteValue(Result.GetMegabytesPerSecond());
+		}
+		Writer.EndObject();
+	}
+	Writer.EndArray();
+	Writer.EndObject();
+
+	FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Json.GetData()), Json.Num());
+	return FString(Converted.Length(), Converted.Get());
+}
+
+FString FRunner::ToCsv() const
+{
+	FString Csv = TEXT("name,iterationsPerSample,samples,medianNs,minNs,bytesPerIteration,medianMBps,")
+		TEXT("allocatedBytes,bytesPerItem\n");
+	for (const FResult& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%s,%lld,%d,%.3f,%.3f,%lld,%.3f,%lld,%.3f\n"), *Result.Name,
+			Result.IterationsPerSample, Result.NumSamples, Result.MedianNanoseconds, Result.MinNanoseconds,
+			Result.BytesPerIteration, Result.GetMegabytesPerSecond(), Result.AllocatedBytes, Result.GetBytesPerItem());
+	}
+	return Csv;
+}
+
+}} // namespace CleverTapSDK::Benchmark
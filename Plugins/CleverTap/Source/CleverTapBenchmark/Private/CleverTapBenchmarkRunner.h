@@ -0,0 +1,137 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace CleverTapSDK { namespace Benchmark {
+
+/**
+ * Keeps the compiler from optimizing away a value computed by a benchmark.
+ */
+template <typename T> FORCEINLINE void DoNotOptimize(const T& Value)
+{
+	static const void* volatile Sink;
+	Sink = &Value;
+}
+
+struct FResult
+{
+	FString Name;
+	int64 IterationsPerSample = 0;
+	int32 NumSamples = 0;
+	double MedianNanoseconds = 0.0;
+	double MinNanoseconds = 0.0;
+	int64 BytesPerIteration = 0;
+
+	// set by memory measurements instead of the timings
+	int64 AllocatedBytes = 0;
+	int64 NumItems = 0;
+
+	double GetMegabytesPerSecond() const
+	{
+		return MedianNanoseconds > 0.0 ? double(BytesPerIteration) * 1000.0 / MedianNanoseconds : 0.0;
+	}
+
+	double GetBytesPerItem() const { return NumItems > 0 ? double(AllocatedBytes) / double(NumItems) : 0.0; }
+};
+
+/**
+ * Runs micro benchmarks and collects their results.
+ *
+ * Each benchmark is calibrated to the smallest power of two iteration count that takes at least the minimum sample
+ *  time, then measured over a fixed number of samples. The median time per iteration is reported, which is less
+ *  sensitive to scheduling noise than the mean.
+ */
+class FRunner
+{
+public:
+	static constexpr int32 NumSamples = 7;
+
+	/**
+	 * \param InFilter - only benchmarks whose name contains the filter are run; empty runs all.
+	 * \param InMinSampleSeconds - minimum duration of a single sample.
+	 */
+	FRunner(FString InFilter, double InMinSampleSeconds);
+
+	/**
+	 * Runs Body repeatedly and records its time per call. BytesPerIteration is reported as throughput, e.g. for
+	 *  serialization.
+	 */
+	template <typename BodyType> void Run(const TCHAR* Name, BodyType&& Body, int64 BytesPerIteration = 0)
+	{
+		if (!ShouldRun(Name))
+		{
+			return;
+		}
+
+		const auto RunIterations = [&Body](int64 Iterations) {
+			const double StartSeconds = FPlatformTime::Seconds();
+			for (int64 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				Body();
+			}
+			return FPlatformTime::Seconds() - StartSeconds;
+		};
+
+		int64 Iterations = 1;
+		while (RunIterations(Iterations) < MinSampleSeconds && Iterations < (int64(1) << 40))
+		{
+			Iterations *= 2;
+		}
+
+		TArray<double, TInlineAllocator<NumSamples>> SampleSeconds;
+		for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+		{
+			SampleSeconds.Add(RunIterations(Iterations));
+		}
+		AddResult(Name, Iterations, SampleSeconds, BytesPerIteration);
+	}
+
+	/**
+	 * Records the heap memory held by the value Build returns, per item. Only the allocations of the calling thread
+	 *  are counted, and only with allocators that report allocation sizes; the value is freed after the measurement.
+	 */
+	template <typename BuildType> void MeasureMemory(const TCHAR* Name, BuildType&& Build, int64 NumItems)
+	{
+		if (!ShouldRun(Name))
+		{
+			return;
+		}
+
+		BeginMeasuringMemory();
+		const auto Value = Build();
+		DoNotOptimize(Value);
+		AddMemoryResult(Name, EndMeasuringMemory() + int64(sizeof(Value)), NumItems);
+	}
+
+	const TArray<FResult>& GetResults() const { return Results; }
+
+	/**
+	 * Renders the results as a JSON document tagged with the plugin version and platform.
+	 */
+	FString ToJson() const;
+
+	/**
+	 * Renders the results as CSV with a header row.
+	 */
+	FString ToCsv() const;
+
+private:
+	bool ShouldRun(const TCHAR* Name) const;
+	void AddResult(const TCHAR* Name, int64 Iterations, TArray<double, TInlineAllocator<NumSamples>>& SampleSeconds,
+		int64 BytesPerIteration);
+	static void BeginMeasuringMemory();
+	static int64 EndMeasuringMemory();
+	void AddMemoryResult(const TCHAR* Name, int64 AllocatedBytes, int64 NumItems);
+
+	FString Filter;
+	double MinSampleSeconds;
+	TArray<FResult> Results;
+};
+
+/**
+ * Runs all benchmarks. Events are pushed to isolated instances of the generic backend, never to the shared instance.
+ */
+void RunAll(FRunner& Runner);
+
+}} // namespace CleverTapSDK::Benchmark
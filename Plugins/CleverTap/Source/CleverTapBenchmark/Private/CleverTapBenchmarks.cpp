@@ -0,0 +1,445 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapBenchmarkRunner.h"
+
+#include "CleverTapBinaryFormat.h"
+#include "CleverTapChargedItems.h"
+#include "CleverTapEventBuilder.h"
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapJsonReader.h"
+#include "CleverTapJsonWriter.h"
+#include "CleverTapTestInstance.h"
+
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace CleverTapSDK { namespace Benchmark {
+
+namespace {
+
+const int32 PropertyCounts[] = { 10, 50 };
+const int32 CartSizes[] = { 10, 100, 1000 };
+
+// the memory benchmarks hold one million properties as events of ten properties each
+constexpr int32 MemoryEvents = 100000;
+constexpr int32 MemoryPropertiesPerEvent = 10;
+
+// A representative mix of the value types seen in game events
+FCleverTapPropertyValue MakeValue(int32 Index)
+{
+	switch (Index % 5)
+	{
+		case 0:
+			return FCleverTapPropertyValue(Index * 7);
+		case 1:
+			return FCleverTapPropertyValue(Index * 0.25);
+		case 2:
+			return FCleverTapPropertyValue(FString::Printf(TEXT("Value %d"), Index));
+		case 3:
+			return FCleverTapPropertyValue((Index & 1) != 0);
+		default:
+			return FCleverTapPropertyValue(int64(Index) << 33);
+	}
+}
+
+TArray<FString> MakeKeys(int32 NumKeys)
+{
+	TArray<FString> Keys;
+	for (int32 Index = 0; Index < NumKeys; ++Index)
+	{
+		Keys.Add(FString::Printf(TEXT("Property %d"), Index));
+	}
+	return Keys;
+}
+
+FCleverTapProperties MakeProperties(const TArray<FString>& Keys)
+{
+	FCleverTapProperties Properties;
+	for (int32 Index = 0; Index < Keys.Num(); ++Index)
+	{
+		Properties.Add(Keys[Index], MakeValue(Index));
+	}
+	return Properties;
+}
+
+// The properties as an FJsonObject, the form FJsonSerializer works with
+TSharedRef<FJsonObject> MakeJsonObject(const FCleverTapProperties& Properties)
+{
+	const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	for (const TPair<FString, FCleverTapPropertyValue>& Property : Properties)
+	{
+		const FCleverTapPropertyValue& Value = Property.Value;
+		if (const int32* Int32 = Value.TryGet<int32>())
+		{
+			Object->SetNumberField(Property.Key, *Int32);
+		}
+		else if (const int64* Int64 = Value.TryGet<int64>())
+		{
+			Object->SetNumberField(Property.Key, double(*Int64));
+		}
+		else if (const double* Double = Value.TryGet<double>())
+		{
+			Object->SetNumberField(Property.Key, *Double);
+		}
+		else if (const bool* Bool = Value.TryGet<bool>())
+		{
+			Object->SetBoolField(Property.Key, *Bool);
+		}
+		else if (const FString* String = Value.TryGet<FString>())
+		{
+			Object->SetStringField(Property.Key, *String);
+		}
+	}
+	return Object;
+}
+
+TArray<FCleverTapProperties> MakeCartRows(int32 NumItems)
+{
+	TArray<FCleverTapProperties> Items;
+	Items.Reserve(NumItems);
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		FCleverTapProperties& Item = Items.AddDefaulted_GetRef();
+		Item.Add(TEXT("Product"), FString::Printf(TEXT("Product %d"), Index));
+		Item.Add(TEXT("Category"), FString(TEXT("Consumables")));
+		Item.Add(TEXT("Quantity"), Index % 4 + 1);
+		Item.Add(TEXT("Price"), 0.99 + Index);
+		Item.Add(TEXT("Discounted"), (Index & 1) != 0);
+	}
+	return Items;
+}
+
+FCleverTapChargedItems MakeCartColumns(int32 NumItems)
+{
+	TArray<FString> Products;
+	TArray<FString> Categories;
+	TArray<int32> Quantities;
+	TArray<double> Prices;
+	TArray<bool> Discounted;
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		Products.Add(FString::Printf(TEXT("Product %d"), Index));
+		Categories.Add(TEXT("Consumables"));
+		Quantities.Add(Index % 4 + 1);
+		Prices.Add(0.99 + Index);
+		Discounted.Add((Index & 1) != 0);
+	}
+
+	FCleverTapChargedItems Items;
+	Items.AddColumn(TEXT("Product"), MoveTemp(Products))
+		.AddColumn(TEXT("Category"), MoveTemp(Categories))
+		.AddColumn(TEXT("Quantity"), MoveTemp(Quantities))
+		.AddColumn(TEXT("Price"), MoveTemp(Prices))
+		.AddColumn(TEXT("Discounted"), MoveTemp(Discounted));
+	return Items;
+}
+
+void RunPropertyValueBenchmarks(FRunner& Runner)
+{
+	const FString String = TEXT("Casio Chronograph Watch");
+	TArray<FString> StringArray;
+	for (int32 Index = 0; Index < 10; ++Index)
+	{
+		StringArray.Add(FString::Printf(TEXT("Item %d"), Index));
+	}
+
+	Runner.Run(TEXT("PropertyValue/Construct/Int32"), [] {
+		FCleverTapPropertyValue Value(42);
+		DoNotOptimize(Value);
+	});
+	Runner.Run(TEXT("PropertyValue/Construct/Double"), [] {
+		FCleverTapPropertyValue Value(59.99);
+		DoNotOptimize(Value);
+	});
+	Runner.Run(TEXT("PropertyValue/Construct/String"), [&String] {
+		FCleverTapPropertyValue Value(String);
+		DoNotOptimize(Value);
+	});
+	Runner.Run(TEXT("PropertyValue/Construct/StringArray10"), [&StringArray] {
+		FCleverTapPropertyValue Value(StringArray);
+		DoNotOptimize(Value);
+	});
+
+	const FCleverTapPropertyValue StringValue(String);
+	const FCleverTapPropertyValue StringArrayValue(StringArray);
+	Runner.Run(TEXT("PropertyValue/Copy/String"), [&StringValue] {
+		FCleverTapPropertyValue Copy(StringValue);
+		DoNotOptimize(Copy);
+	});
+	Runner.Run(TEXT("PropertyValue/Copy/StringArray10"), [&StringArrayValue] {
+		FCleverTapPropertyValue Copy(StringArrayValue);
+		DoNotOptimize(Copy);
+	});
+	Runner.Run(TEXT("PropertyValue/Move/String"), [&StringValue] {
+		FCleverTapPropertyValue Source(StringValue);
+		FCleverTapPropertyValue Moved(MoveTemp(Source));
+		DoNotOptimize(Moved);
+	});
+}
+
+void RunPropertiesBenchmarks(FRunner& Runner)
+{
+	for (int32 NumProperties : PropertyCounts)
+	{
+		const TArray<FString> Keys = MakeKeys(NumProperties);
+
+		Runner.Run(*FString::Printf(TEXT("Properties/Build/%d"), NumProperties), [&Keys] {
+			FCleverTapProperties Properties;
+			for (int32 Index = 0; Index < Keys.Num(); ++Index)
+			{
+				Properties.Add(Keys[Index], MakeValue(Index));
+			}
+			DoNotOptimize(Properties);
+		});
+
+		Runner.Run(*FString::Printf(TEXT("EventBuilder/BuildPayload/%d"), NumProperties), [&Keys] {
+			FCleverTapEventBuilder Builder(TEXT("Benchmark"), Keys.Num());
+			for (int32 Index = 0; Index < Keys.Num(); ++Index)
+			{
+				Builder.Add(Keys[Index], MakeValue(Index));
+			}
+			FCleverTapPayload Payload = Builder.BuildPayload();
+			DoNotOptimize(Payload);
+		});
+	}
+}
+
+void RunSerializationBenchmarks(FRunner& Runner)
+{
+	for (int32 NumProperties : PropertyCounts)
+	{
+		const FCleverTapProperties Properties = MakeProperties(MakeKeys(NumProperties));
+
+		TArray<uint8> Json;
+		FCleverTapJsonWriter(Json).WriteProperties(Properties);
+		TArray<uint8> Binary;
+		FCleverTapBinaryFormat::Write(Properties, Binary);
+
+		TArray<uint8> Output;
+		Runner.Run(*FString::Printf(TEXT("JsonWriter/Write/%d"), NumProperties), [&Properties, &Output] {
+			Output.Reset();
+			FCleverTapJsonWriter(Output).WriteProperties(Properties);
+			DoNotOptimize(Output);
+		}, Json.Num());
+
+		Runner.Run(*FString::Printf(TEXT("JsonReader/Read/%d"), NumProperties), [&Json] {
+			FCleverTapPayload Payload;
+			FCleverTapJsonReader::Read(Json, Payload);
+			DoNotOptimize(Payload);
+		}, Json.Num());
+
+		// FJsonSerializer for comparison, from the same properties and reading the same UTF-8 document
+		using FCondensedJsonWriterFactory = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+		FString JsonString;
+		Runner.Run(*FString::Printf(TEXT("FJsonSerializer/Write/%d"), NumProperties), [&Properties, &JsonString] {
+			JsonString.Reset();
+			FJsonSerializer::Serialize(MakeJsonObject(Properties), FCondensedJsonWriterFactory::Create(&JsonString));
+			DoNotOptimize(JsonString);
+		}, Json.Num());
+
+		Runner.Run(*FString::Printf(TEXT("FJsonSerializer/Read/%d"), NumProperties), [&Json] {
+			const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Json.GetData()), Json.Num());
+			TSharedPtr<FJsonObject> Object;
+			FJsonSerializer::Deserialize(
+				TJsonReaderFactory<>::Create(FString(Converted.Length(), Converted.Get())), Object);
+			DoNotOptimize(Object);
+		}, Json.Num());
+
+		Runner.Run(*FString::Printf(TEXT("BinaryFormat/Write/%d"), NumProperties), [&Properties, &Output] {
+			Output.Reset();
+			FCleverTapBinaryFormat::Write(Properties, Output);
+			DoNotOptimize(Output);
+		}, Binary.Num());
+
+		Runner.Run(*FString::Printf(TEXT("BinaryFormat/Read/%d"), NumProperties), [&Binary] {
+			FCleverTapPayload Payload;
+			FCleverTapBinaryFormat::Read(Binary, Payload);
+			DoNotOptimize(Payload);
+		}, Binary.Num());
+	}
+}
+
+void RunChargedItemsBenchmarks(FRunner& Runner)
+{
+	for (int32 NumItems : CartSizes)
+	{
+		Runner.Run(*FString::Printf(TEXT("ChargedItems/BuildRows/%d"), NumItems), [NumItems] {
+			TArray<FCleverTapProperties> Items = MakeCartRows(NumItems);
+			DoNotOptimize(Items);
+		});
+		Runner.Run(*FString::Printf(TEXT("ChargedItems/BuildColumns/%d"), NumItems), [NumItems] {
+			FCleverTapChargedItems Items = MakeCartColumns(NumItems);
+			DoNotOptimize(Items);
+		});
+	}
+}
+
+void RunMemoryBenchmarks(FRunner& Runner)
+{
+	const TArray<FString> Keys = MakeKeys(MemoryPropertiesPerEvent);
+	const int64 NumProperties = int64(MemoryEvents) * MemoryPropertiesPerEvent;
+
+	Runner.MeasureMemory(TEXT("Memory/Properties/1M"), [&Keys] {
+		TArray<FCleverTapProperties> Events;
+		Events.Reserve(MemoryEvents);
+		for (int32 Event = 0; Event < MemoryEvents; ++Event)
+		{
+			Events.Add(MakeProperties(Keys));
+		}
+		return Events;
+	}, NumProperties);
+
+	Runner.MeasureMemory(TEXT("Memory/Payload/1M"), [&Keys] {
+		TArray<FCleverTapPayload> Events;
+		Events.Reserve(MemoryEvents);
+		for (int32 Event = 0; Event < MemoryEvents; ++Event)
+		{
+			FCleverTapPayload& Payload = Events.AddDefaulted_GetRef();
+			Payload.Reserve(Keys.Num());
+			for (int32 Index = 0; Index < Keys.Num(); ++Index)
+			{
+				Payload.Emplace(Keys[Index], MakeValue(Index));
+			}
+		}
+		return Events;
+	}, NumProperties);
+
+	Runner.MeasureMemory(TEXT("Memory/JsonObject/1M"), [&Keys] {
+		const FCleverTapProperties Properties = MakeProperties(Keys);
+		TArray<TSharedRef<FJsonObject>> Events;
+		Events.Reserve(MemoryEvents);
+		for (int32 Event = 0; Event < MemoryEvents; ++Event)
+		{
+			Events.Add(MakeJsonObject(Properties));
+		}
+		return Events;
+	}, NumProperties);
+
+	// how the generic backend buffers events: binary encoded records in the event queue of an isolated instance
+	Runner.MeasureMemory(TEXT("Memory/EventQueue/1M"), [&Keys] {
+		const FCleverTapProperties Properties = MakeProperties(Keys);
+		FCleverTapInstanceConfig Config;
+		Config.BufferBudgetKilobytes = 0;
+		TUniquePtr<FCleverTapTestInstance> Instance = MakeUnique<FCleverTapTestInstance>(Config);
+		for (int32 Event = 0; Event < MemoryEvents; ++Event)
+		{
+			Instance->Get().PushEvent(TEXT("Benchmark"), Properties);
+		}
+		return Instance;
+	}, NumProperties);
+}
+
+void RunEventQueueBenchmarks(FRunner& Runner)
+{
+	const FCleverTapProperties Properties = MakeProperties(MakeKeys(10));
+	FCleverTapTestInstance Instance{ FCleverTapInstanceConfig{} };
+
+	Runner.Run(TEXT("EventQueue/PushDiscard/10"), [&Properties, &Instance] {
+		Instance.Get().PushEvent(TEXT("Benchmark"), Properties);
+		Instance.DiscardBuffered(1);
+	});
+
+	// producers and consumers all contend on the queue's lock, like game threads pushing events while the uploader
+	//  takes batches
+	constexpr int32 NumThreads = 4;
+	Runner.Run(TEXT("EventQueue/PushDiscard/10/Contended4"), [&Properties, &Instance] {
+		ParallelFor(NumThreads, [&Properties, &Instance](int32) {
+			for (int32 Index = 0; Index < 16; ++Index)
+			{
+				Instance.Get().PushEvent(TEXT("Benchmark"), Properties);
+				Instance.DiscardBuffered(1);
+			}
+		});
+	});
+}
+
+void RunEndToEndBenchmarks(FRunner& Runner)
+{
+	// events are buffered by an instance of their own, bounded by the default budget and never uploaded, so nothing
+	//  reaches the shared instance or the CleverTap account and the metrics below aren't reported with real ones
+	FCleverTapTestInstance Instance{ FCleverTapInstanceConfig{} };
+	ICleverTapInstance& CleverTap = Instance.Get();
+	const TArray<FString> Keys = MakeKeys(10);
+	const FCleverTapProperties Properties = MakeProperties(Keys);
+
+	Runner.Run(TEXT("EndToEnd/PushEvent/NoProperties"), [&CleverTap] { CleverTap.PushEvent(TEXT("Benchmark")); });
+	Runner.Run(TEXT("EndToEnd/PushEvent/10"), [&CleverTap, &Properties] {
+		CleverTap.PushEvent(TEXT("Benchmark"), Properties);
+	});
+	Runner.Run(TEXT("EndToEnd/PushEvent/EventBuilder/10"), [&CleverTap, &Keys] {
+		FCleverTapEventBuilder Builder(TEXT("Benchmark"), Keys.Num());
+		for (int32 Index = 0; Index < Keys.Num(); ++Index)
+		{
+			Builder.Add(Keys[Index], MakeValue(Index));
+		}
+		Builder.Push(CleverTap);
+	});
+
+	// the same event with the shared properties moved into a context and a global property
+	{
+		CleverTap.SetEventContext(FCleverTapEventContext::Create(MakeProperties(MakeKeys(8))));
+		CleverTap.SetGlobalProperty(TEXT("Benchmark Global"), 1);
+
+		FCleverTapProperties EventProperties;
+		EventProperties.Add(TEXT("Property 8"), MakeValue(8));
+		EventProperties.Add(TEXT("Property 9"), MakeValue(9));
+		Runner.Run(TEXT("EndToEnd/PushEvent/Context8+Global1+Event2"), [&CleverTap, &EventProperties] {
+			CleverTap.PushEvent(TEXT("Benchmark"), EventProperties);
+		});
+
+		CleverTap.RemoveGlobalProperty(TEXT("Benchmark Global"));
+		CleverTap.SetEventContext(nullptr);
+	}
+
+	// concurrent pushes contend on the instance's shared state, e.g. the resolved event context
+	constexpr int32 NumThreads = 4;
+	Runner.Run(TEXT("EndToEnd/PushEvent/10/Contended4"), [&CleverTap, &Properties] {
+		ParallelFor(NumThreads, [&CleverTap, &Properties](int32) {
+			for (int32 Index = 0; Index < 16; ++Index)
+			{
+				CleverTap.PushEvent(TEXT("Benchmark"), Properties);
+			}
+		});
+	});
+
+	// metric updates only touch the shard of the updating thread, so they should scale with the number of threads
+	const FCleverTapCounter Counter = CleverTap.Counter(TEXT("Benchmark Counter"));
+	const FCleverTapHistogram Histogram = CleverTap.Histogram(TEXT("Benchmark Histogram"));
+	Runner.Run(TEXT("EndToEnd/Metrics/Counter/Add"), [&Counter] { Counter.Add(); });
+	Runner.Run(TEXT("EndToEnd/Metrics/Histogram/Record"), [&Histogram] { Histogram.Record(16.6); });
+	Runner.Run(TEXT("EndToEnd/Metrics/Counter/Add/Contended4"), [&Counter] {
+		ParallelFor(NumThreads, [&Counter](int32) {
+			for (int32 Index = 0; Index < 16; ++Index)
+			{
+				Counter.Add();
+			}
+		});
+	});
+
+	const FCleverTapProperties ChargeDetails = MakeProperties(MakeKeys(3));
+	for (int32 NumItems : CartSizes)
+	{
+		const TArray<FCleverTapProperties> Rows = MakeCartRows(NumItems);
+		const FCleverTapChargedItems Columns = MakeCartColumns(NumItems);
+		Runner.Run(*FString::Printf(TEXT("EndToEnd/PushChargedEvent/Rows/%d"), NumItems),
+			[&CleverTap, &ChargeDetails, &Rows] { CleverTap.PushChargedEvent(ChargeDetails, Rows); });
+		Runner.Run(*FString::Printf(TEXT("EndToEnd/PushChargedEvent/Columns/%d"), NumItems),
+			[&CleverTap, &ChargeDetails, &Columns] { CleverTap.PushChargedEvent(ChargeDetails, Columns); });
+	}
+}
+
+} // namespace
+
+void RunAll(FRunner& Runner)
+{
+	RunPropertyValueBenchmarks(Runner);
+	RunPropertiesBenchmarks(Runner);
+	RunSerializationBenchmarks(Runner);
+	RunChargedItemsBenchmarks(Runner);
+	RunEventQueueBenchmarks(Runner);
+	RunMemoryBenchmarks(Runner);
+	RunEndToEndBenchmarks(Runner);
+}
+
+}} // namespace CleverTapSDK::Benchmark
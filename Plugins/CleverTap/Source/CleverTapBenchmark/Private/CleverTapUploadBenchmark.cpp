@@ -0,0 +1,170 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapUploadBenchmark.h"
+
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapLog.h"
+#include "CleverTapTestInstance.h"
+
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace CleverTapSDK { namespace Benchmark {
+
+namespace {
+
+constexpr double RunTimeoutSeconds = 300.0;
+
+/**
+ * Measures how fast the uploader drains a queue of events for each concurrency level, one level after the other, with
+ *  an instance of the generic backend of its own per level. The runs are driven by the core ticker like uploads in a
+ *  game, so the command returns immediately and the results are logged as each run completes.
+ */
+class FUploadBenchmark
+{
+public:
+	FUploadBenchmark(FString InEndpointUrl, int32 InNumEvents, TArray<int32> InConcurrencies)
+		: EndpointUrl(MoveTemp(InEndpointUrl)), NumEvents(InNumEvents), Concurrencies(MoveTemp(InConcurrencies))
+	{
+		TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FUploadBenchmark::Tick));
+	}
+
+	~FUploadBenchmark()
+	{
+		if (TickHandle.IsValid())
+		{
+			FTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		}
+	}
+
+	FUploadBenchmark(const FUploadBenchmark&) = delete;
+	FUploadBenchmark& operator=(const FUploadBenchmark&) = delete;
+
+private:
+	bool Tick(float /*DeltaTime*/)
+	{
+		if (Instance)
+		{
+			const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+			if (!Instance->IsUploadIdle() && ElapsedSeconds < RunTimeoutSeconds)
+			{
+				return true;
+			}
+			Report(ElapsedSeconds);
+			Instance.Reset();
+		}
+
+		if (NextRun == Concurrencies.Num())
+		{
+			UE_LOG(LogCleverTap, Display, TEXT("CleverTap.UploadBenchmark: done"));
+			TickHandle.Reset();
+			return false;
+		}
+		Start(Concurrencies[NextRun++]);
+		return true;
+	}
+
+	void Start(int32 Concurrency)
+	{
+		CurrentConcurrency = FMath::Max(Concurrency, 1);
+		FCleverTapInstanceConfig Config;
+		Config.ProjectId = TEXT("Benchmark");
+		Config.UploadEndpointUrl = EndpointUrl;
+		Config.UploadMaxConcurrentBatches = CurrentConcurrency;
+		Config.UploadMinIntervalSeconds = 0.0f;
+		Config.BufferBudgetKilobytes = 0; // holds every event
+		Config.MetricsIntervalSeconds = 0.0f; // only the benchmark events are uploaded
+
+		FCleverTapProperties Properties;
+		for (int32 Index = 0; Index < 10; ++Index)
+		{
+			Properties.Add(FString::Printf(TEXT("Property %d"), Index), Index * 7);
+		}
+
+		// the uploader first ticks after this returns, so every event is queued before the first batch is taken
+		Instance = MakeUnique<FCleverTapTestInstance>(Config);
+		for (int32 Index = 0; Index < NumEvents; ++Index)
+		{
+			Instance->Get().PushEvent(TEXT("Benchmark"), Properties);
+		}
+		StartSeconds = FPlatformTime::Seconds();
+	}
+
+	void Report(double ElapsedSeconds) const
+	{
+		const FString Name = FString::Printf(TEXT("Upload/%d/Concurrent%d"), NumEvents, CurrentConcurrency);
+		if (!Instance->IsUploadIdle())
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("%-48s timed out with %d events left"), *Name,
+				Instance->GetNumBuffered());
+			return;
+		}
+		UE_LOG(LogCleverTap, Display, TEXT("%-48s %10.0f events/s %8.2f s  batch %4d  rtt %6.1f ms"), *Name,
+			NumEvents / FMath::Max(ElapsedSeconds, 0.001), ElapsedSeconds, Instance->GetUploadBatchSize(),
+			Instance->GetUploadRttSeconds() * 1000.0);
+	}
+
+	const FString EndpointUrl;
+	const int32 NumEvents;
+	const TArray<int32> Concurrencies;
+	int32 NextRun = 0;
+
+	TUniquePtr<FCleverTapTestInstance> Instance;
+	int32 CurrentConcurrency = 0;
+	double StartSeconds = 0.0;
+
+	FDelegateHandle TickHandle;
+};
+
+TUniquePtr<FUploadBenchmark> RunningBenchmark;
+
+void RunUploadBenchmark(const TArray<FString>& Args)
+{
+	FString EndpointUrl;
+	int32 NumEvents = 10000;
+	FString ConcurrencyList = TEXT("1,2,4,8");
+	for (const FString& Arg : Args)
+	{
+		if (!FParse::Value(*Arg, TEXT("Endpoint="), EndpointUrl) && !FParse::Value(*Arg, TEXT("Events="), NumEvents)
+			&& !FParse::Value(*Arg, TEXT("Concurrency="), ConcurrencyList, /*bShouldStopOnSeparator=*/false))
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("CleverTap.UploadBenchmark: ignoring unknown argument '%s'"), *Arg);
+		}
+	}
+	if (EndpointUrl.IsEmpty())
+	{
+		UE_LOG(LogCleverTap, Error, TEXT("CleverTap.UploadBenchmark: Endpoint=<url> is required"));
+		return;
+	}
+
+	TArray<FString> ConcurrencyStrings;
+	ConcurrencyList.ParseIntoArray(ConcurrencyStrings, TEXT(","));
+	TArray<int32> Concurrencies;
+	for (const FString& Concurrency : ConcurrencyStrings)
+	{
+		Concurrencies.Add(FCString::Atoi(*Concurrency));
+	}
+
+	UE_LOG(LogCleverTap, Display, TEXT("CleverTap.UploadBenchmark: uploading %d events to %s"), NumEvents,
+		*EndpointUrl);
+	RunningBenchmark = MakeUnique<FUploadBenchmark>(EndpointUrl, FMath::Max(NumEvents, 1), MoveTemp(Concurrencies));
+}
+
+FAutoConsoleCommand UploadBenchmarkCommand(TEXT("CleverTap.UploadBenchmark"),
+	TEXT("Measures how fast the generic uploader drains a queue of events at several concurrency levels.\n")
+	TEXT("Arguments: Endpoint=<url> Events=<count> Concurrency=<comma separated levels>"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunUploadBenchmark));
+
+} // namespace
+
+void StopUploadBenchmark()
+{
+	RunningBenchmark.Reset();
+}
+
+}} // namespace CleverTapSDK::Benchmark
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,18 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace CleverTapSDK { namespace Benchmark {
+
+/**
+ * Stops the upload benchmark started from the console, if any. Called when the module shuts down, before the ticker
+ *  and the CleverTap module go away.
+ */
+void StopUploadBenchmark();
+
+}} // namespace CleverTapSDK::Benchmark
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,28 @@
+// Copyright CleverTap All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class CleverTapStandIn : ModuleRules
+{
+	public CleverTapStandIn(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"HTTPServer",
+				"Json",
+			}
+		);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"CleverTap",
+				"HTTP",
+			}
+		);
+	}
+}
@@ -0,0 +1,94 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapStandInServer.h"
+
+#include "CleverTapLog.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/Parse.h"
+#include "Modules/ModuleManager.h"
+
+namespace CleverTapSDK {
+
+namespace {
+
+TUniquePtr<FCleverTapStandInServer> ConsoleServer;
+
+void StartServer(const TArray<FString>& Args)
+{
+	FCleverTapStandInServer::FSettings Settings;
+	double LatencyMilliseconds = 0.0;
+	double JitterMilliseconds = 0.0;
+	for (const FString& Arg : Args)
+	{
+		if (!FParse::Value(*Arg, TEXT("Port="), Settings.Port) && !FParse::Value(*Arg, TEXT("Path="), Settings.Path)
+			&& !FParse::Value(*Arg, TEXT("AccountId="), Settings.AccountId)
+			&& !FParse::Value(*Arg, TEXT("Token="), Settings.Token)
+			&& !FParse::Value(*Arg, TEXT("Latency="), LatencyMilliseconds)
+			&& !FParse::Value(*Arg, TEXT("Jitter="), JitterMilliseconds)
+			&& !FParse::Value(*Arg, TEXT("ErrorRate="), Settings.ErrorRate)
+			&& !FParse::Value(*Arg, TEXT("ThrottleRate="), Settings.ThrottleRate)
+			&& !FParse::Value(*Arg, TEXT("RetryAfter="), Settings.RetryAfterSeconds)
+			&& !FParse::Value(*Arg, TEXT("Seed="), Settings.RandomSeed))
+		{
+			UE_LOG(LogCleverTap, Warning, TEXT("CleverTap.StandIn.Start: ignoring unknown argument '%s'"), *Arg);
+		}
+	}
+	Settings.LatencySeconds = LatencyMilliseconds / 1000.0;
+	Settings.JitterSeconds = JitterMilliseconds / 1000.0;
+
+	ConsoleServer.Reset(); // frees the port of a previous server
+	ConsoleServer = MakeUnique<FCleverTapStandInServer>(Settings);
+	if (!ConsoleServer->Start())
+	{
+		ConsoleServer.Reset();
+	}
+}
+
+void StopServer()
+{
+	if (ConsoleServer)
+	{
+		ConsoleServer->LogSummary();
+		ConsoleServer.Reset();
+	}
+}
+
+void ReportServer()
+{
+	if (ConsoleServer)
+	{
+		ConsoleServer->LogSummary();
+	}
+	else
+	{
+		UE_LOG(LogCleverTap, Display, TEXT("Stand-in server is not running"));
+	}
+}
+
+FAutoConsoleCommand StartCommand(TEXT("CleverTap.StandIn.Start"),
+	TEXT("Starts a local stand-in ingestion server for the generic uploader.\n")
+	TEXT("Arguments: Port=<port> Path=<path> AccountId=<id> Token=<token> Latency=<ms> Jitter=<ms> ")
+	TEXT("ErrorRate=<0-1> ThrottleRate=<0-1> RetryAfter=<seconds> Seed=<int>"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&StartServer));
+
+FAutoConsoleCommand StopCommand(TEXT("CleverTap.StandIn.Stop"),
+	TEXT("Logs what the stand-in ingestion server received and stops it."),
+	FConsoleCommandDelegate::CreateStatic(&StopServer));
+
+FAutoConsoleCommand ReportCommand(TEXT("CleverTap.StandIn.Report"),
+	TEXT("Logs what the stand-in ingestion server received."), FConsoleCommandDelegate::CreateStatic(&ReportServer));
+
+/**
+ * Stops the server started from the console before the HTTP server module it uses is unloaded.
+ */
+class FCleverTapStandInModule : public IModuleInterface
+{
+public:
+	virtual void ShutdownModule() override { ConsoleServer.Reset(); }
+};
+
+} // namespace
+
+} // namespace CleverTapSDK
+
+IMPLEMENT_MODULE(CleverTapSDK::FCleverTapStandInModule, CleverTapStandIn)
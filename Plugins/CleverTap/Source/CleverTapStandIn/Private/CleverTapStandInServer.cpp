@@ -0,0 +1,372 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapStandInServer.h"
+
+#include "CleverTapLog.h"
+#include "CleverTapUploadProtocol.h"
+
+#include "Containers/Ticker.h"
+#include "HAL/PlatformTime.h"
+#include "HttpPath.h"
+#include "HttpServerModule.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "IHttpRouter.h"
+#include "Misc/Compression.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace CleverTapSDK {
+
+namespace {
+
+// larger bodies are rejected rather than decompressed
+constexpr int32 MaxUncompressedBytes = 64 * 1024 * 1024;
+
+const FString* FindHeader(const FHttpServerRequest& Request, const TCHAR* Name)
+{
+	const TArray<FString>* const Values = Request.Headers.Find(Name);
+	return Values && Values->Num() > 0 ? &(*Values)[0] : nullptr;
+}
+
+bool ValidateEvent(const FJsonObject& Event, FString& OutError)
+{
+	FString Type;
+	double Timestamp = 0.0;
+	const TSharedPtr<FJsonObject>* Properties = nullptr;
+	if (!Event.TryGetStringField(TEXT("type"), Type) || !Event.TryGetNumberField(TEXT("ts"), Timestamp)
+		|| !Event.TryGetObjectField(TEXT("properties"), Properties))
+	{
+		OutError = TEXT("event without type, ts or properties");
+		return false;
+	}
+
+	FString Name;
+	const TArray<TSharedPtr<FJsonValue>>* Items = nullptr;
+	if (Type == TEXT("event") || Type == TEXT("increment"))
+	{
+		if (!Event.TryGetStringField(TEXT("name"), Name) || Name.IsEmpty())
+		{
+			OutError = FString::Printf(TEXT("%s without a name"), *Type);
+			return false;
+		}
+	}
+	else if (Type == TEXT("charged"))
+	{
+		if (!Event.TryGetArrayField(TEXT("items"), Items))
+		{
+			OutError = TEXT("charged event without items");
+			return false;
+		}
+	}
+	else if (Type == TEXT("login"))
+	{
+		if (!Event.HasTypedField<EJson::String>(TEXT("identity")))
+		{
+			OutError = TEXT("login without an identity");
+			return false;
+		}
+	}
+	else if (Type != TEXT("profile"))
+	{
+		OutError = FString::Printf(TEXT("unknown event type '%s'"), *Type);
+		return false;
+	}
+	return true;
+}
+
+} // namespace
+
+FCleverTapStandInServer::FCleverTapStandInServer(const FSettings& InSettings)
+	: Settings(InSettings), Random(InSettings.RandomSeed)
+{
+}
+
+FCleverTapStandInServer::~FCleverTapStandInServer()
+{
+	Stop();
+}
+
+bool FCleverTapStandInServer::Start()
+{
+	check(IsInGameThread());
+	if (RouteHandle.IsValid())
+	{
+		return true;
+	}
+
+	FHttpServerModule& HttpServer = FHttpServerModule::Get();
+	Router = HttpServer.GetHttpRouter(Settings.Port);
+	if (Router.IsValid())
+	{
+		RouteHandle = Router->BindRoute(FHttpPath(Settings.Path), EHttpServerRequestVerbs::VERB_POST,
+			FHttpRequestHandler::CreateRaw(this, &FCleverTapStandInServer::HandleRequest));
+	}
+	if (!RouteHandle.IsValid())
+	{
+		UE_LOG(LogCleverTap, Error, TEXT("Stand-in server failed to bind %s"), *GetUrl());
+		Router.Reset();
+		return false;
+	}
+
+	HttpServer.StartAllListeners();
+	TickHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FCleverTapStandInServer::Tick));
+	UE_LOG(LogCleverTap, Display,
+		TEXT("Stand-in server listening on %s (latency %.0f ms, jitter %.0f ms, errors %.0f%%, throttling %.0f%%)"),
+		*GetUrl(), Settings.LatencySeconds * 1000.0, Settings.JitterSeconds * 1000.0, Settings.ErrorRate * 100.0,
+		Settings.ThrottleRate * 100.0);
+	return true;
+}
+
+void FCleverTapStandInServer::Stop()
+{
+	if (!RouteHandle.IsValid())
+	{
+		return;
+	}
+
+	FTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	Router->UnbindRoute(RouteHandle);
+	RouteHandle.Reset();
+	Router.Reset();
+
+	// answer the delayed responses, so no client waits for its timeout
+	for (FPendingResponse& Pending : PendingResponses)
+	{
+		Pending.DueSeconds = 0.0;
+	}
+	Tick(0.0f);
+}
+
+FString FCleverTapStandInServer::GetUrl() const
+{
+	return FString::Printf(TEXT("http://127.0.0.1:%u%s"), Settings.Port, *Settings.Path);
+}
+
+void FCleverTapStandInServer::Reset()
+{
+	Batches.Reset();
+	BatchIds.Reset();
+	HighestSequences.Reset();
+	NumEvents = 0;
+	NumDuplicates = 0;
+	NumRejected = 0;
+	NumInjectedErrors = 0;
+	NumThrottled = 0;
+	NumReordered = 0;
+}
+
+void FCleverTapStandInServer::LogSummary() const
+{
+	const double Seconds = Batches.Num() > 1 ? Batches.Last().ReceivedSeconds - Batches[0].ReceivedSeconds : 0.0;
+	UE_LOG(LogCleverTap, Display,
+		TEXT("Stand-in server: %d events in %d batches (%.0f events/s), %d duplicates, %d reordered, %d rejected, ")
+			TEXT("%d injected errors, %d throttled"),
+		NumEvents, Batches.Num(), Seconds > 0.0 ? NumEvents / Seconds : 0.0, NumDuplicates, NumReordered,
+		NumRejected, NumInjectedErrors, NumThrottled);
+}
+
+bool FCleverTapStandInServer::HandleRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+{
+	FString Error;
+	if (!Authenticate(Request, Error))
+	{
+		++NumRejected;
+		UE_LOG(LogCleverTap, Warning, TEXT("Stand-in server rejected a batch: %s"), *Error);
+		Respond(401, MoveTemp(Error), 0, OnComplete);
+		return true;
+	}
+
+	TArray<uint8> Json;
+	FBatch Batch;
+	if (!DecodeBody(Request, Json, Error) || !ParseBatch(Json, Batch, Error))
+	{
+		++NumRejected;
+		UE_LOG(LogCleverTap, Warning, TEXT("Stand-in server rejected a batch: %s"), *Error);
+		Respond(400, MoveTemp(Error), 0, OnComplete);
+		return true;
+	}
+
+	const double Roll = Random.FRand();
+	if (Roll < Settings.ErrorRate)
+	{
+		++NumInjectedErrors;
+		Respond(503, TEXT("injected error"), 0, OnComplete);
+		return true;
+	}
+	if (Roll < Settings.ErrorRate + Settings.ThrottleRate)
+	{
+		++NumThrottled;
+		Respond(429, TEXT("injected throttling"), Settings.RetryAfterSeconds, OnComplete);
+		return true;
+	}
+
+	FString BatchId = Batch.Id;
+	if (BatchIds.Contains(Batch.Id))
+	{
+		++NumDuplicates;
+	}
+	else
+	{
+		int32& HighestSequence = HighestSequences.FindOrAdd(Batch.Session, -1);
+		NumReordered += Batch.Sequence < HighestSequence ? 1 : 0;
+		HighestSequence = FMath::Max(HighestSequence, Batch.Sequence);
+
+		BatchIds.Add(Batch.Id);
+		const FString* const AccountId = FindHeader(Request, UploadProtocol::AccountIdHeader);
+		Batch.AccountId = AccountId ? *AccountId : FString();
+		Batch.BodyBytes = Request.Body.Num();
+		Batch.UncompressedBytes = Json.Num();
+		Batch.ReceivedSeconds = FPlatformTime::Seconds();
+		NumEvents += Batch.Events.Num();
+		Batches.Add(MoveTemp(Batch));
+	}
+	Respond(200, TEXT("ok"), 0, OnComplete, MoveTemp(BatchId));
+	return true;
+}
+
+bool FCleverTapStandInServer::Authenticate(const FHttpServerRequest& Request, FString& OutError) const
+{
+	const FString* const AccountId = FindHeader(Request, UploadProtocol::AccountIdHeader);
+	if (!Settings.AccountId.IsEmpty() && (!AccountId || *AccountId != Settings.AccountId))
+	{
+		OutError = FString::Printf(TEXT("unknown account id '%s'"), AccountId ? **AccountId : TEXT(""));
+		return false;
+	}
+	const FString* const Token = FindHeader(Request, UploadProtocol::TokenHeader);
+	if (!Settings.Token.IsEmpty() && (!Token || *Token != Settings.Token))
+	{
+		OutError = TEXT("invalid token");
+		return false;
+	}
+	return true;
+}
+
+bool FCleverTapStandInServer::DecodeBody(
+	const FHttpServerRequest& Request, TArray<uint8>& OutJson, FString& OutError) const
+{
+	const FString* const Compression = FindHeader(Request, UploadProtocol::CompressionHeader);
+	if (Compression == nullptr)
+	{
+		OutJson = Request.Body;
+		return true;
+	}
+
+	FName FormatName = NAME_None;
+	if (*Compression == TEXT("LZ4"))
+	{
+		FormatName = NAME_LZ4;
+	}
+	else if (*Compression == TEXT("Zlib"))
+	{
+		FormatName = NAME_Zlib;
+	}
+	const FString* const UncompressedLength = FindHeader(Request, UploadProtocol::UncompressedLengthHeader);
+	const int32 UncompressedBytes = UncompressedLength ? FCString::Atoi(**UncompressedLength) : 0;
+	if (FormatName == NAME_None || UncompressedBytes <= 0 || UncompressedBytes > MaxUncompressedBytes)
+	{
+		OutError = FString::Printf(TEXT("unsupported compression '%s' or length"), **Compression);
+		return false;
+	}
+
+	OutJson.SetNumUninitialized(UncompressedBytes);
+	if (!FCompression::UncompressMemory(
+			FormatName, OutJson.GetData(), UncompressedBytes, Request.Body.GetData(), Request.Body.Num()))
+	{
+		OutError = FString::Printf(TEXT("failed to decompress the %s body"), **Compression);
+		return false;
+	}
+	return true;
+}
+
+bool FCleverTapStandInServer::ParseBatch(const TArray<uint8>& Json, FBatch& OutBatch, FString& OutError) const
+{
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Json.GetData()), Json.Num());
+	const FString Text(Converted.Length(), Converted.Get());
+	TSharedPtr<FJsonObject> Root;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root) || !Root.IsValid())
+	{
+		OutError = TEXT("the body is not a JSON object");
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* Events = nullptr;
+	if (!Root->TryGetStringField(TEXT("batch"), OutBatch.Id) || OutBatch.Id.IsEmpty()
+		|| !Root->TryGetStringField(TEXT("session"), OutBatch.Session)
+		|| !Root->TryGetNumberField(TEXT("seq"), OutBatch.Sequence) || !Root->TryGetArrayField(TEXT("events"), Events))
+	{
+		OutError = TEXT("batch without an id, session, seq or events");
+		return false;
+	}
+
+	OutBatch.Events.Reserve(Events->Num());
+	for (const TSharedPtr<FJsonValue>& Value : *Events)
+	{
+		const TSharedPtr<FJsonObject>* Event = nullptr;
+		if (!Value.IsValid() || !Value->TryGetObject(Event))
+		{
+			OutError = TEXT("event that is not an object");
+			return false;
+		}
+		if (!ValidateEvent(**Event, OutError))
+		{
+			return false;
+		}
+		OutBatch.Events.Add(*Event);
+	}
+	return true;
+}
+
+void FCleverTapStandInServer::Respond(
+	int32 Code, FString Message, int32 RetryAfterSeconds, const FHttpResultCallback& OnComplete, FString BatchId)
+{
+	FPendingResponse Pending;
+	Pending.DueSeconds =
+		FPlatformTime::Seconds() + Settings.LatencySeconds + Settings.JitterSeconds * double(Random.FRand());
+	Pending.Code = Code;
+	Pending.Message = MoveTemp(Message);
+	Pending.RetryAfterSeconds = RetryAfterSeconds;
+	Pending.BatchId = MoveTemp(BatchId);
+	Pending.OnComplete = OnComplete;
+	PendingResponses.Add(MoveTemp(Pending));
+	if (Settings.LatencySeconds <= 0.0 && Settings.JitterSeconds <= 0.0)
+	{
+		Tick(0.0f);
+	}
+}
+
+bool FCleverTapStandInServer::Tick(float /*DeltaTime*/)
+{
+	const double NowSeconds = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < PendingResponses.Num();)
+	{
+		FPendingResponse& Pending = PendingResponses[Index];
+		if (Pending.DueSeconds > NowSeconds)
+		{
+			++Index;
+			continue;
+		}
+
+		TUniquePtr<FHttpServerResponse> Response = FHttpServerResponse::Create(Pending.Message, TEXT("text/plain"));
+		Response->Code = EHttpServerResponseCodes(Pending.Code);
+		if (Pending.RetryAfterSeconds > 0)
+		{
+			Response->Headers.Add(TEXT("Retry-After"), TArray<FString>{ FString::FromInt(Pending.RetryAfterSeconds) });
+		}
+		if (!Pending.BatchId.IsEmpty())
+		{
+			FBatch* const Batch = Batches.FindByPredicate(
+				[&Pending](const FBatch& Recorded) { return Recorded.Id == Pending.BatchId; });
+			if (Batch && Batch->AcknowledgedSeconds == 0.0)
+			{
+				Batch->AcknowledgedSeconds = NowSeconds;
+			}
+		}
+		const FHttpResultCallback OnComplete = MoveTemp(Pending.OnComplete);
+		PendingResponses.RemoveAt(Index);
+		OnComplete(MoveTemp(Response));
+	}
+	return true;
+}
+
+} // namespace CleverTapSDK
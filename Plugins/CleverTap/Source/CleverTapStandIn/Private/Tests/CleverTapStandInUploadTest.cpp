@@ -0,0 +1,250 @@
+// Copyright CleverTap All Rights Reserved.
+#include "CleverTapStandInServer.h"
+
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapTestInstance.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CleverTapSDK {
+
+namespace {
+
+constexpr int32 NumEvents = 200;
+constexpr int32 LoginAfter = NumEvents / 2; // the concurrent run logs in after this many events
+constexpr double TimeoutSeconds = 60.0;
+
+const TCHAR* const AccountId = TEXT("StandInTest");
+const TCHAR* const Token = TEXT("StandInToken");
+
+/**
+ * The server and uploading instance of one run; declared so the instance is destroyed before the server.
+ */
+struct FUploadRun
+{
+	TUniquePtr<FCleverTapStandInServer> Server;
+	TUniquePtr<FCleverTapTestInstance> Instance;
+	double StartSeconds = 0.0;
+};
+
+bool IsDoneOrTimedOut(const FUploadRun& Run)
+{
+	return Run.Instance->IsUploadIdle() || FPlatformTime::Seconds() - Run.StartSeconds >= TimeoutSeconds;
+}
+
+/**
+ * The Index property of an event, or INDEX_NONE for events without one, such as the login.
+ */
+int32 GetEventIndex(const FJsonObject& Event)
+{
+	const TSharedPtr<FJsonObject>* Properties = nullptr;
+	int32 Index = INDEX_NONE;
+	return Event.TryGetObjectField(TEXT("properties"), Properties)
+			&& (*Properties)->TryGetNumberField(TEXT("Index"), Index)
+		? Index
+		: INDEX_NONE;
+}
+
+bool IsLogin(const FJsonObject& Event)
+{
+	FString Type;
+	return Event.TryGetStringField(TEXT("type"), Type) && Type == TEXT("login");
+}
+
+FCleverTapStandInServer::FSettings MakeServerSettings(uint32 Port)
+{
+	FCleverTapStandInServer::FSettings Settings;
+	Settings.Port = Port;
+	Settings.AccountId = AccountId;
+	Settings.Token = Token;
+	Settings.ErrorRate = 0.2;
+	Settings.ThrottleRate = 0.2;
+	Settings.RetryAfterSeconds = 1;
+	Settings.RandomSeed = 25; // injects both kinds of failure within the first batches
+	return Settings;
+}
+
+FCleverTapInstanceConfig MakeInstanceConfig(const FCleverTapStandInServer& Server, int32 MaxConcurrentBatches)
+{
+	FCleverTapInstanceConfig Config;
+	Config.ProjectId = AccountId;
+	Config.ProjectToken = Token;
+	Config.UploadEndpointUrl = Server.GetUrl();
+	Config.UploadMaxBatchEvents = 20;
+	Config.UploadMinIntervalSeconds = 0.0f;
+	Config.UploadMaxConcurrentBatches = MaxConcurrentBatches;
+	Config.BufferBudgetKilobytes = 0;
+	return Config;
+}
+
+} // namespace
+
+/**
+ * Waits until the uploader has drained the queue, then checks what the server received.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FCleverTapWaitForUploadCommand, TSharedRef<FUploadRun>, Run,
+	FAutomationTestBase*, Test);
+
+bool FCleverTapWaitForUploadCommand::Update()
+{
+	if (!IsDoneOrTimedOut(*Run))
+	{
+		return false;
+	}
+
+	const FCleverTapStandInServer& Server = *Run->Server;
+	Server.LogSummary();
+	Test->TestTrue(TEXT("The queue is drained before the timeout"), Run->Instance->IsUploadIdle());
+	Test->TestTrue(TEXT("Errors were injected"), Server.GetNumInjectedErrors() > 0);
+	Test->TestTrue(TEXT("Throttling was injected"), Server.GetNumThrottled() > 0);
+	Test->TestEqual(TEXT("Every event is received"), Server.GetNumEvents(), NumEvents);
+	Test->TestEqual(TEXT("No batch is rejected"), Server.GetNumRejected(), 0);
+	Test->TestEqual(TEXT("No retried batch is received twice"), Server.GetNumDuplicates(), 0);
+	Test->TestEqual(TEXT("No batch overtakes a failed one"), Server.GetNumReordered(), 0);
+
+	int32 NextIndex = 0;
+	for (const FCleverTapStandInServer::FBatch& Batch : Server.GetBatches())
+	{
+		for (const TSharedPtr<FJsonObject>& Event : Batch.Events)
+		{
+			NextIndex += GetEventIndex(*Event) == NextIndex ? 1 : 0;
+		}
+	}
+	Test->TestEqual(TEXT("Events are received in the order they were enqueued"), NextIndex, NumEvents);
+
+	Run->Instance.Reset();
+	Run->Server.Reset();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapStandInUploadTest, "CleverTap.StandIn.Upload",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapStandInUploadTest::RunTest(const FString& Parameters)
+{
+	const TSharedRef<FUploadRun> Run = MakeShared<FUploadRun>();
+	Run->Server = MakeUnique<FCleverTapStandInServer>(MakeServerSettings(8094)); // clear of the console server
+	if (!TestTrue(TEXT("The server starts"), Run->Server->Start()))
+	{
+		return false;
+	}
+
+	// one batch at a time, so a failed batch has to be retried before any later one is sent; the uploader first ticks
+	//  after the test returns, so every event is queued before the first batch is taken
+	Run->StartSeconds = FPlatformTime::Seconds();
+	Run->Instance = MakeUnique<FCleverTapTestInstance>(MakeInstanceConfig(*Run->Server, 1));
+	for (int32 Index = 0; Index < NumEvents; ++Index)
+	{
+		FCleverTapProperties Properties;
+		Properties.Add(TEXT("Index"), Index);
+		Run->Instance->Get().PushEvent(TEXT("Test"), Properties);
+	}
+	ADD_LATENT_AUTOMATION_COMMAND(FCleverTapWaitForUploadCommand(Run, this));
+	return true;
+}
+
+/**
+ * Waits until the uploader has drained the queue, then checks that the batches of the concurrent run restore the
+ *  order of the events and that no event after the login was received before the login was acknowledged.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FCleverTapWaitForConcurrentUploadCommand, TSharedRef<FUploadRun>, Run,
+	FAutomationTestBase*, Test);
+
+bool FCleverTapWaitForConcurrentUploadCommand::Update()
+{
+	if (!IsDoneOrTimedOut(*Run))
+	{
+		return false;
+	}
+
+	const FCleverTapStandInServer& Server = *Run->Server;
+	Server.LogSummary();
+	Test->TestTrue(TEXT("The queue is drained before the timeout"), Run->Instance->IsUploadIdle());
+	Test->TestTrue(TEXT("Failures were injected"), Server.GetNumInjectedErrors() + Server.GetNumThrottled() > 0);
+	Test->TestEqual(TEXT("Every event and the login are received"), Server.GetNumEvents(), NumEvents + 1);
+	Test->TestEqual(TEXT("No batch is rejected"), Server.GetNumRejected(), 0);
+
+	TArray<const FCleverTapStandInServer::FBatch*> Batches;
+	for (const FCleverTapStandInServer::FBatch& Batch : Server.GetBatches())
+	{
+		Batches.Add(&Batch);
+	}
+	Batches.Sort([](const FCleverTapStandInServer::FBatch& A, const FCleverTapStandInServer::FBatch& B) {
+		return A.Sequence < B.Sequence;
+	});
+
+	int32 NextIndex = 0;
+	int32 LoginIndex = INDEX_NONE;
+	const FCleverTapStandInServer::FBatch* LoginBatch = nullptr;
+	for (const FCleverTapStandInServer::FBatch* Batch : Batches)
+	{
+		for (const TSharedPtr<FJsonObject>& Event : Batch->Events)
+		{
+			if (IsLogin(*Event))
+			{
+				LoginIndex = NextIndex;
+				LoginBatch = Batch;
+			}
+			NextIndex += GetEventIndex(*Event) == NextIndex ? 1 : 0;
+		}
+	}
+	Test->TestEqual(TEXT("Sorting the batches by seq restores the order of the events"), NextIndex, NumEvents);
+	Test->TestEqual(TEXT("The login is between the events pushed before and after it"), LoginIndex, LoginAfter);
+
+	if (Test->TestNotNull(TEXT("The login is received"), LoginBatch))
+	{
+		bool bWaitedForLogin = true;
+		for (const FCleverTapStandInServer::FBatch* Batch : Batches)
+		{
+			bWaitedForLogin &= Batch->Sequence <= LoginBatch->Sequence
+				|| (LoginBatch->AcknowledgedSeconds > 0.0 && Batch->ReceivedSeconds >= LoginBatch->AcknowledgedSeconds);
+		}
+		Test->TestTrue(TEXT("No event after the login is received before the login is acknowledged"), bWaitedForLogin);
+	}
+
+	Run->Instance.Reset();
+	Run->Server.Reset();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCleverTapStandInConcurrentUploadTest, "CleverTap.StandIn.ConcurrentUpload",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FCleverTapStandInConcurrentUploadTest::RunTest(const FString& Parameters)
+{
+	// a round trip long enough for several batches to be in flight, and for a batch sent too early to stand out
+	FCleverTapStandInServer::FSettings Settings = MakeServerSettings(8095);
+	Settings.LatencySeconds = 0.05;
+	Settings.JitterSeconds = 0.05;
+
+	const TSharedRef<FUploadRun> Run = MakeShared<FUploadRun>();
+	Run->Server = MakeUnique<FCleverTapStandInServer>(Settings);
+	if (!TestTrue(TEXT("The server starts"), Run->Server->Start()))
+	{
+		return false;
+	}
+
+	Run->StartSeconds = FPlatformTime::Seconds();
+	Run->Instance = MakeUnique<FCleverTapTestInstance>(MakeInstanceConfig(*Run->Server, 4));
+	for (int32 Index = 0; Index < NumEvents; ++Index)
+	{
+		if (Index == LoginAfter)
+		{
+			FCleverTapProperties Profile;
+			Profile.Add(TEXT("Identity"), TEXT("StandInUser"));
+			Run->Instance->Get().OnUserLogin(Profile);
+		}
+		FCleverTapProperties Properties;
+		Properties.Add(TEXT("Index"), Index);
+		Run->Instance->Get().PushEvent(TEXT("Test"), Properties);
+	}
+	ADD_LATENT_AUTOMATION_COMMAND(FCleverTapWaitForConcurrentUploadCommand(Run, this));
+	return true;
+}
+
+} // namespace CleverTapSDK
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,145 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "HttpResultCallback.h"
+#include "HttpRouteHandle.h"
+#include "Math/RandomStream.h"
+
+class IHttpRouter;
+struct FHttpServerRequest;
+
+namespace CleverTapSDK {
+
+/**
+ * A local stand-in for an ingestion endpoint that accepts the requests of the generic uploader (see
+ *  CleverTapUploadProtocol.h), so uploads can be tested and measured without network access.
+ *
+ * Every request is authenticated, decompressed and validated; requests with another account id or token than the
+ *  configured ones are answered with 401 and malformed requests with 400. Valid batches are recorded
+ *  for assertions, with repeated batch ids counted as duplicates rather than recorded again. Responses can be delayed
+ *  to simulate a round trip time, and a share of them replaced with 503 errors or 429 throttling responses. The
+ *  injected failures are drawn from a seeded random stream, so a run is repeatable for a given sequence of requests.
+ *
+ * Runs on the game thread; the HTTP server and the delayed responses are driven by the core ticker.
+ */
+class CLEVERTAPSTANDIN_API FCleverTapStandInServer
+{
+public:
+	struct FSettings
+	{
+		uint32 Port = 8093;
+		FString Path = TEXT("/events");
+
+		// the X-CleverTap-Account-Id and X-CleverTap-Token every request has to carry; not checked when empty
+		FString AccountId;
+		FString Token;
+
+		// the delay before each response, plus a random jitter of up to JitterSeconds
+		double LatencySeconds = 0.0;
+		double JitterSeconds = 0.0;
+
+		// the share of valid requests answered with 503, and with 429 carrying RetryAfterSeconds
+		double ErrorRate = 0.0;
+		double ThrottleRate = 0.0;
+		int32 RetryAfterSeconds = 1;
+
+		int32 RandomSeed = 0;
+	};
+
+	struct FBatch
+	{
+		FString Id;
+		FString AccountId;
+		FString Session;
+		int32 Sequence = 0;
+		TArray<TSharedPtr<FJsonObject>> Events;
+		int32 BodyBytes = 0;
+		int32 UncompressedBytes = 0;
+		double ReceivedSeconds = 0.0;
+		double AcknowledgedSeconds = 0.0; // when the 200 response was sent, or zero while it is delayed
+	};
+
+	explicit FCleverTapStandInServer(const FSettings& InSettings);
+	~FCleverTapStandInServer();
+
+	FCleverTapStandInServer(const FCleverTapStandInServer&) = delete;
+	FCleverTapStandInServer& operator=(const FCleverTapStandInServer&) = delete;
+
+	/**
+	 * Starts listening on the configured port. Returns false if the route can't be bound.
+	 */
+	bool Start();
+	void Stop();
+
+	/**
+	 * The URL to set as UploadEndpointUrl.
+	 */
+	FString GetUrl() const;
+
+	/**
+	 * The accepted batches in the order they were received.
+	 */
+	const TArray<FBatch>& GetBatches() const { return Batches; }
+
+	int32 GetNumEvents() const { return NumEvents; }
+	int32 GetNumDuplicates() const { return NumDuplicates; }
+	int32 GetNumRejected() const { return NumRejected; }
+	int32 GetNumInjectedErrors() const { return NumInjectedErrors; }
+	int32 GetNumThrottled() const { return NumThrottled; }
+
+	/**
+	 * The number of batches received after a batch of the same session with a higher sequence number.
+	 */
+	int32 GetNumReordered() const { return NumReordered; }
+
+	/**
+	 * Forgets the recorded batches and counters.
+	 */
+	void Reset();
+
+	/**
+	 * Logs the counters and the event throughput since the first batch.
+	 */
+	void LogSummary() const;
+
+private:
+	struct FPendingResponse
+	{
+		double DueSeconds = 0.0;
+		int32 Code = 200;
+		FString Message;
+		int32 RetryAfterSeconds = 0;
+		FString BatchId; // of the recorded batch the response acknowledges, if any
+		FHttpResultCallback OnComplete;
+	};
+
+	bool HandleRequest(const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete);
+	bool Authenticate(const FHttpServerRequest& Request, FString& OutError) const;
+	bool DecodeBody(const FHttpServerRequest& Request, TArray<uint8>& OutJson, FString& OutError) const;
+	bool ParseBatch(const TArray<uint8>& Json, FBatch& OutBatch, FString& OutError) const;
+	void Respond(int32 Code, FString Message, int32 RetryAfterSeconds, const FHttpResultCallback& OnComplete,
+		FString BatchId = FString());
+	bool Tick(float DeltaTime);
+
+	const FSettings Settings;
+	FRandomStream Random;
+
+	TSharedPtr<IHttpRouter> Router;
+	FHttpRouteHandle RouteHandle;
+	FDelegateHandle TickHandle;
+	TArray<FPendingResponse> PendingResponses;
+
+	TArray<FBatch> Batches;
+	TSet<FString> BatchIds;
+	TMap<FString, int32> HighestSequences;
+	int32 NumEvents = 0;
+	int32 NumDuplicates = 0;
+	int32 NumRejected = 0;
+	int32 NumInjectedErrors = 0;
+	int32 NumThrottled = 0;
+	int32 NumReordered = 0;
+};
+
+} // namespace CleverTapSDK
@@ -2,6 +2,19 @@
 
 #include "CleverTapSample.h"
 #include "Modules/ModuleManager.h"
+#include "SampleLoadGenerator.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE(FDefaultGameModuleImpl, CleverTapSample, "CleverTapSample");
+class FCleverTapSampleModule : public FDefaultGameModuleImpl
+{
+public:
+	void ShutdownModule() override
+	{
+#if !UE_BUILD_SHIPPING
+		// the load generator's instance and ticker must go before the CleverTap module and the core ticker
+		StopLoadGenerator();
+#endif
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE(FCleverTapSampleModule, CleverTapSample, "CleverTapSample");
 DEFINE_LOG_CATEGORY(LogCleverTapSample);
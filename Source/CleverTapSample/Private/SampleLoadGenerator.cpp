@@ -0,0 +1,374 @@
+// Copyright CleverTap All Rights Reserved.
+#include "SampleLoadGenerator.h"
+
+#include "CleverTapConfig.h"
+#include "CleverTapInstance.h"
+#include "CleverTapInstanceConfig.h"
+#include "CleverTapSample.h"
+
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Load generator for the CleverTap plugin.
+ *
+ * Emits a weighted mix of events from a number of threads at a target total rate and reports the achieved throughput,
+ *  per-call latency percentiles, skipped sends, events dropped by the plugin and peak memory. The events go to an
+ *  instance of the generic backend of their own, configured like the shared instance, so they never reach the
+ *  CleverTap account. The command returns immediately and the results are logged when the run completes; in headless
+ *  runs pass Quit to exit then:
+ *
+ *  CleverTapSample -nullrhi -unattended -ExecCmds="CleverTapSample.LoadGenerator Threads=4 Rate=2000 Duration=30 Quit"
+ *
+ * Arguments (all optional):
+ *  Threads=<n>       number of sending threads (default 4)
+ *  Rate=<n>          target events per second over all threads (default 1000)
+ *  Duration=<s>      run time in seconds (default 10)
+ *  Items=<n>         items per charged event (default 10)
+ *  Plain=<w> Props10=<w> Props50=<w> Charged=<w> Increment=<w>
+ *                    relative weights of the event kinds in the mix (default 4, 3, 1, 1, 1)
+ *  Budget=<KB>       buffer budget of the instance (default from the CleverTap config)
+ *  Endpoint=<url>    uploads the events there, e.g. to the CleverTapStandIn server; without it nothing drains the
+ *                    buffer, so events are dropped once the budget is used up
+ *  Quit              exits when the run completes
+ */
+
+namespace {
+
+const TCHAR* const LoadEventKindNames[NumLoadEventKinds] = {
+	TEXT("Plain"), TEXT("Props10"), TEXT("Props50"), TEXT("Charged"), TEXT("Increment")
+};
+
+// A thread that falls further behind its schedule than this skips the missed sends and counts them, so a saturated
+// run reports how much of the target rate it could not sustain instead of bursting to catch up.
+constexpr double MaxBacklogSeconds = 0.1;
+
+// How often the ticker samples memory usage and checks whether the senders are done
+constexpr float MemorySampleIntervalSeconds = 0.05f;
+
+FCleverTapProperties MakeProperties(int32 NumProperties)
+{
+	FCleverTapProperties Properties;
+	Properties.Reserve(NumProperties);
+	for (int32 Index = 0; Index < NumProperties; ++Index)
+	{
+		const FString Key = FString::Printf(TEXT("Property %d"), Index);
+		switch (Index % 4)
+		{
+			case 0:
+				Properties.Add(Key, Index);
+				break;
+			case 1:
+				Properties.Add(Key, Index * 0.5);
+				break;
+			case 2:
+				Properties.Add(Key, FString::Printf(TEXT("Value %d"), Index));
+				break;
+			default:
+				Properties.Add(Key, (Index & 1) != 0);
+				break;
+		}
+	}
+	return Properties;
+}
+
+FLoadGenerator::FEvents MakeEvents(const FLoadGeneratorSettings& Settings)
+{
+	FLoadGenerator::FEvents Events;
+	Events.Properties10 = MakeProperties(10);
+	Events.Properties50 = MakeProperties(50);
+
+	Events.ChargeDetails.Add("Amount", 9.99 * Settings.NumChargedItems);
+	Events.ChargeDetails.Add("Payment Mode", "Credit card");
+	Events.ChargedItems.Reserve(Settings.NumChargedItems);
+	for (int32 Index = 0; Index < Settings.NumChargedItems; ++Index)
+	{
+		FCleverTapProperties& Item = Events.ChargedItems.AddDefaulted_GetRef();
+		Item.Add("Product", FString::Printf(TEXT("Product %d"), Index));
+		Item.Add("Quantity", Index % 3 + 1);
+		Item.Add("Price", 9.99);
+	}
+	return Events;
+}
+
+ELoadEventKind PickKind(FRandomStream& Random, const float (&Weights)[NumLoadEventKinds], float TotalWeight)
+{
+	float Pick = Random.FRand() * TotalWeight;
+	for (int32 Kind = 0; Kind < NumLoadEventKinds; ++Kind)
+	{
+		Pick -= Weights[Kind];
+		if (Pick < 0.0f)
+		{
+			return ELoadEventKind(Kind);
+		}
+	}
+	return ELoadEventKind::Plain;
+}
+
+void Send(ICleverTapInstance& CleverTap, ELoadEventKind Kind, const FLoadGenerator::FEvents& Events)
+{
+	switch (Kind)
+	{
+		case ELoadEventKind::Plain:
+			CleverTap.PushEvent(TEXT("Load Plain"));
+			break;
+		case ELoadEventKind::Properties10:
+			CleverTap.PushEvent(TEXT("Load Props10"), Events.Properties10);
+			break;
+		case ELoadEventKind::Properties50:
+			CleverTap.PushEvent(TEXT("Load Props50"), Events.Properties50);
+			break;
+		case ELoadEventKind::Charged:
+			CleverTap.PushChargedEvent(Events.ChargeDetails, Events.ChargedItems);
+			break;
+		case ELoadEventKind::Increment:
+			CleverTap.IncrementValue(TEXT("Load Counter"), 1);
+			break;
+		default:
+			checkNoEntry();
+	}
+}
+
+FLoadGenerator::FThreadResult RunSender(ICleverTapInstance& CleverTap, const FLoadGeneratorSettings& Settings,
+	const FLoadGenerator::FEvents& Events, int32 ThreadIndex, double StartSeconds, const std::atomic<bool>& bStop)
+{
+	FLoadGenerator::FThreadResult Result;
+
+	const double IntervalSeconds = Settings.NumThreads / Settings.EventsPerSecond;
+	const double EndSeconds = StartSeconds + Settings.DurationSeconds;
+
+	float TotalWeight = 0.0f;
+	for (float Weight : Settings.Weights)
+	{
+		TotalWeight += Weight;
+	}
+
+	FRandomStream Random(ThreadIndex + 1);
+
+	// stagger the threads so their sends interleave instead of arriving together
+	double NextSendSeconds = StartSeconds + IntervalSeconds * ThreadIndex / Settings.NumThreads;
+	while (NextSendSeconds < EndSeconds && !bStop.load(std::memory_order_relaxed))
+	{
+		const double NowSeconds = FPlatformTime::Seconds();
+		if (NowSeconds < NextSendSeconds)
+		{
+			FPlatformProcess::SleepNoStats(float(FMath::Min(NextSendSeconds - NowSeconds, MaxBacklogSeconds)));
+			continue;
+		}
+
+		if (NowSeconds - NextSendSeconds > MaxBacklogSeconds)
+		{
+			const int64 NumSkipped = int64((NowSeconds - NextSendSeconds) / IntervalSeconds);
+			Result.NumSkipped += NumSkipped;
+			NextSendSeconds += NumSkipped * IntervalSeconds;
+		}
+
+		const ELoadEventKind Kind = TotalWeight > 0.0f ? PickKind(Random, Settings.Weights, TotalWeight)
+													   : ELoadEventKind::Plain;
+		const double SendStartSeconds = FPlatformTime::Seconds();
+		Send(CleverTap, Kind, Events);
+		const double SendSeconds = FPlatformTime::Seconds() - SendStartSeconds;
+
+		Result.NumSent[int32(Kind)]++;
+		Result.LatencyMicroseconds[int32(Kind)].Add(float(SendSeconds * 1000000.0));
+		NextSendSeconds += IntervalSeconds;
+	}
+	return Result;
+}
+
+float GetPercentile(const TArray<float>& SortedValues, double Percentile)
+{
+	if (SortedValues.Num() == 0)
+	{
+		return 0.0f;
+	}
+	const int32 Index = FMath::Min(int32(Percentile * SortedValues.Num()), SortedValues.Num() - 1);
+	return SortedValues[Index];
+}
+
+void LogLatencies(const TCHAR* Name, TArray<float>& Latencies)
+{
+	if (Latencies.Num() == 0)
+	{
+		return;
+	}
+	Latencies.Sort();
+	UE_LOG(LogCleverTapSample, Display,
+		TEXT("LoadGenerator: %-9s n=%-8d p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus"), Name,
+		Latencies.Num(), GetPercentile(Latencies, 0.5), GetPercentile(Latencies, 0.9), GetPercentile(Latencies, 0.99),
+		GetPercentile(Latencies, 0.999), Latencies.Last());
+}
+
+
+TUniquePtr<FLoadGenerator> RunningGenerator;
+
+void RunLoadGenerator(const TArray<FString>& Args)
+{
+	if (RunningGenerator && !RunningGenerator->IsDone())
+	{
+		UE_LOG(LogCleverTapSample, Warning, TEXT("LoadGenerator: a run is already in progress"));
+		return;
+	}
+	RunningGenerator = MakeUnique<FLoadGenerator>(FLoadGeneratorSettings::Parse(Args));
+}
+
+FAutoConsoleCommand LoadGeneratorCommand(TEXT("CleverTapSample.LoadGenerator"),
+	TEXT("Pushes a mix of CleverTap events from multiple threads at a target rate and reports throughput, latency, ")
+	TEXT("dropped events and memory. Arguments: Threads=<n> Rate=<events/s> Duration=<s> Items=<n> ")
+	TEXT("Plain=<w> Props10=<w> Props50=<w> Charged=<w> Increment=<w> Budget=<KB> Endpoint=<url> Quit"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunLoadGenerator));
+
+} // namespace
+
+FLoadGeneratorSettings FLoadGeneratorSettings::Parse(const TArray<FString>& Args)
+{
+	FLoadGeneratorSettings Settings;
+	for (const FString& Arg : Args)
+	{
+		if (Arg.Equals(TEXT("Quit"), ESearchCase::IgnoreCase))
+		{
+			Settings.bQuitWhenDone = true;
+			continue;
+		}
+		bool bParsed = FParse::Value(*Arg, TEXT("Threads="), Settings.NumThreads)
+			|| FParse::Value(*Arg, TEXT("Rate="), Settings.EventsPerSecond)
+			|| FParse::Value(*Arg, TEXT("Duration="), Settings.DurationSeconds)
+			|| FParse::Value(*Arg, TEXT("Items="), Settings.NumChargedItems)
+			|| FParse::Value(*Arg, TEXT("Budget="), Settings.BufferBudgetKilobytes)
+			|| FParse::Value(*Arg, TEXT("Endpoint="), Settings.EndpointUrl);
+		for (int32 Kind = 0; Kind < NumLoadEventKinds && !bParsed; ++Kind)
+		{
+			const FString Match = FString::Printf(TEXT("%s="), LoadEventKindNames[Kind]);
+			bParsed = FParse::Value(*Arg, *Match, Settings.Weights[Kind]);
+		}
+		if (!bParsed)
+		{
+			UE_LOG(LogCleverTapSample, Warning, TEXT("LoadGenerator: ignoring unknown argument '%s'"), *Arg);
+		}
+	}
+
+	Settings.NumThreads = FMath::Clamp(Settings.NumThreads, 1, 64);
+	Settings.EventsPerSecond = FMath::Max(Settings.EventsPerSecond, 1.0);
+	Settings.DurationSeconds = FMath::Max(Settings.DurationSeconds, 0.1);
+	Settings.NumChargedItems = FMath::Max(Settings.NumChargedItems, 1);
+	for (float& Weight : Settings.Weights)
+	{
+		Weight = FMath::Max(Weight, 0.0f);
+	}
+	return Settings;
+}
+
+FLoadGenerator::FLoadGenerator(const FLoadGeneratorSettings& InSettings)
+	: Settings(InSettings), Events(MakeEvents(InSettings))
+{
+	FCleverTapInstanceConfig Config = FCleverTapInstanceConfig::FromCleverTapConfig(GetDefault<UCleverTapConfig>());
+	Config.UploadEndpointUrl = Settings.EndpointUrl;
+	if (Settings.BufferBudgetKilobytes != INDEX_NONE)
+	{
+		Config.BufferBudgetKilobytes = FMath::Max(Settings.BufferBudgetKilobytes, 0);
+	}
+	Instance = MakeUnique<FCleverTapTestInstance>(Config);
+
+	UE_LOG(LogCleverTapSample, Display,
+		TEXT("LoadGenerator: %d threads, %.0f events/s for %.1fs, %d items per charged event"), Settings.NumThreads,
+		Settings.EventsPerSecond, Settings.DurationSeconds, Settings.NumChargedItems);
+
+	Report.UsedPhysicalBefore = Report.PeakUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	StartSeconds = FPlatformTime::Seconds() + 0.01;
+	ICleverTapInstance& CleverTap = Instance->Get();
+	for (int32 ThreadIndex = 0; ThreadIndex < Settings.NumThreads; ++ThreadIndex)
+	{
+		Senders.Add(Async(EAsyncExecution::Thread, [this, &CleverTap, ThreadIndex] {
+			return RunSender(CleverTap, Settings, Events, ThreadIndex, StartSeconds, bStopRequested);
+		}));
+	}
+	TickHandle = FTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FLoadGenerator::Tick), MemorySampleIntervalSeconds);
+}
+
+FLoadGenerator::~FLoadGenerator()
+{
+	if (TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	}
+	bStopRequested = true;
+	for (const TFuture<FThreadResult>& Sender : Senders)
+	{
+		Sender.Wait();
+	}
+	Instance.Reset(); // after the senders that push to it
+}
+
+bool FLoadGenerator::Tick(float DeltaTime)
+{
+	Report.PeakUsedPhysical = FMath::Max(Report.PeakUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+	for (const TFuture<FThreadResult>& Sender : Senders)
+	{
+		if (!Sender.IsReady())
+		{
+			return true;
+		}
+	}
+	Finish();
+	TickHandle.Reset();
+	return false;
+}
+
+void FLoadGenerator::Finish()
+{
+	Report.ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+	Report.UsedPhysicalAfter = FPlatformMemory::GetStats().UsedPhysical;
+	Report.PeakUsedPhysical = FMath::Max(Report.PeakUsedPhysical, Report.UsedPhysicalAfter);
+	Report.NumDropped = Instance->GetNumDropped();
+	Report.NumBuffered = Instance->GetNumBuffered();
+
+	TArray<float> Latencies[NumLoadEventKinds];
+	TArray<float> AllLatencies;
+	for (TFuture<FThreadResult>& Sender : Senders)
+	{
+		FThreadResult Result = Sender.Get();
+		Report.NumSkipped += Result.NumSkipped;
+		for (int32 Kind = 0; Kind < NumLoadEventKinds; ++Kind)
+		{
+			Report.NumSent += Result.NumSent[Kind];
+			AllLatencies.Append(Result.LatencyMicroseconds[Kind]);
+			Latencies[Kind].Append(MoveTemp(Result.LatencyMicroseconds[Kind]));
+		}
+	}
+	Senders.Reset();
+
+	UE_LOG(LogCleverTapSample, Display,
+		TEXT("LoadGenerator: sent %lld in %.2fs (%.0f/s of %.0f/s target), skipped %lld"), Report.NumSent,
+		Report.ElapsedSeconds, Report.NumSent / Report.ElapsedSeconds, Settings.EventsPerSecond, Report.NumSkipped);
+	UE_LOG(LogCleverTapSample, Display, TEXT("LoadGenerator: the plugin dropped %lld, %d still buffered"),
+		Report.NumDropped, Report.NumBuffered);
+	for (int32 Kind = 0; Kind < NumLoadEventKinds; ++Kind)
+	{
+		LogLatencies(LoadEventKindNames[Kind], Latencies[Kind]);
+	}
+	LogLatencies(TEXT("All"), AllLatencies);
+	UE_LOG(LogCleverTapSample, Display,
+		TEXT("LoadGenerator: used memory %.1fMB before, %.1fMB after, %.1fMB peak (process peak %.1fMB)"),
+		Report.UsedPhysicalBefore / (1024.0 * 1024.0), Report.UsedPhysicalAfter / (1024.0 * 1024.0),
+		Report.PeakUsedPhysical / (1024.0 * 1024.0), FPlatformMemory::GetStats().PeakUsedPhysical / (1024.0 * 1024.0));
+
+	bDone = true;
+	if (Settings.bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExit(/*Force=*/false);
+	}
+}
+
+void StopLoadGenerator()
+{
+	RunningGenerator.Reset();
+}
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,123 @@
+// Copyright CleverTap All Rights Reserved.
+#pragma once
+
+#include "CleverTapProperties.h"
+#include "CleverTapTestInstance.h"
+
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+#if !UE_BUILD_SHIPPING
+
+enum class ELoadEventKind : uint8
+{
+	Plain,
+	Properties10,
+	Properties50,
+	Charged,
+	Increment,
+	Num
+};
+
+constexpr int32 NumLoadEventKinds = int32(ELoadEventKind::Num);
+
+struct FLoadGeneratorSettings
+{
+	int32 NumThreads = 4;
+	double EventsPerSecond = 1000.0;
+	double DurationSeconds = 10.0;
+	int32 NumChargedItems = 10;
+	float Weights[NumLoadEventKinds] = { 4.0f, 3.0f, 1.0f, 1.0f, 1.0f };
+
+	// uploads the events there when set; otherwise nothing drains the buffer and the overflow policy applies
+	FString EndpointUrl;
+
+	// the buffer budget of the instance under load, or INDEX_NONE for the one in the project's CleverTap config
+	int32 BufferBudgetKilobytes = INDEX_NONE;
+
+	bool bQuitWhenDone = false;
+
+	/**
+	 * Parses the console command arguments listed in SampleLoadGenerator.cpp.
+	 */
+	static FLoadGeneratorSettings Parse(const TArray<FString>& Args);
+};
+
+struct FLoadGeneratorReport
+{
+	int64 NumSent = 0;
+	int64 NumSkipped = 0; // sends the threads couldn't fit in their schedule
+	int64 NumDropped = 0; // sent events dropped by the plugin's buffer overflow policy
+	int32 NumBuffered = 0;
+	double ElapsedSeconds = 0.0;
+	uint64 UsedPhysicalBefore = 0;
+	uint64 UsedPhysicalAfter = 0;
+	uint64 PeakUsedPhysical = 0;
+};
+
+/**
+ * Emits a weighted mix of events from a number of threads at a target total rate into an instance of the generic
+ *  backend of its own, then logs the achieved throughput, per-call latency percentiles, the sends that were skipped
+ *  and the events the plugin dropped, and peak memory. The senders run on threads of their own while the core ticker
+ *  samples memory and collects the results, so the game thread isn't blocked.
+ */
+class FLoadGenerator
+{
+public:
+	explicit FLoadGenerator(const FLoadGeneratorSettings& InSettings);
+
+	/**
+	 * Stops the senders of an unfinished run and waits for them.
+	 */
+	~FLoadGenerator();
+
+	FLoadGenerator(const FLoadGenerator&) = delete;
+	FLoadGenerator& operator=(const FLoadGenerator&) = delete;
+
+	bool IsDone() const { return bDone; }
+
+	/**
+	 * The results, once IsDone().
+	 */
+	const FLoadGeneratorReport& GetReport() const { return Report; }
+
+	struct FEvents
+	{
+		FCleverTapProperties Properties10;
+		FCleverTapProperties Properties50;
+		FCleverTapProperties ChargeDetails;
+		TArray<FCleverTapProperties> ChargedItems;
+	};
+
+	struct FThreadResult
+	{
+		int64 NumSent[NumLoadEventKinds] = {};
+		int64 NumSkipped = 0;
+		TArray<float> LatencyMicroseconds[NumLoadEventKinds];
+	};
+
+private:
+	bool Tick(float DeltaTime);
+	void Finish();
+
+	const FLoadGeneratorSettings Settings;
+	const FEvents Events;
+	TUniquePtr<FCleverTapTestInstance> Instance;
+	TArray<TFuture<FThreadResult>> Senders;
+	std::atomic<bool> bStopRequested{ false };
+
+	double StartSeconds = 0.0;
+	FLoadGeneratorReport Report;
+	bool bDone = false;
+	FDelegateHandle TickHandle;
+};
+
+/**
+ * Stops the load generator started from the console, if any. Called when the module shuts down, before the ticker
+ *  and the CleverTap module go away.
+ */
+void StopLoadGenerator();
+
+#endif // !UE_BUILD_SHIPPING
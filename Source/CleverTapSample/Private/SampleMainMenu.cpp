@@ -1,6 +1,7 @@
 // Copyright CleverTap All Rights Reserved.
 #include "SampleMainMenu.h"
 
+#include "CleverTapEventBuilder.h"
 #include "CleverTapInstanceConfig.h"
 #include "CleverTapProperties.h"
 #include "CleverTapInstance.h"
@@ -148,6 +149,9 @@ void USampleMainMenu::ConfigureSharedInstance()
 
 	// simple test of the OnPushPermissionResponse notification
 	CleverTap.OnPushPermissionResponse.AddUObject(this, &USampleMainMenu::OnPushPermissionResponse);
+
+	// refresh the displayed id whenever it changes, e.g. after OnUserLogin()
+	CleverTap.OnCleverTapIdChanged.AddUObject(this, &USampleMainMenu::OnCleverTapIdChanged);
 }
 
 void USampleMainMenu::OnPushPermissionResponse(bool bGranted)
@@ -161,6 +165,12 @@ void USampleMainMenu::OnPushPermissionResponse(bool bGranted)
 	}
 }
 
+void USampleMainMenu::OnCleverTapIdChanged(const FString& CleverTapId)
+{
+	UE_LOG(LogCleverTapSample, Log, TEXT("OnCleverTapIdChanged(CleverTapId=%s)"), *CleverTapId);
+	PopulateUI();
+}
+
 void USampleMainMenu::OnUserLogin(const FString& Name, const FString& Email, const FString& Identity)
 {
 	OnUserLoginWithCleverTapId(Name, Email, Identity, /*CleverTapId=*/FString{});
@@ -332,9 +342,12 @@ void USampleMainMenu::RecordEvent(const FString& EventName, const TArray<FClever
 	{
 		UE_LOG(LogCleverTapSample, Log, TEXT("Calling RecordEvent('%s', %s)"), *EventName,
 			*FCleverTapSampleKeyValuePairArrayToString(Params));
-		FCleverTapProperties Properties;
-		PopulatePropertiesWith(Properties, Params);
-		CleverTap.PushEvent(EventName, Properties);
+		FCleverTapEventBuilder Event(EventName, Params.Num());
+		for (const FCleverTapSampleKeyValuePair& Param : Params)
+		{
+			Event.Add(Param.Key, Param.Value);
+		}
+		Event.Push(CleverTap);
 	}
 }
 
@@ -365,26 +378,6 @@ void USampleMainMenu::RecordChargedEvent(
 	CleverTap.PushChargedEvent(ChargeDetails, Items);
 }
 
-void USampleMainMenu::Tick(float DeltaTime)
-{
-	if (CleverTapSys == nullptr || !CleverTapSys->IsSharedInstanceInitialized())
-	{
-		return;
-	}
-
-	FString CleverTapId = CleverTapSys->SharedInstance().GetCleverTapId();
-	if (LastSeenCleverTapId != CleverTapSys->SharedInstance().GetCleverTapId())
-	{
-		PopulateUI();
-		LastSeenCleverTapId = MoveTemp(CleverTapId);
-	}
-}
-
-TStatId USampleMainMenu::GetStatId() const
-{
-	RETURN_QUICK_DECLARE_CYCLE_STAT(USampleMainMenu, STATGROUP_Tickables);
-}
-
 void USampleMainMenu::PopulateUI() const
 {
 	if (CleverTapSys == nullptr || !CleverTapSys->IsSharedInstanceInitialized())
@@ -40,7 +40,7 @@ private:
  * Base class for the sample menu UI blueprint
  */
 UCLASS()
-class USampleMainMenu : public UUserWidget, public FTickableGameObject
+class USampleMainMenu : public UUserWidget
 {
 	GENERATED_BODY()
 
@@ -83,16 +83,11 @@ public:
 	void RecordChargedEvent(
 		const TArray<FCleverTapSampleKeyValuePair>& Params, const UCleverTapSampleProductList* Products);
 
-	// <FTickableGameObject>
-	void Tick(float DeltaTime) override;
-	TStatId GetStatId() const override;
-	ETickableTickType GetTickableTickType() const override { return ETickableTickType::Always; }
-	// </FTickableGameObject>
-
 private:
 	void PopulateUI() const;
 	void ConfigureSharedInstance();
 	void OnPushPermissionResponse(bool bGranted);
+	void OnCleverTapIdChanged(const FString& CleverTapId);
 
 private:
 	UPROPERTY(BlueprintReadWrite, meta = (BindWidget, AllowPrivateAccess = "true"))
@@ -101,8 +96,6 @@ private:
 	UPROPERTY()
 	UCleverTapSubsystem* CleverTapSys;
 
-	FString LastSeenCleverTapId;
-
 	UPROPERTY(BlueprintReadWrite, meta = (BindWidget, AllowPrivateAccess = "true"))
 	UTextBlock* PushPermissionGrantedText;
 };
@@ -0,0 +1,75 @@
+// Copyright CleverTap All Rights Reserved.
+#include "SampleLoadGenerator.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+constexpr double TimeoutSeconds = 30.0;
+
+struct FLoadGeneratorRun
+{
+	TUniquePtr<FLoadGenerator> Generator;
+	int64 NumScheduled = 0;
+	double StartSeconds = 0.0;
+};
+
+} // namespace
+
+/**
+ * Waits until the load generator is done, then checks its report.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FSampleWaitForLoadGeneratorCommand, TSharedRef<FLoadGeneratorRun>,
+	Run, FAutomationTestBase*, Test);
+
+bool FSampleWaitForLoadGeneratorCommand::Update()
+{
+	const bool bDone = Run->Generator->IsDone();
+	if (!bDone && FPlatformTime::Seconds() - Run->StartSeconds < TimeoutSeconds)
+	{
+		return false;
+	}
+
+	Test->TestTrue(TEXT("The run completes before the timeout"), bDone);
+	if (bDone)
+	{
+		const FLoadGeneratorReport& Report = Run->Generator->GetReport();
+		const int64 NumAccounted = Report.NumSent + Report.NumSkipped;
+		Test->TestTrue(TEXT("Events are sent"), Report.NumSent > 0);
+		Test->TestTrue(TEXT("Every scheduled send is either sent or skipped"),
+			NumAccounted >= Run->NumScheduled * 95 / 100 && NumAccounted <= Run->NumScheduled * 105 / 100);
+		Test->TestTrue(TEXT("The plugin drops events once the budget is used up"), Report.NumDropped > 0);
+		Test->TestTrue(TEXT("The plugin only drops sent events"), Report.NumDropped <= Report.NumSent);
+		Test->TestTrue(TEXT("The events that aren't dropped are still buffered"), Report.NumBuffered > 0);
+	}
+
+	// destroyed here rather than when the test framework releases the command, as it joins the sender threads
+	Run->Generator.Reset();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSampleLoadGeneratorTest, "CleverTapSample.LoadGenerator",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSampleLoadGeneratorTest::RunTest(const FString& Parameters)
+{
+	// a budget far below what the run sends, and nothing uploading, so the plugin has to drop events
+	FLoadGeneratorSettings Settings;
+	Settings.NumThreads = 2;
+	Settings.EventsPerSecond = 2000.0;
+	Settings.DurationSeconds = 0.5;
+	Settings.BufferBudgetKilobytes = 16;
+
+	const TSharedRef<FLoadGeneratorRun> Run = MakeShared<FLoadGeneratorRun>();
+	Run->NumScheduled = int64(Settings.EventsPerSecond * Settings.DurationSeconds);
+	Run->StartSeconds = FPlatformTime::Seconds();
+	Run->Generator = MakeUnique<FLoadGenerator>(Settings);
+	TestFalse(TEXT("The command doesn't block until the run completes"), Run->Generator->IsDone());
+	ADD_LATENT_AUTOMATION_COMMAND(FSampleWaitForLoadGeneratorCommand(Run, this));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS